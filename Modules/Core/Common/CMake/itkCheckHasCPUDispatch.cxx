@@ -0,0 +1,47 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#if !defined(__x86_64__) && !defined(__i386__)
+#  error "Runtime CPU dispatch is only implemented for x86 processors."
+#endif
+
+/** Test whether functions can be compiled for other instruction sets than
+ * the one of the translation unit, and whether the instruction sets of the
+ * processor can be queried. */
+__attribute__((target("avx512f,avx512bw,avx512vl,avx512dq"))) int
+AVX512Function(int value)
+{
+  return 2 * value;
+}
+
+__attribute__((target("avx2"))) int
+AVX2Function(int value)
+{
+  return 2 * value;
+}
+
+int
+main()
+{
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+  {
+    return AVX512Function(0);
+  }
+  return __builtin_cpu_supports("avx2") ? AVX2Function(0) : 0;
+}
@@ -0,0 +1,339 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkCPUDispatch_h
+#define itkCPUDispatch_h
+
+#include "itkMacro.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** \def ITK_CPU_DISPATCH_TARGET_SSE41
+ * \def ITK_CPU_DISPATCH_TARGET_AVX2
+ * \def ITK_CPU_DISPATCH_TARGET_AVX512
+ * Attributes which compile a function for an instruction set, whatever the
+ * flags of the translation unit. The function must only be called when
+ * CPUDispatch::GetInstructionSet() is at least that instruction set.
+ * They expand to nothing when ITK_USE_CPU_DISPATCH is not enabled, and
+ * ITK_CPU_DISPATCH_HAS_TARGETS is then not defined.
+ *
+ * \def ITK_CPU_DISPATCH_INLINE
+ * Forces the inlining of a function into its caller, so that it is compiled
+ * for the instruction set of the caller. */
+#if defined(ITK_USE_CPU_DISPATCH) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define ITK_CPU_DISPATCH_HAS_TARGETS
+#  define ITK_CPU_DISPATCH_TARGET_SSE41 __attribute__((target("sse4.1")))
+#  define ITK_CPU_DISPATCH_TARGET_AVX2 __attribute__((target("avx2")))
+#  define ITK_CPU_DISPATCH_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl,avx512dq")))
+#else
+#  define ITK_CPU_DISPATCH_TARGET_SSE41
+#  define ITK_CPU_DISPATCH_TARGET_AVX2
+#  define ITK_CPU_DISPATCH_TARGET_AVX512
+#endif
+
+#if defined(__GNUC__)
+#  define ITK_CPU_DISPATCH_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#  define ITK_CPU_DISPATCH_INLINE __forceinline
+#else
+#  define ITK_CPU_DISPATCH_INLINE inline
+#endif
+
+namespace itk
+{
+/** \class CPUDispatchEnums
+ * \brief enums for CPUDispatch
+ *
+ * \ingroup ITKCommon
+ */
+class CPUDispatchEnums
+{
+public:
+  /** The instruction sets for which kernels can be compiled, in increasing
+   * order: each one includes the previous ones. AVX512 is the F, BW, VL and
+   * DQ subsets. */
+  enum class InstructionSet : uint8_t
+  {
+    Generic,
+    SSE41,
+    AVX2,
+    AVX512
+  };
+};
+// Define how to print enumeration
+extern ITKCommon_EXPORT std::ostream &
+                        operator<<(std::ostream & out, const CPUDispatchEnums::InstructionSet value);
+
+/** \class CPUDispatch
+ * \brief Selects, at run time, the variant of a kernel compiled for the best
+ * instruction set of the processor.
+ *
+ * A binary built for a baseline instruction set does not use the wide vector
+ * units of recent processors. A kernel can instead be compiled several times,
+ * for each of the instruction sets of CPUDispatchEnums::InstructionSet, and
+ * the variant to call is selected at run time, from the instruction set of
+ * the host processor.
+ *
+ * The instruction set used for the selection, GetInstructionSet(), is the
+ * one of the host, limited by SetMaximumInstructionSet(). The maximum can
+ * also be set with the ITK_MAXIMUM_INSTRUCTION_SET environment variable (for
+ * example to AVX2 or GENERIC), to compare the variants or to work around a
+ * problem on a given processor. Without ITK_USE_CPU_DISPATCH (a CMake option
+ * of ITKCommon, enabled for GCC and Clang on x86), only the generic variants
+ * are used.
+ *
+ * The variants are gathered in a CPUDispatchTable, which registers the kernel
+ * here when it is constructed, so that GetRegisteredKernelNames() and Print()
+ * report the variants selected for the kernels of the process.
+ *
+ * \sa CPUDispatchTable
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT CPUDispatch
+{
+public:
+  using InstructionSetEnum = CPUDispatchEnums::InstructionSet;
+
+  /** The best instruction set supported by the host processor (Generic
+   * without ITK_USE_CPU_DISPATCH). */
+  static InstructionSetEnum
+  GetHostInstructionSet();
+
+  /** Set/Get the best instruction set that kernels may use. By default, the
+   * value of the ITK_MAXIMUM_INSTRUCTION_SET environment variable, or
+   * AVX512. */
+  static void
+  SetMaximumInstructionSet(InstructionSetEnum instructionSet);
+  static InstructionSetEnum
+  GetMaximumInstructionSet();
+
+  /** The instruction set of the variants to select: the lowest of the host
+   * and of the maximum instruction sets. */
+  static InstructionSetEnum
+  GetInstructionSet();
+
+  /** Convert an instruction set to its name ("GENERIC", "SSE41", "AVX2" or
+   * "AVX512") and back. The conversion from a string is case insensitive,
+   * and throws an ExceptionObject for an unknown name. */
+  static std::string
+  InstructionSetToString(InstructionSetEnum instructionSet);
+  static InstructionSetEnum
+  InstructionSetFromString(std::string instructionSetString);
+
+  /** Add a kernel to the registry, with the instruction sets of its
+   * variants. Registering a kernel again replaces its variants. Called by
+   * the constructor of CPUDispatchTable. */
+  static void
+  RegisterKernel(const std::string & name, const std::vector<InstructionSetEnum> & variants);
+
+  /** The names of the registered kernels, in alphabetical order. */
+  static std::vector<std::string>
+  GetRegisteredKernelNames();
+
+  /** The instruction sets of the variants of a registered kernel. Throws an
+   * ExceptionObject for an unknown kernel. */
+  static std::vector<InstructionSetEnum>
+  GetKernelVariants(const std::string & name);
+
+  /** The instruction set of the variant selected for a registered kernel.
+   * Throws an ExceptionObject for an unknown kernel. */
+  static InstructionSetEnum
+  GetSelectedKernelVariant(const std::string & name);
+
+  /** Print the host, maximum and selected instruction sets, and the variant
+   * selected for each registered kernel. */
+  static void
+  Print(std::ostream & os);
+
+  /** The best instruction set among the available ones which does not
+   * exceed GetInstructionSet(). The generic variant is assumed available. */
+  static InstructionSetEnum
+  SelectVariant(const std::vector<InstructionSetEnum> & available);
+};
+
+namespace CPUDispatchDetails
+{
+// Calls TKernel::Run<VInstructionSet>(parameters...), compiled for that
+// instruction set. TKernel::Run must be declared ITK_CPU_DISPATCH_INLINE to
+// be compiled with the target of its caller.
+template <typename TKernel, typename TResult, typename... TParameters>
+TResult
+RunGeneric(TParameters... parameters)
+{
+  return TKernel::template Run<CPUDispatchEnums::InstructionSet::Generic>(parameters...);
+}
+
+#ifdef ITK_CPU_DISPATCH_HAS_TARGETS
+template <typename TKernel, typename TResult, typename... TParameters>
+ITK_CPU_DISPATCH_TARGET_SSE41 TResult
+                              RunSSE41(TParameters... parameters)
+{
+  return TKernel::template Run<CPUDispatchEnums::InstructionSet::SSE41>(parameters...);
+}
+
+template <typename TKernel, typename TResult, typename... TParameters>
+ITK_CPU_DISPATCH_TARGET_AVX2 TResult
+                             RunAVX2(TParameters... parameters)
+{
+  return TKernel::template Run<CPUDispatchEnums::InstructionSet::AVX2>(parameters...);
+}
+
+template <typename TKernel, typename TResult, typename... TParameters>
+ITK_CPU_DISPATCH_TARGET_AVX512 TResult
+                               RunAVX512(TParameters... parameters)
+{
+  return TKernel::template Run<CPUDispatchEnums::InstructionSet::AVX512>(parameters...);
+}
+#endif
+} // namespace CPUDispatchDetails
+
+template <typename TFunction>
+class CPUDispatchTable;
+
+/** \class CPUDispatchTable
+ * \brief The variants of a kernel for each instruction set.
+ *
+ * A table holds a generic implementation of a kernel, and optionally
+ * implementations for the other instruction sets (for example written with
+ * intrinsics, in functions marked ITK_CPU_DISPATCH_TARGET_AVX2). Calling the
+ * table calls the variant of the best instruction set which does not exceed
+ * CPUDispatch::GetInstructionSet(). Tables are usually static variables,
+ * constructed at startup:
+ * \code
+ *   const itk::CPUDispatchTable<void(const float *, float *, itk::SizeValueType)> scaleKernel(
+ *     "Scale", &ScaleGeneric, nullptr, &ScaleAVX2);
+ *   scaleKernel(input, output, n);
+ * \endcode
+ *
+ * FromKernel() compiles a same implementation for all the instruction sets:
+ * it calls TKernel::Run<VInstructionSet>(parameters...), a static member
+ * function template marked ITK_CPU_DISPATCH_INLINE, from functions compiled
+ * for each instruction set. Loops of Run are thereby vectorized by the
+ * compiler for each of them, and Run may use VInstructionSet to pick a vector
+ * width. Functions called by Run which are not inlined are compiled for the
+ * baseline instruction set of the build, so that their code may be shared
+ * with other translation units.
+ *
+ * Variants compiled for instruction sets including FMA (AVX512) may fuse
+ * multiplications and additions, and round differently from the generic
+ * variant.
+ *
+ * \sa CPUDispatch
+ * \ingroup ITKCommon
+ */
+template <typename TResult, typename... TParameters>
+class CPUDispatchTable<TResult(TParameters...)>
+{
+public:
+  using FunctionType = TResult(TParameters...);
+  using InstructionSetEnum = CPUDispatchEnums::InstructionSet;
+
+  static constexpr unsigned int NumberOfInstructionSets = static_cast<unsigned int>(InstructionSetEnum::AVX512) + 1;
+
+  /** Construct a table from the variants of a kernel, a null pointer meaning
+   * that no variant is available for that instruction set, and register the
+   * kernel under the given name. */
+  CPUDispatchTable(const char *   name,
+                   FunctionType * generic,
+                   FunctionType * sse41 = nullptr,
+                   FunctionType * avx2 = nullptr,
+                   FunctionType * avx512 = nullptr)
+    : m_Name(name)
+    , m_Variants{ generic, sse41, avx2, avx512 }
+  {
+    if (generic == nullptr)
+    {
+      itkGenericExceptionMacro("The generic variant of kernel " << name << " is missing.");
+    }
+    std::vector<InstructionSetEnum> available;
+    for (unsigned int i = 0; i < NumberOfInstructionSets; ++i)
+    {
+      if (m_Variants[i] != nullptr)
+      {
+        available.push_back(static_cast<InstructionSetEnum>(i));
+      }
+    }
+    CPUDispatch::RegisterKernel(name, available);
+  }
+
+  /** Construct a table with variants of TKernel::Run for all the instruction
+   * sets (only the generic one without ITK_CPU_DISPATCH_HAS_TARGETS). */
+  template <typename TKernel>
+  static CPUDispatchTable
+  FromKernel(const char * name)
+  {
+#ifdef ITK_CPU_DISPATCH_HAS_TARGETS
+    return CPUDispatchTable(name,
+                            &CPUDispatchDetails::RunGeneric<TKernel, TResult, TParameters...>,
+                            &CPUDispatchDetails::RunSSE41<TKernel, TResult, TParameters...>,
+                            &CPUDispatchDetails::RunAVX2<TKernel, TResult, TParameters...>,
+                            &CPUDispatchDetails::RunAVX512<TKernel, TResult, TParameters...>);
+#else
+    return CPUDispatchTable(name, &CPUDispatchDetails::RunGeneric<TKernel, TResult, TParameters...>);
+#endif
+  }
+
+  /** The name under which the kernel is registered. */
+  const char *
+  GetName() const
+  {
+    return m_Name;
+  }
+
+  /** The instruction set of the variant selected for the current
+   * CPUDispatch::GetInstructionSet(). */
+  InstructionSetEnum
+  GetSelectedInstructionSet() const
+  {
+    auto index = static_cast<unsigned int>(CPUDispatch::GetInstructionSet());
+    while (index > 0 && m_Variants[index] == nullptr)
+    {
+      --index;
+    }
+    return static_cast<InstructionSetEnum>(index);
+  }
+
+  /** The selected variant. */
+  FunctionType *
+  Get() const
+  {
+    return m_Variants[static_cast<unsigned int>(this->GetSelectedInstructionSet())];
+  }
+
+  /** The variant of a given instruction set, or null if not available. */
+  FunctionType *
+  GetVariant(InstructionSetEnum instructionSet) const
+  {
+    return m_Variants[static_cast<unsigned int>(instructionSet)];
+  }
+
+  /** Call the selected variant. */
+  TResult
+  operator()(TParameters... parameters) const
+  {
+    return this->Get()(parameters...);
+  }
+
+private:
+  const char *   m_Name;
+  FunctionType * m_Variants[NumberOfInstructionSets];
+};
+} // end namespace itk
+
+#endif
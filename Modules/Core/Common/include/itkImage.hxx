@@ -61,8 +61,14 @@ Image<TPixel, VImageDimension>::Initialize()
 
   // Replace the handle to the buffer. This is the safest thing to do,
   // since the same container can be shared by multiple images (e.g.
-  // Grafted outputs and in place filters).
+  // Grafted outputs and in place filters). The allocation settings of
+  // the image are kept.
+  const PixelContainerPointer previousBuffer = m_Buffer;
   m_Buffer = PixelContainer::New();
+  if (previousBuffer)
+  {
+    m_Buffer->CopyAllocationSettings(*previousBuffer);
+  }
 }
 
 
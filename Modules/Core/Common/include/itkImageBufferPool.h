@@ -0,0 +1,148 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageBufferPool_h
+#define itkImageBufferPool_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+
+#include <limits>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace itk
+{
+/** \class ImageBufferPool
+ * \brief Keeps released image buffers for reuse by later allocations.
+ *
+ * When a pipeline is updated repeatedly with images of the same size, each
+ * update allocates new buffers for the intermediate images, and pays again
+ * for the page faults and for the zero-initialization of the memory. An
+ * ImportImageContainer associated with an ImageBufferPool instead returns its
+ * buffer to the pool when it is released, and takes one from the pool when it
+ * allocates.
+ *
+ * Blocks are grouped in buckets of similar sizes (sizes are rounded up to the
+ * next multiple of an eighth of their highest power of two), so that a block
+ * can serve requests of a slightly smaller size. The pool holds at most
+ * MaximumNumberOfBytesHeld bytes of released blocks; blocks released beyond
+ * that are freed.
+ *
+ * A pool can be shared by all the images of the process, by setting it as
+ * ImportImageContainerCommon::SetGlobalDefaultBufferPool(), or by the images
+ * of one pipeline, by setting it on the pixel containers of their outputs.
+ * All the methods are thread safe.
+ *
+ * \sa ImportImageContainer::SetBufferPool
+ *
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ImageBufferPool : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ImageBufferPool);
+
+  /** Standard class type aliases. */
+  using Self = ImageBufferPool;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(ImageBufferPool);
+
+  /** The alignment of the blocks, a cache line. It satisfies the Aligned
+   * allocation policy of ImportImageContainer. */
+  static constexpr SizeValueType BlockAlignment = 64;
+
+  /** Return a block of memory of at least numberOfBytes bytes, aligned to
+   * BlockAlignment bytes. The block is taken from the pool if a
+   * released block of the same bucket is available (a hit), and newly
+   * allocated otherwise (a miss). Throws a MemoryAllocationError if the
+   * memory cannot be allocated. */
+  void *
+  Acquire(SizeValueType numberOfBytes);
+
+  /** Give back a block obtained from Acquire(numberOfBytes), with the same
+   * number of bytes. The block is kept for reuse, unless the pool already
+   * holds MaximumNumberOfBytesHeld bytes. */
+  void
+  Release(void * block, SizeValueType numberOfBytes);
+
+  /** Free all the blocks held by the pool. Blocks in use are not affected. */
+  void
+  Clear();
+
+  /** Set/Get the maximum number of bytes of released blocks kept by the pool.
+   * Lowering it frees held blocks as needed. Unlimited by default. */
+  void
+  SetMaximumNumberOfBytesHeld(SizeValueType numberOfBytes);
+  SizeValueType
+  GetMaximumNumberOfBytesHeld() const;
+
+  /** The number of Acquire() calls served by a held block. */
+  SizeValueType
+  GetNumberOfHits() const;
+
+  /** The number of Acquire() calls which needed a new allocation. */
+  SizeValueType
+  GetNumberOfMisses() const;
+
+  /** The number of bytes of the released blocks currently held by the pool. */
+  SizeValueType
+  GetNumberOfBytesHeld() const;
+
+  /** Reset the hit and miss counters to zero. */
+  void
+  ResetStatistics();
+
+  /** The size of the blocks of the bucket of a request of numberOfBytes. */
+  static SizeValueType
+  GetBucketSize(SizeValueType numberOfBytes);
+
+protected:
+  ImageBufferPool() = default;
+  ~ImageBufferPool() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Free held blocks, largest first, until at most numberOfBytes are held. */
+  void
+  ShrinkTo(SizeValueType numberOfBytes); // to be called with m_Mutex locked
+
+  mutable std::mutex m_Mutex;
+
+  /** The released blocks, per bucket size. */
+  std::map<SizeValueType, std::vector<void *>> m_HeldBlocks; // guarded by m_Mutex
+
+  SizeValueType m_MaximumNumberOfBytesHeld{ std::numeric_limits<SizeValueType>::max() }; // guarded by m_Mutex
+  SizeValueType m_NumberOfBytesHeld{ 0 };                                              // guarded by m_Mutex
+  SizeValueType m_NumberOfHits{ 0 };                                                   // guarded by m_Mutex
+  SizeValueType m_NumberOfMisses{ 0 };                                                 // guarded by m_Mutex
+};
+} // end namespace itk
+
+#endif
@@ -18,6 +18,8 @@
 #ifndef itkImportImageContainer_h
 #define itkImportImageContainer_h
 
+#include "itkImageBufferPool.h"
+#include "itkImportImageContainerCommon.h"
 #include "itkObject.h"
 #include "itkObjectFactory.h"
 #include <utility>
@@ -57,6 +59,8 @@ public:
   using ElementIdentifier = TElementIdentifier;
   using Element = TElement;
 
+  using AllocationPolicyEnum = ImportImageContainerEnums::AllocationPolicy;
+
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
 
@@ -159,6 +163,49 @@ public:
   itkGetConstMacro(ContainerManageMemory, bool);
   itkBooleanMacro(ContainerManageMemory);
 
+  /** Set/Get whether the pages of a newly allocated buffer are first touched
+   * (and zero-initialized, when value initialization is requested) by the
+   * threads of the ThreadPool, instead of by the allocating thread. On
+   * NUMA systems, this distributes the buffer over the memory nodes of the
+   * threads which later process it. It only applies to element types which
+   * are trivially default constructible. Initialized from
+   * ImportImageContainerCommon::GetGlobalDefaultParallelFirstTouch().
+   * \sa ThreadPool::SetUseThreadAffinity */
+  itkSetMacro(ParallelFirstTouch, bool);
+  itkGetConstMacro(ParallelFirstTouch, bool);
+  itkBooleanMacro(ParallelFirstTouch);
+
+  /** Set/Get how the buffer is allocated: aligned for the element type
+   * only, aligned to 64 bytes, or aligned to and backed by huge pages. A new
+   * policy applies to the next allocation. Initialized from
+   * ImportImageContainerCommon::GetGlobalDefaultAllocationPolicy().
+   * \sa ImportImageContainerEnums::AllocationPolicy */
+  itkSetEnumMacro(AllocationPolicy, AllocationPolicyEnum);
+  itkGetEnumMacro(AllocationPolicy, AllocationPolicyEnum);
+
+  /** Set/Get the pool from which the buffer is allocated, and to which it
+   * is returned when the container releases it. A buffer always goes back
+   * to the pool it was taken from, even if the pool is changed in between.
+   * Buffers allocated with the HugePages policy, and element types which
+   * need more than ImageBufferPool::BlockAlignment, are never pooled. A
+   * pooled buffer must not be freed with delete[] by code which took it
+   * over from the container. Initialized from
+   * ImportImageContainerCommon::GetGlobalDefaultBufferPool().
+   * \sa ImageBufferPool */
+  itkSetObjectMacro(BufferPool, ImageBufferPool);
+  itkGetModifiableObjectMacro(BufferPool, ImageBufferPool);
+
+  /** Copy the settings which control how the buffer is allocated from
+   * another container, without copying its buffer. Image uses it to keep
+   * these settings when it replaces its container. */
+  void
+  CopyAllocationSettings(const Self & other)
+  {
+    this->SetAllocationPolicy(other.m_AllocationPolicy);
+    this->SetParallelFirstTouch(other.m_ParallelFirstTouch);
+    this->SetBufferPool(other.m_BufferPool);
+  }
+
 protected:
   ImportImageContainer() = default;
   ~ImportImageContainer() override;
@@ -210,6 +257,25 @@ private:
   TElementIdentifier m_Size{};
   TElementIdentifier m_Capacity{};
   bool               m_ContainerManageMemory{ true };
+  bool               m_ParallelFirstTouch{ ImportImageContainerCommon::GetGlobalDefaultParallelFirstTouch() };
+
+  AllocationPolicyEnum     m_AllocationPolicy{ ImportImageContainerCommon::GetGlobalDefaultAllocationPolicy() };
+  ImageBufferPool::Pointer m_BufferPool{ ImportImageContainerCommon::GetGlobalDefaultBufferPool() };
+
+  /** How a buffer was allocated, which determines how it is freed: by its
+   * pool if it has one, else with FreeBuffer unless the policy is Default,
+   * else with delete[]. */
+  struct BufferOrigin
+  {
+    ImageBufferPool::Pointer Pool{};
+    AllocationPolicyEnum     Policy{ AllocationPolicyEnum::Default };
+  };
+
+  /** The origin of m_ImportPointer. */
+  BufferOrigin m_ImportPointerOrigin{};
+
+  /** The origin of the buffer returned by the last call to AllocateElements(). */
+  mutable BufferOrigin m_LastAllocationOrigin{};
 };
 } // end namespace itk
 
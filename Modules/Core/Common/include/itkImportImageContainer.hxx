@@ -29,6 +29,9 @@
 #define itkImportImageContainer_hxx
 
 #include <algorithm> // For copy_n.
+#include <memory>    // For uninitialized_default_construct_n and destroy_n.
+#include <new>
+#include <type_traits>
 
 namespace itk
 {
@@ -53,13 +56,16 @@ ImportImageContainer<TElementIdentifier, TElement>::Reserve(ElementIdentifier si
   {
     if (size > m_Capacity)
     {
-      TElement * temp = this->AllocateElements(size, UseValueInitialization);
+      m_LastAllocationOrigin = {};
+      TElement *         temp = this->AllocateElements(size, UseValueInitialization);
+      const BufferOrigin tempOrigin = std::move(m_LastAllocationOrigin);
       // only copy the portion of the data used in the old buffer
       std::copy_n(m_ImportPointer, m_Size, temp);
 
       DeallocateManagedMemory();
 
       m_ImportPointer = temp;
+      m_ImportPointerOrigin = tempOrigin;
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -73,7 +79,9 @@ ImportImageContainer<TElementIdentifier, TElement>::Reserve(ElementIdentifier si
   }
   else
   {
+    m_LastAllocationOrigin = {};
     m_ImportPointer = this->AllocateElements(size, UseValueInitialization);
+    m_ImportPointerOrigin = std::move(m_LastAllocationOrigin);
     m_Capacity = size;
     m_Size = size;
     m_ContainerManageMemory = true;
@@ -94,12 +102,15 @@ ImportImageContainer<TElementIdentifier, TElement>::Squeeze()
     if (m_Size < m_Capacity)
     {
       const TElementIdentifier size = m_Size;
-      TElement *               temp = this->AllocateElements(size, false);
+      m_LastAllocationOrigin = {};
+      TElement *         temp = this->AllocateElements(size, false);
+      const BufferOrigin tempOrigin = std::move(m_LastAllocationOrigin);
       std::copy_n(m_ImportPointer, m_Size, temp);
 
       DeallocateManagedMemory();
 
       m_ImportPointer = temp;
+      m_ImportPointerOrigin = tempOrigin;
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -155,11 +166,68 @@ TElement *
 ImportImageContainer<TElementIdentifier, TElement>::AllocateElements(ElementIdentifier size,
                                                                      bool              UseValueInitialization) const
 {
+  // Elements which do not need to be constructed can be left untouched here,
+  // and be initialized by several threads afterwards.
+  constexpr bool isTrivialElement =
+    std::is_trivially_default_constructible_v<TElement> && std::is_trivially_destructible_v<TElement>;
+  const bool parallelFirstTouch = isTrivialElement && m_ParallelFirstTouch;
+
+  const SizeValueType numberOfBytes = size * sizeof(TElement);
+  if (const auto allocationObserver = ImportImageContainerCommon::GetAllocationObserver())
+  {
+    allocationObserver(numberOfBytes);
+  }
+
+  // Allocate raw memory when it comes from a pool or needs a particular
+  // alignment, and construct the elements in place.
+  const bool usePool = m_BufferPool && m_AllocationPolicy != AllocationPolicyEnum::HugePages &&
+                       alignof(TElement) <= ImageBufferPool::BlockAlignment;
+  if (usePool || m_AllocationPolicy != AllocationPolicyEnum::Default)
+  {
+    auto * const data = static_cast<TElement *>(
+      usePool ? m_BufferPool->Acquire(numberOfBytes)
+              : ImportImageContainerCommon::AllocateBuffer(numberOfBytes, m_AllocationPolicy, alignof(TElement)));
+    const auto releaseData = [this, usePool, data, numberOfBytes] {
+      if (usePool)
+      {
+        m_BufferPool->Release(data, numberOfBytes);
+      }
+      else
+      {
+        ImportImageContainerCommon::FreeBuffer(data, numberOfBytes, m_AllocationPolicy, alignof(TElement));
+      }
+    };
+    try
+    {
+      if (parallelFirstTouch)
+      {
+        // Zero bytes value-initialize trivial elements.
+        ImportImageContainerCommon::ParallelFirstTouch(data, numberOfBytes, UseValueInitialization);
+      }
+      else if (UseValueInitialization)
+      {
+        std::uninitialized_value_construct_n(data, size);
+      }
+      else
+      {
+        std::uninitialized_default_construct_n(data, size);
+      }
+    }
+    catch (...)
+    {
+      releaseData();
+      throw;
+    }
+    m_LastAllocationOrigin.Pool = usePool ? m_BufferPool : nullptr;
+    m_LastAllocationOrigin.Policy = m_AllocationPolicy;
+    return data;
+  }
+
   TElement * data;
 
   try
   {
-    if (UseValueInitialization)
+    if (UseValueInitialization && !parallelFirstTouch)
     {
       data = new TElement[size]();
     }
@@ -178,6 +246,11 @@ ImportImageContainer<TElementIdentifier, TElement>::AllocateElements(ElementIden
     // of memory.  Do not use the exception macro.
     throw MemoryAllocationError(__FILE__, __LINE__, "Failed to allocate memory for image.", ITK_LOCATION);
   }
+  if (parallelFirstTouch)
+  {
+    // Zero bytes value-initialize trivial elements.
+    ImportImageContainerCommon::ParallelFirstTouch(data, numberOfBytes, UseValueInitialization);
+  }
   return data;
 }
 
@@ -188,8 +261,23 @@ ImportImageContainer<TElementIdentifier, TElement>::DeallocateManagedMemory()
   // Encapsulate all image memory deallocation here
   if (m_ContainerManageMemory)
   {
-    delete[] m_ImportPointer;
+    if (m_ImportPointerOrigin.Pool)
+    {
+      std::destroy_n(m_ImportPointer, m_Capacity);
+      m_ImportPointerOrigin.Pool->Release(m_ImportPointer, m_Capacity * sizeof(TElement));
+    }
+    else if (m_ImportPointerOrigin.Policy != AllocationPolicyEnum::Default)
+    {
+      std::destroy_n(m_ImportPointer, m_Capacity);
+      ImportImageContainerCommon::FreeBuffer(
+        m_ImportPointer, m_Capacity * sizeof(TElement), m_ImportPointerOrigin.Policy, alignof(TElement));
+    }
+    else
+    {
+      delete[] m_ImportPointer;
+    }
   }
+  m_ImportPointerOrigin = {};
   m_ImportPointer = nullptr;
   m_Capacity = 0;
   m_Size = 0;
@@ -205,6 +293,9 @@ ImportImageContainer<TElementIdentifier, TElement>::PrintSelf(std::ostream & os,
   os << indent << "Container manages memory: " << (m_ContainerManageMemory ? "true" : "false") << std::endl;
   os << indent << "Size: " << m_Size << std::endl;
   os << indent << "Capacity: " << m_Capacity << std::endl;
+  os << indent << "Parallel first touch: " << (m_ParallelFirstTouch ? "true" : "false") << std::endl;
+  os << indent << "AllocationPolicy: " << m_AllocationPolicy << std::endl;
+  itkPrintSelfObjectMacro(BufferPool);
 }
 } // end namespace itk
 
@@ -0,0 +1,147 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImportImageContainerCommon_h
+#define itkImportImageContainerCommon_h
+
+#include "ITKCommonExport.h"
+#include "itkIntTypes.h"
+#include "itkSmartPointer.h"
+#include <ostream>
+
+namespace itk
+{
+
+class ImageBufferPool;
+
+/** \class ImportImageContainerEnums
+ *
+ * \brief enums for ImportImageContainer
+ *
+ * \ingroup ITKCommon
+ */
+class ImportImageContainerEnums
+{
+public:
+  /**
+   * \ingroup ITKCommon
+   * How the buffer of an ImportImageContainer is allocated.
+   * Default: with new[], aligned for the element type only.
+   * Aligned: aligned to 64 bytes (a cache line, and the width of the
+   * largest SIMD registers).
+   * HugePages: buffers of at least 2 MiB are aligned to 2 MiB, and on Linux
+   * they are advised to be backed by transparent huge pages, which reduces
+   * the TLB misses of the accesses to large images. Smaller buffers are
+   * allocated as with Aligned.
+   */
+  enum class AllocationPolicy : uint8_t
+  {
+    Default,
+    Aligned,
+    HugePages
+  };
+};
+// Define how to print enumeration
+extern ITKCommon_EXPORT std::ostream &
+                        operator<<(std::ostream & out, const ImportImageContainerEnums::AllocationPolicy value);
+
+/** \class ImportImageContainerCommon
+ * \brief Code of ImportImageContainer common between templates
+ *
+ * This class provides common non-templated code which can be compiled
+ * and used by all templated versions of ImportImageContainer, among which
+ * the global defaults of the memory allocation settings.
+ *
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ImportImageContainerCommon
+{
+public:
+  using AllocationPolicyEnum = ImportImageContainerEnums::AllocationPolicy;
+
+  /** The alignment of the buffers allocated with the Aligned policy. */
+  static constexpr SizeValueType AlignedAllocationAlignment = 64;
+
+  /** The size of a huge page, and the alignment of the large buffers
+   * allocated with the HugePages policy. */
+  static constexpr SizeValueType HugePageSize = 2 * 1024 * 1024;
+
+  /** Set/Get the value which is used to initialize the AllocationPolicy
+   * setting of an ImportImageContainer at construction time. Default by
+   * default. */
+  static void
+  SetGlobalDefaultAllocationPolicy(AllocationPolicyEnum);
+  static AllocationPolicyEnum
+  GetGlobalDefaultAllocationPolicy();
+
+  /** Set/Get the value which is used to initialize the ParallelFirstTouch
+   * setting of an ImportImageContainer at construction time. Off by default. */
+  static void
+  SetGlobalDefaultParallelFirstTouch(bool);
+  static bool
+  GetGlobalDefaultParallelFirstTouch();
+
+  /** Set/Get the buffer pool which is used to initialize the BufferPool
+   * setting of an ImportImageContainer at construction time. Set a pool to
+   * share it between all the images of the process. None by default. Both
+   * may be called from any thread: the pool returned stays valid while
+   * another one is set. */
+  static void
+  SetGlobalDefaultBufferPool(ImageBufferPool * bufferPool);
+  static SmartPointer<ImageBufferPool>
+  GetGlobalDefaultBufferPool();
+
+  /** A function which is called with the size in bytes of each buffer that an
+   * ImportImageContainer allocates. */
+  using AllocationObserverType = void (*)(SizeValueType numberOfBytes);
+
+  /** Set/Get the allocation observer, or nullptr for none, the default. An
+   * active PipelineProfiler sets it to record the bytes allocated by each
+   * filter execution. */
+  static void
+  SetAllocationObserver(AllocationObserverType allocationObserver);
+  static AllocationObserverType
+  GetAllocationObserver();
+
+  /** Write to each memory page of a newly allocated buffer from the threads
+   * of the ThreadPool, which are the ones that ThreadPool::SetUseThreadAffinity
+   * binds to processors. The buffer is split into one contiguous piece per
+   * thread, like ImageRegionSplitterSlowDimension splits the buffered region
+   * of an image, so that on NUMA systems each piece is placed on the memory
+   * node of the thread which processes that part of the image later on.
+   * If zeroFill is true, all the bytes of the buffer are set to zero,
+   * otherwise only one byte per page is written. */
+  static void
+  ParallelFirstTouch(void * buffer, SizeValueType numberOfBytes, bool zeroFill);
+
+  /** The alignment of a buffer of numberOfBytes allocated with the given
+   * policy, for elements which need elementAlignment. */
+  static SizeValueType
+  GetBufferAlignment(SizeValueType numberOfBytes, AllocationPolicyEnum policy, SizeValueType elementAlignment);
+
+  /** Allocate an uninitialized buffer of numberOfBytes with the given policy
+   * (which must not be Default). Throws a MemoryAllocationError on failure.
+   * The buffer must be freed with FreeBuffer, with the same arguments. */
+  static void *
+  AllocateBuffer(SizeValueType numberOfBytes, AllocationPolicyEnum policy, SizeValueType elementAlignment);
+  static void
+  FreeBuffer(void * buffer, SizeValueType numberOfBytes, AllocationPolicyEnum policy, SizeValueType elementAlignment);
+};
+
+} // end namespace itk
+
+#endif
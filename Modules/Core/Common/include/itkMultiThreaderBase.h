@@ -79,12 +79,28 @@ public:
     STD_EXCEPTION,
     UNKNOWN
   };
+
+  /**
+   * \ingroup ITKCommon
+   * How ParallelizeImageRegion divides a region among the threads.
+   * Static: into NumberOfWorkUnits pieces of the same size.
+   * Guided: into chunks which the threads claim whenever they become idle,
+   * large at first and smaller as less of the region remains, for work whose
+   * cost per pixel varies across the region.
+   */
+  enum class WorkScheduling : uint8_t
+  {
+    Static,
+    Guided
+  };
 };
 // Define how to print enumeration
 extern ITKCommon_EXPORT std::ostream &
                         operator<<(std::ostream & out, const MultiThreaderBaseEnums::Threader value);
 extern ITKCommon_EXPORT std::ostream &
                         operator<<(std::ostream & out, const MultiThreaderBaseEnums::ThreadExitCode value);
+extern ITKCommon_EXPORT std::ostream &
+                        operator<<(std::ostream & out, const MultiThreaderBaseEnums::WorkScheduling value);
 
 /** \class MultiThreaderBase
  * \brief A class for performing multithreaded execution
@@ -139,6 +155,20 @@ public:
   SetUpdateProgress(bool updates);
   itkGetConstMacro(UpdateProgress, bool);
 
+  using WorkSchedulingEnum = MultiThreaderBaseEnums::WorkScheduling;
+
+  /** Set/Get how ParallelizeImageRegion divides a region among the threads.
+   * Initialized with GlobalDefaultWorkScheduling at construction.
+   *
+   * With Guided scheduling, min(MaximumNumberOfThreads, NumberOfWorkUnits)
+   * threads repeatedly claim the next chunk of the region, cut along its
+   * slowest dimensions, of about a (2 * number of threads)th of what
+   * remains. The funcP of ParallelizeImageRegion is then called for more,
+   * smaller regions than with Static scheduling. TBBMultiThreader, whose
+   * partitioner already balances the work dynamically, ignores it. */
+  itkSetEnumMacro(WorkScheduling, WorkSchedulingEnum);
+  itkGetEnumMacro(WorkScheduling, WorkSchedulingEnum);
+
   /** Set/Get the maximum number of threads to use when multithreading.  It
    * will be clamped to the range [ 1, ITK_MAX_THREADS ] because several arrays
    * are already statically allocated using the ITK_MAX_THREADS number.
@@ -215,6 +245,15 @@ public:
   static ThreadIdType
   GetGlobalDefaultNumberOfThreads();
 
+  /** Set/Get the value which is used to initialize the WorkScheduling in the
+   * constructor. It is initially picked up from the
+   * ITK_GLOBAL_DEFAULT_WORK_SCHEDULING environment variable (Static or
+   * Guided), and is Static otherwise. */
+  static void
+  SetGlobalDefaultWorkScheduling(WorkSchedulingEnum workScheduling);
+  static WorkSchedulingEnum
+  GetGlobalDefaultWorkScheduling();
+
 #if !defined(ITK_LEGACY_REMOVE)
   /** Get/Set the number of threads to use.
    * DEPRECATED! Use WorkUnits and MaximumNumberOfThreads instead. */
@@ -451,6 +490,15 @@ protected:
   static ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
   ParallelizeImageRegionHelper(void * arg);
 
+  /** Implements ParallelizeImageRegion with Guided work scheduling, by
+   * running the threads with ParallelizeArray. */
+  void
+  ParallelizeImageRegionGuided(unsigned int                 dimension,
+                               const IndexValueType         index[],
+                               const SizeValueType          size[],
+                               const ThreadingFunctorType & funcP,
+                               ProcessObject *              filter);
+
   /** The number of work units to create. */
   ThreadIdType m_NumberOfWorkUnits{};
 
@@ -464,6 +512,9 @@ protected:
    */
   ThreadIdType m_MaximumNumberOfThreads{};
 
+  /** How ParallelizeImageRegion divides a region among the threads. */
+  WorkSchedulingEnum m_WorkScheduling{ WorkSchedulingEnum::Static };
+
   /** Static function used as a "proxy callback" by multi-threaders.  The
    * threading library will call this routine for each thread, which
    * will delegate the control to the prescribed SingleMethod. This
@@ -0,0 +1,284 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPipelineProfiler_h
+#define itkPipelineProfiler_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+
+#include <chrono>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace itk
+{
+class ProcessObject;
+class PipelineProfilerExecution;
+
+/** \class PipelineProfiler
+ * \brief Records the executions of the filters of the pipelines.
+ *
+ * While a profiler is active, i.e. between its Start() and Stop(), each
+ * filter which generates its data records an execution: the wall time of
+ * its GenerateData(), the bytes allocated for images while it runs, the
+ * work chunks it runs on the threads of its multithreader, and, for the
+ * streaming filters, the number of pieces it requests from upstream. A filter
+ * which is updated for several streamed pieces records one execution per
+ * piece. Executions nest: the upstream filters updated by a streaming filter,
+ * or the mini-pipeline of a composite filter, are children of the execution
+ * of that filter.
+ *
+ * The executions are summarized per filter by GetFilterSummaries(), with the
+ * busy time of each thread (the time it spent in work chunks of the filter)
+ * and its idle time (the rest of the wall time of the executions in which it
+ * ran work chunks), which tells how well the filter balances its work.
+ * WriteJSON() writes the summaries and the executions, and WriteChromeTrace()
+ * writes them in the trace event format of chrome://tracing and Perfetto.
+ *
+ * Only one profiler is active at a time. When none is, the instrumentation of
+ * ProcessObject and of the multithreaders costs one atomic load per filter
+ * execution and one thread local load per work chunk, and an allocation of
+ * ImportImageContainer one atomic load of its observer.
+ *
+ * \code
+ * auto profiler = itk::PipelineProfiler::New();
+ * profiler->Start();
+ * writer->Update();
+ * profiler->Stop();
+ * std::ofstream trace("trace.json");
+ * profiler->WriteChromeTrace(trace);
+ * \endcode
+ *
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT PipelineProfiler : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(PipelineProfiler);
+
+  /** Standard class type aliases. */
+  using Self = PipelineProfiler;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(PipelineProfiler);
+
+  /** A work chunk run by a thread for a filter execution. Times are in
+   * seconds since the profiler was created or cleared. */
+  struct WorkChunk
+  {
+    ThreadIdType ThreadIndex;
+    double       StartTime;
+    double       Duration;
+  };
+
+  /** An execution of a filter. Threads are numbered in the order in which the
+   * profiler first sees them, from zero. */
+  struct FilterExecution
+  {
+    std::string            Name;
+    std::string            NameOfClass;
+    SizeValueType          FilterIndex;
+    SizeValueType          ParentIndex; // index of the parent execution, or NoParent
+    unsigned int           Depth;
+    ThreadIdType           ThreadIndex;
+    double                 StartTime;
+    double                 Duration;
+    SizeValueType          AllocatedBytes;
+    SizeValueType          NumberOfStreamingPieces;
+    std::vector<WorkChunk> WorkChunks;
+  };
+
+  /** The work of a thread for a filter. */
+  struct ThreadLoad
+  {
+    ThreadIdType  ThreadIndex;
+    SizeValueType NumberOfWorkChunks;
+    double        BusyTime;
+    double        IdleTime;
+  };
+
+  /** The executions of a filter, summed. SelfTime excludes the time spent in
+   * child executions on the same thread. */
+  struct FilterSummary
+  {
+    std::string             Name;
+    std::string             NameOfClass;
+    SizeValueType           NumberOfExecutions;
+    double                  TotalTime;
+    double                  SelfTime;
+    SizeValueType           AllocatedBytes;
+    SizeValueType           NumberOfStreamingPieces;
+    SizeValueType           NumberOfWorkChunks;
+    std::vector<ThreadLoad> Threads;
+  };
+
+  static constexpr SizeValueType NoParent = std::numeric_limits<SizeValueType>::max();
+
+  /** Make this profiler the active one, replacing any other. */
+  void
+  Start();
+
+  /** Stop recording, if this profiler is the active one. Executions in
+   * progress are still recorded when they end. */
+  void
+  Stop();
+
+  /** Whether this profiler is the active one. */
+  bool
+  IsActive() const;
+
+  /** The active profiler, or nullptr. */
+  static PipelineProfiler *
+  GetActiveProfiler();
+
+  /** Forget the recorded executions, and restart the clock. Executions in
+   * progress are not recorded. */
+  void
+  Clear();
+
+  /** Set/Get the maximum number of executions which are recorded; later ones
+   * are dropped. A million by default. */
+  itkSetMacro(MaximumNumberOfExecutions, SizeValueType);
+  itkGetConstMacro(MaximumNumberOfExecutions, SizeValueType);
+
+  /** The number of executions dropped since the last Clear(). */
+  SizeValueType
+  GetNumberOfDroppedExecutions() const;
+
+  /** The completed executions, in the order in which they started. */
+  std::vector<FilterExecution>
+  GetExecutions() const;
+
+  /** The executions summed per filter, in the order in which the filters
+   * first ran. */
+  std::vector<FilterSummary>
+  GetFilterSummaries() const;
+
+  /** Write the filter summaries and the executions as a JSON document. */
+  void
+  WriteJSON(std::ostream & os) const;
+
+  /** Write the executions and their work chunks in the Chrome trace event
+   * format, with one track per thread. */
+  void
+  WriteChromeTrace(std::ostream & os) const;
+
+  /** Records an execution of a filter, from its construction to its
+   * destruction, when a profiler is active. Used by ProcessObject. */
+  class ITKCommon_EXPORT ExecutionScope
+  {
+  public:
+    ITK_DISALLOW_COPY_AND_MOVE(ExecutionScope);
+
+    explicit ExecutionScope(const ProcessObject * filter);
+    ~ExecutionScope();
+
+  private:
+    SmartPointer<PipelineProfiler>             m_Profiler;
+    std::shared_ptr<PipelineProfilerExecution> m_Execution;
+    PipelineProfilerExecution *                m_PreviousExecution{ nullptr };
+    bool                                       m_PreviousInWorkChunk{ false };
+  };
+
+  /** Records a work chunk of an execution on the current thread, from its
+   * construction to its destruction. Does nothing when the execution is
+   * nullptr, or when the thread is already in a work chunk of the execution.
+   * Used by the multithreaders. */
+  class ITKCommon_EXPORT WorkChunkScope
+  {
+  public:
+    ITK_DISALLOW_COPY_AND_MOVE(WorkChunkScope);
+
+    explicit WorkChunkScope(PipelineProfilerExecution * execution);
+    ~WorkChunkScope();
+
+  private:
+    PipelineProfilerExecution *           m_Execution;
+    PipelineProfilerExecution *           m_PreviousExecution{ nullptr };
+    bool                                  m_PreviousInWorkChunk{ false };
+    std::chrono::steady_clock::time_point m_StartTime;
+  };
+
+  /** The execution of the current thread, to be passed to the work chunks the
+   * thread starts. nullptr when no execution is recorded. */
+  static PipelineProfilerExecution *
+  GetCurrentExecution();
+
+  /** Add to the bytes allocated by the execution of the current thread. The
+   * allocation observer of ImportImageContainerCommon while a profiler is
+   * active. */
+  static void
+  RecordAllocation(SizeValueType numberOfBytes);
+
+  /** Add to the streaming pieces of the execution of the current thread. Used
+   * by the streaming filters. */
+  static void
+  RecordStreamingPieces(SizeValueType numberOfPieces);
+
+protected:
+  PipelineProfiler() = default;
+  ~PipelineProfiler() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  std::shared_ptr<PipelineProfilerExecution>
+  BeginExecution(const ProcessObject * filter, PipelineProfilerExecution * parent);
+
+  void
+  EndExecution(PipelineProfilerExecution & execution);
+
+  void
+  EndWorkChunk(PipelineProfilerExecution &           execution,
+               std::chrono::steady_clock::time_point startTime,
+               std::chrono::steady_clock::time_point endTime);
+
+  ThreadIdType
+  GetThreadIndex(std::thread::id threadId); // to be called with m_Mutex locked
+
+  mutable std::mutex m_Mutex;
+
+  std::chrono::steady_clock::time_point m_ClockOrigin{ std::chrono::steady_clock::now() }; // guarded by m_Mutex
+
+  /** The recorded executions, in the order in which they started. */
+  std::vector<std::shared_ptr<PipelineProfilerExecution>> m_Executions; // guarded by m_Mutex
+
+  /** The filters are numbered in the order in which they first ran. A filter
+   * created at the address of a deleted one shares its number. */
+  std::map<const ProcessObject *, SizeValueType> m_FilterIndices;                  // guarded by m_Mutex
+  std::map<std::thread::id, ThreadIdType>        m_ThreadIndices;                  // guarded by m_Mutex
+  SizeValueType                                  m_NumberOfDroppedExecutions{ 0 }; // guarded by m_Mutex
+
+  SizeValueType m_MaximumNumberOfExecutions{ 1000000 };
+};
+} // end namespace itk
+
+#endif
@@ -114,6 +114,13 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Determine the number of pieces in which the output region is
+   * streamed. This is the minimum of what the user specified via
+   * SetNumberOfStreamDivisions() and what the splitter thinks is a
+   * reasonable value. */
+  virtual unsigned int
+  ComputeNumberOfStreamDivisions(const OutputImageRegionType & outputRegion);
+
 private:
   unsigned int          m_NumberOfStreamDivisions{};
   RegionSplitterPointer m_RegionSplitter{};
@@ -20,6 +20,7 @@
 #include "itkCommand.h"
 #include "itkImageAlgorithm.h"
 #include "itkImageRegionSplitterSlowDimension.h"
+#include "itkPipelineProfiler.h"
 
 namespace itk
 {
@@ -90,6 +91,21 @@ StreamingImageFilter<TInputImage, TOutputImage>::PropagateRequestedRegion(DataOb
   // because the pipeline managed later
 }
 
+template <typename TInputImage, typename TOutputImage>
+unsigned int
+StreamingImageFilter<TInputImage, TOutputImage>::ComputeNumberOfStreamDivisions(
+  const OutputImageRegionType & outputRegion)
+{
+  unsigned int       numDivisions = m_NumberOfStreamDivisions;
+  const unsigned int numDivisionsFromSplitter =
+    m_RegionSplitter->GetNumberOfSplits(outputRegion, m_NumberOfStreamDivisions);
+  if (numDivisionsFromSplitter < numDivisions)
+  {
+    numDivisions = numDivisionsFromSplitter;
+  }
+  return numDivisions;
+}
+
 /**
  *
  */
@@ -133,54 +149,51 @@ StreamingImageFilter<TInputImage, TOutputImage>::UpdateOutputData(DataObject * i
   this->m_Updating = true;
 
 
-  /**
-   * Allocate the output buffer.
-   */
-  OutputImageType *           outputPtr = this->GetOutput(0);
-  const OutputImageRegionType outputRegion = outputPtr->GetRequestedRegion();
-  outputPtr->SetBufferedRegion(outputRegion);
-  outputPtr->Allocate();
-
-  /**
-   * Grab the input
-   */
-  auto * inputPtr = const_cast<InputImageType *>(this->GetInput(0));
-
-  /**
-   * Determine of number of pieces to divide the input.  This will be the
-   * minimum of what the user specified via SetNumberOfStreamDivisions()
-   * and what the Splitter thinks is a reasonable value.
-   */
-  unsigned int       numDivisions = m_NumberOfStreamDivisions;
-  const unsigned int numDivisionsFromSplitter =
-    m_RegionSplitter->GetNumberOfSplits(outputRegion, m_NumberOfStreamDivisions);
-  if (numDivisionsFromSplitter < numDivisions)
   {
-    numDivisions = numDivisionsFromSplitter;
-  }
-
-  /**
-   * Loop over the number of pieces, execute the upstream pipeline on each
-   * piece, and copy the results into the output image.
-   */
-  unsigned int piece = 0;
-  for (; piece < numDivisions && !this->GetAbortGenerateData(); ++piece)
-  {
-    InputImageRegionType streamRegion = outputRegion;
-    m_RegionSplitter->GetSplit(piece, numDivisions, streamRegion);
+    const PipelineProfiler::ExecutionScope profilerScope(this);
+
+    /**
+     * Allocate the output buffer.
+     */
+    OutputImageType *           outputPtr = this->GetOutput(0);
+    const OutputImageRegionType outputRegion = outputPtr->GetRequestedRegion();
+    outputPtr->SetBufferedRegion(outputRegion);
+    outputPtr->Allocate();
+
+    /**
+     * Grab the input
+     */
+    auto * inputPtr = const_cast<InputImageType *>(this->GetInput(0));
+
+    /**
+     * Determine of number of pieces to divide the input.
+     */
+    const unsigned int numDivisions = this->ComputeNumberOfStreamDivisions(outputRegion);
+    PipelineProfiler::RecordStreamingPieces(numDivisions);
+
+    /**
+     * Loop over the number of pieces, execute the upstream pipeline on each
+     * piece, and copy the results into the output image.
+     */
+    unsigned int piece = 0;
+    for (; piece < numDivisions && !this->GetAbortGenerateData(); ++piece)
+    {
+      InputImageRegionType streamRegion = outputRegion;
+      m_RegionSplitter->GetSplit(piece, numDivisions, streamRegion);
 
-    inputPtr->SetRequestedRegion(streamRegion);
-    inputPtr->PropagateRequestedRegion();
-    inputPtr->UpdateOutputData();
+      inputPtr->SetRequestedRegion(streamRegion);
+      inputPtr->PropagateRequestedRegion();
+      inputPtr->UpdateOutputData();
 
-    // copy the result to the proper place in the output. the input
-    // requested region determined by the RegionSplitter (as opposed
-    // to what the pipeline might have enlarged it to) is used to
-    // copy the regions from the input to output
-    ImageAlgorithm::Copy(inputPtr, outputPtr, streamRegion, streamRegion);
+      // copy the result to the proper place in the output. the input
+      // requested region determined by the RegionSplitter (as opposed
+      // to what the pipeline might have enlarged it to) is used to
+      // copy the regions from the input to output
+      ImageAlgorithm::Copy(inputPtr, outputPtr, streamRegion, streamRegion);
 
 
-    this->UpdateProgress(static_cast<float>(piece) / static_cast<float>(numDivisions));
+      this->UpdateProgress(static_cast<float>(piece) / static_cast<float>(numDivisions));
+    }
   }
 
   /**
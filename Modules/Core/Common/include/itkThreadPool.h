@@ -21,10 +21,12 @@
 #include "itkConfigure.h"
 #include "itkIntTypes.h"
 
+#include <atomic>
 #include <deque>
 #include <functional>
 #include <future>
 #include <condition_variable>
+#include <memory>
 #include <thread>
 
 #include "itkObject.h"
@@ -43,7 +45,19 @@ namespace itk
  * Initially the thread pool is started with GlobalDefaultNumberOfThreads.
  * The jobs are submitted via AddWork method.
  *
- * This implementation heavily borrows from:
+ * Each thread of the pool owns a work queue. Jobs submitted from outside
+ * the pool are distributed over these queues in a round-robin fashion,
+ * while jobs submitted from within a pool thread (nested parallelism) are
+ * pushed onto the queue of that thread. A thread takes its work from the
+ * back of its own queue, and steals from the front of the queues of the
+ * other threads when its own queue is empty. A pool thread which waits for
+ * nested work can call ExecuteLocalTask() to make progress instead of
+ * blocking, so nested parallel sections neither deadlock nor oversubscribe.
+ * Each job is tagged with the job which submitted it, so that a waiting
+ * thread only runs the nested work of the job it is executing, never an
+ * unrelated job which happens to be in its queue.
+ *
+ * This implementation initially borrowed from:
  * https://github.com/progschj/ThreadPool
  *
  * \ingroup OSSystemObjects
@@ -92,14 +106,22 @@ auto result = pool->AddWork([](int param) { return param; }, 7);
       [function, arguments...]() -> return_type { return function(arguments...); });
 
     std::future<return_type> res = task->get_future();
-    {
-      const std::lock_guard<std::mutex> lockGuard(this->GetMutex());
-      m_WorkQueue.emplace_back([task]() { (*task)(); });
-    }
-    m_Condition.notify_one();
+    this->SubmitTask([task]() { (*task)(); });
     return res;
   }
 
+  /** Execute one job from the queue of the calling thread which was
+   * submitted by the job that the calling thread is executing, if the
+   * calling thread belongs to this pool and there is such a job. Returns
+   * whether a job was executed. This allows a pool thread waiting for the
+   * completion of nested work to process that work itself. */
+  bool
+  ExecuteLocalTask();
+
+  /** Returns whether the calling thread is one of the threads of the pool. */
+  static bool
+  IsCurrentThreadInPool();
+
   /** Can call this method if we want to add extra threads to the pool. */
   void
   AddThreads(ThreadIdType count);
@@ -111,6 +133,17 @@ auto result = pool->AddWork([](int param) { return param; }, 7);
     return static_cast<ThreadIdType>(m_Threads.size());
   }
 
+  /** Set/Get whether each thread of the pool is bound to one processor. The
+   * processors available to the process are assigned to the threads in a
+   * round-robin fashion. Together with ImportImageContainer::SetParallelFirstTouch,
+   * this keeps the memory which a thread touched first local to it on NUMA
+   * systems. Off by default. Only implemented on Linux, this setting has no
+   * effect on other systems. */
+  void
+  SetUseThreadAffinity(bool useThreadAffinity);
+  bool
+  GetUseThreadAffinity() const;
+
   /** The approximate number of idle threads. */
   int
   GetNumberOfCurrentlyIdleThreads() const;
@@ -130,6 +163,10 @@ protected:
   std::mutex &
   GetMutex() const;
 
+  /** Push the job onto a work queue and wake up an idle thread if needed. */
+  void
+  SubmitTask(std::function<void()> && task);
+
   ThreadPool();
 
   /** Stop the pool and release threads. To be called by the destructor and atfork. */
@@ -147,13 +184,55 @@ private:
   /** Only used to synchronize the global variable across static libraries.*/
   itkGetGlobalDeclarationMacro(ThreadPoolGlobals, PimplGlobals);
 
-  /** This is a list of jobs submitted to the thread pool.
-   * This is the only place where the jobs are submitted.
-   * Filled by AddWork, emptied by ThreadExecute. */
-  std::deque<std::function<void()>> m_WorkQueue; // guarded by m_PimplGlobals->m_Mutex
+  /** A job, with the identifier of the job which submitted it (zero when
+   * it was submitted from outside the pool). */
+  struct Task
+  {
+    std::function<void()> m_Function;
+    SizeValueType         m_Id{ 0 };
+    SizeValueType         m_ParentId{ 0 };
+  };
+
+  /** The list of jobs of one thread of the pool, with its own lock. */
+  struct WorkQueue
+  {
+    std::mutex       m_Mutex;
+    std::deque<Task> m_Jobs; // guarded by m_Mutex
+  };
+
+  /** Take a job from the back of the queue of the given thread or, if that
+   * one is empty, steal one from the front of the queue of another thread.
+   * Returns false if no job was available, or if the queues which had jobs
+   * were locked by other threads. */
+  bool
+  PopTask(ThreadIdType workerIndex, Task & task);
+
+  /** Run the job on the calling thread, as the current job of that thread. */
+  static void
+  RunTask(Task & task);
+
+  /** One work queue per possible thread (ITK_MAX_THREADS of them), so that
+   * the queues never move while threads are running.
+   * Filled by SubmitTask, emptied by PopTask. */
+  std::unique_ptr<WorkQueue[]> m_WorkQueues;
+
+  /** Number of queues in use, equal to the number of threads. */
+  std::atomic<ThreadIdType> m_NumberOfWorkQueues{ 0 };
+
+  /** Total number of jobs over all the queues. */
+  std::atomic<SizeValueType> m_NumberOfPendingTasks{ 0 };
+
+  /** Number of threads waiting on m_Condition. */
+  std::atomic<ThreadIdType> m_NumberOfSleepingThreads{ 0 };
+
+  /** Round-robin queue selection for jobs submitted from outside the pool. */
+  std::atomic<ThreadIdType> m_NextWorkQueue{ 0 };
+
+  /** Source of the job identifiers. */
+  std::atomic<SizeValueType> m_NextTaskId{ 1 };
 
   /** When a thread is idle, it is waiting on m_Condition.
-   * AddWork signals it to resume a (random) thread. */
+   * SubmitTask signals it to resume a (random) thread. */
   std::condition_variable m_Condition;
 
   /** Vector to hold all thread handles.
@@ -163,12 +242,15 @@ private:
   /* Has destruction started? */
   bool m_Stopping{ false }; // guarded by m_PimplGlobals->m_Mutex
 
+  /** Are the threads bound to processors? */
+  bool m_UseThreadAffinity{ false }; // guarded by m_PimplGlobals->m_Mutex
+
   /** To lock on the internal variables */
   static ThreadPoolGlobals * m_PimplGlobals;
 
   /** The continuously running thread function */
   static void
-  ThreadExecute();
+  ThreadExecute(ThreadIdType workerIndex);
 };
 
 } // namespace itk
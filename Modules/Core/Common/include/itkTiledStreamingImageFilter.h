@@ -0,0 +1,114 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTiledStreamingImageFilter_h
+#define itkTiledStreamingImageFilter_h
+
+#include "itkStreamingImageFilter.h"
+
+namespace itk
+{
+/** \class TiledStreamingImageFilter
+ * \brief Executes the upstream pipeline tile by tile, with cache-sized tiles.
+ *
+ * TiledStreamingImageFilter is a StreamingImageFilter which chooses the
+ * number of pieces from a memory budget instead of from a fixed number of
+ * divisions, and which splits the output into compact tiles instead of
+ * slabs. For each tile, the requested region is propagated upstream, and
+ * each filter of the chain enlarges it with the padding it needs in
+ * GenerateInputRequestedRegion(). Then the whole chain executes on that
+ * tile before the next one is requested, so the intermediate images of the
+ * chain only hold one tile, and stay in cache when the tiles are small
+ * enough.
+ *
+ * The size of the tiles is computed so that the pixels of one tile, in the
+ * output and in each image of the upstream pipeline, fit in TileSizeInBytes.
+ * The images of the upstream pipeline are assumed to have pixels of the
+ * size of the output pixels. The default budget is 512 KiB per thread, a
+ * typical size of a L2 cache. Larger tiles reduce the redundant computation
+ * of the padding of the neighborhood filters of the chain.
+ *
+ * To also reuse the buffers of the intermediate images from one tile to the
+ * next, set an ImageBufferPool with
+ * ImportImageContainerCommon::SetGlobalDefaultBufferPool() before the
+ * pipeline is created.
+ *
+ * \sa StreamingImageFilter
+ * \sa ImageRegionSplitterMultidimensional
+ *
+ * \ingroup ITKSystemObjects
+ * \ingroup DataProcessing
+ * \ingroup ITKCommon
+ */
+template <typename TInputImage, typename TOutputImage = TInputImage>
+class ITK_TEMPLATE_EXPORT TiledStreamingImageFilter : public StreamingImageFilter<TInputImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(TiledStreamingImageFilter);
+
+  /** Standard class type aliases. */
+  using Self = TiledStreamingImageFilter;
+  using Superclass = StreamingImageFilter<TInputImage, TOutputImage>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(TiledStreamingImageFilter);
+
+  using typename Superclass::OutputImageType;
+  using typename Superclass::OutputImageRegionType;
+  using typename Superclass::SplitterType;
+
+  /** The default budget of one tile, per thread. */
+  static constexpr SizeValueType DefaultTileSizeInBytesPerThread = 512 * 1024;
+
+  /** Set/Get the memory budget of one tile, for the output and all the
+   * images of the upstream pipeline. Zero, the default, stands for
+   * DefaultTileSizeInBytesPerThread times the global default number of
+   * threads. The number of tiles is at least NumberOfStreamDivisions,
+   * which is one by default. */
+  itkSetMacro(TileSizeInBytes, SizeValueType);
+  itkGetConstMacro(TileSizeInBytes, SizeValueType);
+
+  /** The number of images of the upstream pipeline, found the last time the
+   * number of tiles was computed. */
+  itkGetConstMacro(NumberOfUpstreamImages, SizeValueType);
+
+protected:
+  TiledStreamingImageFilter();
+  ~TiledStreamingImageFilter() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  unsigned int
+  ComputeNumberOfStreamDivisions(const OutputImageRegionType & outputRegion) override;
+
+private:
+  SizeValueType m_TileSizeInBytes{ 0 };
+  SizeValueType m_NumberOfUpstreamImages{ 0 };
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTiledStreamingImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,103 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTiledStreamingImageFilter_hxx
+#define itkTiledStreamingImageFilter_hxx
+
+#include "itkImageRegionSplitterMultidimensional.h"
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <vector>
+
+namespace itk
+{
+template <typename TInputImage, typename TOutputImage>
+TiledStreamingImageFilter<TInputImage, TOutputImage>::TiledStreamingImageFilter()
+{
+  this->SetNumberOfStreamDivisions(1);
+  this->SetRegionSplitter(ImageRegionSplitterMultidimensional::New());
+}
+
+template <typename TInputImage, typename TOutputImage>
+unsigned int
+TiledStreamingImageFilter<TInputImage, TOutputImage>::ComputeNumberOfStreamDivisions(
+  const OutputImageRegionType & outputRegion)
+{
+  // Count the images of the upstream pipeline, each of which holds one tile.
+  std::set<const DataObject *> visited;
+  std::vector<ProcessObject *> sources{ this };
+  while (!sources.empty())
+  {
+    ProcessObject * const source = sources.back();
+    sources.pop_back();
+    for (const auto & input : source->GetInputs())
+    {
+      if (dynamic_cast<const ImageBase<OutputImageType::ImageDimension> *>(input.GetPointer()) &&
+          visited.insert(input).second && input->GetSource())
+      {
+        sources.push_back(input->GetSource());
+      }
+    }
+  }
+  m_NumberOfUpstreamImages = visited.size();
+
+  const OutputImageType * const output = this->GetOutput();
+  const SizeValueType           bytesPerPixel = sizeof(typename OutputImageType::InternalPixelType) *
+                                      output->GetNumberOfComponentsPerPixel() * (m_NumberOfUpstreamImages + 1);
+  const SizeValueType tileSizeInBytes =
+    (m_TileSizeInBytes > 0)
+      ? m_TileSizeInBytes
+      : DefaultTileSizeInBytesPerThread * MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  const SizeValueType pixelsPerTile = std::max<SizeValueType>(tileSizeInBytes / bytesPerPixel, 1);
+
+  const SizeValueType numberOfTiles = (outputRegion.GetNumberOfPixels() + pixelsPerTile - 1) / pixelsPerTile;
+  const auto          requestedDivisions = static_cast<unsigned int>(std::max<SizeValueType>(
+    std::min<SizeValueType>(numberOfTiles, std::numeric_limits<unsigned int>::max()),
+    this->GetNumberOfStreamDivisions()));
+
+  // The splitter may only support fewer pieces than requested, such as the
+  // products of the numbers of splits along each dimension. Ask for more
+  // until the tiles fit the budget, or the splitter cannot split further.
+  const SplitterType * const splitter = this->GetRegionSplitter();
+  const SizeValueType        maximumDivisions =
+    std::min<SizeValueType>(SizeValueType{ requestedDivisions } << OutputImageType::ImageDimension,
+                            std::numeric_limits<unsigned int>::max());
+  unsigned int divisions = requestedDivisions;
+  unsigned int numberOfSplits = splitter->GetNumberOfSplits(outputRegion, divisions);
+  while (numberOfSplits < requestedDivisions && divisions < maximumDivisions)
+  {
+    ++divisions;
+    numberOfSplits = splitter->GetNumberOfSplits(outputRegion, divisions);
+  }
+  return numberOfSplits;
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+TiledStreamingImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "TileSizeInBytes: " << m_TileSizeInBytes << std::endl;
+  os << indent << "NumberOfUpstreamImages: " << m_NumberOfUpstreamImages << std::endl;
+}
+} // end namespace itk
+
+#endif
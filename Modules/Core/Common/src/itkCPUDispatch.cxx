@@ -0,0 +1,244 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkCPUDispatch.h"
+#include "itkObject.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace itk
+{
+namespace
+{
+using InstructionSetEnum = CPUDispatchEnums::InstructionSet;
+
+InstructionSetEnum
+DetectHostInstructionSet()
+{
+#ifdef ITK_CPU_DISPATCH_HAS_TARGETS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl") &&
+      __builtin_cpu_supports("avx512dq"))
+  {
+    return InstructionSetEnum::AVX512;
+  }
+  if (__builtin_cpu_supports("avx2"))
+  {
+    return InstructionSetEnum::AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.1"))
+  {
+    return InstructionSetEnum::SSE41;
+  }
+#endif
+  return InstructionSetEnum::Generic;
+}
+
+InstructionSetEnum
+GetInitialMaximumInstructionSet()
+{
+  std::string envVar;
+  if (itksys::SystemTools::GetEnv("ITK_MAXIMUM_INSTRUCTION_SET", envVar))
+  {
+    try
+    {
+      return CPUDispatch::InstructionSetFromString(envVar);
+    }
+    catch (const ExceptionObject &)
+    {
+      itkGenericOutputMacro("Warning: ignoring the unknown instruction set " << envVar
+                                                                             << " of ITK_MAXIMUM_INSTRUCTION_SET.");
+    }
+  }
+  return InstructionSetEnum::AVX512;
+}
+
+struct CPUDispatchGlobals
+{
+  const InstructionSetEnum        hostInstructionSet{ DetectHostInstructionSet() };
+  std::atomic<InstructionSetEnum> maximumInstructionSet{ GetInitialMaximumInstructionSet() };
+  std::atomic<InstructionSetEnum> instructionSet{ std::min(hostInstructionSet, maximumInstructionSet.load()) };
+
+  std::mutex                                             registryMutex;
+  std::map<std::string, std::vector<InstructionSetEnum>> registry; // guarded by registryMutex
+};
+
+CPUDispatchGlobals &
+GetCPUDispatchGlobals()
+{
+  // Constructed on first use, as kernels register from static initializers.
+  static CPUDispatchGlobals globals;
+  return globals;
+}
+} // namespace
+
+auto
+CPUDispatch::GetHostInstructionSet() -> InstructionSetEnum
+{
+  return GetCPUDispatchGlobals().hostInstructionSet;
+}
+
+void
+CPUDispatch::SetMaximumInstructionSet(InstructionSetEnum instructionSet)
+{
+  CPUDispatchGlobals & globals = GetCPUDispatchGlobals();
+  globals.maximumInstructionSet = instructionSet;
+  globals.instructionSet = std::min(globals.hostInstructionSet, instructionSet);
+}
+
+auto
+CPUDispatch::GetMaximumInstructionSet() -> InstructionSetEnum
+{
+  return GetCPUDispatchGlobals().maximumInstructionSet;
+}
+
+auto
+CPUDispatch::GetInstructionSet() -> InstructionSetEnum
+{
+  return GetCPUDispatchGlobals().instructionSet.load(std::memory_order_relaxed);
+}
+
+std::string
+CPUDispatch::InstructionSetToString(InstructionSetEnum instructionSet)
+{
+  switch (instructionSet)
+  {
+    case InstructionSetEnum::Generic:
+      return "GENERIC";
+    case InstructionSetEnum::SSE41:
+      return "SSE41";
+    case InstructionSetEnum::AVX2:
+      return "AVX2";
+    case InstructionSetEnum::AVX512:
+      return "AVX512";
+  }
+  return "UNKNOWN";
+}
+
+auto
+CPUDispatch::InstructionSetFromString(std::string instructionSetString) -> InstructionSetEnum
+{
+  instructionSetString = itksys::SystemTools::UpperCase(instructionSetString);
+  for (const auto instructionSet :
+       { InstructionSetEnum::Generic, InstructionSetEnum::SSE41, InstructionSetEnum::AVX2, InstructionSetEnum::AVX512 })
+  {
+    if (instructionSetString == InstructionSetToString(instructionSet))
+    {
+      return instructionSet;
+    }
+  }
+  itkGenericExceptionMacro("Unknown instruction set: " << instructionSetString);
+}
+
+void
+CPUDispatch::RegisterKernel(const std::string & name, const std::vector<InstructionSetEnum> & variants)
+{
+  CPUDispatchGlobals &              globals = GetCPUDispatchGlobals();
+  const std::lock_guard<std::mutex> lockGuard(globals.registryMutex);
+  globals.registry[name] = variants;
+}
+
+std::vector<std::string>
+CPUDispatch::GetRegisteredKernelNames()
+{
+  CPUDispatchGlobals &              globals = GetCPUDispatchGlobals();
+  const std::lock_guard<std::mutex> lockGuard(globals.registryMutex);
+  std::vector<std::string>          names;
+  names.reserve(globals.registry.size());
+  for (const auto & kernel : globals.registry)
+  {
+    names.push_back(kernel.first);
+  }
+  return names;
+}
+
+auto
+CPUDispatch::GetKernelVariants(const std::string & name) -> std::vector<InstructionSetEnum>
+{
+  CPUDispatchGlobals &              globals = GetCPUDispatchGlobals();
+  const std::lock_guard<std::mutex> lockGuard(globals.registryMutex);
+  const auto                        it = globals.registry.find(name);
+  if (it == globals.registry.end())
+  {
+    itkGenericExceptionMacro("Unknown kernel: " << name);
+  }
+  return it->second;
+}
+
+auto
+CPUDispatch::GetSelectedKernelVariant(const std::string & name) -> InstructionSetEnum
+{
+  return SelectVariant(GetKernelVariants(name));
+}
+
+auto
+CPUDispatch::SelectVariant(const std::vector<InstructionSetEnum> & available) -> InstructionSetEnum
+{
+  const InstructionSetEnum instructionSet = GetInstructionSet();
+  InstructionSetEnum       selected = InstructionSetEnum::Generic;
+  for (const InstructionSetEnum variant : available)
+  {
+    if (variant <= instructionSet && variant > selected)
+    {
+      selected = variant;
+    }
+  }
+  return selected;
+}
+
+void
+CPUDispatch::Print(std::ostream & os)
+{
+  os << "Host instruction set: " << InstructionSetToString(GetHostInstructionSet()) << std::endl;
+  os << "Maximum instruction set: " << InstructionSetToString(GetMaximumInstructionSet()) << std::endl;
+  os << "Instruction set: " << InstructionSetToString(GetInstructionSet()) << std::endl;
+  for (const std::string & name : GetRegisteredKernelNames())
+  {
+    os << "  " << name << ": " << InstructionSetToString(GetSelectedKernelVariant(name)) << " (available:";
+    for (const InstructionSetEnum variant : GetKernelVariants(name))
+    {
+      os << ' ' << InstructionSetToString(variant);
+    }
+    os << ')' << std::endl;
+  }
+}
+
+/** Print enum values */
+std::ostream &
+operator<<(std::ostream & out, const CPUDispatchEnums::InstructionSet value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case CPUDispatchEnums::InstructionSet::Generic:
+        return "itk::CPUDispatchEnums::InstructionSet::Generic";
+      case CPUDispatchEnums::InstructionSet::SSE41:
+        return "itk::CPUDispatchEnums::InstructionSet::SSE41";
+      case CPUDispatchEnums::InstructionSet::AVX2:
+        return "itk::CPUDispatchEnums::InstructionSet::AVX2";
+      case CPUDispatchEnums::InstructionSet::AVX512:
+        return "itk::CPUDispatchEnums::InstructionSet::AVX512";
+      default:
+        return "INVALID VALUE FOR itk::CPUDispatchEnums::InstructionSet";
+    }
+  }();
+}
+} // end namespace itk
@@ -0,0 +1,196 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageBufferPool.h"
+
+#include <algorithm>
+#include <iterator>
+#include <new>
+
+namespace itk
+{
+
+ImageBufferPool::~ImageBufferPool()
+{
+  this->ShrinkTo(0);
+}
+
+SizeValueType
+ImageBufferPool::GetBucketSize(SizeValueType numberOfBytes)
+{
+  constexpr SizeValueType minimumStep = 64;
+  if (numberOfBytes <= 8 * minimumStep)
+  {
+    return std::max<SizeValueType>((numberOfBytes + minimumStep - 1) / minimumStep * minimumStep, minimumStep);
+  }
+  // Round up to a multiple of an eighth of the highest power of two, which
+  // wastes at most 12.5% of the block.
+  SizeValueType highestPowerOfTwo = 1;
+  while (highestPowerOfTwo <= numberOfBytes / 2)
+  {
+    highestPowerOfTwo *= 2;
+  }
+  const SizeValueType step = highestPowerOfTwo / 8;
+  return (numberOfBytes + step - 1) / step * step;
+}
+
+void *
+ImageBufferPool::Acquire(SizeValueType numberOfBytes)
+{
+  const SizeValueType bucketSize = GetBucketSize(numberOfBytes);
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+    const auto                        bucket = m_HeldBlocks.find(bucketSize);
+    if (bucket != m_HeldBlocks.end() && !bucket->second.empty())
+    {
+      void * const block = bucket->second.back();
+      bucket->second.pop_back();
+      m_NumberOfBytesHeld -= bucketSize;
+      ++m_NumberOfHits;
+      return block;
+    }
+    ++m_NumberOfMisses;
+  }
+
+  void * block = ::operator new(bucketSize, std::align_val_t{ BlockAlignment }, std::nothrow);
+  if (block == nullptr)
+  {
+    // The held blocks of other sizes may be what prevents the allocation.
+    this->Clear();
+    block = ::operator new(bucketSize, std::align_val_t{ BlockAlignment }, std::nothrow);
+  }
+  if (block == nullptr)
+  {
+    // We cannot construct an error string here because we may be out
+    // of memory.  Do not use the exception macro.
+    throw MemoryAllocationError(__FILE__, __LINE__, "Failed to allocate memory for image.", ITK_LOCATION);
+  }
+  return block;
+}
+
+void
+ImageBufferPool::Release(void * block, SizeValueType numberOfBytes)
+{
+  if (block == nullptr)
+  {
+    return;
+  }
+  const SizeValueType bucketSize = GetBucketSize(numberOfBytes);
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+    if (m_NumberOfBytesHeld + bucketSize <= m_MaximumNumberOfBytesHeld)
+    {
+      m_HeldBlocks[bucketSize].push_back(block);
+      m_NumberOfBytesHeld += bucketSize;
+      return;
+    }
+  }
+  ::operator delete(block, std::align_val_t{ BlockAlignment });
+}
+
+void
+ImageBufferPool::Clear()
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  this->ShrinkTo(0);
+}
+
+void
+ImageBufferPool::ShrinkTo(SizeValueType numberOfBytes)
+{
+  while (m_NumberOfBytesHeld > numberOfBytes && !m_HeldBlocks.empty())
+  {
+    const auto            largest = std::prev(m_HeldBlocks.end());
+    std::vector<void *> & blocks = largest->second;
+    while (!blocks.empty() && m_NumberOfBytesHeld > numberOfBytes)
+    {
+      ::operator delete(blocks.back(), std::align_val_t{ BlockAlignment });
+      blocks.pop_back();
+      m_NumberOfBytesHeld -= largest->first;
+    }
+    if (blocks.empty())
+    {
+      m_HeldBlocks.erase(largest);
+    }
+  }
+}
+
+void
+ImageBufferPool::SetMaximumNumberOfBytesHeld(SizeValueType numberOfBytes)
+{
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+    if (m_MaximumNumberOfBytesHeld == numberOfBytes)
+    {
+      return;
+    }
+    m_MaximumNumberOfBytesHeld = numberOfBytes;
+    this->ShrinkTo(numberOfBytes);
+  }
+  this->Modified();
+}
+
+SizeValueType
+ImageBufferPool::GetMaximumNumberOfBytesHeld() const
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  return m_MaximumNumberOfBytesHeld;
+}
+
+SizeValueType
+ImageBufferPool::GetNumberOfHits() const
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  return m_NumberOfHits;
+}
+
+SizeValueType
+ImageBufferPool::GetNumberOfMisses() const
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  return m_NumberOfMisses;
+}
+
+SizeValueType
+ImageBufferPool::GetNumberOfBytesHeld() const
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  return m_NumberOfBytesHeld;
+}
+
+void
+ImageBufferPool::ResetStatistics()
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  m_NumberOfHits = 0;
+  m_NumberOfMisses = 0;
+}
+
+void
+ImageBufferPool::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  os << indent << "MaximumNumberOfBytesHeld: " << m_MaximumNumberOfBytesHeld << std::endl;
+  os << indent << "NumberOfBytesHeld: " << m_NumberOfBytesHeld << std::endl;
+  os << indent << "NumberOfHits: " << m_NumberOfHits << std::endl;
+  os << indent << "NumberOfMisses: " << m_NumberOfMisses << std::endl;
+}
+
+} // namespace itk
@@ -0,0 +1,239 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImportImageContainerCommon.h"
+#include "itkImageBufferPool.h"
+#include "itkPoolMultiThreader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#endif
+
+namespace itk
+{
+
+namespace
+{
+std::atomic<ImportImageContainerCommon::AllocationPolicyEnum> globalDefaultAllocationPolicy{
+  ImportImageContainerCommon::AllocationPolicyEnum::Default
+};
+std::atomic<bool>        globalDefaultParallelFirstTouch{ false };
+ImageBufferPool::Pointer globalDefaultBufferPool;
+std::mutex               globalDefaultBufferPoolMutex;
+
+std::atomic<ImportImageContainerCommon::AllocationObserverType> allocationObserver{ nullptr };
+
+// Smallest page size of the supported platforms. Writing once per 4 KiB
+// touches every page when the actual pages are larger.
+constexpr SizeValueType pageSize = 4096;
+
+// Below this size, the cost of starting the threads exceeds the gain.
+constexpr SizeValueType minimumParallelFirstTouchSize = 1024 * 1024;
+
+void
+TouchPages(char * buffer, SizeValueType begin, SizeValueType end, bool zeroFill)
+{
+  if (zeroFill)
+  {
+    std::memset(buffer + begin, 0, end - begin);
+  }
+  else
+  {
+    for (SizeValueType offset = begin; offset < end; offset += pageSize)
+    {
+      buffer[offset] = 0;
+    }
+  }
+}
+// The number of bytes actually allocated: huge-page buffers are extended to
+// a whole number of huge pages, so that no other allocation shares them.
+SizeValueType
+GetAllocatedSize(SizeValueType numberOfBytes, SizeValueType alignment)
+{
+  if (alignment == ImportImageContainerCommon::HugePageSize)
+  {
+    return (numberOfBytes + alignment - 1) / alignment * alignment;
+  }
+  return numberOfBytes;
+}
+} // namespace
+
+void
+ImportImageContainerCommon::SetGlobalDefaultAllocationPolicy(AllocationPolicyEnum allocationPolicy)
+{
+  globalDefaultAllocationPolicy = allocationPolicy;
+}
+
+auto
+ImportImageContainerCommon::GetGlobalDefaultAllocationPolicy() -> AllocationPolicyEnum
+{
+  return globalDefaultAllocationPolicy;
+}
+
+void
+ImportImageContainerCommon::SetGlobalDefaultParallelFirstTouch(bool parallelFirstTouch)
+{
+  globalDefaultParallelFirstTouch = parallelFirstTouch;
+}
+
+bool
+ImportImageContainerCommon::GetGlobalDefaultParallelFirstTouch()
+{
+  return globalDefaultParallelFirstTouch;
+}
+
+void
+ImportImageContainerCommon::SetGlobalDefaultBufferPool(ImageBufferPool * bufferPool)
+{
+  const std::lock_guard<std::mutex> lockGuard(globalDefaultBufferPoolMutex);
+  globalDefaultBufferPool = bufferPool;
+}
+
+ImageBufferPool::Pointer
+ImportImageContainerCommon::GetGlobalDefaultBufferPool()
+{
+  const std::lock_guard<std::mutex> lockGuard(globalDefaultBufferPoolMutex);
+  return globalDefaultBufferPool;
+}
+
+void
+ImportImageContainerCommon::SetAllocationObserver(AllocationObserverType observer)
+{
+  allocationObserver.store(observer, std::memory_order_release);
+}
+
+auto
+ImportImageContainerCommon::GetAllocationObserver() -> AllocationObserverType
+{
+  return allocationObserver.load(std::memory_order_acquire);
+}
+
+void
+ImportImageContainerCommon::ParallelFirstTouch(void * buffer, SizeValueType numberOfBytes, bool zeroFill)
+{
+  auto * const bytes = static_cast<char *>(buffer);
+  if (numberOfBytes < minimumParallelFirstTouchSize)
+  {
+    TouchPages(bytes, 0, numberOfBytes, zeroFill);
+    return;
+  }
+
+  // Split the buffer at page boundaries, as a one-dimensional region of pages.
+  const IndexValueType index[1] = { 0 };
+  const SizeValueType  size[1] = { (numberOfBytes + pageSize - 1) / pageSize };
+
+  // The pages are touched by the threads of the pool, which are the ones
+  // bound to processors by ThreadPool::SetUseThreadAffinity, whatever the
+  // global default multi-threader is. One piece per thread.
+  const PoolMultiThreader::Pointer multiThreader = PoolMultiThreader::New();
+  multiThreader->SetWorkScheduling(MultiThreaderBase::WorkSchedulingEnum::Static);
+  multiThreader->SetNumberOfWorkUnits(multiThreader->GetMaximumNumberOfThreads());
+  multiThreader->ParallelizeImageRegion(
+    1,
+    index,
+    size,
+    [bytes, numberOfBytes, zeroFill](const IndexValueType pieceIndex[], const SizeValueType pieceSize[]) {
+      const SizeValueType begin = static_cast<SizeValueType>(pieceIndex[0]) * pageSize;
+      const SizeValueType end = std::min(begin + pieceSize[0] * pageSize, numberOfBytes);
+      TouchPages(bytes, begin, end, zeroFill);
+    },
+    nullptr);
+}
+
+SizeValueType
+ImportImageContainerCommon::GetBufferAlignment(SizeValueType        numberOfBytes,
+                                               AllocationPolicyEnum policy,
+                                               SizeValueType        elementAlignment)
+{
+  switch (policy)
+  {
+    case AllocationPolicyEnum::Aligned:
+      return std::max(AlignedAllocationAlignment, elementAlignment);
+    case AllocationPolicyEnum::HugePages:
+      if (numberOfBytes >= HugePageSize)
+      {
+        return std::max(HugePageSize, elementAlignment);
+      }
+      return std::max(AlignedAllocationAlignment, elementAlignment);
+    default:
+      return elementAlignment;
+  }
+}
+
+void *
+ImportImageContainerCommon::AllocateBuffer(SizeValueType        numberOfBytes,
+                                           AllocationPolicyEnum policy,
+                                           SizeValueType        elementAlignment)
+{
+  const SizeValueType alignment = GetBufferAlignment(numberOfBytes, policy, elementAlignment);
+  const SizeValueType allocatedSize = GetAllocatedSize(numberOfBytes, alignment);
+
+  void * const buffer = ::operator new(allocatedSize, std::align_val_t{ alignment }, std::nothrow);
+  if (buffer == nullptr)
+  {
+    // We cannot construct an error string here because we may be out
+    // of memory.  Do not use the exception macro.
+    throw MemoryAllocationError(__FILE__, __LINE__, "Failed to allocate memory for image.", ITK_LOCATION);
+  }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (alignment == HugePageSize)
+  {
+    // Must be done before the pages are touched. Only a hint: it fails when
+    // transparent huge pages are disabled, and the buffer is then backed by
+    // regular pages.
+    madvise(buffer, allocatedSize, MADV_HUGEPAGE);
+  }
+#endif
+  return buffer;
+}
+
+void
+ImportImageContainerCommon::FreeBuffer(void *               buffer,
+                                       SizeValueType        numberOfBytes,
+                                       AllocationPolicyEnum policy,
+                                       SizeValueType        elementAlignment)
+{
+  ::operator delete(buffer, std::align_val_t{ GetBufferAlignment(numberOfBytes, policy, elementAlignment) });
+}
+
+/** Print enum values */
+std::ostream &
+operator<<(std::ostream & out, const ImportImageContainerEnums::AllocationPolicy value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case ImportImageContainerEnums::AllocationPolicy::Default:
+        return "itk::ImportImageContainerEnums::AllocationPolicy::Default";
+      case ImportImageContainerEnums::AllocationPolicy::Aligned:
+        return "itk::ImportImageContainerEnums::AllocationPolicy::Aligned";
+      case ImportImageContainerEnums::AllocationPolicy::HugePages:
+        return "itk::ImportImageContainerEnums::AllocationPolicy::HugePages";
+      default:
+        return "INVALID VALUE FOR itk::ImportImageContainerEnums::AllocationPolicy";
+    }
+  }();
+}
+
+} // namespace itk
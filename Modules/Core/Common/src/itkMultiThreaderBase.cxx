@@ -39,12 +39,17 @@
 #include "itkImageSourceCommon.h"
 #include "itkSingleton.h"
 #include "itkProcessObject.h"
+#include "itkPipelineProfiler.h"
 
 #include <algorithm> // For clamp.
+#include <atomic>
+#include <functional> // For multiplies.
 #include <iostream>
+#include <numeric> // For accumulate.
 #include <string>
 #include <cctype>
 #include <utility> // For move.
+#include <vector>
 
 #if defined(ITK_HAS_SCHED_GETAFFINITY)
 #  include <sched.h>
@@ -58,6 +63,28 @@
 
 namespace itk
 {
+namespace
+{
+MultiThreaderBaseEnums::WorkScheduling
+GetInitialGlobalDefaultWorkScheduling()
+{
+  std::string envVar;
+  if (itksys::SystemTools::GetEnv("ITK_GLOBAL_DEFAULT_WORK_SCHEDULING", envVar))
+  {
+    envVar = itksys::SystemTools::UpperCase(envVar);
+    if (envVar == "GUIDED")
+    {
+      return MultiThreaderBaseEnums::WorkScheduling::Guided;
+    }
+    if (envVar != "STATIC")
+    {
+      itkGenericOutputMacro("Warning: ignoring the unknown work scheduling "
+                            << envVar << " of ITK_GLOBAL_DEFAULT_WORK_SCHEDULING.");
+    }
+  }
+  return MultiThreaderBaseEnums::WorkScheduling::Static;
+}
+} // namespace
 
 struct MultiThreaderBaseGlobals
 {
@@ -89,6 +116,11 @@ struct MultiThreaderBaseGlobals
   //  m_GlobalMaximumNumberOfThreads and larger or equal to 1 once it has been
   //  initialized in the constructor of the first MultiThreaderBase instantiation.
   ThreadIdType m_GlobalDefaultNumberOfThreads{ 0 };
+
+  // Global value used to initialize the WorkScheduling of the multi-threaders.
+  std::atomic<MultiThreaderBase::WorkSchedulingEnum> m_GlobalDefaultWorkScheduling{
+    GetInitialGlobalDefaultWorkScheduling()
+  };
 };
 
 itkGetGlobalSimpleMacro(MultiThreaderBase, MultiThreaderBaseGlobals, PimplGlobals);
@@ -243,6 +275,20 @@ MultiThreaderBase::SetGlobalDefaultNumberOfThreads(ThreadIdType val)
     std::clamp<ThreadIdType>(val, 1, m_PimplGlobals->m_GlobalMaximumNumberOfThreads);
 }
 
+void
+MultiThreaderBase::SetGlobalDefaultWorkScheduling(WorkSchedulingEnum workScheduling)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  m_PimplGlobals->m_GlobalDefaultWorkScheduling = workScheduling;
+}
+
+auto
+MultiThreaderBase::GetGlobalDefaultWorkScheduling() -> WorkSchedulingEnum
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return m_PimplGlobals->m_GlobalDefaultWorkScheduling;
+}
+
 void
 MultiThreaderBase::SetMaximumNumberOfThreads(ThreadIdType numberOfThreads)
 {
@@ -418,6 +464,7 @@ MultiThreaderBase::MultiThreaderBase()
 {
   m_MaximumNumberOfThreads = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
   m_NumberOfWorkUnits = m_MaximumNumberOfThreads;
+  m_WorkScheduling = MultiThreaderBase::GetGlobalDefaultWorkScheduling();
 }
 
 MultiThreaderBase::~MultiThreaderBase() = default;
@@ -455,9 +502,39 @@ MultiThreaderBase::SingleMethodProxy(void * arg)
 }
 
 
+namespace
+{
+// The single method and its data, run by ProfiledSingleMethodCallback in a
+// work chunk of a filter execution.
+struct ProfiledSingleMethod
+{
+  ThreadFunctionType          method;
+  void *                      data;
+  PipelineProfilerExecution * execution;
+};
+
+ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+ProfiledSingleMethodCallback(void * arg)
+{
+  auto *       workUnitInfo = static_cast<MultiThreaderBase::WorkUnitInfo *>(arg);
+  const auto * profiled = static_cast<const ProfiledSingleMethod *>(workUnitInfo->UserData);
+  workUnitInfo->UserData = profiled->data;
+
+  const PipelineProfiler::WorkChunkScope workChunkScope(profiled->execution);
+  return profiled->method(workUnitInfo);
+}
+} // namespace
+
 void
 MultiThreaderBase::SetSingleMethodAndExecute(ThreadFunctionType func, void * data)
 {
+  if (PipelineProfilerExecution * const execution = PipelineProfiler::GetCurrentExecution())
+  {
+    ProfiledSingleMethod profiled{ func, data, execution };
+    this->SetSingleMethod(&ProfiledSingleMethodCallback, &profiled);
+    this->SingleMethodExecute();
+    return;
+  }
   this->SetSingleMethod(std::move(func), data);
   this->SingleMethodExecute();
 }
@@ -537,6 +614,12 @@ MultiThreaderBase::ParallelizeImageRegion(unsigned int
   }
   const ProgressReporter progress(filter, 0, 1);
 
+  if (m_WorkScheduling == WorkSchedulingEnum::Guided)
+  {
+    this->ParallelizeImageRegionGuided(dimension, index, size, funcP, filter);
+    return;
+  }
+
   struct RegionAndCallback rnc{ funcP, dimension, index, size, filter };
   this->SetSingleMethodAndExecute(&MultiThreaderBase::ParallelizeImageRegionHelper, &rnc);
 }
@@ -570,6 +653,161 @@ MultiThreaderBase::ParallelizeImageRegionHelper(void * arg)
   return ITK_THREAD_RETURN_DEFAULT_VALUE;
 }
 
+namespace
+{
+// The chunks of a region which the threads claim with Guided work scheduling.
+// The positions along the slowest dimensions of the region, from
+// m_SplitDimension up, are numbered in memory order, and a chunk is a range
+// of these positions, covered by a few boxes.
+class GuidedRegionChunks
+{
+public:
+  GuidedRegionChunks(unsigned int         dimension,
+                     const IndexValueType index[],
+                     const SizeValueType  size[],
+                     ThreadIdType         numberOfThreads)
+    : m_Index(index, index + dimension)
+    , m_Size(size, size + dimension)
+    , m_Strides(dimension)
+    , m_NumberOfThreads(numberOfThreads)
+  {
+    // Split along as few dimensions as give enough positions for the tail of
+    // the guided schedule to balance the threads.
+    m_SplitDimension = dimension - 1;
+    m_NumberOfPositions = size[m_SplitDimension];
+    while (m_SplitDimension > 0 && m_NumberOfPositions < 16 * SizeValueType{ numberOfThreads })
+    {
+      --m_SplitDimension;
+      m_NumberOfPositions *= size[m_SplitDimension];
+    }
+    SizeValueType stride = 1;
+    for (unsigned int d = m_SplitDimension; d < dimension; ++d)
+    {
+      m_Strides[d] = stride;
+      stride *= size[d];
+    }
+  }
+
+  /** Claim the next chunk, [begin, end) in the order of the positions.
+   * Returns false when the whole region has been claimed. */
+  bool
+  Claim(SizeValueType & begin, SizeValueType & end)
+  {
+    const SizeValueType divisor = 2 * SizeValueType{ m_NumberOfThreads };
+    SizeValueType       next = m_Next.load(std::memory_order_relaxed);
+    SizeValueType       chunkSize = 0;
+    do
+    {
+      if (next >= m_NumberOfPositions)
+      {
+        return false;
+      }
+      chunkSize = (m_NumberOfPositions - next + divisor - 1) / divisor;
+    } while (!m_Next.compare_exchange_weak(next, next + chunkSize, std::memory_order_relaxed));
+    begin = next;
+    end = next + chunkSize;
+    return true;
+  }
+
+  /** Call function(index, size) for the boxes which cover the positions
+   * [begin, end). */
+  template <typename TFunction>
+  void
+  ForEachBox(SizeValueType begin, SizeValueType end, TFunction && function) const
+  {
+    const auto                  dimension = static_cast<unsigned int>(m_Size.size());
+    std::vector<IndexValueType> boxIndex(m_Index);
+    std::vector<SizeValueType>  boxSize(m_Size);
+    while (begin < end)
+    {
+      // The highest dimension along which the box can extend: the dimensions
+      // below it are then whole.
+      unsigned int k = dimension - 1;
+      while (k > m_SplitDimension && (begin % m_Strides[k] != 0 || m_Strides[k] > end - begin))
+      {
+        --k;
+      }
+      const SizeValueType coordinate = (begin / m_Strides[k]) % m_Size[k];
+      const SizeValueType count = std::min((end - begin) / m_Strides[k], m_Size[k] - coordinate);
+      for (unsigned int d = m_SplitDimension; d < k; ++d)
+      {
+        boxIndex[d] = m_Index[d];
+        boxSize[d] = m_Size[d];
+      }
+      boxIndex[k] = m_Index[k] + static_cast<IndexValueType>(coordinate);
+      boxSize[k] = count;
+      for (unsigned int d = k + 1; d < dimension; ++d)
+      {
+        boxIndex[d] = m_Index[d] + static_cast<IndexValueType>((begin / m_Strides[d]) % m_Size[d]);
+        boxSize[d] = 1;
+      }
+      function(boxIndex.data(), boxSize.data());
+      begin += count * m_Strides[k];
+    }
+  }
+
+private:
+  const std::vector<IndexValueType> m_Index;
+  const std::vector<SizeValueType>  m_Size;
+  std::vector<SizeValueType>        m_Strides;
+  const ThreadIdType                m_NumberOfThreads;
+  unsigned int                      m_SplitDimension;
+  SizeValueType                     m_NumberOfPositions;
+  std::atomic<SizeValueType>        m_Next{ 0 };
+};
+} // namespace
+
+void
+MultiThreaderBase::ParallelizeImageRegionGuided(unsigned int                 dimension,
+                                                const IndexValueType         index[],
+                                                const SizeValueType          size[],
+                                                const ThreadingFunctorType & funcP,
+                                                ProcessObject *              filter)
+{
+  SizeValueType numberOfPixels = 1;
+  for (unsigned int d = 0; d < dimension; ++d)
+  {
+    numberOfPixels *= size[d];
+  }
+  const ThreadIdType numberOfThreads = std::min(m_MaximumNumberOfThreads, m_NumberOfWorkUnits);
+  if (numberOfThreads <= 1 || numberOfPixels <= 1)
+  {
+    const PipelineProfiler::WorkChunkScope workChunkScope(PipelineProfiler::GetCurrentExecution());
+    funcP(index, size);
+    return;
+  }
+
+  GuidedRegionChunks chunks(dimension, index, size, numberOfThreads);
+  std::atomic<bool>  failed{ false };
+  this->ParallelizeArray(
+    0,
+    numberOfThreads,
+    [&chunks, &failed, &funcP, filter, dimension, numberOfPixels](SizeValueType) {
+      TotalProgressReporter progress(filter, numberOfPixels);
+      try
+      {
+        SizeValueType begin = 0;
+        SizeValueType end = 0;
+        while (!failed.load(std::memory_order_relaxed) && chunks.Claim(begin, end))
+        {
+          progress.CheckAbortGenerateData();
+          chunks.ForEachBox(begin, end, [&](const IndexValueType * boxIndex, const SizeValueType * boxSize) {
+            funcP(boxIndex, boxSize);
+            progress.Completed(
+              std::accumulate(boxSize, boxSize + dimension, SizeValueType{ 1 }, std::multiplies<>()));
+          });
+        }
+      }
+      catch (...)
+      {
+        // Let the other threads stop at their next chunk.
+        failed = true;
+        throw;
+      }
+    },
+    nullptr);
+}
+
 // Print method for the multithreader
 void
 MultiThreaderBase::PrintSelf(std::ostream & os, Indent indent) const
@@ -581,6 +819,7 @@ MultiThreaderBase::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "Global Maximum Number Of Threads: " << m_PimplGlobals->m_GlobalMaximumNumberOfThreads << std::endl;
   os << indent << "Global Default Number Of Threads: " << m_PimplGlobals->m_GlobalDefaultNumberOfThreads << std::endl;
   os << indent << "Global Default Threader Type: " << m_PimplGlobals->m_GlobalDefaultThreader << std::endl;
+  os << indent << "WorkScheduling: " << m_WorkScheduling << std::endl;
   os << indent << "SingleMethod: " << m_SingleMethod << std::endl;
   os << indent << "SingleData: " << m_SingleData << std::endl;
 }
@@ -633,4 +872,20 @@ operator<<(std::ostream & out, const MultiThreaderBaseEnums::ThreadExitCode valu
     }
   }();
 }
+/** Print enum values */
+std::ostream &
+operator<<(std::ostream & out, const MultiThreaderBaseEnums::WorkScheduling value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case MultiThreaderBaseEnums::WorkScheduling::Static:
+        return "itk::MultiThreaderBaseEnums::WorkScheduling::Static";
+      case MultiThreaderBaseEnums::WorkScheduling::Guided:
+        return "itk::MultiThreaderBaseEnums::WorkScheduling::Guided";
+      default:
+        return "INVALID VALUE FOR itk::MultiThreaderBaseEnums::WorkScheduling";
+    }
+  }();
+}
 } // namespace itk
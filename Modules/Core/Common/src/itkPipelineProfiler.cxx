@@ -0,0 +1,659 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPipelineProfiler.h"
+#include "itkImportImageContainerCommon.h"
+#include "itkProcessObject.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iomanip>
+#include <unordered_map>
+
+namespace itk
+{
+/** A filter execution being recorded. Its times are those of the clock, and
+ * are converted to seconds when the executions are retrieved. */
+class PipelineProfilerExecution : public std::enable_shared_from_this<PipelineProfilerExecution>
+{
+public:
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  struct RawWorkChunk
+  {
+    ThreadIdType threadIndex;
+    TimePoint    startTime;
+    TimePoint    endTime;
+  };
+
+  /** The work chunks which one thread ran for the execution. The thread
+   * appends to them without locking, and they are merged into workChunks
+   * when the execution ends, after all its work chunks. There is one node
+   * per thread, pushed at the front of the list threadChunks. */
+  struct ThreadWorkChunks
+  {
+    std::thread::id           threadId;
+    std::vector<RawWorkChunk> chunks;
+    ThreadWorkChunks *        next{ nullptr };
+  };
+
+  PipelineProfiler * const                         profiler;
+  const std::shared_ptr<PipelineProfilerExecution> parent;
+  const std::string                                name;
+  const std::string                                nameOfClass;
+  const SizeValueType                              serialNumber;
+  SizeValueType                                    filterIndex{ 0 };
+  ThreadIdType                                     threadIndex{ 0 };
+  unsigned int                                     depth{ 0 };
+  bool                                             completed{ false }; // guarded by the mutex of the profiler
+  TimePoint                                        startTime{};
+  TimePoint                                        endTime{};          // guarded by the mutex of the profiler
+  std::vector<RawWorkChunk>                        workChunks;         // guarded by the mutex of the profiler
+  std::atomic<ThreadWorkChunks *>                  threadChunks{ nullptr };
+  std::atomic<SizeValueType>                       allocatedBytes{ 0 };
+  std::atomic<SizeValueType>                       numberOfStreamingPieces{ 0 };
+
+  PipelineProfilerExecution(PipelineProfiler *                         profiler_,
+                            std::shared_ptr<PipelineProfilerExecution> parent_,
+                            std::string                                name_,
+                            std::string                                nameOfClass_)
+    : profiler(profiler_)
+    , parent(std::move(parent_))
+    , name(std::move(name_))
+    , nameOfClass(std::move(nameOfClass_))
+    , serialNumber(nextSerialNumber.fetch_add(1, std::memory_order_relaxed))
+  {}
+
+  ~PipelineProfilerExecution()
+  {
+    const ThreadWorkChunks * node = threadChunks.load(std::memory_order_acquire);
+    while (node != nullptr)
+    {
+      const ThreadWorkChunks * const next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  /** The work chunks of the calling thread, created on its first work chunk
+   * of the execution. */
+  ThreadWorkChunks &
+  GetThreadWorkChunks();
+
+  /** Move the work chunks of all the threads into workChunks, in the order in
+   * which they started. To be called with the mutex of the profiler locked,
+   * once the work chunks ended. */
+  template <typename TGetThreadIndex>
+  void
+  MergeThreadWorkChunks(TGetThreadIndex getThreadIndex)
+  {
+    for (ThreadWorkChunks * node = threadChunks.load(std::memory_order_acquire); node != nullptr; node = node->next)
+    {
+      const ThreadIdType index = getThreadIndex(node->threadId);
+      for (RawWorkChunk & chunk : node->chunks)
+      {
+        chunk.threadIndex = index;
+        workChunks.push_back(chunk);
+      }
+      node->chunks.clear();
+    }
+    std::sort(workChunks.begin(), workChunks.end(), [](const RawWorkChunk & a, const RawWorkChunk & b) {
+      return a.startTime < b.startTime;
+    });
+  }
+
+private:
+  static std::atomic<SizeValueType> nextSerialNumber;
+};
+
+std::atomic<SizeValueType> PipelineProfilerExecution::nextSerialNumber{ 1 };
+
+namespace
+{
+struct ProfilerThreadState
+{
+  PipelineProfilerExecution * execution{ nullptr };
+  bool                        inWorkChunk{ false };
+
+  // The work chunks of this thread for the executions it last worked on, by
+  // serial number of the execution. A serial number is never reused, so an
+  // entry is only used while its execution lives.
+  std::array<std::pair<SizeValueType, PipelineProfilerExecution::ThreadWorkChunks *>, 4> recentWorkChunks{};
+  unsigned int                                                                            nextRecentWorkChunks{ 0 };
+};
+
+thread_local ProfilerThreadState profilerThreadState;
+
+struct ActiveProfilerGlobals
+{
+  // Checked without locking by the instrumentation, which takes a reference
+  // to the profiler under the mutex only when it is not null.
+  std::atomic<PipelineProfiler *> activeProfiler{ nullptr };
+  std::mutex                      mutex;
+  PipelineProfiler::Pointer       reference; // guarded by mutex
+};
+
+ActiveProfilerGlobals &
+GetActiveProfilerGlobals()
+{
+  static ActiveProfilerGlobals globals;
+  return globals;
+}
+
+double
+ToSeconds(std::chrono::steady_clock::duration duration)
+{
+  return std::chrono::duration<double>(duration).count();
+}
+
+void
+WriteJSONString(std::ostream & os, const std::string & value)
+{
+  os << '"';
+  for (const char c : value)
+  {
+    switch (c)
+    {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      case '\t':
+        os << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+        {
+          os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec
+             << std::setfill(' ');
+        }
+        else
+        {
+          os << c;
+        }
+    }
+  }
+  os << '"';
+}
+
+// Restores the format flags and precision of a stream on destruction.
+class StreamFormatGuard
+{
+public:
+  explicit StreamFormatGuard(std::ostream & os)
+    : m_Stream(os)
+    , m_Flags(os.flags())
+    , m_Precision(os.precision())
+  {}
+  ~StreamFormatGuard()
+  {
+    m_Stream.flags(m_Flags);
+    m_Stream.precision(m_Precision);
+  }
+
+private:
+  std::ostream &           m_Stream;
+  const std::ios::fmtflags m_Flags;
+  const std::streamsize    m_Precision;
+};
+} // namespace
+
+auto
+PipelineProfilerExecution::GetThreadWorkChunks() -> ThreadWorkChunks &
+{
+  auto & recent = profilerThreadState.recentWorkChunks;
+  for (const auto & entry : recent)
+  {
+    if (entry.first == serialNumber)
+    {
+      return *entry.second;
+    }
+  }
+  auto * const node = new ThreadWorkChunks{ std::this_thread::get_id(), {}, threadChunks.load() };
+  while (!threadChunks.compare_exchange_weak(node->next, node, std::memory_order_release))
+  {
+  }
+  recent[profilerThreadState.nextRecentWorkChunks] = { serialNumber, node };
+  profilerThreadState.nextRecentWorkChunks = (profilerThreadState.nextRecentWorkChunks + 1) % recent.size();
+  return *node;
+}
+
+PipelineProfiler::~PipelineProfiler() = default;
+
+void
+PipelineProfiler::Start()
+{
+  ActiveProfilerGlobals &           globals = GetActiveProfilerGlobals();
+  const std::lock_guard<std::mutex> lockGuard(globals.mutex);
+  globals.reference = this;
+  globals.activeProfiler = this;
+  ImportImageContainerCommon::SetAllocationObserver(&PipelineProfiler::RecordAllocation);
+}
+
+void
+PipelineProfiler::Stop()
+{
+  ActiveProfilerGlobals &           globals = GetActiveProfilerGlobals();
+  Pointer                           released; // released after the unlock, as it may be the last reference
+  const std::lock_guard<std::mutex> lockGuard(globals.mutex);
+  if (globals.reference == this)
+  {
+    globals.activeProfiler = nullptr;
+    ImportImageContainerCommon::SetAllocationObserver(nullptr);
+    released.Swap(globals.reference);
+  }
+}
+
+bool
+PipelineProfiler::IsActive() const
+{
+  return GetActiveProfiler() == this;
+}
+
+PipelineProfiler *
+PipelineProfiler::GetActiveProfiler()
+{
+  return GetActiveProfilerGlobals().activeProfiler.load(std::memory_order_acquire);
+}
+
+void
+PipelineProfiler::Clear()
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  m_Executions.clear();
+  m_FilterIndices.clear();
+  m_ThreadIndices.clear();
+  m_NumberOfDroppedExecutions = 0;
+  m_ClockOrigin = std::chrono::steady_clock::now();
+}
+
+SizeValueType
+PipelineProfiler::GetNumberOfDroppedExecutions() const
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  return m_NumberOfDroppedExecutions;
+}
+
+ThreadIdType
+PipelineProfiler::GetThreadIndex(std::thread::id threadId)
+{
+  const auto inserted = m_ThreadIndices.emplace(threadId, static_cast<ThreadIdType>(m_ThreadIndices.size()));
+  return inserted.first->second;
+}
+
+std::shared_ptr<PipelineProfilerExecution>
+PipelineProfiler::BeginExecution(const ProcessObject * filter, PipelineProfilerExecution * parent)
+{
+  const std::string & objectName = filter->GetObjectName();
+  auto                execution = std::make_shared<PipelineProfilerExecution>(
+    this,
+    parent ? parent->shared_from_this() : nullptr,
+    objectName.empty() ? std::string(filter->GetNameOfClass()) : objectName,
+    filter->GetNameOfClass());
+  execution->depth = parent ? parent->depth + 1 : 0;
+
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  execution->filterIndex = m_FilterIndices.emplace(filter, m_FilterIndices.size()).first->second;
+  execution->threadIndex = this->GetThreadIndex(std::this_thread::get_id());
+  if (m_Executions.size() < m_MaximumNumberOfExecutions)
+  {
+    m_Executions.push_back(execution);
+  }
+  else
+  {
+    ++m_NumberOfDroppedExecutions;
+  }
+  execution->startTime = std::chrono::steady_clock::now();
+  return execution;
+}
+
+void
+PipelineProfiler::EndExecution(PipelineProfilerExecution & execution)
+{
+  const auto                        endTime = std::chrono::steady_clock::now();
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  execution.endTime = endTime;
+  execution.completed = true;
+  execution.MergeThreadWorkChunks([this](std::thread::id threadId) { return this->GetThreadIndex(threadId); });
+}
+
+void
+PipelineProfiler::EndWorkChunk(PipelineProfilerExecution &           execution,
+                               std::chrono::steady_clock::time_point startTime,
+                               std::chrono::steady_clock::time_point endTime)
+{
+  // No lock: the chunks of each thread are merged when the execution ends.
+  execution.GetThreadWorkChunks().chunks.push_back({ 0, startTime, endTime });
+}
+
+std::vector<PipelineProfiler::FilterExecution>
+PipelineProfiler::GetExecutions() const
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+
+  std::vector<FilterExecution>                                         executions;
+  std::unordered_map<const PipelineProfilerExecution *, SizeValueType> indices;
+  executions.reserve(m_Executions.size());
+  for (const auto & execution : m_Executions)
+  {
+    // Executions still in progress have no duration yet. Their children
+    // are reported without parent.
+    if (!execution->completed)
+    {
+      continue;
+    }
+    const auto parent = indices.find(execution->parent.get());
+
+    FilterExecution result{};
+    result.Name = execution->name;
+    result.NameOfClass = execution->nameOfClass;
+    result.FilterIndex = execution->filterIndex;
+    result.ParentIndex = parent != indices.end() ? parent->second : NoParent;
+    result.Depth = execution->depth;
+    result.ThreadIndex = execution->threadIndex;
+    // Executions which started before a Clear() start at zero.
+    result.StartTime = std::max(0.0, ToSeconds(execution->startTime - m_ClockOrigin));
+    result.Duration = ToSeconds(execution->endTime - execution->startTime);
+    result.AllocatedBytes = execution->allocatedBytes;
+    result.NumberOfStreamingPieces = execution->numberOfStreamingPieces;
+    result.WorkChunks.reserve(execution->workChunks.size());
+    for (const auto & chunk : execution->workChunks)
+    {
+      result.WorkChunks.push_back({ chunk.threadIndex,
+                                    std::max(0.0, ToSeconds(chunk.startTime - m_ClockOrigin)),
+                                    ToSeconds(chunk.endTime - chunk.startTime) });
+    }
+    indices.emplace(execution.get(), executions.size());
+    executions.push_back(std::move(result));
+  }
+  return executions;
+}
+
+std::vector<PipelineProfiler::FilterSummary>
+PipelineProfiler::GetFilterSummaries() const
+{
+  const std::vector<FilterExecution> executions = this->GetExecutions();
+
+  // The time of the children of each execution on its thread.
+  std::vector<double> childTimes(executions.size(), 0.0);
+  for (const FilterExecution & execution : executions)
+  {
+    if (execution.ParentIndex != NoParent && executions[execution.ParentIndex].ThreadIndex == execution.ThreadIndex)
+    {
+      childTimes[execution.ParentIndex] += execution.Duration;
+    }
+  }
+
+  std::map<SizeValueType, FilterSummary>                      summaries;
+  std::map<SizeValueType, std::map<ThreadIdType, ThreadLoad>> threadLoads;
+  for (SizeValueType i = 0; i < executions.size(); ++i)
+  {
+    const FilterExecution & execution = executions[i];
+    const auto              inserted = summaries.emplace(execution.FilterIndex, FilterSummary{});
+    FilterSummary &         summary = inserted.first->second;
+    if (inserted.second)
+    {
+      summary.Name = execution.Name;
+      summary.NameOfClass = execution.NameOfClass;
+    }
+    ++summary.NumberOfExecutions;
+    summary.TotalTime += execution.Duration;
+    summary.SelfTime += std::max(0.0, execution.Duration - childTimes[i]);
+    summary.AllocatedBytes += execution.AllocatedBytes;
+    summary.NumberOfStreamingPieces += execution.NumberOfStreamingPieces;
+    summary.NumberOfWorkChunks += execution.WorkChunks.size();
+
+    std::map<ThreadIdType, ThreadLoad> executionLoads;
+    for (const WorkChunk & chunk : execution.WorkChunks)
+    {
+      ThreadLoad & load = executionLoads.emplace(chunk.ThreadIndex, ThreadLoad{ chunk.ThreadIndex, 0, 0.0, 0.0 })
+                            .first->second;
+      ++load.NumberOfWorkChunks;
+      load.BusyTime += chunk.Duration;
+    }
+    std::map<ThreadIdType, ThreadLoad> & filterLoads = threadLoads[execution.FilterIndex];
+    for (const auto & executionLoad : executionLoads)
+    {
+      const ThreadLoad & load = executionLoad.second;
+      ThreadLoad &       filterLoad =
+        filterLoads.emplace(load.ThreadIndex, ThreadLoad{ load.ThreadIndex, 0, 0.0, 0.0 }).first->second;
+      filterLoad.NumberOfWorkChunks += load.NumberOfWorkChunks;
+      filterLoad.BusyTime += load.BusyTime;
+      filterLoad.IdleTime += std::max(0.0, execution.Duration - load.BusyTime);
+    }
+  }
+
+  std::vector<FilterSummary> result;
+  result.reserve(summaries.size());
+  for (auto & summary : summaries)
+  {
+    for (const auto & load : threadLoads[summary.first])
+    {
+      summary.second.Threads.push_back(load.second);
+    }
+    result.push_back(std::move(summary.second));
+  }
+  return result;
+}
+
+void
+PipelineProfiler::WriteJSON(std::ostream & os) const
+{
+  const std::vector<FilterExecution> executions = this->GetExecutions();
+  const std::vector<FilterSummary>   summaries = this->GetFilterSummaries();
+
+  const StreamFormatGuard formatGuard(os);
+  os << std::setprecision(9);
+
+  os << "{\n  \"filters\": [";
+  for (SizeValueType i = 0; i < summaries.size(); ++i)
+  {
+    const FilterSummary & summary = summaries[i];
+    os << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+    WriteJSONString(os, summary.Name);
+    os << ", \"class\": ";
+    WriteJSONString(os, summary.NameOfClass);
+    os << ", \"executions\": " << summary.NumberOfExecutions << ", \"totalTime\": " << summary.TotalTime
+       << ", \"selfTime\": " << summary.SelfTime << ", \"allocatedBytes\": " << summary.AllocatedBytes
+       << ", \"streamingPieces\": " << summary.NumberOfStreamingPieces
+       << ", \"workChunks\": " << summary.NumberOfWorkChunks << ", \"threads\": [";
+    for (SizeValueType t = 0; t < summary.Threads.size(); ++t)
+    {
+      const ThreadLoad & load = summary.Threads[t];
+      os << (t == 0 ? "" : ", ") << "{\"thread\": " << load.ThreadIndex
+         << ", \"workChunks\": " << load.NumberOfWorkChunks << ", \"busyTime\": " << load.BusyTime
+         << ", \"idleTime\": " << load.IdleTime << '}';
+    }
+    os << "]}";
+  }
+  os << "\n  ],\n  \"executions\": [";
+  for (SizeValueType i = 0; i < executions.size(); ++i)
+  {
+    const FilterExecution & execution = executions[i];
+    os << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+    WriteJSONString(os, execution.Name);
+    os << ", \"class\": ";
+    WriteJSONString(os, execution.NameOfClass);
+    os << ", \"filter\": " << execution.FilterIndex << ", \"parent\": ";
+    if (execution.ParentIndex == NoParent)
+    {
+      os << "null";
+    }
+    else
+    {
+      os << execution.ParentIndex;
+    }
+    os << ", \"depth\": " << execution.Depth << ", \"thread\": " << execution.ThreadIndex
+       << ", \"startTime\": " << execution.StartTime << ", \"duration\": " << execution.Duration
+       << ", \"allocatedBytes\": " << execution.AllocatedBytes
+       << ", \"streamingPieces\": " << execution.NumberOfStreamingPieces
+       << ", \"workChunks\": " << execution.WorkChunks.size() << '}';
+  }
+  os << "\n  ]\n}\n";
+}
+
+void
+PipelineProfiler::WriteChromeTrace(std::ostream & os) const
+{
+  const std::vector<FilterExecution> executions = this->GetExecutions();
+
+  const StreamFormatGuard formatGuard(os);
+  os << std::fixed << std::setprecision(3);
+
+  // Complete events, whose times are in microseconds.
+  bool       first = true;
+  const auto writeEvent = [&os, &first](const FilterExecution & execution,
+                                        const char *            category,
+                                        ThreadIdType            threadIndex,
+                                        double                  startTime,
+                                        double                  duration) {
+    os << (first ? "\n" : ",\n") << "  {\"name\": ";
+    first = false;
+    WriteJSONString(os, execution.Name);
+    os << ", \"cat\": \"" << category << "\", \"ph\": \"X\", \"ts\": " << startTime * 1e6
+       << ", \"dur\": " << duration * 1e6 << ", \"pid\": 0, \"tid\": " << threadIndex;
+  };
+
+  ThreadIdType numberOfThreads = 0;
+  os << "{\"traceEvents\": [";
+  for (const FilterExecution & execution : executions)
+  {
+    writeEvent(execution, "filter", execution.ThreadIndex, execution.StartTime, execution.Duration);
+    os << ", \"args\": {\"class\": ";
+    WriteJSONString(os, execution.NameOfClass);
+    os << ", \"allocatedBytes\": " << execution.AllocatedBytes
+       << ", \"streamingPieces\": " << execution.NumberOfStreamingPieces
+       << ", \"workChunks\": " << execution.WorkChunks.size() << "}}";
+    numberOfThreads = std::max(numberOfThreads, execution.ThreadIndex + 1);
+
+    for (const WorkChunk & chunk : execution.WorkChunks)
+    {
+      writeEvent(execution, "work chunk", chunk.ThreadIndex, chunk.StartTime, chunk.Duration);
+      os << '}';
+      numberOfThreads = std::max(numberOfThreads, chunk.ThreadIndex + 1);
+    }
+  }
+  for (ThreadIdType threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex)
+  {
+    os << (first ? "\n" : ",\n") << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << threadIndex
+       << ", \"args\": {\"name\": \"Thread " << threadIndex << "\"}}";
+    first = false;
+  }
+  os << "\n], \"displayTimeUnit\": \"ms\"}\n";
+}
+
+PipelineProfilerExecution *
+PipelineProfiler::GetCurrentExecution()
+{
+  return profilerThreadState.execution;
+}
+
+void
+PipelineProfiler::RecordAllocation(SizeValueType numberOfBytes)
+{
+  if (PipelineProfilerExecution * const execution = profilerThreadState.execution)
+  {
+    execution->allocatedBytes.fetch_add(numberOfBytes, std::memory_order_relaxed);
+  }
+}
+
+void
+PipelineProfiler::RecordStreamingPieces(SizeValueType numberOfPieces)
+{
+  if (PipelineProfilerExecution * const execution = profilerThreadState.execution)
+  {
+    execution->numberOfStreamingPieces.fetch_add(numberOfPieces, std::memory_order_relaxed);
+  }
+}
+
+PipelineProfiler::ExecutionScope::ExecutionScope(const ProcessObject * filter)
+{
+  if (GetActiveProfiler() == nullptr)
+  {
+    return;
+  }
+  {
+    ActiveProfilerGlobals &           globals = GetActiveProfilerGlobals();
+    const std::lock_guard<std::mutex> lockGuard(globals.mutex);
+    m_Profiler = globals.reference;
+  }
+  if (m_Profiler.IsNull())
+  {
+    return;
+  }
+  m_Execution = m_Profiler->BeginExecution(filter, profilerThreadState.execution);
+  m_PreviousExecution = profilerThreadState.execution;
+  m_PreviousInWorkChunk = profilerThreadState.inWorkChunk;
+  profilerThreadState.execution = m_Execution.get();
+  profilerThreadState.inWorkChunk = false;
+}
+
+PipelineProfiler::ExecutionScope::~ExecutionScope()
+{
+  if (m_Execution)
+  {
+    m_Profiler->EndExecution(*m_Execution);
+    profilerThreadState.execution = m_PreviousExecution;
+    profilerThreadState.inWorkChunk = m_PreviousInWorkChunk;
+  }
+}
+
+PipelineProfiler::WorkChunkScope::WorkChunkScope(PipelineProfilerExecution * execution)
+  : m_Execution(execution)
+{
+  if (m_Execution == nullptr ||
+      (profilerThreadState.execution == m_Execution && profilerThreadState.inWorkChunk))
+  {
+    // Nested parallelism within a work chunk is part of the chunk.
+    m_Execution = nullptr;
+    return;
+  }
+  m_PreviousExecution = profilerThreadState.execution;
+  m_PreviousInWorkChunk = profilerThreadState.inWorkChunk;
+  profilerThreadState.execution = m_Execution;
+  profilerThreadState.inWorkChunk = true;
+  m_StartTime = std::chrono::steady_clock::now();
+}
+
+PipelineProfiler::WorkChunkScope::~WorkChunkScope()
+{
+  if (m_Execution)
+  {
+    m_Execution->profiler->EndWorkChunk(*m_Execution, m_StartTime, std::chrono::steady_clock::now());
+    profilerThreadState.execution = m_PreviousExecution;
+    profilerThreadState.inWorkChunk = m_PreviousInWorkChunk;
+  }
+}
+
+void
+PipelineProfiler::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  os << indent << "Active: " << (GetActiveProfiler() == this) << std::endl;
+  os << indent << "NumberOfExecutions: " << m_Executions.size() << std::endl;
+  os << indent << "NumberOfDroppedExecutions: " << m_NumberOfDroppedExecutions << std::endl;
+  os << indent << "MaximumNumberOfExecutions: " << m_MaximumNumberOfExecutions << std::endl;
+}
+} // end namespace itk
@@ -29,6 +29,7 @@
 #include "itkNumericTraits.h"
 #include "itkProcessObject.h"
 #include "itkImageSourceCommon.h"
+#include "itkPipelineProfiler.h"
 #include <algorithm>
 #include <exception>
 #include <iostream>
@@ -74,6 +75,30 @@ public:
 private:
   std::exception_ptr m_FirstCaughtException;
 };
+
+// Waits until the future is ready. When called from a thread of the pool (nested
+// parallelism), the queued work of this thread is processed meanwhile, instead of
+// blocking the thread while the work it waits for sits in its own queue.
+template <typename TFuture>
+void
+WaitForFuture(ThreadPool & threadPool, TFuture & future, ProcessObject * filter)
+{
+  std::future_status status = future.wait_for(std::chrono::milliseconds(0));
+  while (status != std::future_status::ready)
+  {
+    if (threadPool.ExecuteLocalTask())
+    {
+      status = future.wait_for(std::chrono::milliseconds(0));
+      continue;
+    }
+    status = future.wait_for(threadCompletionPollingInterval);
+    if (filter && status == std::future_status::timeout)
+    {
+      filter->IncrementProgress(0);
+    }
+  }
+  future.get();
+}
 } // namespace
 
 
@@ -145,7 +170,8 @@ PoolMultiThreader::SingleMethodExecute()
   // so now it waits for each of the other work units to finish
   for (threadLoop = 1; threadLoop < m_NumberOfWorkUnits; ++threadLoop)
   {
-    exceptionHandler.TryAndCatch([this, threadLoop] { m_ThreadInfoArray[threadLoop].Future.get(); });
+    exceptionHandler.TryAndCatch(
+      [this, threadLoop] { WaitForFuture(*m_ThreadPool, m_ThreadInfoArray[threadLoop].Future, nullptr); });
   }
 
   exceptionHandler.RethrowFirstCaughtException();
@@ -170,7 +196,10 @@ PoolMultiThreader::ParallelizeArray(SizeValueType             firstIndex,
       ++chunkSize; // we want slightly bigger chunks to be processed first
     }
 
-    auto lambda = [aFunc](SizeValueType start, SizeValueType end) {
+    PipelineProfilerExecution * const execution = PipelineProfiler::GetCurrentExecution();
+
+    auto lambda = [aFunc, execution](SizeValueType start, SizeValueType end) {
+      const PipelineProfiler::WorkChunkScope workChunkScope(execution);
       for (SizeValueType ii = start; ii < end; ++ii)
       {
         aFunc(ii);
@@ -199,15 +228,7 @@ PoolMultiThreader::ParallelizeArray(SizeValueType             firstIndex,
     for (SizeValueType i = 1; i < workUnit; ++i)
     {
       exceptionHandler.TryAndCatch([this, i, &reporter, &filter] {
-        std::future_status status;
-        do
-        {
-          status = m_ThreadInfoArray[i].Future.wait_for(threadCompletionPollingInterval);
-          if (filter && status == std::future_status::timeout)
-          {
-            filter->IncrementProgress(0);
-          }
-        } while (status != std::future_status::ready);
+        WaitForFuture(*m_ThreadPool, m_ThreadInfoArray[i].Future, filter);
         reporter.CompletedPixel();
       });
     }
@@ -233,10 +254,22 @@ PoolMultiThreader::ParallelizeImageRegion(unsigned int         dimension,
     filter = nullptr;
   }
 
+  if (m_WorkScheduling == WorkSchedulingEnum::Guided)
+  {
+    const ProgressReporter reporter(filter, 0, 1);
+    this->ParallelizeImageRegionGuided(dimension, index, size, funcP, filter);
+    return;
+  }
+
+  PipelineProfilerExecution * const execution = PipelineProfiler::GetCurrentExecution();
+
   if (m_NumberOfWorkUnits == 1) // no multi-threading wanted
   {
     ProgressReporter reporter(filter, 0, 1);
-    funcP(index, size); // process whole region
+    {
+      const PipelineProfiler::WorkChunkScope workChunkScope(execution);
+      funcP(index, size); // process whole region
+    }
     reporter.CompletedPixel();
   }
   else
@@ -249,6 +282,7 @@ PoolMultiThreader::ParallelizeImageRegion(unsigned int         dimension,
     }
     if (region.GetNumberOfPixels() <= 1)
     {
+      const PipelineProfiler::WorkChunkScope workChunkScope(execution);
       funcP(index, size); // process whole region
     }
     else
@@ -265,7 +299,8 @@ PoolMultiThreader::ParallelizeImageRegion(unsigned int         dimension,
         total = splitter->GetSplit(i, splitCount, iRegion);
         if (i < total)
         {
-          m_ThreadInfoArray[i].Future = m_ThreadPool->AddWork([funcP, iRegion]() {
+          m_ThreadInfoArray[i].Future = m_ThreadPool->AddWork([funcP, iRegion, execution]() {
+            const PipelineProfiler::WorkChunkScope workChunkScope(execution);
             funcP(&iRegion.GetIndex()[0], &iRegion.GetSize()[0]);
             // make this lambda have the same signature as m_SingleMethod
             return ITK_THREAD_RETURN_DEFAULT_VALUE;
@@ -282,8 +317,11 @@ PoolMultiThreader::ParallelizeImageRegion(unsigned int         dimension,
 
       // execute this thread's share
       ExceptionHandler exceptionHandler;
-      exceptionHandler.TryAndCatch([funcP, iRegion, &reporter] {
-        funcP(&iRegion.GetIndex()[0], &iRegion.GetSize()[0]);
+      exceptionHandler.TryAndCatch([funcP, iRegion, execution, &reporter] {
+        {
+          const PipelineProfiler::WorkChunkScope workChunkScope(execution);
+          funcP(&iRegion.GetIndex()[0], &iRegion.GetSize()[0]);
+        }
         reporter.CompletedPixel();
       });
 
@@ -291,16 +329,7 @@ PoolMultiThreader::ParallelizeImageRegion(unsigned int         dimension,
       for (ThreadIdType i = 1; i < splitCount; ++i)
       {
         exceptionHandler.TryAndCatch([this, i, &reporter, &filter] {
-          std::future_status status;
-          do
-          {
-            status = m_ThreadInfoArray[i].Future.wait_for(threadCompletionPollingInterval);
-            if (filter && status == std::future_status::timeout)
-            {
-              filter->IncrementProgress(0);
-            }
-          } while (status != std::future_status::ready);
-          m_ThreadInfoArray[i].Future.get();
+          WaitForFuture(*m_ThreadPool, m_ThreadInfoArray[i].Future, filter);
           reporter.CompletedPixel();
         });
       }
@@ -32,6 +32,7 @@
 #include <sstream>
 #include <algorithm>
 #include "itkMultiThreaderBase.h"
+#include "itkPipelineProfiler.h"
 
 namespace itk
 {
@@ -1689,6 +1690,7 @@ ProcessObject::UpdateOutputData(DataObject * itkNotUsed(output))
 
   try
   {
+    const PipelineProfiler::ExecutionScope profilerScope(this);
     this->GenerateData();
   }
   catch (const ProcessAborted &)
@@ -17,6 +17,7 @@
  *=========================================================================*/
 
 #include "itkStreamingProcessObject.h"
+#include "itkPipelineProfiler.h"
 
 namespace itk
 {
@@ -37,6 +38,7 @@ StreamingProcessObject::GenerateData()
   // and what the Splitter thinks is a reasonable value.
   //
   const unsigned int numberOfInputRequestRegion = this->GetNumberOfInputRequestedRegions();
+  PipelineProfiler::RecordStreamingPieces(numberOfInputRequestRegion);
 
   //
   // Loop over the number of pieces, execute the upstream pipeline on each
@@ -152,7 +154,10 @@ StreamingProcessObject::UpdateOutputData(DataObject * itkNotUsed(output))
    */
   this->InvokeEvent(StartEvent());
 
-  this->Self::GenerateData();
+  {
+    const PipelineProfiler::ExecutionScope profilerScope(this);
+    this->Self::GenerateData();
+  }
   /*
    * If we ended due to aborting, push the progress up to 1.0 (since
    * it probably didn't end there)
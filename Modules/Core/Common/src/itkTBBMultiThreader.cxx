@@ -19,6 +19,7 @@
 #include "itkTBBMultiThreader.h"
 #include "itkNumericTraits.h"
 #include "itkProcessObject.h"
+#include "itkPipelineProfiler.h"
 #include "itkTotalProgressReporter.h"
 #include <iostream>
 #include <atomic>
@@ -127,8 +128,9 @@ TBBMultiThreader::ParallelizeArray(SizeValueType             firstIndex,
 
   if (firstIndex + 1 < lastIndexPlus1)
   {
-    const unsigned int  count = lastIndexPlus1 - firstIndex;
-    tbb::global_control l_ParallelizeArray_tbb_global_context(
+    const unsigned int                count = lastIndexPlus1 - firstIndex;
+    PipelineProfilerExecution * const execution = PipelineProfiler::GetCurrentExecution();
+    tbb::global_control               l_ParallelizeArray_tbb_global_context(
       tbb::global_control::max_allowed_parallelism,
       std::min<int>(tbb_utility::get_default_num_threads(), m_MaximumNumberOfThreads));
 
@@ -142,7 +144,10 @@ TBBMultiThreader::ParallelizeArray(SizeValueType             firstIndex,
         TotalProgressReporter progress(filter, count, 100);
         progress.CheckAbortGenerateData();
 
-        aFunc(r.begin()); // invoke the function
+        {
+          const PipelineProfiler::WorkChunkScope workChunkScope(execution);
+          aFunc(r.begin()); // invoke the function
+        }
 
         progress.CompletedPixel();
       },
@@ -249,8 +254,11 @@ TBBMultiThreader::ParallelizeImageRegion(unsigned int         dimension,
   }
   ProgressReporter progressStartEnd(filter, 0, 1);
 
+  PipelineProfilerExecution * const execution = PipelineProfiler::GetCurrentExecution();
+
   if (m_NumberOfWorkUnits == 1)
   {
+    const PipelineProfiler::WorkChunkScope workChunkScope(execution);
     funcP(index, size);
   }
   else
@@ -272,7 +280,10 @@ TBBMultiThreader::ParallelizeImageRegion(unsigned int         dimension,
       TotalProgressReporter progress(filter, totalCount, 100);
       progress.CheckAbortGenerateData();
 
-      funcP(&regionToProcess.GetIndex()[0], &regionToProcess.GetSize()[0]);
+      {
+        const PipelineProfiler::WorkChunkScope workChunkScope(execution);
+        funcP(&regionToProcess.GetIndex()[0], &regionToProcess.GetSize()[0]);
+      }
 
       progress.Completed(regionToProcess.GetNumberOfPixels());
     }); // we implicitly use auto_partitioner for load balancing
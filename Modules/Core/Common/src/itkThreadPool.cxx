@@ -28,6 +28,12 @@
 #include <atomic>
 #include <cassert>
 #include <mutex>
+#include <thread>
+
+#if defined(__linux__) && defined(ITK_USE_PTHREADS)
+#  include <sched.h>
+#  define ITK_THREAD_POOL_HAS_AFFINITY
+#endif
 
 
 namespace itk
@@ -61,6 +67,76 @@ struct ThreadPoolGlobals
 
 itkGetGlobalSimpleMacro(ThreadPool, ThreadPoolGlobals, PimplGlobals);
 
+namespace
+{
+// Index of the work queue owned by the calling thread, or
+// NumericTraits<ThreadIdType>::max() if it is not a thread of the pool.
+thread_local ThreadIdType currentWorkerIndex = NumericTraits<ThreadIdType>::max();
+
+// Identifier of the job which the calling thread is executing, or zero.
+thread_local SizeValueType currentTaskId = 0;
+
+#if defined(ITK_THREAD_POOL_HAS_AFFINITY)
+// The processors available to the process, captured when the pool is created,
+// before any thread is bound: the mask of the calling thread is not the one of
+// the process once the calling thread is itself a bound thread of the pool.
+cpu_set_t processAffinity;
+bool      hasProcessAffinity = false;
+#endif
+
+void
+CaptureProcessAffinity()
+{
+#if defined(ITK_THREAD_POOL_HAS_AFFINITY)
+  CPU_ZERO(&processAffinity);
+  hasProcessAffinity = sched_getaffinity(0, sizeof(processAffinity), &processAffinity) == 0;
+#endif
+}
+
+// Bind the thread to the processor assigned to workerIndex, or to all the
+// processors available to the process if bind is false.
+void
+SetThreadAffinity(std::thread & thread, ThreadIdType workerIndex, bool bind)
+{
+#if defined(ITK_THREAD_POOL_HAS_AFFINITY)
+  if (!hasProcessAffinity)
+  {
+    return;
+  }
+  const cpu_set_t & available = processAffinity;
+  cpu_set_t         processors;
+  CPU_ZERO(&processors);
+  if (bind)
+  {
+    const int numberOfProcessors = CPU_COUNT(&available);
+    if (numberOfProcessors == 0)
+    {
+      return;
+    }
+    // Take the n-th available processor, counting round-robin
+    int n = static_cast<int>(workerIndex % static_cast<ThreadIdType>(numberOfProcessors));
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+      if (CPU_ISSET(cpu, &available) && n-- == 0)
+      {
+        CPU_SET(cpu, &processors);
+        break;
+      }
+    }
+  }
+  else
+  {
+    processors = available;
+  }
+  pthread_setaffinity_np(thread.native_handle(), sizeof(processors), &processors);
+#else
+  (void)thread;
+  (void)workerIndex;
+  (void)bind;
+#endif
+}
+} // namespace
+
 ThreadPool::Pointer
 ThreadPool::New()
 {
@@ -77,6 +153,7 @@ ThreadPool::GetInstance()
 
   // Create a singleton ThreadPool.
   std::call_once(m_PimplGlobals->m_ThreadPoolOnceFlag, []() {
+    CaptureProcessAffinity();
     m_PimplGlobals->m_ThreadPoolInstance = ObjectFactory<Self>::Create();
     if (m_PimplGlobals->m_ThreadPoolInstance.IsNull())
     {
@@ -111,11 +188,14 @@ ThreadPool::ThreadPool()
 
   m_PimplGlobals->m_ThreadPoolInstance = this;        // threads need this
   m_PimplGlobals->m_ThreadPoolInstance->UnRegister(); // Remove extra reference
-  const ThreadIdType threadCount = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  m_WorkQueues = std::make_unique<WorkQueue[]>(ITK_MAX_THREADS);
+  const ThreadIdType threadCount =
+    std::min<ThreadIdType>(MultiThreaderBase::GetGlobalDefaultNumberOfThreads(), ITK_MAX_THREADS);
   m_Threads.reserve(threadCount);
+  m_NumberOfWorkQueues = threadCount;
   for (ThreadIdType i = 0; i < threadCount; ++i)
   {
-    m_Threads.emplace_back(&ThreadPool::ThreadExecute);
+    m_Threads.emplace_back(&ThreadPool::ThreadExecute, i);
   }
 }
 
@@ -123,13 +203,43 @@ void
 ThreadPool::AddThreads(ThreadIdType count)
 {
   const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  const auto firstIndex = static_cast<ThreadIdType>(m_Threads.size());
+  count = std::min<ThreadIdType>(count, ITK_MAX_THREADS - firstIndex);
   m_Threads.reserve(m_Threads.size() + count);
+  // The queues must be visible before the threads start stealing from them
+  m_NumberOfWorkQueues = firstIndex + count;
   for (ThreadIdType i = 0; i < count; ++i)
   {
-    m_Threads.emplace_back(&ThreadPool::ThreadExecute);
+    m_Threads.emplace_back(&ThreadPool::ThreadExecute, firstIndex + i);
+    if (m_UseThreadAffinity)
+    {
+      SetThreadAffinity(m_Threads.back(), firstIndex + i, true);
+    }
+  }
+}
+
+void
+ThreadPool::SetUseThreadAffinity(bool useThreadAffinity)
+{
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  if (m_UseThreadAffinity == useThreadAffinity)
+  {
+    return;
+  }
+  m_UseThreadAffinity = useThreadAffinity;
+  for (ThreadIdType i = 0; i < m_Threads.size(); ++i)
+  {
+    SetThreadAffinity(m_Threads[i], i, useThreadAffinity);
   }
 }
 
+bool
+ThreadPool::GetUseThreadAffinity() const
+{
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+  return m_UseThreadAffinity;
+}
+
 std::mutex &
 ThreadPool::GetMutex() const
 {
@@ -140,7 +250,121 @@ int
 ThreadPool::GetNumberOfCurrentlyIdleThreads() const
 {
   const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
-  return static_cast<int>(m_Threads.size()) - static_cast<int>(m_WorkQueue.size()); // lousy approximation
+  return static_cast<int>(m_Threads.size()) - static_cast<int>(m_NumberOfPendingTasks); // lousy approximation
+}
+
+bool
+ThreadPool::IsCurrentThreadInPool()
+{
+  return currentWorkerIndex != NumericTraits<ThreadIdType>::max();
+}
+
+void
+ThreadPool::SubmitTask(std::function<void()> && task)
+{
+  const ThreadIdType numberOfQueues = std::max<ThreadIdType>(m_NumberOfWorkQueues, 1);
+  // Nested work stays with the submitting thread, other work is spread out
+  const ThreadIdType queueIndex = (currentWorkerIndex < numberOfQueues)
+                                    ? currentWorkerIndex
+                                    : m_NextWorkQueue.fetch_add(1, std::memory_order_relaxed) % numberOfQueues;
+  Task job;
+  job.m_Function = std::move(task);
+  job.m_Id = m_NextTaskId.fetch_add(1, std::memory_order_relaxed);
+  job.m_ParentId = currentTaskId;
+  {
+    WorkQueue &                       queue = m_WorkQueues[queueIndex];
+    const std::lock_guard<std::mutex> lockGuard(queue.m_Mutex);
+    // Counted before it can be popped, which decrements the count
+    ++m_NumberOfPendingTasks;
+    queue.m_Jobs.emplace_back(std::move(job));
+  }
+
+  // A thread about to sleep increments m_NumberOfSleepingThreads before it checks
+  // m_NumberOfPendingTasks, so at least one of the two sides sees the other.
+  if (m_NumberOfSleepingThreads > 0)
+  {
+    {
+      const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->m_Mutex);
+    }
+    m_Condition.notify_one();
+  }
+}
+
+bool
+ThreadPool::PopTask(ThreadIdType workerIndex, Task & task)
+{
+  {
+    WorkQueue &                       queue = m_WorkQueues[workerIndex];
+    const std::lock_guard<std::mutex> lockGuard(queue.m_Mutex);
+    if (!queue.m_Jobs.empty())
+    {
+      task = std::move(queue.m_Jobs.back());
+      queue.m_Jobs.pop_back();
+      --m_NumberOfPendingTasks;
+      return true;
+    }
+  }
+
+  const ThreadIdType numberOfQueues = m_NumberOfWorkQueues;
+  for (ThreadIdType offset = 1; offset < numberOfQueues; ++offset)
+  {
+    WorkQueue &                        victim = m_WorkQueues[(workerIndex + offset) % numberOfQueues];
+    const std::unique_lock<std::mutex> lock(victim.m_Mutex, std::try_to_lock);
+    if (lock.owns_lock() && !victim.m_Jobs.empty())
+    {
+      task = std::move(victim.m_Jobs.front());
+      victim.m_Jobs.pop_front();
+      --m_NumberOfPendingTasks;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+ThreadPool::ExecuteLocalTask()
+{
+  if (currentWorkerIndex >= m_NumberOfWorkQueues)
+  {
+    return false;
+  }
+
+  // Only the nested work of the current job is run: an unrelated job could
+  // take arbitrarily long, or wait itself for the job that is waiting here.
+  if (currentTaskId == 0)
+  {
+    return false;
+  }
+
+  Task task;
+  {
+    WorkQueue &                       queue = m_WorkQueues[currentWorkerIndex];
+    const std::lock_guard<std::mutex> lockGuard(queue.m_Mutex);
+    // The nested work is usually at the back, unless jobs from outside the
+    // pool were queued since.
+    const auto it = std::find_if(queue.m_Jobs.rbegin(), queue.m_Jobs.rend(), [](const Task & job) {
+      return job.m_ParentId == currentTaskId;
+    });
+    if (it == queue.m_Jobs.rend())
+    {
+      return false;
+    }
+    task = std::move(*it);
+    queue.m_Jobs.erase(std::next(it).base());
+  }
+  --m_NumberOfPendingTasks;
+
+  RunTask(task);
+  return true;
+}
+
+void
+ThreadPool::RunTask(Task & task)
+{
+  const SizeValueType parentTaskId = currentTaskId;
+  currentTaskId = task.m_Id;
+  task.m_Function();
+  currentTaskId = parentTaskId;
 }
 
 void
@@ -182,33 +406,43 @@ ThreadPool::ResumeFromFork()
   ThreadPool *       instance = m_PimplGlobals->m_ThreadPoolInstance.GetPointer();
   const ThreadIdType threadCount = instance->m_Threads.size();
   instance->m_Threads.clear();
+  instance->m_NumberOfWorkQueues = 0;
   instance->m_Stopping = false;
   instance->AddThreads(threadCount);
 }
 
 void
-ThreadPool::ThreadExecute()
+ThreadPool::ThreadExecute(ThreadIdType workerIndex)
 {
   // plain pointer does not increase reference count
   ThreadPool * threadPool = m_PimplGlobals->m_ThreadPoolInstance.GetPointer();
+  currentWorkerIndex = workerIndex;
 
   while (true)
   {
-    std::function<void()> task;
-
+    Task task;
+    if (threadPool->PopTask(workerIndex, task))
     {
-      std::unique_lock<std::mutex> mutexHolder(m_PimplGlobals->m_Mutex);
-      threadPool->m_Condition.wait(mutexHolder,
-                                   [threadPool] { return threadPool->m_Stopping || !threadPool->m_WorkQueue.empty(); });
-      if (threadPool->m_Stopping && threadPool->m_WorkQueue.empty())
-      {
-        return;
-      }
-      task = std::move(threadPool->m_WorkQueue.front());
-      threadPool->m_WorkQueue.pop_front();
+      RunTask(task);
+      continue;
+    }
+    if (threadPool->m_NumberOfPendingTasks > 0)
+    {
+      // The queues which have jobs are locked by other threads: back off
+      // instead of spinning on their locks.
+      std::this_thread::yield();
+      continue;
     }
 
-    task(); // execute the task
+    std::unique_lock<std::mutex> mutexHolder(m_PimplGlobals->m_Mutex);
+    ++threadPool->m_NumberOfSleepingThreads;
+    threadPool->m_Condition.wait(
+      mutexHolder, [threadPool] { return threadPool->m_Stopping || threadPool->m_NumberOfPendingTasks > 0; });
+    --threadPool->m_NumberOfSleepingThreads;
+    if (threadPool->m_Stopping && threadPool->m_NumberOfPendingTasks == 0)
+    {
+      return;
+    }
   }
 }
 
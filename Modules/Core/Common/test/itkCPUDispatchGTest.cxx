@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkCPUDispatch.h"
+#include <gtest/gtest.h>
+#include <algorithm> // For find.
+#include <numeric>   // For iota.
+#include <sstream>
+
+
+namespace
+{
+using InstructionSetEnum = itk::CPUDispatchEnums::InstructionSet;
+
+// Restores the maximum instruction set at the end of a test.
+class MaximumInstructionSetGuard
+{
+public:
+  MaximumInstructionSetGuard()
+    : m_Maximum(itk::CPUDispatch::GetMaximumInstructionSet())
+  {}
+  ~MaximumInstructionSetGuard() { itk::CPUDispatch::SetMaximumInstructionSet(m_Maximum); }
+
+private:
+  const InstructionSetEnum m_Maximum;
+};
+
+int
+GenericVariant()
+{
+  return 0;
+}
+
+int
+AVX2Variant()
+{
+  return 2;
+}
+
+// A kernel compiled for all the instruction sets by CPUDispatchTable::FromKernel.
+struct SumOfProductsKernel
+{
+  template <InstructionSetEnum>
+  static ITK_CPU_DISPATCH_INLINE int64_t
+  Run(const int32_t * input1, const int32_t * input2, size_t numberOfElements)
+  {
+    int64_t sum = 0;
+    for (size_t i = 0; i < numberOfElements; ++i)
+    {
+      sum += int64_t{ input1[i] } * input2[i];
+    }
+    return sum;
+  }
+};
+} // namespace
+
+
+TEST(CPUDispatch, ConvertsInstructionSetsToStringsAndBack)
+{
+  for (const auto instructionSet :
+       { InstructionSetEnum::Generic, InstructionSetEnum::SSE41, InstructionSetEnum::AVX2, InstructionSetEnum::AVX512 })
+  {
+    EXPECT_EQ(itk::CPUDispatch::InstructionSetFromString(itk::CPUDispatch::InstructionSetToString(instructionSet)),
+              instructionSet);
+  }
+  EXPECT_EQ(itk::CPUDispatch::InstructionSetFromString("avx2"), InstructionSetEnum::AVX2);
+  EXPECT_THROW(itk::CPUDispatch::InstructionSetFromString("AVX3"), itk::ExceptionObject);
+}
+
+
+// Tests that the instruction set is the host one, limited by the maximum.
+TEST(CPUDispatch, LimitsInstructionSetToMaximum)
+{
+  const MaximumInstructionSetGuard guard;
+
+  const InstructionSetEnum host = itk::CPUDispatch::GetHostInstructionSet();
+#ifndef ITK_CPU_DISPATCH_HAS_TARGETS
+  EXPECT_EQ(host, InstructionSetEnum::Generic);
+#endif
+
+  itk::CPUDispatch::SetMaximumInstructionSet(InstructionSetEnum::AVX512);
+  EXPECT_EQ(itk::CPUDispatch::GetInstructionSet(), host);
+
+  itk::CPUDispatch::SetMaximumInstructionSet(InstructionSetEnum::Generic);
+  EXPECT_EQ(itk::CPUDispatch::GetMaximumInstructionSet(), InstructionSetEnum::Generic);
+  EXPECT_EQ(itk::CPUDispatch::GetInstructionSet(), InstructionSetEnum::Generic);
+
+  itk::CPUDispatch::SetMaximumInstructionSet(InstructionSetEnum::SSE41);
+  EXPECT_EQ(itk::CPUDispatch::GetInstructionSet(), std::min(host, InstructionSetEnum::SSE41));
+}
+
+
+// Tests that a table calls the best available variant which does not exceed the instruction set.
+TEST(CPUDispatch, TableSelectsBestAvailableVariant)
+{
+  const MaximumInstructionSetGuard guard;
+
+  const itk::CPUDispatchTable<int()> table("CPUDispatchGTest.Selection", &GenericVariant, nullptr, &AVX2Variant);
+  EXPECT_EQ(std::string(table.GetName()), "CPUDispatchGTest.Selection");
+  EXPECT_EQ(table.GetVariant(InstructionSetEnum::SSE41), nullptr);
+
+  itk::CPUDispatch::SetMaximumInstructionSet(InstructionSetEnum::Generic);
+  EXPECT_EQ(table.GetSelectedInstructionSet(), InstructionSetEnum::Generic);
+  EXPECT_EQ(table(), 0);
+
+  itk::CPUDispatch::SetMaximumInstructionSet(InstructionSetEnum::AVX512);
+  const InstructionSetEnum expected =
+    itk::CPUDispatch::GetHostInstructionSet() >= InstructionSetEnum::AVX2 ? InstructionSetEnum::AVX2
+                                                                          : InstructionSetEnum::Generic;
+  EXPECT_EQ(table.GetSelectedInstructionSet(), expected);
+  EXPECT_EQ(table(), expected == InstructionSetEnum::AVX2 ? 2 : 0);
+
+  EXPECT_THROW(itk::CPUDispatchTable<int()>("CPUDispatchGTest.NoGenericVariant", nullptr), itk::ExceptionObject);
+}
+
+
+// Tests that the variants of a kernel compiled for each instruction set give the same result.
+TEST(CPUDispatch, KernelVariantsGiveSameResults)
+{
+  const MaximumInstructionSetGuard guard;
+
+  using FunctionType = int64_t(const int32_t *, const int32_t *, size_t);
+  const auto table = itk::CPUDispatchTable<FunctionType>::FromKernel<SumOfProductsKernel>("CPUDispatchGTest.Kernel");
+
+  std::vector<int32_t> input1(1001);
+  std::vector<int32_t> input2(input1.size());
+  std::iota(input1.begin(), input1.end(), -500);
+  std::iota(input2.begin(), input2.end(), 7);
+  const int64_t expected = SumOfProductsKernel::Run<InstructionSetEnum::Generic>(input1.data(), input2.data(), 1001);
+
+  for (const auto instructionSet :
+       { InstructionSetEnum::Generic, InstructionSetEnum::SSE41, InstructionSetEnum::AVX2, InstructionSetEnum::AVX512 })
+  {
+    if (instructionSet > itk::CPUDispatch::GetHostInstructionSet())
+    {
+      break;
+    }
+    itk::CPUDispatch::SetMaximumInstructionSet(instructionSet);
+    EXPECT_EQ(table.GetSelectedInstructionSet(), instructionSet);
+    EXPECT_EQ(table(input1.data(), input2.data(), input1.size()), expected);
+  }
+}
+
+
+// Tests that the tables register their kernels.
+TEST(CPUDispatch, RegistersKernels)
+{
+  const MaximumInstructionSetGuard guard;
+
+  const itk::CPUDispatchTable<int()> table("CPUDispatchGTest.Registry", &GenericVariant, nullptr, &AVX2Variant);
+
+  const std::vector<std::string> names = itk::CPUDispatch::GetRegisteredKernelNames();
+  EXPECT_NE(std::find(names.cbegin(), names.cend(), "CPUDispatchGTest.Registry"), names.cend());
+  EXPECT_EQ(itk::CPUDispatch::GetKernelVariants("CPUDispatchGTest.Registry"),
+            (std::vector<InstructionSetEnum>{ InstructionSetEnum::Generic, InstructionSetEnum::AVX2 }));
+
+  itk::CPUDispatch::SetMaximumInstructionSet(InstructionSetEnum::Generic);
+  EXPECT_EQ(itk::CPUDispatch::GetSelectedKernelVariant("CPUDispatchGTest.Registry"), InstructionSetEnum::Generic);
+  EXPECT_THROW(itk::CPUDispatch::GetKernelVariants("CPUDispatchGTest.Unknown"), itk::ExceptionObject);
+
+  std::ostringstream os;
+  itk::CPUDispatch::Print(os);
+  EXPECT_NE(os.str().find("CPUDispatchGTest.Registry: GENERIC"), std::string::npos);
+}
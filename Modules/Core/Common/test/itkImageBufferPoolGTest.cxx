@@ -0,0 +1,169 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkImageBufferPool.h"
+#include "itkImage.h"
+#include "itkVectorImage.h"
+#include <gtest/gtest.h>
+#include <algorithm> // For all_of.
+#include <string>
+
+
+// Tests that the bucket of a request is at least as large as the request, and wastes at most an eighth of it.
+TEST(ImageBufferPool, GetBucketSize)
+{
+  EXPECT_EQ(itk::ImageBufferPool::GetBucketSize(0), 64u);
+  EXPECT_EQ(itk::ImageBufferPool::GetBucketSize(1), 64u);
+  EXPECT_EQ(itk::ImageBufferPool::GetBucketSize(65), 128u);
+  EXPECT_EQ(itk::ImageBufferPool::GetBucketSize(1024), 1024u);
+  EXPECT_EQ(itk::ImageBufferPool::GetBucketSize(1025), 1152u);
+
+  for (itk::SizeValueType numberOfBytes = 1; numberOfBytes < 100000000; numberOfBytes = numberOfBytes * 3 + 1)
+  {
+    const itk::SizeValueType bucketSize = itk::ImageBufferPool::GetBucketSize(numberOfBytes);
+    EXPECT_GE(bucketSize, numberOfBytes);
+    if (numberOfBytes > 512)
+    {
+      EXPECT_LE(bucketSize - numberOfBytes, numberOfBytes / 8);
+    }
+    EXPECT_EQ(itk::ImageBufferPool::GetBucketSize(bucketSize), bucketSize);
+  }
+}
+
+
+// Tests the statistics of a sequence of acquisitions and releases.
+TEST(ImageBufferPool, CountsHitsMissesAndBytesHeld)
+{
+  const auto pool = itk::ImageBufferPool::New();
+
+  void * const first = pool->Acquire(1000);
+  EXPECT_EQ(pool->GetNumberOfMisses(), 1u);
+  EXPECT_EQ(pool->GetNumberOfHits(), 0u);
+  EXPECT_EQ(pool->GetNumberOfBytesHeld(), 0u);
+
+  pool->Release(first, 1000);
+  EXPECT_EQ(pool->GetNumberOfBytesHeld(), itk::ImageBufferPool::GetBucketSize(1000));
+
+  // A slightly smaller request of the same bucket reuses the block.
+  void * const second = pool->Acquire(990);
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(pool->GetNumberOfHits(), 1u);
+  EXPECT_EQ(pool->GetNumberOfBytesHeld(), 0u);
+
+  // A request of another bucket does not.
+  void * const third = pool->Acquire(100000);
+  EXPECT_EQ(pool->GetNumberOfMisses(), 2u);
+
+  pool->Release(second, 990);
+  pool->Release(third, 100000);
+  EXPECT_EQ(pool->GetNumberOfBytesHeld(),
+            itk::ImageBufferPool::GetBucketSize(1000) + itk::ImageBufferPool::GetBucketSize(100000));
+
+  pool->ResetStatistics();
+  EXPECT_EQ(pool->GetNumberOfHits(), 0u);
+  EXPECT_EQ(pool->GetNumberOfMisses(), 0u);
+
+  pool->Clear();
+  EXPECT_EQ(pool->GetNumberOfBytesHeld(), 0u);
+}
+
+
+// Tests that the pool never holds more than its maximum, and frees the largest blocks first when it is lowered.
+TEST(ImageBufferPool, RespectsMaximumNumberOfBytesHeld)
+{
+  const auto pool = itk::ImageBufferPool::New();
+
+  void * const small = pool->Acquire(1024);
+  void * const large = pool->Acquire(4096);
+  pool->Release(small, 1024);
+  pool->Release(large, 4096);
+  ASSERT_EQ(pool->GetNumberOfBytesHeld(), 1024u + 4096u);
+
+  pool->SetMaximumNumberOfBytesHeld(2048);
+  EXPECT_EQ(pool->GetMaximumNumberOfBytesHeld(), 2048u);
+  EXPECT_EQ(pool->GetNumberOfBytesHeld(), 1024u);
+
+  // The block which does not fit is freed instead of held.
+  void * const other = pool->Acquire(4096);
+  pool->Release(other, 4096);
+  EXPECT_EQ(pool->GetNumberOfBytesHeld(), 1024u);
+
+  EXPECT_EQ(pool->Acquire(1024), small);
+  pool->Release(small, 1024);
+}
+
+
+// Tests that the outputs of a pipeline updated repeatedly reuse their previous buffers, as the image keeps its pool
+// when it is initialized, and that the reused buffers are correctly value-initialized.
+TEST(ImageBufferPool, ImageReusesReleasedBuffer)
+{
+  using ImageType = itk::Image<float, 3>;
+
+  const auto pool = itk::ImageBufferPool::New();
+  const auto image = ImageType::New();
+  image->GetPixelContainer()->SetBufferPool(pool);
+  image->SetRegions(ImageType::SizeType::Filled(32));
+
+  for (unsigned int update = 0; update < 4; ++update)
+  {
+    image->Initialize();
+    image->SetRegions(ImageType::SizeType::Filled(32));
+    image->AllocateInitialized();
+    EXPECT_EQ(image->GetPixelContainer()->GetBufferPool(), pool);
+
+    const float * const begin = image->GetBufferPointer();
+    EXPECT_TRUE(std::all_of(begin, begin + image->GetPixelContainer()->Size(), [](float pixel) { return pixel == 0; }));
+    image->FillBuffer(1.0f);
+  }
+  EXPECT_EQ(pool->GetNumberOfMisses(), 1u);
+  EXPECT_EQ(pool->GetNumberOfHits(), 3u);
+
+  // Replacing the pool does not change the pool to which the current buffer goes back.
+  image->GetPixelContainer()->SetBufferPool(nullptr);
+  image->Initialize();
+  EXPECT_EQ(pool->GetNumberOfBytesHeld(), itk::ImageBufferPool::GetBucketSize(32 * 32 * 32 * sizeof(float)));
+}
+
+
+// Tests that the global default pool is used by new images, including for element types which need construction.
+TEST(ImageBufferPool, UsesGlobalDefaultBufferPool)
+{
+  using ImageType = itk::Image<std::string, 2>;
+
+  const auto pool = itk::ImageBufferPool::New();
+  itk::ImportImageContainerCommon::SetGlobalDefaultBufferPool(pool);
+  {
+    const auto image = ImageType::New();
+    image->SetRegions(ImageType::SizeType::Filled(8));
+    image->Allocate();
+    image->FillBuffer("a string which is too long for the small string optimization");
+
+    const auto vectorImage = itk::VectorImage<double, 2>::New();
+    vectorImage->SetRegions(itk::VectorImage<double, 2>::SizeType::Filled(8));
+    vectorImage->SetNumberOfComponentsPerPixel(3);
+    vectorImage->Allocate();
+  }
+  itk::ImportImageContainerCommon::SetGlobalDefaultBufferPool(nullptr);
+
+  EXPECT_EQ(pool->GetNumberOfMisses(), 2u);
+  EXPECT_EQ(pool->GetNumberOfBytesHeld(),
+            itk::ImageBufferPool::GetBucketSize(8 * 8 * sizeof(std::string)) +
+              itk::ImageBufferPool::GetBucketSize(8 * 8 * 3 * sizeof(double)));
+  EXPECT_EQ(itk::ImportImageContainerCommon::GetGlobalDefaultBufferPool(), nullptr);
+}
@@ -0,0 +1,174 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkImportImageContainer.h"
+#include "itkImage.h"
+#include "itkThreadPool.h"
+#include <gtest/gtest.h>
+#include <algorithm> // For all_of.
+#include <cstdint>
+#include <string>
+
+
+namespace
+{
+template <typename TElement>
+bool
+IsZeroFilled(itk::ImportImageContainer<itk::SizeValueType, TElement> & container)
+{
+  const TElement * const begin = container.GetBufferPointer();
+  return std::all_of(begin, begin + container.Size(), [](const TElement element) { return element == TElement{}; });
+}
+
+bool
+IsAligned(const void * const pointer, const std::uintptr_t alignment)
+{
+  return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+} // namespace
+
+
+// Tests that value initialization zero-fills the buffer when it is done in parallel, for buffers both smaller and
+// larger than the size from which multiple threads are used.
+TEST(ImportImageContainer, ParallelFirstTouchValueInitializes)
+{
+  using ContainerType = itk::ImportImageContainer<itk::SizeValueType, double>;
+
+  for (const itk::SizeValueType size : { itk::SizeValueType{ 10 }, itk::SizeValueType{ 1000000 } })
+  {
+    const auto container = ContainerType::New();
+    container->ParallelFirstTouchOn();
+    container->Reserve(size, true);
+    ASSERT_EQ(container->Size(), size);
+    EXPECT_TRUE(IsZeroFilled(*container));
+  }
+}
+
+
+// Tests that the global default is used at construction time.
+TEST(ImportImageContainer, UsesGlobalDefaultParallelFirstTouch)
+{
+  using ContainerType = itk::ImportImageContainer<itk::SizeValueType, short>;
+
+  EXPECT_FALSE(ContainerType::New()->GetParallelFirstTouch());
+
+  itk::ImportImageContainerCommon::SetGlobalDefaultParallelFirstTouch(true);
+  EXPECT_TRUE(ContainerType::New()->GetParallelFirstTouch());
+  itk::ImportImageContainerCommon::SetGlobalDefaultParallelFirstTouch(false);
+  EXPECT_FALSE(ContainerType::New()->GetParallelFirstTouch());
+}
+
+
+// Tests that an image keeps the allocation settings of its buffer when it is initialized, as it happens to the output
+// of a filter each time the pipeline is updated.
+TEST(ImportImageContainer, ImageKeepsAllocationSettingsOnInitialize)
+{
+  using ImageType = itk::Image<float, 3>;
+
+  const auto image = ImageType::New();
+  image->GetPixelContainer()->ParallelFirstTouchOn();
+  image->SetRegions(ImageType::SizeType::Filled(64));
+  image->AllocateInitialized();
+  EXPECT_TRUE(IsZeroFilled(*image->GetPixelContainer()));
+
+  image->Initialize();
+  EXPECT_TRUE(image->GetPixelContainer()->GetParallelFirstTouch());
+}
+
+
+// Tests that the threads of the pool can be bound to processors, and unbound again.
+TEST(ImportImageContainer, ParallelFirstTouchWithThreadAffinity)
+{
+  const auto threadPool = itk::ThreadPool::GetInstance();
+  threadPool->SetUseThreadAffinity(true);
+  EXPECT_TRUE(threadPool->GetUseThreadAffinity());
+
+  const auto container = itk::ImportImageContainer<itk::SizeValueType, int>::New();
+  container->ParallelFirstTouchOn();
+  container->Reserve(1 << 20, true);
+  EXPECT_TRUE(IsZeroFilled(*container));
+
+  threadPool->SetUseThreadAffinity(false);
+  EXPECT_FALSE(threadPool->GetUseThreadAffinity());
+}
+
+
+// Tests that the buffer has the alignment of the allocation policy, and is value-initialized, both when it is allocated
+// and when it is grown by Reserve or shrunk by Squeeze.
+TEST(ImportImageContainer, AllocationPolicyAlignsBuffer)
+{
+  using ContainerType = itk::ImportImageContainer<itk::SizeValueType, float>;
+  using AllocationPolicyEnum = itk::ImportImageContainerEnums::AllocationPolicy;
+
+  const auto container = ContainerType::New();
+  EXPECT_EQ(container->GetAllocationPolicy(), AllocationPolicyEnum::Default);
+
+  container->SetAllocationPolicy(AllocationPolicyEnum::Aligned);
+  container->Reserve(1001, true);
+  EXPECT_TRUE(IsAligned(container->GetBufferPointer(), 64));
+  EXPECT_TRUE(IsZeroFilled(*container));
+
+  // Large buffers are aligned to a huge page, small ones to a cache line.
+  container->SetAllocationPolicy(AllocationPolicyEnum::HugePages);
+  container->Reserve(itk::ImportImageContainerCommon::HugePageSize, true);
+  EXPECT_TRUE(IsAligned(container->GetBufferPointer(), itk::ImportImageContainerCommon::HugePageSize));
+  container->Reserve(100);
+  container->Squeeze();
+  EXPECT_TRUE(IsAligned(container->GetBufferPointer(), 64));
+
+  container->Initialize();
+  EXPECT_EQ(container->GetBufferPointer(), nullptr);
+}
+
+
+// Tests that element types which need construction and destruction are correctly handled by an allocation policy.
+TEST(ImportImageContainer, AllocationPolicyConstructsElements)
+{
+  using ContainerType = itk::ImportImageContainer<itk::SizeValueType, std::string>;
+
+  const auto container = ContainerType::New();
+  container->SetAllocationPolicy(itk::ImportImageContainerEnums::AllocationPolicy::HugePages);
+  container->Reserve(10);
+  EXPECT_TRUE(IsZeroFilled(*container));
+  (*container)[9] = "a string which is too long for the small string optimization";
+  container->Reserve(20);
+  EXPECT_EQ((*container)[9], "a string which is too long for the small string optimization");
+}
+
+
+// Tests that the global default policy is used at construction time, and kept by an image when it is initialized.
+TEST(ImportImageContainer, UsesGlobalDefaultAllocationPolicy)
+{
+  using ImageType = itk::Image<unsigned char, 2>;
+  using AllocationPolicyEnum = itk::ImportImageContainerEnums::AllocationPolicy;
+
+  itk::ImportImageContainerCommon::SetGlobalDefaultAllocationPolicy(AllocationPolicyEnum::Aligned);
+  const auto image = ImageType::New();
+  itk::ImportImageContainerCommon::SetGlobalDefaultAllocationPolicy(AllocationPolicyEnum::Default);
+  EXPECT_EQ(itk::ImportImageContainerCommon::GetGlobalDefaultAllocationPolicy(), AllocationPolicyEnum::Default);
+
+  for (unsigned int update = 0; update < 2; ++update)
+  {
+    image->Initialize();
+    image->SetRegions(ImageType::SizeType{ { 33, 17 } });
+    image->Allocate();
+    EXPECT_EQ(image->GetPixelContainer()->GetAllocationPolicy(), AllocationPolicyEnum::Aligned);
+    EXPECT_TRUE(IsAligned(image->GetBufferPointer(), 64));
+  }
+}
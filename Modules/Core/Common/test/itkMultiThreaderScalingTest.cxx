@@ -0,0 +1,168 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMultiThreaderBase.h"
+#include "itkThreadPool.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+#include <mutex>
+#include <set>
+#include <vector>
+
+// Runs ParallelizeImageRegion with many small work units, which stresses
+// the scheduling of the threaders, and checks that it computes the right
+// result, also in nested parallel sections (a threader used from within a
+// work unit of another threader).
+
+namespace
+{
+using ThreaderEnum = itk::MultiThreaderBase::ThreaderEnum;
+
+constexpr unsigned int Dimension = 3;
+
+// Cheap per-pixel work, so that the scheduling cost is significant.
+double
+ProcessRegion(const itk::IndexValueType index[], const itk::SizeValueType size[])
+{
+  double sum = 0.0;
+  for (itk::SizeValueType z = 0; z < size[2]; ++z)
+  {
+    for (itk::SizeValueType y = 0; y < size[1]; ++y)
+    {
+      for (itk::SizeValueType x = 0; x < size[0]; ++x)
+      {
+        sum += std::sqrt(static_cast<double>((index[0] + x) + (index[1] + y) + (index[2] + z)));
+      }
+    }
+  }
+  return sum;
+}
+
+double
+ParallelSum(itk::MultiThreaderBase * threader, const itk::SizeValueType size[])
+{
+  const itk::IndexValueType index[Dimension] = { 0, 0, 0 };
+  std::mutex                sumMutex;
+  double                    sum = 0.0;
+  threader->ParallelizeImageRegion(
+    Dimension,
+    index,
+    size,
+    [&sumMutex, &sum](const itk::IndexValueType subIndex[], const itk::SizeValueType subSize[]) {
+      const double                      partialSum = ProcessRegion(subIndex, subSize);
+      const std::lock_guard<std::mutex> lockGuard(sumMutex);
+      sum += partialSum;
+    },
+    nullptr);
+  return sum;
+}
+
+bool
+CheckNestedParallelism(ThreaderEnum threaderType, const itk::SizeValueType size[], double expected)
+{
+  itk::MultiThreaderBase::SetGlobalDefaultThreader(threaderType);
+  const itk::MultiThreaderBase::Pointer outer = itk::MultiThreaderBase::New();
+
+  // More outer work items than threads, and each of them uses all the threads again.
+  const itk::SizeValueType outerCount = 2 * itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads() + 1;
+  std::vector<double>      results(outerCount, 0.0);
+  outer->ParallelizeArray(
+    0,
+    outerCount,
+    [&results, size](itk::SizeValueType i) {
+      const itk::MultiThreaderBase::Pointer inner = itk::MultiThreaderBase::New();
+      results[i] = ParallelSum(inner, size);
+    },
+    nullptr);
+
+  bool ok = true;
+  for (const double result : results)
+  {
+    if (std::abs(result - expected) > 1e-6 * std::abs(expected))
+    {
+      std::cerr << "Nested parallel sum with " << threaderType << " is " << result << " instead of " << expected
+                << std::endl;
+      ok = false;
+    }
+  }
+  return ok;
+}
+} // namespace
+
+int
+itkMultiThreaderScalingTest(int argc, char * argv[])
+{
+  itk::SizeValueType size[Dimension] = { 64, 64, 256 };
+  if (argc > 1)
+  {
+    size[2] = static_cast<itk::SizeValueType>(std::stoi(argv[1]));
+  }
+
+  const itk::IndexValueType index[Dimension] = { 0, 0, 0 };
+  const double              expected = ProcessRegion(index, size);
+
+  const std::set<ThreaderEnum> threadersToTest = {
+    ThreaderEnum::Platform,
+    ThreaderEnum::Pool,
+#ifdef ITK_USE_TBB
+    ThreaderEnum::TBB,
+#endif // ITK_USE_TBB
+  };
+
+  const itk::ThreadIdType maximumNumberOfThreads = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  const ThreaderEnum      globalDefaultThreader = itk::MultiThreaderBase::GetGlobalDefaultThreader();
+
+  bool ok = true;
+  for (const auto threaderType : threadersToTest)
+  {
+    itk::MultiThreaderBase::SetGlobalDefaultThreader(threaderType);
+    const itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+
+    for (itk::ThreadIdType threads = 1; threads <= maximumNumberOfThreads; threads *= 2)
+    {
+      // Small work units, as produced by the default splitting of ParallelizeImageRegion
+      const itk::ThreadIdType workUnits = std::min<itk::ThreadIdType>(4 * threads, itk::ITK_MAX_THREADS);
+      threader->SetMaximumNumberOfThreads(threads);
+      threader->SetNumberOfWorkUnits(workUnits);
+
+      const double sum = ParallelSum(threader, size);
+      if (std::abs(sum - expected) > 1e-6 * std::abs(expected))
+      {
+        std::cerr << "Parallel sum with " << threaderType << " is " << sum << " instead of " << expected << std::endl;
+        ok = false;
+      }
+    }
+
+    ok &= CheckNestedParallelism(threaderType, size, expected);
+  }
+  itk::MultiThreaderBase::SetGlobalDefaultThreader(globalDefaultThreader);
+
+  // Once all the work is done, the count of pending tasks is back to zero
+  // rather than wrapped around, so all the threads of the pool are idle.
+  const itk::ThreadPool::Pointer pool = itk::ThreadPool::GetInstance();
+  ITK_TEST_EXPECT_EQUAL(pool->GetNumberOfCurrentlyIdleThreads(), static_cast<int>(pool->GetMaximumNumberOfThreads()));
+
+  if (!ok)
+  {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkMultiThreaderBase.h"
+#include "itkIndexRange.h"
+#include "itkPlatformMultiThreader.h"
+#include "itkPoolMultiThreader.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <sstream>
+#include <vector>
+
+
+namespace
+{
+using WorkSchedulingEnum = itk::MultiThreaderBaseEnums::WorkScheduling;
+
+// Checks that the regions passed to funcP cover each pixel of the requested region exactly once.
+template <unsigned int VDimension>
+void
+CheckCoverage(itk::MultiThreaderBase & multiThreader, const itk::ImageRegion<VDimension> & requestedRegion)
+{
+  std::vector<std::atomic<int>> counts(requestedRegion.GetNumberOfPixels());
+  std::atomic<int>              numberOfCalls{ 0 };
+
+  multiThreader.ParallelizeImageRegion<VDimension>(
+    requestedRegion,
+    [&](const itk::ImageRegion<VDimension> & region) {
+      ++numberOfCalls;
+      ASSERT_TRUE(requestedRegion.IsInside(region)) << region;
+      for (const auto & index : itk::ImageRegionIndexRange<VDimension>(region))
+      {
+        itk::SizeValueType offset = 0;
+        for (int d = VDimension - 1; d >= 0; --d)
+        {
+          offset = offset * requestedRegion.GetSize(d) + (index[d] - requestedRegion.GetIndex(d));
+        }
+        ++counts[offset];
+      }
+    },
+    nullptr);
+
+  for (size_t i = 0; i < counts.size(); ++i)
+  {
+    ASSERT_EQ(counts[i], 1) << "Pixel " << i << " of " << requestedRegion;
+  }
+  if (multiThreader.GetWorkScheduling() == WorkSchedulingEnum::Guided && requestedRegion.GetNumberOfPixels() >= 1000)
+  {
+    // Smaller and smaller chunks, at least two per thread.
+    EXPECT_GT(numberOfCalls, 2 * static_cast<int>(multiThreader.GetMaximumNumberOfThreads()));
+  }
+}
+
+template <typename TMultiThreader>
+void
+CheckCoverageOfRegions(WorkSchedulingEnum workScheduling)
+{
+  const auto multiThreader = TMultiThreader::New();
+  multiThreader->SetMaximumNumberOfThreads(4);
+  multiThreader->SetNumberOfWorkUnits(16);
+  multiThreader->SetWorkScheduling(workScheduling);
+
+  CheckCoverage(*multiThreader, itk::ImageRegion<1>({ { 5 } }, { { 1001 } }));
+  CheckCoverage(*multiThreader, itk::ImageRegion<2>({ { -3, 2 } }, { { 37, 200 } }));
+  CheckCoverage(*multiThreader, itk::ImageRegion<2>({ { 0, 0 } }, { { 1000, 3 } }));
+  CheckCoverage(*multiThreader, itk::ImageRegion<3>({ { 1, 2, 3 } }, { { 17, 19, 5 } }));
+  CheckCoverage(*multiThreader, itk::ImageRegion<3>({ { 0, 0, 0 } }, { { 2, 1, 1 } }));
+  CheckCoverage(*multiThreader, itk::ImageRegion<4>({ { 0, 0, 0, 0 } }, { { 3, 4, 5, 6 } }));
+}
+} // namespace
+
+
+TEST(MultiThreaderWorkScheduling, CoversRegions)
+{
+  for (const auto workScheduling : { WorkSchedulingEnum::Static, WorkSchedulingEnum::Guided })
+  {
+    CheckCoverageOfRegions<itk::PlatformMultiThreader>(workScheduling);
+    CheckCoverageOfRegions<itk::PoolMultiThreader>(workScheduling);
+  }
+}
+
+
+TEST(MultiThreaderWorkScheduling, PropagatesExceptions)
+{
+  const itk::MultiThreaderBase::Pointer multiThreader = itk::PoolMultiThreader::New();
+  multiThreader->SetMaximumNumberOfThreads(4);
+  multiThreader->SetWorkScheduling(WorkSchedulingEnum::Guided);
+
+  std::atomic<int> numberOfCalls{ 0 };
+  EXPECT_THROW(multiThreader->ParallelizeImageRegion<2>(
+                 itk::ImageRegion<2>({ { 0, 0 } }, { { 100, 100 } }),
+                 [&numberOfCalls](const itk::ImageRegion<2> &) {
+                   ++numberOfCalls;
+                   itkGenericExceptionMacro("Failed chunk");
+                 },
+                 nullptr),
+               itk::ExceptionObject);
+  // Each thread stops at its first failure.
+  EXPECT_LE(numberOfCalls, 4);
+}
+
+
+TEST(MultiThreaderWorkScheduling, InitializesWithGlobalDefault)
+{
+  const WorkSchedulingEnum globalDefault = itk::MultiThreaderBase::GetGlobalDefaultWorkScheduling();
+
+  itk::MultiThreaderBase::SetGlobalDefaultWorkScheduling(WorkSchedulingEnum::Guided);
+  EXPECT_EQ(itk::PoolMultiThreader::New()->GetWorkScheduling(), WorkSchedulingEnum::Guided);
+  itk::MultiThreaderBase::SetGlobalDefaultWorkScheduling(WorkSchedulingEnum::Static);
+  EXPECT_EQ(itk::PoolMultiThreader::New()->GetWorkScheduling(), WorkSchedulingEnum::Static);
+
+  itk::MultiThreaderBase::SetGlobalDefaultWorkScheduling(globalDefault);
+
+  std::ostringstream os;
+  os << WorkSchedulingEnum::Guided;
+  EXPECT_EQ(os.str(), "itk::MultiThreaderBaseEnums::WorkScheduling::Guided");
+}
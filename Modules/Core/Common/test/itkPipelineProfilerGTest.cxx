@@ -0,0 +1,190 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkPipelineProfiler.h"
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageSource.h"
+#include "itkStreamingImageFilter.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+
+namespace
+{
+using ImageType = itk::Image<float, 2>;
+
+// A source which fills its output with the sum of the index of each pixel.
+class IndexSumSource : public itk::ImageSource<ImageType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(IndexSumSource);
+
+  using Self = IndexSumSource;
+  using Superclass = itk::ImageSource<ImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(IndexSumSource);
+
+protected:
+  IndexSumSource() = default;
+
+  void
+  GenerateOutputInformation() override
+  {
+    Superclass::GenerateOutputInformation();
+    this->GetOutput()->SetLargestPossibleRegion(ImageType::RegionType(ImageType::SizeType{ { 64, 64 } }));
+  }
+
+  void
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegion) override
+  {
+    for (itk::ImageRegionIterator<ImageType> it(this->GetOutput(), outputRegion); !it.IsAtEnd(); ++it)
+    {
+      it.Set(static_cast<float>(it.GetIndex()[0] + it.GetIndex()[1]));
+    }
+  }
+};
+
+// Updates a source streamed in four pieces.
+void
+UpdateStreamedPipeline(const char * sourceName = "")
+{
+  const auto source = IndexSumSource::New();
+  source->SetObjectName(sourceName);
+  source->SetNumberOfWorkUnits(2);
+  const auto streamer = itk::StreamingImageFilter<ImageType, ImageType>::New();
+  streamer->SetInput(source->GetOutput());
+  streamer->SetNumberOfStreamDivisions(4);
+  streamer->Update();
+}
+} // namespace
+
+
+TEST(PipelineProfiler, RecordsOnlyWhileActive)
+{
+  const auto profiler = itk::PipelineProfiler::New();
+  EXPECT_FALSE(profiler->IsActive());
+  UpdateStreamedPipeline();
+  EXPECT_TRUE(profiler->GetExecutions().empty());
+
+  profiler->Start();
+  EXPECT_TRUE(profiler->IsActive());
+  EXPECT_EQ(itk::PipelineProfiler::GetActiveProfiler(), profiler.GetPointer());
+  UpdateStreamedPipeline();
+  profiler->Stop();
+  EXPECT_FALSE(profiler->IsActive());
+  EXPECT_EQ(itk::PipelineProfiler::GetActiveProfiler(), nullptr);
+  const size_t numberOfExecutions = profiler->GetExecutions().size();
+  EXPECT_GT(numberOfExecutions, 0u);
+
+  UpdateStreamedPipeline();
+  EXPECT_EQ(profiler->GetExecutions().size(), numberOfExecutions);
+
+  profiler->Clear();
+  EXPECT_TRUE(profiler->GetExecutions().empty());
+}
+
+
+// Tests that each streamed piece of the source is an execution nested in the one of the streaming filter.
+TEST(PipelineProfiler, RecordsStreamedExecutions)
+{
+  const auto profiler = itk::PipelineProfiler::New();
+  profiler->Start();
+  UpdateStreamedPipeline();
+  profiler->Stop();
+
+  const std::vector<itk::PipelineProfiler::FilterExecution> executions = profiler->GetExecutions();
+  ASSERT_EQ(executions.size(), 5u);
+
+  const itk::PipelineProfiler::FilterExecution & streamerExecution = executions[0];
+  EXPECT_EQ(streamerExecution.NameOfClass, "StreamingImageFilter");
+  EXPECT_EQ(streamerExecution.ParentIndex, itk::PipelineProfiler::NoParent);
+  EXPECT_EQ(streamerExecution.Depth, 0u);
+  EXPECT_EQ(streamerExecution.NumberOfStreamingPieces, 4u);
+  EXPECT_EQ(streamerExecution.AllocatedBytes, 64u * 64u * sizeof(float));
+
+  for (size_t i = 1; i < executions.size(); ++i)
+  {
+    const itk::PipelineProfiler::FilterExecution & execution = executions[i];
+    EXPECT_EQ(execution.Name, "IndexSumSource");
+    EXPECT_EQ(execution.ParentIndex, 0u);
+    EXPECT_EQ(execution.Depth, 1u);
+    // The later pieces reuse the buffer of the first one.
+    EXPECT_EQ(execution.AllocatedBytes, i == 1 ? 64u * 16u * sizeof(float) : 0u);
+    EXPECT_GE(execution.WorkChunks.size(), 1u);
+    EXPECT_GE(execution.StartTime, streamerExecution.StartTime);
+    EXPECT_LE(execution.StartTime + execution.Duration, streamerExecution.StartTime + streamerExecution.Duration);
+  }
+
+  const std::vector<itk::PipelineProfiler::FilterSummary> summaries = profiler->GetFilterSummaries();
+  ASSERT_EQ(summaries.size(), 2u);
+  EXPECT_EQ(summaries[0].NumberOfExecutions, 1u);
+  EXPECT_LT(summaries[0].SelfTime, summaries[0].TotalTime);
+  EXPECT_EQ(summaries[1].NumberOfExecutions, 4u);
+  EXPECT_EQ(summaries[1].AllocatedBytes, 64u * 16u * sizeof(float));
+  EXPECT_DOUBLE_EQ(summaries[1].SelfTime, summaries[1].TotalTime);
+  ASSERT_FALSE(summaries[1].Threads.empty());
+
+  itk::SizeValueType numberOfWorkChunks = 0;
+  for (const itk::PipelineProfiler::ThreadLoad & load : summaries[1].Threads)
+  {
+    numberOfWorkChunks += load.NumberOfWorkChunks;
+    EXPECT_LE(load.BusyTime, summaries[1].TotalTime);
+    EXPECT_GE(load.IdleTime, 0.0);
+  }
+  EXPECT_EQ(numberOfWorkChunks, summaries[1].NumberOfWorkChunks);
+}
+
+
+TEST(PipelineProfiler, DropsExecutionsBeyondMaximum)
+{
+  const auto profiler = itk::PipelineProfiler::New();
+  profiler->SetMaximumNumberOfExecutions(2);
+  profiler->Start();
+  UpdateStreamedPipeline();
+  profiler->Stop();
+
+  EXPECT_EQ(profiler->GetExecutions().size(), 2u);
+  EXPECT_EQ(profiler->GetNumberOfDroppedExecutions(), 3u);
+}
+
+
+TEST(PipelineProfiler, WritesJSONAndChromeTrace)
+{
+  const auto profiler = itk::PipelineProfiler::New();
+  profiler->Start();
+  UpdateStreamedPipeline("the \"source\"");
+  profiler->Stop();
+
+  std::ostringstream json;
+  profiler->WriteJSON(json);
+  EXPECT_NE(json.str().find("\"filters\": ["), std::string::npos);
+  EXPECT_NE(json.str().find("\"name\": \"the \\\"source\\\"\", \"class\": \"IndexSumSource\", \"executions\": 4"),
+            std::string::npos);
+  EXPECT_NE(json.str().find("\"streamingPieces\": 4"), std::string::npos);
+
+  std::ostringstream trace;
+  profiler->WriteChromeTrace(trace);
+  EXPECT_EQ(trace.str().find("{\"traceEvents\": ["), 0u);
+  EXPECT_NE(trace.str().find("\"cat\": \"filter\", \"ph\": \"X\""), std::string::npos);
+  EXPECT_NE(trace.str().find("\"cat\": \"work chunk\", \"ph\": \"X\""), std::string::npos);
+  EXPECT_NE(trace.str().find("\"ph\": \"M\""), std::string::npos);
+}
@@ -0,0 +1,113 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTiledStreamingImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkShiftScaleImageFilter.h"
+#include "itkTestingMacros.h"
+
+// Runs a chain of a neighborhood filter and a pixelwise filter tile by tile,
+// and checks that each tile fits the memory budget and that the result is the
+// same as when the chain runs on the whole image.
+int
+itkTiledStreamingImageFilterTest(int, char *[])
+{
+  constexpr unsigned int Dimension = 3;
+  using ImageType = itk::Image<float, Dimension>;
+  using KernelType = itk::FlatStructuringElement<Dimension>;
+  using DilateType = itk::GrayscaleDilateImageFilter<ImageType, ImageType, KernelType>;
+  using ShiftScaleType = itk::ShiftScaleImageFilter<ImageType, ImageType>;
+  using MonitorType = itk::PipelineMonitorImageFilter<ImageType>;
+  using StreamerType = itk::TiledStreamingImageFilter<ImageType>;
+
+  auto                            input = ImageType::New();
+  constexpr ImageType::SizeType   size = { { 40, 37, 29 } };
+  input->SetRegions(size);
+  input->Allocate();
+  itk::SizeValueType i = 0;
+  for (itk::ImageRegionIterator<ImageType> it(input, input->GetBufferedRegion()); !it.IsAtEnd(); ++it, ++i)
+  {
+    it.Set(static_cast<float>((i * 7919) % 1000));
+  }
+
+  auto dilate = DilateType::New();
+  dilate->SetInput(input);
+  dilate->SetKernel(KernelType::Box(KernelType::RadiusType::Filled(2)));
+
+  auto shiftScale = ShiftScaleType::New();
+  shiftScale->SetInput(dilate->GetOutput());
+  shiftScale->SetShift(1.0);
+  shiftScale->SetScale(0.5);
+
+  // The reference result, from the whole image.
+  shiftScale->Update();
+  const ImageType::Pointer expected = shiftScale->GetOutput();
+  expected->DisconnectPipeline();
+
+  auto monitor = MonitorType::New();
+  monitor->SetInput(shiftScale->GetOutput());
+
+  auto streamer = StreamerType::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(streamer, TiledStreamingImageFilter, StreamingImageFilter);
+
+  ITK_TEST_EXPECT_EQUAL(streamer->GetTileSizeInBytes(), 0);
+  ITK_TEST_EXPECT_EQUAL(streamer->GetNumberOfStreamDivisions(), 1);
+
+  constexpr itk::SizeValueType tileSizeInBytes = 64 * 1024;
+  streamer->SetTileSizeInBytes(tileSizeInBytes);
+  ITK_TEST_SET_GET_VALUE(tileSizeInBytes, streamer->GetTileSizeInBytes());
+
+  streamer->SetInput(monitor->GetOutput());
+  ITK_TRY_EXPECT_NO_EXCEPTION(streamer->Update());
+
+  // The monitor, the shift-scale, the dilate outputs and the input.
+  ITK_TEST_EXPECT_EQUAL(streamer->GetNumberOfUpstreamImages(), 4);
+
+  const itk::SizeValueType bytesPerTilePixel = sizeof(float) * (streamer->GetNumberOfUpstreamImages() + 1);
+  const itk::SizeValueType minimumNumberOfTiles =
+    (expected->GetBufferedRegion().GetNumberOfPixels() * bytesPerTilePixel + tileSizeInBytes - 1) / tileSizeInBytes;
+  std::cout << "Number of tiles: " << monitor->GetNumberOfUpdates() << std::endl;
+  ITK_TEST_EXPECT_TRUE(monitor->GetNumberOfUpdates() >= minimumNumberOfTiles);
+  for (const auto & region : monitor->GetOutputRequestedRegions())
+  {
+    if (region.GetNumberOfPixels() * bytesPerTilePixel > tileSizeInBytes)
+    {
+      std::cerr << "Tile " << region << " exceeds the budget of " << tileSizeInBytes << " bytes" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  itk::ImageRegionConstIterator<ImageType> expectedIt(expected, expected->GetBufferedRegion());
+  itk::ImageRegionConstIterator<ImageType> outputIt(streamer->GetOutput(), expected->GetBufferedRegion());
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++outputIt)
+  {
+    if (expectedIt.Get() != outputIt.Get())
+    {
+      std::cerr << "Pixel " << expectedIt.GetIndex() << " expected " << expectedIt.Get() << " but got "
+                << outputIt.Get() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,53 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTestingRandomImage_h
+#define itkTestingRandomImage_h
+
+#include "itkRandomImageSource.h"
+
+namespace itk
+{
+namespace Testing
+{
+/** Create an image of the given size, whose pixels are random values between
+ * the given minimum and maximum, generated by a RandomImageSource. The image
+ * is disconnected from the source, so that a test may modify it, or compare
+ * the output of a filter to values it computes from the whole image.
+ *
+ * \ingroup ITKTestKernel
+ */
+template <typename TImage>
+typename TImage::Pointer
+CreateRandomImage(const typename TImage::SizeType & size,
+                  typename TImage::PixelType        minimum,
+                  typename TImage::PixelType        maximum)
+{
+  const auto source = RandomImageSource<TImage>::New();
+  source->SetSize(size);
+  source->SetMin(minimum);
+  source->SetMax(maximum);
+  source->Update();
+
+  typename TImage::Pointer image = source->GetOutput();
+  image->DisconnectPipeline();
+  return image;
+}
+} // end namespace Testing
+} // end namespace itk
+
+#endif
@@ -26,10 +26,14 @@
 #include "itkExtractImageFilter.h"
 #include "itkFFTPadImageFilter.h"
 #include "itkImageBase.h"
+#include "itkImageRegionRange.h"
+#include "itkIndexRange.h"
 #include "itkMultiplyImageFilter.h"
 #include "itkNormalizeToConstantImageFilter.h"
 #include "itkMath.h"
+#include "itkProgressTransformer.h"
 #include "itkRegionOfInterestImageFilter.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -54,6 +58,7 @@ FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrec
     // as an implementation detail, while pixels for kernel radius padding may be taken
     // from the original image if they lies inside the image bounds.
     inputRegion.PadByRadius(this->GetKernelRadius());
+    const InputRegionType paddedRegion = inputRegion;
 
     // Crop the output requested region to fit within the largest
     // possible region.
@@ -64,6 +69,14 @@ FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrec
       itkExceptionMacro("Requested region is outside the largest possible region.");
     }
 
+    // The pixels of the blocks outside the image are taken from the
+    // boundary condition, which may need other pixels of the image.
+    if (m_BlockSize != OutputSizeType::Filled(0))
+    {
+      inputRegion =
+        this->GetBoundaryCondition()->GetInputRequestedRegion(inputPtr->GetLargestPossibleRegion(), paddedRegion);
+    }
+
     // Input is an image, cast away the constness so we can set
     // the requested region.
     inputPtr->SetRequestedRegion(inputRegion);
@@ -82,6 +95,12 @@ template <typename TInputImage, typename TKernelImage, typename TOutputImage, ty
 void
 FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::GenerateData()
 {
+  if (m_BlockSize != OutputSizeType::Filled(0))
+  {
+    this->GenerateDataInBlocks();
+    return;
+  }
+
   // Create a process accumulator for tracking the progress of this minipipeline
   auto progress = ProgressAccumulator::New();
   progress->SetMiniPipelineFilter(this);
@@ -112,6 +131,152 @@ FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrec
   this->ProduceOutput(multiplyFilter->GetOutput(), progress, 0.2);
 }
 
+template <typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision>
+void
+FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::GenerateDataInBlocks()
+{
+  const InputImageType *  input = this->GetInput();
+  const KernelImageType * kernel = this->GetKernelImage();
+  const KernelSizeType    kernelRadius = this->GetKernelRadius();
+
+  this->AllocateOutputs();
+  OutputImageType *      output = this->GetOutput();
+  const OutputRegionType outputRegion = output->GetRequestedRegion();
+
+  // The blocks are transformed along with the pixels within the kernel
+  // radius of them, in images of the smallest size with no prime factor
+  // greater than m_SizeGreatestPrimeFactor, and grow to fill them.
+  InternalSizeType fftSize;
+  OutputSizeType   blockSize;
+  OutputSizeType   numberOfBlocks;
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  {
+    const SizeValueType requestedSize = outputRegion.GetSize(dim);
+    SizeValueType       size = (m_BlockSize[dim] == 0 ? requestedSize : std::min(m_BlockSize[dim], requestedSize)) +
+                         2 * kernelRadius[dim];
+    if (m_SizeGreatestPrimeFactor > 1)
+    {
+      while (Math::GreatestPrimeFactor(size) > m_SizeGreatestPrimeFactor)
+      {
+        ++size;
+      }
+    }
+    else if (m_SizeGreatestPrimeFactor == 1)
+    {
+      // make sure the total size is even
+      size += size % 2;
+    }
+    fftSize[dim] = size;
+    blockSize[dim] = size - 2 * kernelRadius[dim];
+    numberOfBlocks[dim] = (requestedSize + blockSize[dim] - 1) / blockSize[dim];
+  }
+
+  // The spectrum of the kernel is computed once, for the size of the
+  // blocks, and shared between them. The padded blocks are local to this
+  // pass, which leaves the padded input region of the whole region path
+  // alone.
+  const InternalRegionType paddedBlockRegion(fftSize);
+  auto                     progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter(this);
+  InternalComplexImagePointerType preparedKernel = nullptr;
+  this->PrepareKernel(kernel, paddedBlockRegion, preparedKernel, progress, 0.1f);
+  const InternalComplexType * const kernelSpectrum = preparedKernel->GetBufferPointer();
+  const bool                        xDimensionIsOdd = (fftSize[0] % 2 != 0);
+
+  const BoundaryConditionType * boundaryCondition = this->GetBoundaryCondition();
+  const InputRegionType         inputBufferedRegion = input->GetBufferedRegion();
+
+  ProgressTransformer blocksProgress(0.1f, 1.0f, this);
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  multiThreader->template ParallelizeImageRegion<ImageDimension>(
+    OutputRegionType(numberOfBlocks),
+    [&](const OutputRegionType & blocks) {
+      // Each work unit transforms its blocks one after the other, in the
+      // same images.
+      auto fftFilter = FFTFilterType::New();
+      fftFilter->SetNumberOfWorkUnits(1);
+      auto ifftFilter = IFFTFilterType::New();
+      ifftFilter->SetActualXDimensionIsOdd(xDimensionIsOdd);
+      ifftFilter->SetNumberOfWorkUnits(1);
+      auto paddedBlock = InternalImageType::New();
+      paddedBlock->SetRegions(paddedBlockRegion);
+      paddedBlock->Allocate();
+
+      for (const OutputIndexType & blockIndex : ImageRegionIndexRange<ImageDimension>(blocks))
+      {
+        // The block of the output, and the region of the input it depends
+        // on, the rest of the padded block being zero.
+        OutputRegionType block;
+        InputRegionType  blockInputRegion;
+        for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+          const IndexValueType blockStart =
+            outputRegion.GetIndex(dim) + static_cast<IndexValueType>(blockIndex[dim] * blockSize[dim]);
+          const IndexValueType requestedEnd =
+            outputRegion.GetIndex(dim) + static_cast<IndexValueType>(outputRegion.GetSize(dim));
+          block.SetIndex(dim, blockStart);
+          block.SetSize(dim, std::min<SizeValueType>(blockSize[dim], requestedEnd - blockStart));
+          blockInputRegion.SetIndex(dim, blockStart - static_cast<IndexValueType>(kernelRadius[dim]));
+          blockInputRegion.SetSize(dim, block.GetSize(dim) + 2 * kernelRadius[dim]);
+        }
+
+        paddedBlock->FillBuffer(TInternalPrecision{});
+        ImageRegionRange<InternalImageType> paddedBlockRange(*paddedBlock,
+                                                             InternalRegionType(blockInputRegion.GetSize()));
+        if (inputBufferedRegion.IsInside(blockInputRegion))
+        {
+          const ImageRegionRange<const InputImageType> inputRange(*input, blockInputRegion);
+          std::transform(inputRange.cbegin(), inputRange.cend(), paddedBlockRange.begin(), [](InputPixelType pixel) {
+            return static_cast<TInternalPrecision>(pixel);
+          });
+        }
+        else
+        {
+          auto paddedBlockIt = paddedBlockRange.begin();
+          for (const InputIndexType & inputIndex : ImageRegionIndexRange<ImageDimension>(blockInputRegion))
+          {
+            *paddedBlockIt = static_cast<TInternalPrecision>(inputBufferedRegion.IsInside(inputIndex)
+                                                               ? input->GetPixel(inputIndex)
+                                                               : boundaryCondition->GetPixel(inputIndex, input));
+            ++paddedBlockIt;
+          }
+        }
+        paddedBlock->Modified();
+
+        fftFilter->SetInput(paddedBlock);
+        fftFilter->Update();
+        const InternalComplexImagePointerType spectrum = fftFilter->GetOutput();
+        spectrum->DisconnectPipeline();
+        InternalComplexType * const spectrumBuffer = spectrum->GetBufferPointer();
+        const SizeValueType         spectrumSize = spectrum->GetBufferedRegion().GetNumberOfPixels();
+        for (SizeValueType i = 0; i < spectrumSize; ++i)
+        {
+          spectrumBuffer[i] *= kernelSpectrum[i];
+        }
+
+        ifftFilter->SetInput(spectrum);
+        ifftFilter->Update();
+
+        // The pixels of the padded block within the kernel radius of its
+        // start wrap around, the following ones are the block.
+        InternalIndexType blockInPaddedBlockIndex;
+        for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+          blockInPaddedBlockIndex[dim] = static_cast<IndexValueType>(kernelRadius[dim]);
+        }
+        const ImageRegionRange<const InternalImageType> convolvedRange(
+          *ifftFilter->GetOutput(), InternalRegionType(blockInPaddedBlockIndex, block.GetSize()));
+        ImageRegionRange<OutputImageType> outputRange(*output, block);
+        std::transform(convolvedRange.cbegin(),
+                       convolvedRange.cend(),
+                       outputRange.begin(),
+                       [](TInternalPrecision value) { return static_cast<OutputPixelType>(value); });
+      }
+    },
+    blocksProgress.GetProcessObject());
+}
+
 template <typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision>
 void
 FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::PrepareInputs(
@@ -334,11 +499,23 @@ FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrec
   InternalComplexImagePointerType & preparedKernel,
   ProgressAccumulator *             progress,
   float                             progressWeight)
+{
+  this->PrepareKernel(kernel, m_PaddedInputRegion, preparedKernel, progress, progressWeight);
+}
+
+template <typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision>
+void
+FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::PrepareKernel(
+  const KernelImageType *           kernel,
+  const InternalRegionType &        paddedInputRegion,
+  InternalComplexImagePointerType & preparedKernel,
+  ProgressAccumulator *             progress,
+  float                             progressWeight)
 {
   const KernelRegionType kernelRegion = kernel->GetLargestPossibleRegion();
   KernelSizeType         kernelSize = kernelRegion.GetSize();
 
-  InputSizeType                      inputPadSize = m_PaddedInputRegion.GetSize();
+  InputSizeType                      inputPadSize = paddedInputRegion.GetSize();
   typename KernelImageType::SizeType kernelUpperBound;
   for (unsigned int i = 0; i < ImageDimension; ++i)
   {
@@ -414,7 +591,7 @@ FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrec
   kernelInfoFilter->ChangeRegionOn();
 
   using InfoOffsetValueType = typename InfoFilterType::OutputImageOffsetValueType;
-  const InputIndexType &  inputIndex = m_PaddedInputRegion.GetIndex();
+  const InputIndexType &  inputIndex = paddedInputRegion.GetIndex();
   const KernelIndexType & kernelIndex = kernel->GetLargestPossibleRegion().GetIndex();
   InfoOffsetValueType     kernelOffset[ImageDimension];
   for (unsigned int i = 0; i < ImageDimension; ++i)
@@ -524,6 +701,7 @@ FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrec
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "SizeGreatestPrimeFactor: " << m_SizeGreatestPrimeFactor << std::endl;
+  os << indent << "BlockSize: " << m_BlockSize << std::endl;
 }
 
 } // namespace itk
@@ -0,0 +1,190 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkConstantBoundaryCondition.h"
+#include "itkConvolutionImageFilter.h"
+#include "itkFFTConvolutionImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkPeriodicBoundaryCondition.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTestingMacros.h"
+#include "itkTestingRandomImage.h"
+#include <cmath>
+#include <type_traits>
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using FFTConvolutionFilterType = itk::FFTConvolutionImageFilter<ImageType>;
+using BoundaryConditionType = FFTConvolutionFilterType::BoundaryConditionType;
+
+// Convolve the given region of the image in the given number of stream
+// divisions, with the given block size.
+template <typename TFilter>
+ImageType::Pointer
+Convolve(const ImageType *                                                        image,
+         const ImageType *                                                        kernel,
+         BoundaryConditionType *                                                  boundaryCondition,
+         bool                                                                     normalize,
+         itk::ConvolutionImageFilterBaseEnums::ConvolutionImageFilterOutputRegion outputRegionMode,
+         const ImageType::RegionType &                                            requestedRegion,
+         unsigned int                                                             numberOfStreamDivisions,
+         const ImageType::SizeType &                                              blockSize)
+{
+  const auto filter = TFilter::New();
+  filter->SetInput(image);
+  filter->SetKernelImage(kernel);
+  filter->SetBoundaryCondition(boundaryCondition);
+  filter->SetNormalize(normalize);
+  filter->SetOutputRegionMode(outputRegionMode);
+  if constexpr (std::is_same_v<TFilter, FFTConvolutionFilterType>)
+  {
+    filter->SetBlockSize(blockSize);
+  }
+  const auto streamer = itk::StreamingImageFilter<ImageType, ImageType>::New();
+  streamer->SetInput(filter->GetOutput());
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  streamer->GetOutput()->SetRequestedRegion(requestedRegion);
+  streamer->Update();
+  return streamer->GetOutput();
+}
+
+// Check that convolving in blocks gives the output of convolving the
+// requested region as a whole, and of convolving in the spatial domain.
+bool
+CheckBlocks(const ImageType *                                                        image,
+            const ImageType *                                                        kernel,
+            BoundaryConditionType *                                                  boundaryCondition,
+            bool                                                                     normalize,
+            itk::ConvolutionImageFilterBaseEnums::ConvolutionImageFilterOutputRegion outputRegionMode,
+            const ImageType::RegionType &                                            requestedRegion,
+            unsigned int                                                             numberOfStreamDivisions,
+            const ImageType::SizeType &                                              blockSize)
+{
+  const ImageType::Pointer whole = Convolve<FFTConvolutionFilterType>(
+    image, kernel, boundaryCondition, normalize, outputRegionMode, requestedRegion, 1, ImageType::SizeType::Filled(0));
+  const ImageType::Pointer spatial = Convolve<itk::ConvolutionImageFilter<ImageType>>(
+    image, kernel, boundaryCondition, normalize, outputRegionMode, requestedRegion, 1, blockSize);
+  const ImageType::Pointer blocks = Convolve<FFTConvolutionFilterType>(
+    image, kernel, boundaryCondition, normalize, outputRegionMode, requestedRegion, numberOfStreamDivisions, blockSize);
+
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(blocks, requestedRegion); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType & index = it.GetIndex();
+    if (std::abs(it.Get() - whole->GetPixel(index)) > 1e-5f || std::abs(it.Get() - spatial->GetPixel(index)) > 1e-4f)
+    {
+      std::cerr << "Test failed for blocks of size " << blockSize << " in " << numberOfStreamDivisions
+                << " stream divisions!" << std::endl;
+      std::cerr << "Expected " << whole->GetPixel(index) << " and " << spatial->GetPixel(index) << " at " << index
+                << ", but got " << it.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkFFTConvolutionImageFilterBlockTest(int, char *[])
+{
+  const auto filter = FFTConvolutionFilterType::New();
+  ITK_TEST_SET_GET_VALUE(ImageType::SizeType::Filled(0), filter->GetBlockSize());
+  filter->SetBlockSize(ImageType::SizeType{ { 16, 8, 0 } });
+  ITK_TEST_SET_GET_VALUE((ImageType::SizeType{ { 16, 8, 0 } }), filter->GetBlockSize());
+
+  const ImageType::Pointer image = itk::Testing::CreateRandomImage<ImageType>({ { 37, 30, 23 } }, -1.0f, 1.0f);
+  const ImageType::Pointer oddKernel = itk::Testing::CreateRandomImage<ImageType>({ { 7, 5, 3 } }, -1.0f, 1.0f);
+  const ImageType::Pointer evenKernel = itk::Testing::CreateRandomImage<ImageType>({ { 6, 3, 4 } }, -1.0f, 1.0f);
+
+  const auto same = itk::ConvolutionImageFilterBaseEnums::ConvolutionImageFilterOutputRegion::SAME;
+  const auto valid = itk::ConvolutionImageFilterBaseEnums::ConvolutionImageFilterOutputRegion::VALID;
+
+  itk::ZeroFluxNeumannBoundaryCondition<ImageType> zeroFluxNeumannBoundaryCondition;
+  itk::ConstantBoundaryCondition<ImageType>        constantBoundaryCondition;
+  constantBoundaryCondition.SetConstant(0.5f);
+  itk::PeriodicBoundaryCondition<ImageType> periodicBoundaryCondition;
+
+  const ImageType::RegionType largestRegion = image->GetLargestPossibleRegion();
+  const ImageType::RegionType subregion({ { 3, 25, 4 } }, { { 30, 5, 11 } });
+  const ImageType::RegionType validRegion({ { 3, 2, 1 } }, { { 31, 26, 21 } });
+
+  bool success = true;
+
+  // Blocks which do not divide the requested region, blocks which span it
+  // along some axes, and blocks larger than it.
+  for (const auto & blockSize : { ImageType::SizeType{ { 8, 8, 8 } },
+                                  ImageType::SizeType{ { 10, 0, 5 } },
+                                  ImageType::SizeType{ { 64, 64, 64 } } })
+  {
+    for (BoundaryConditionType * boundaryCondition :
+         std::initializer_list<BoundaryConditionType *>{ &zeroFluxNeumannBoundaryCondition,
+                                                         &constantBoundaryCondition,
+                                                         &periodicBoundaryCondition })
+    {
+      for (const ImageType * kernel : { oddKernel.GetPointer(), evenKernel.GetPointer() })
+      {
+        success &= CheckBlocks(image, kernel, boundaryCondition, false, same, largestRegion, 1, blockSize);
+        success &= CheckBlocks(image, kernel, boundaryCondition, true, same, subregion, 3, blockSize);
+      }
+    }
+    success &=
+      CheckBlocks(image, oddKernel, &zeroFluxNeumannBoundaryCondition, false, valid, validRegion, 2, blockSize);
+  }
+
+  // Padded blocks of an odd size along the first axis.
+  success &= CheckBlocks(image,
+                         oddKernel,
+                         &zeroFluxNeumannBoundaryCondition,
+                         false,
+                         same,
+                         largestRegion,
+                         1,
+                         ImageType::SizeType{ { 9, 4, 6 } });
+
+  // Convolving in blocks leaves the state of the whole region path alone,
+  // when the same filter then convolves the image as a whole.
+  const ImageType::Pointer whole = Convolve<FFTConvolutionFilterType>(image,
+                                                                      oddKernel,
+                                                                      &zeroFluxNeumannBoundaryCondition,
+                                                                      false,
+                                                                      same,
+                                                                      largestRegion,
+                                                                      1,
+                                                                      ImageType::SizeType::Filled(0));
+  filter->SetInput(image);
+  filter->SetKernelImage(oddKernel);
+  filter->SetBlockSize(ImageType::SizeType{ { 8, 8, 8 } });
+  filter->Update();
+  filter->SetBlockSize(ImageType::SizeType::Filled(0));
+  filter->Update();
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(filter->GetOutput(), largestRegion); !it.IsAtEnd(); ++it)
+  {
+    if (std::abs(it.Get() - whole->GetPixel(it.GetIndex())) > 1e-5f)
+    {
+      std::cerr << "Test failed after convolving in blocks!" << std::endl;
+      std::cerr << "Expected " << whole->GetPixel(it.GetIndex()) << " at " << it.GetIndex() << ", but got "
+                << it.Get() << std::endl;
+      success = false;
+      break;
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
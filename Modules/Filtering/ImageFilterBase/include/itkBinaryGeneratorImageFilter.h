@@ -18,14 +18,67 @@
 #ifndef itkBinaryGeneratorImageFilter_h
 #define itkBinaryGeneratorImageFilter_h
 
+#include "itkDefaultPixelAccessor.h"
 #include "itkInPlaceImageFilter.h"
 #include "itkSimpleDataObjectDecorator.h"
 
 
 #include <functional>
+#include <type_traits>
 
 namespace itk
 {
+namespace Functor
+{
+/** Apply a binary functor to numberOfPixels contiguous pixels.
+ *
+ * BinaryGeneratorImageFilter calls these functions on the lines of pixels
+ * which are contiguous in the buffers of its inputs and output. Overloads
+ * for a given functor type, found by argument dependent lookup, can provide
+ * a vectorized implementation of the functor. The output may be the same
+ * buffer as one of the inputs, when the filter runs in place.
+ * \ingroup ITKImageFilterBase */
+template <typename TFunctor, typename TInput1, typename TInput2, typename TOutput>
+inline void
+ApplyBinaryFunctorToLine(const TFunctor & functor,
+                         const TInput1 *  input1,
+                         const TInput2 *  input2,
+                         TOutput *        output,
+                         SizeValueType    numberOfPixels)
+{
+  for (SizeValueType i = 0; i < numberOfPixels; ++i)
+  {
+    output[i] = functor(input1[i], input2[i]);
+  }
+}
+template <typename TFunctor, typename TInput1, typename TInput2, typename TOutput>
+inline void
+ApplyBinaryFunctorToLineWithConstant1(const TFunctor & functor,
+                                      const TInput1 &  constant1,
+                                      const TInput2 *  input2,
+                                      TOutput *        output,
+                                      SizeValueType    numberOfPixels)
+{
+  for (SizeValueType i = 0; i < numberOfPixels; ++i)
+  {
+    output[i] = functor(constant1, input2[i]);
+  }
+}
+template <typename TFunctor, typename TInput1, typename TInput2, typename TOutput>
+inline void
+ApplyBinaryFunctorToLineWithConstant2(const TFunctor & functor,
+                                      const TInput1 *  input1,
+                                      const TInput2 &  constant2,
+                                      TOutput *        output,
+                                      SizeValueType    numberOfPixels)
+{
+  for (SizeValueType i = 0; i < numberOfPixels; ++i)
+  {
+    output[i] = functor(input1[i], constant2);
+  }
+}
+} // namespace Functor
+
 /** \class BinaryGeneratorImageFilter
  * \brief Implements pixel-wise generic operation of two images,
  * or of an image and a constant.
@@ -238,6 +291,25 @@ protected:
   DynamicThreadedGenerateDataWithFunctor(const TFunctor &, const OutputImageRegionType & outputRegionForThread);
   void
   DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+  /** Whether the pixels of an image type are stored as they are accessed,
+   * in a buffer which can be processed through raw pointers. */
+  template <typename TImage>
+  static constexpr bool HasDirectlyAccessiblePixels =
+    std::is_same_v<typename TImage::AccessorType, DefaultPixelAccessor<typename TImage::PixelType>> &&
+    std::is_same_v<typename TImage::InternalPixelType, typename TImage::PixelType>;
+
+  /** Call lineFunction(offset1, offset2, outputOffset, numberOfPixels) for
+   * each line of pixels of the region which is contiguous in the buffers of
+   * the given images (a null image is ignored). A line spans several rows
+   * when the region covers whole rows of all the buffers. */
+  template <typename TLineFunction>
+  static void
+  ForEachContiguousLine(const TInputImage1 *          inputPtr1,
+                        const TInputImage2 *          inputPtr2,
+                        const TOutputImage *          outputPtr,
+                        const OutputImageRegionType & region,
+                        TLineFunction &&              lineFunction);
   void
   AfterThreadedGenerateData() override
   {
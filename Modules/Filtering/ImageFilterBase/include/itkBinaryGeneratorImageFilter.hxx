@@ -19,6 +19,7 @@
 #define itkBinaryGeneratorImageFilter_hxx
 
 #include "itkImageScanlineIterator.h"
+#include "itkIndexRange.h"
 #include "itkTotalProgressReporter.h"
 
 
@@ -186,7 +187,64 @@ BinaryGeneratorImageFilter<TInputImage1, TInputImage2, TOutputImage>::DynamicThr
 
   TotalProgressReporter progress(this, outputPtr->GetRequestedRegion().GetNumberOfPixels());
 
-  if (inputPtr1 && inputPtr2)
+  if constexpr (HasDirectlyAccessiblePixels<TInputImage1> && HasDirectlyAccessiblePixels<TInputImage2> &&
+                HasDirectlyAccessiblePixels<TOutputImage>)
+  {
+    // Process the contiguous lines of pixels through raw pointers, which the
+    // compiler can vectorize, or with a vectorized overload for the functor.
+    using Functor::ApplyBinaryFunctorToLine;
+    using Functor::ApplyBinaryFunctorToLineWithConstant1;
+    using Functor::ApplyBinaryFunctorToLineWithConstant2;
+
+    OutputImagePixelType * const output = outputPtr->GetBufferPointer();
+    if (inputPtr1 && inputPtr2)
+    {
+      const Input1ImagePixelType * const input1 = inputPtr1->GetBufferPointer();
+      const Input2ImagePixelType * const input2 = inputPtr2->GetBufferPointer();
+      ForEachContiguousLine(
+        inputPtr1,
+        inputPtr2,
+        outputPtr,
+        outputRegionForThread,
+        [&](OffsetValueType offset1, OffsetValueType offset2, OffsetValueType outputOffset, SizeValueType length) {
+          ApplyBinaryFunctorToLine(functor, input1 + offset1, input2 + offset2, output + outputOffset, length);
+          progress.Completed(length);
+        });
+    }
+    else if (inputPtr1)
+    {
+      const Input1ImagePixelType * const input1 = inputPtr1->GetBufferPointer();
+      const Input2ImagePixelType &       input2Value = this->GetConstant2();
+      ForEachContiguousLine(
+        inputPtr1,
+        nullptr,
+        outputPtr,
+        outputRegionForThread,
+        [&](OffsetValueType offset1, OffsetValueType, OffsetValueType outputOffset, SizeValueType length) {
+          ApplyBinaryFunctorToLineWithConstant2(functor, input1 + offset1, input2Value, output + outputOffset, length);
+          progress.Completed(length);
+        });
+    }
+    else if (inputPtr2)
+    {
+      const Input1ImagePixelType &       input1Value = this->GetConstant1();
+      const Input2ImagePixelType * const input2 = inputPtr2->GetBufferPointer();
+      ForEachContiguousLine(
+        nullptr,
+        inputPtr2,
+        outputPtr,
+        outputRegionForThread,
+        [&](OffsetValueType, OffsetValueType offset2, OffsetValueType outputOffset, SizeValueType length) {
+          ApplyBinaryFunctorToLineWithConstant1(functor, input1Value, input2 + offset2, output + outputOffset, length);
+          progress.Completed(length);
+        });
+    }
+    else
+    {
+      itkGenericExceptionMacro("At most one of the inputs can be a constant.");
+    }
+  }
+  else if (inputPtr1 && inputPtr2)
   {
     ImageScanlineConstIterator inputIt1(inputPtr1, outputRegionForThread);
     ImageScanlineConstIterator inputIt2(inputPtr2, outputRegionForThread);
@@ -253,6 +311,46 @@ BinaryGeneratorImageFilter<TInputImage1, TInputImage2, TOutputImage>::DynamicThr
     itkGenericExceptionMacro("At most one of the inputs can be a constant.");
   }
 }
+
+template <typename TInputImage1, typename TInputImage2, typename TOutputImage>
+template <typename TLineFunction>
+void
+BinaryGeneratorImageFilter<TInputImage1, TInputImage2, TOutputImage>::ForEachContiguousLine(
+  const TInputImage1 *          inputPtr1,
+  const TInputImage2 *          inputPtr2,
+  const TOutputImage *          outputPtr,
+  const OutputImageRegionType & region,
+  TLineFunction &&              lineFunction)
+{
+  const auto coversWholeRows = [&region](const auto * image, unsigned int dimension) {
+    return image == nullptr || (image->GetBufferedRegion().GetIndex(dimension) == region.GetIndex(dimension) &&
+                                image->GetBufferedRegion().GetSize(dimension) == region.GetSize(dimension));
+  };
+
+  // Merge the first dimensions into one line as long as the region covers
+  // the whole extent of the buffers along them.
+  SizeValueType lineLength = region.GetSize(0);
+  unsigned int  lineDimension = 1;
+  while (lineDimension < OutputImageDimension && coversWholeRows(inputPtr1, lineDimension - 1) &&
+         coversWholeRows(inputPtr2, lineDimension - 1) && coversWholeRows(outputPtr, lineDimension - 1))
+  {
+    lineLength *= region.GetSize(lineDimension);
+    ++lineDimension;
+  }
+
+  OutputImageRegionType lineStarts = region;
+  for (unsigned int dimension = 0; dimension < lineDimension; ++dimension)
+  {
+    lineStarts.SetSize(dimension, 1);
+  }
+  for (const auto & index : ImageRegionIndexRange<OutputImageDimension>(lineStarts))
+  {
+    lineFunction(inputPtr1 ? inputPtr1->ComputeOffset(index) : 0,
+                 inputPtr2 ? inputPtr2->ComputeOffset(index) : 0,
+                 outputPtr->ComputeOffset(index),
+                 lineLength);
+  }
+}
 } // end namespace itk
 
 #endif
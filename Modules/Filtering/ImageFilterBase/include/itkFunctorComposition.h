@@ -0,0 +1,256 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFunctorComposition_h
+#define itkFunctorComposition_h
+
+#include "itkMacro.h"
+
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace itk
+{
+namespace Functor
+{
+namespace Details
+{
+// Passes all the inputs to the first functor, when it accepts them.
+template <typename TFirst, typename TSecond, typename... TInputs>
+auto
+ApplyComposition(int, const TFirst & first, const TSecond & second, const TInputs &... inputs)
+  -> decltype(second(first(inputs...)))
+{
+  return second(first(inputs...));
+}
+
+// Otherwise, passes the first input to the first functor, and the other
+// inputs to the second functor, after the result of the first functor.
+template <typename TFirst, typename TSecond, typename TInput, typename... TExtraInputs>
+auto
+ApplyComposition(long,
+                 const TFirst &         first,
+                 const TSecond &        second,
+                 const TInput &         input,
+                 const TExtraInputs &... extraInputs) -> decltype(second(first(input), extraInputs...))
+{
+  return second(first(input), extraInputs...);
+}
+
+template <typename T, typename = void>
+struct IsEqualityComparable : std::false_type
+{};
+
+template <typename T>
+struct IsEqualityComparable<T, std::void_t<decltype(std::declval<const T &>() == std::declval<const T &>())>>
+  : std::true_type
+{};
+
+// Holds a functor by value, so that a Composition is default constructible
+// and copy assignable, as the functor of a filter must be, even when the
+// functor is not, like a lambda.
+template <typename TFunctor,
+          bool VIsRegular = std::is_default_constructible_v<TFunctor> && std::is_copy_assignable_v<TFunctor>>
+class FunctorHolder
+{
+public:
+  FunctorHolder() = default;
+
+  explicit FunctorHolder(const TFunctor & functor)
+    : m_Functor(functor)
+  {}
+
+  const TFunctor &
+  Get() const
+  {
+    return m_Functor;
+  }
+  TFunctor &
+  Get()
+  {
+    return m_Functor;
+  }
+
+private:
+  TFunctor m_Functor{};
+};
+
+// The functor is then only constructed when a functor is given, and it is
+// copy constructed again on assignment.
+template <typename TFunctor>
+class FunctorHolder<TFunctor, false>
+{
+public:
+  FunctorHolder() = default;
+
+  explicit FunctorHolder(const TFunctor & functor)
+    : m_Functor(functor)
+  {}
+
+  FunctorHolder(const FunctorHolder &) = default;
+
+  FunctorHolder &
+  operator=(const FunctorHolder & other)
+  {
+    if (this != &other)
+    {
+      m_Functor.reset();
+      if (other.m_Functor)
+      {
+        m_Functor.emplace(*other.m_Functor);
+      }
+    }
+    return *this;
+  }
+
+  const TFunctor &
+  Get() const
+  {
+    itkAssertInDebugAndIgnoreInReleaseMacro(m_Functor.has_value());
+    return *m_Functor;
+  }
+  TFunctor &
+  Get()
+  {
+    itkAssertInDebugAndIgnoreInReleaseMacro(m_Functor.has_value());
+    return *m_Functor;
+  }
+
+private:
+  std::optional<TFunctor> m_Functor{};
+};
+} // namespace Details
+
+/** \class Composition
+ * \brief Functor which applies a functor to the result of another one.
+ *
+ * Composition fuses two pixel-wise operations into one, so that a chain of
+ * pixel-wise filters can be replaced by a single UnaryGeneratorImageFilter,
+ * BinaryGeneratorImageFilter or TernaryGeneratorImageFilter (or a
+ * UnaryFunctorImageFilter or BinaryFunctorImageFilter), which reads the
+ * inputs and writes the output buffer once, instead of once per filter of
+ * the chain. The fused filter keeps the usual pipeline behavior of these
+ * filters for the meta data and the requested regions.
+ *
+ * The functors are usually composed with Compose(), from the functors of the
+ * filters of the chain (see UnaryFunctorImageFilter::GetFunctor()), lambdas,
+ * or function pointers. A chain may have several inputs: the extra inputs
+ * of the composition go to the first functor of the chain which accepts
+ * them. For example, the chain Cast, Clamp, Mask, Sigmoid is fused by
+ * \code
+ *   const auto fused = itk::Functor::Compose(castFunctor, clampFunctor, maskFunctor, sigmoidFunctor);
+ *   auto       filter = itk::BinaryGeneratorImageFilter<InputImageType, MaskImageType, OutputImageType>::New();
+ *   filter->SetFunctor(fused);
+ * \endcode
+ * where fused(pixel, maskPixel) is
+ * sigmoidFunctor(maskFunctor(clampFunctor(castFunctor(pixel)), maskPixel)).
+ *
+ * A Composition is default constructible and copy assignable even when its
+ * functors are not, like lambdas, so that it can be the functor type of a
+ * UnaryFunctorImageFilter or BinaryFunctorImageFilter. Such a default
+ * constructed Composition must be assigned before it is applied. Two
+ * compositions are equal when their functors are; compositions of functors
+ * which cannot be compared, like lambdas, are never equal.
+ *
+ * \sa UnaryGeneratorImageFilter BinaryGeneratorImageFilter
+ *
+ * \ingroup ITKImageFilterBase
+ */
+template <typename TFirst, typename TSecond>
+class Composition
+{
+public:
+  Composition() = default;
+
+  Composition(const TFirst & first, const TSecond & second)
+    : m_First(first)
+    , m_Second(second)
+  {}
+
+  /** Get the functor which is applied first. */
+  const TFirst &
+  GetFirst() const
+  {
+    return m_First.Get();
+  }
+  TFirst &
+  GetFirst()
+  {
+    return m_First.Get();
+  }
+
+  /** Get the functor which is applied to the result of the first one. */
+  const TSecond &
+  GetSecond() const
+  {
+    return m_Second.Get();
+  }
+  TSecond &
+  GetSecond()
+  {
+    return m_Second.Get();
+  }
+
+  bool
+  operator==(const Composition & other) const
+  {
+    if constexpr (Details::IsEqualityComparable<TFirst>::value && Details::IsEqualityComparable<TSecond>::value)
+    {
+      return this->GetFirst() == other.GetFirst() && this->GetSecond() == other.GetSecond();
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  ITK_UNEQUAL_OPERATOR_MEMBER_FUNCTION(Composition);
+
+  template <typename... TInputs>
+  auto
+  operator()(const TInputs &... inputs) const -> decltype(
+    Details::ApplyComposition(0, std::declval<const TFirst &>(), std::declval<const TSecond &>(), inputs...))
+  {
+    return Details::ApplyComposition(0, m_First.Get(), m_Second.Get(), inputs...);
+  }
+
+private:
+  Details::FunctorHolder<TFirst>  m_First{};
+  Details::FunctorHolder<TSecond> m_Second{};
+};
+
+/** Compose functors, which are applied from left to right:
+ * Compose(f, g, h)(x) is h(g(f(x))).
+ * \sa Composition */
+template <typename TFunctor>
+std::decay_t<TFunctor>
+Compose(const TFunctor & functor)
+{
+  return functor;
+}
+
+template <typename TFirst, typename TSecond, typename... TOthers>
+auto
+Compose(const TFirst & first, const TSecond & second, const TOthers &... others)
+{
+  return Compose(Composition<std::decay_t<TFirst>, std::decay_t<TSecond>>(first, second), others...);
+}
+} // namespace Functor
+} // namespace itk
+
+#endif
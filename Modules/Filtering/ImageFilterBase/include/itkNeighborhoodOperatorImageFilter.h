@@ -35,6 +35,13 @@ namespace itk
  * with the image region.  Apply the mirror()'d operator for
  * non-symmetric NeighborhoodOperators.
  *
+ * Operators which extend along a single axis, such as the directional
+ * operators of separable filters, are applied to images of scalars a line
+ * at a time: each line is copied to a buffer along with its boundary
+ * pixels, and lines along the other axes are processed in bundles of
+ * neighbors along the first axis, so that the image is read and written
+ * contiguously. The result is the same as that of the inner products.
+ *
  * \ingroup ImageFilters
  *
  * \sa Image
@@ -180,6 +187,13 @@ protected:
   }
 
 private:
+  /** Applies an operator which extends along a single axis to the lines of
+   * the region along that axis. Returns false, without generating any
+   * output, when the operator extends along several axes or when the
+   * boundary pixels of the lines are in the image but not buffered. */
+  bool
+  GenerateDataAlongLines(const OutputImageRegionType & outputRegionForThread);
+
   /** Internal operator used to filter the image. */
   OutputNeighborhoodType m_Operator{};
 
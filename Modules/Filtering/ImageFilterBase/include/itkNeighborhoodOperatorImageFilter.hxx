@@ -24,6 +24,10 @@
 #include "itkImageRegionIterator.h"
 #include "itkConstNeighborhoodIterator.h"
 #include "itkTotalProgressReporter.h"
+#include "itkIndexRange.h"
+#include <algorithm>
+#include <type_traits>
+#include <vector>
 
 namespace itk
 {
@@ -76,6 +80,16 @@ void
 NeighborhoodOperatorImageFilter<TInputImage, TOutputImage, TOperatorValueType>::DynamicThreadedGenerateData(
   const OutputImageRegionType & outputRegionForThread)
 {
+  if constexpr (std::is_same_v<InputImageType, Image<InputPixelType, InputImageDimension>> &&
+                std::is_same_v<OutputImageType, Image<OutputPixelType, ImageDimension>> &&
+                std::is_arithmetic_v<InputPixelType> && std::is_arithmetic_v<OutputPixelType>)
+  {
+    if (this->GenerateDataAlongLines(outputRegionForThread))
+    {
+      return;
+    }
+  }
+
   using BFC = NeighborhoodAlgorithm::ImageBoundaryFacesCalculator<InputImageType>;
   using FaceListType = typename BFC::FaceListType;
 
@@ -114,6 +128,148 @@ NeighborhoodOperatorImageFilter<TInputImage, TOutputImage, TOperatorValueType>::
     }
   }
 }
+
+template <typename TInputImage, typename TOutputImage, typename TOperatorValueType>
+bool
+NeighborhoodOperatorImageFilter<TInputImage, TOutputImage, TOperatorValueType>::GenerateDataAlongLines(
+  const OutputImageRegionType & outputRegionForThread)
+{
+  // the types of the inner product, so that the results are the same
+  using InputPixelRealType = typename NumericTraits<InputPixelType>::RealType;
+  using AccumulateRealType = typename NumericTraits<InputPixelRealType>::AccumulateType;
+  using KernelValueType = typename NumericTraits<ComputingPixelType>::ValueType;
+  using InputRegionType = typename InputImageType::RegionType;
+  using IndexType = typename InputImageType::IndexType;
+
+  // lines along the other axes are processed in bundles of this number of
+  // neighbors along the first axis
+  constexpr OffsetValueType maximumBundleSize = 16;
+  // the sums are accumulated this number of values at a time, which stay in
+  // the cache along with the buffered pixels they need
+  constexpr OffsetValueType blockSize = 1024;
+
+  unsigned int direction = 0;
+  unsigned int numberOfDirections = 0;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    if (m_Operator.GetRadius(i) > 0)
+    {
+      direction = i;
+      ++numberOfDirections;
+    }
+  }
+  if (numberOfDirections > 1)
+  {
+    return false;
+  }
+
+  // the pixels of the lines and of their boundaries must either be buffered
+  // or be outside the image, where the boundary condition gives them
+  const InputImageType * input = this->GetInput();
+  OutputImageType *      output = this->GetOutput();
+  const InputRegionType  bufferedRegion = input->GetBufferedRegion();
+  InputRegionType        paddedRegion = outputRegionForThread;
+  paddedRegion.PadByRadius(m_Operator.GetRadius());
+  if (!bufferedRegion.IsInside(InputRegionType(outputRegionForThread)) ||
+      !paddedRegion.Crop(input->GetLargestPossibleRegion()) || !bufferedRegion.IsInside(paddedRegion))
+  {
+    return false;
+  }
+
+  const auto            radius = static_cast<OffsetValueType>(m_Operator.GetRadius(direction));
+  const auto            lineLength = static_cast<OffsetValueType>(outputRegionForThread.GetSize(direction));
+  const IndexValueType  bufferedBegin = bufferedRegion.GetIndex(direction);
+  const IndexValueType  bufferedEnd = bufferedBegin + static_cast<IndexValueType>(bufferedRegion.GetSize(direction));
+  const OffsetValueType inputStride = direction == 0 ? 1 : input->GetOffsetTable()[direction];
+  const OffsetValueType outputStride = direction == 0 ? 1 : output->GetOffsetTable()[direction];
+
+  std::vector<KernelValueType> kernel;
+  for (auto it = m_Operator.Begin(); it != m_Operator.End(); ++it)
+  {
+    kernel.push_back(static_cast<KernelValueType>(*it));
+  }
+
+  const OffsetValueType maximumWidth = direction == 0 ? 1 : maximumBundleSize;
+  std::vector<InputPixelRealType> buffer((lineLength + 2 * radius) * maximumWidth);
+  std::vector<AccumulateRealType> sums(lineLength * maximumWidth);
+
+  TotalProgressReporter progress(this, output->GetRequestedRegion().GetNumberOfPixels());
+
+  OutputImageRegionType linesRegion = outputRegionForThread;
+  linesRegion.SetSize(direction, 1);
+  linesRegion.SetSize(0, 1);
+  const IndexValueType firstBegin = outputRegionForThread.GetIndex(0);
+  const IndexValueType firstEnd = firstBegin + static_cast<IndexValueType>(outputRegionForThread.GetSize(0));
+  const IndexValueType bundleStep = direction == 0 ? firstEnd - firstBegin : maximumBundleSize;
+  for (const IndexType & linesIndex : ImageRegionIndexRange<ImageDimension>(linesRegion))
+  {
+    for (IndexType index = linesIndex; index[0] < firstEnd; index[0] += bundleStep)
+    {
+      // the bundle of lines is copied to the buffer a row of neighbors at a
+      // time, with the rows before and after the lines which are outside
+      // the image given by the boundary condition
+      const OffsetValueType width = direction == 0 ? 1 : std::min<OffsetValueType>(bundleStep, firstEnd - index[0]);
+      const OffsetValueType rowsBegin = std::max(-radius, bufferedBegin - index[direction]);
+      const OffsetValueType rowsEnd = std::min(lineLength + radius, bufferedEnd - index[direction]);
+      const InputPixelType * const inputLine = input->GetBufferPointer() + input->ComputeOffset(index);
+      for (OffsetValueType row = -radius; row < lineLength + radius; ++row)
+      {
+        InputPixelRealType * const bufferRow = buffer.data() + (row + radius) * width;
+        if (row >= rowsBegin && row < rowsEnd)
+        {
+          const InputPixelType * const inputRow = inputLine + row * inputStride;
+          for (OffsetValueType i = 0; i < width; ++i)
+          {
+            bufferRow[i] = static_cast<InputPixelRealType>(inputRow[i]);
+          }
+        }
+        else
+        {
+          IndexType boundaryIndex = index;
+          boundaryIndex[direction] += row;
+          for (OffsetValueType i = 0; i < width; ++i)
+          {
+            bufferRow[i] = static_cast<InputPixelRealType>(m_BoundsCondition->GetPixel(boundaryIndex, input));
+            ++boundaryIndex[0];
+          }
+        }
+      }
+
+      // each element of the kernel is applied in turn to all the pixels, so
+      // that the sums vectorize and add the products in the order of the
+      // inner product
+      const OffsetValueType numberOfSums = lineLength * width;
+      for (OffsetValueType blockBegin = 0; blockBegin < numberOfSums; blockBegin += blockSize)
+      {
+        const OffsetValueType      blockEnd = std::min<OffsetValueType>(blockBegin + blockSize, numberOfSums);
+        AccumulateRealType * const blockSums = sums.data() + blockBegin;
+        std::fill(blockSums, blockSums + (blockEnd - blockBegin), AccumulateRealType{});
+        for (size_t k = 0; k < kernel.size(); ++k)
+        {
+          const KernelValueType            kernelValue = kernel[k];
+          const InputPixelRealType * const blockPixels = buffer.data() + blockBegin + k * width;
+          for (OffsetValueType i = 0; i < blockEnd - blockBegin; ++i)
+          {
+            blockSums[i] += static_cast<AccumulateRealType>(kernelValue * blockPixels[i]);
+          }
+        }
+      }
+
+      OutputPixelType * const outputLine = output->GetBufferPointer() + output->ComputeOffset(index);
+      for (OffsetValueType row = 0; row < lineLength; ++row)
+      {
+        OutputPixelType * const          outputRow = outputLine + row * outputStride;
+        const AccumulateRealType * const rowSums = sums.data() + row * width;
+        for (OffsetValueType i = 0; i < width; ++i)
+        {
+          outputRow[i] = static_cast<OutputPixelType>(static_cast<ComputingPixelType>(rowSums[i]));
+        }
+      }
+      progress.Completed(numberOfSums);
+    }
+  }
+  return true;
+}
 } // end namespace itk
 
 #endif
@@ -0,0 +1,182 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkFunctorComposition.h"
+#include "itkBinaryGeneratorImageFilter.h"
+#include "itkClampImageFilter.h"
+#include "itkMaskImageFilter.h"
+#include "itkSigmoidImageFilter.h"
+#include "itkUnaryFunctorImageFilter.h"
+#include "itkUnaryGeneratorImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include <gtest/gtest.h>
+
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using InputImageType = itk::Image<short, Dimension>;
+using MaskImageType = itk::Image<unsigned char, Dimension>;
+using OutputImageType = itk::Image<float, Dimension>;
+
+template <typename TImage>
+typename TImage::Pointer
+CreateImage(int step)
+{
+  auto image = TImage::New();
+  image->SetRegions(typename TImage::SizeType{ { 13, 7 } });
+  image->SetOrigin(typename TImage::PointType(1.5));
+  image->Allocate();
+  int value = 0;
+  for (itk::ImageRegionIterator<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<typename TImage::PixelType>((value += step) % 256));
+  }
+  return image;
+}
+
+float
+Halve(float value)
+{
+  return value / 2;
+}
+} // namespace
+
+
+// Tests that functors are applied from left to right, with functors, lambdas, and function pointers.
+TEST(FunctorComposition, AppliesFunctorsFromLeftToRight)
+{
+  const auto addOne = [](float value) { return value + 1; };
+
+  EXPECT_EQ(itk::Functor::Compose(addOne)(1.0f), 2.0f);
+  EXPECT_EQ(itk::Functor::Compose(addOne, Halve)(3.0f), 2.0f);
+  EXPECT_EQ(itk::Functor::Compose(Halve, addOne)(3.0f), 2.5f);
+  EXPECT_EQ(itk::Functor::Compose(&Halve, addOne, addOne, &Halve)(4.0f), 2.0f);
+
+  // The extra inputs go to the first functor which accepts them.
+  const auto subtract = [](float a, float b) { return a - b; };
+  EXPECT_EQ(itk::Functor::Compose(subtract, Halve)(5.0f, 1.0f), 2.0f);
+  EXPECT_EQ(itk::Functor::Compose(Halve, subtract, addOne)(5.0f, 1.0f), 2.5f);
+}
+
+
+// Tests that a fused unary filter gives the same result as the chain of filters, and can be used as the functor of a
+// UnaryFunctorImageFilter.
+TEST(FunctorComposition, FusedUnaryFilterMatchesChain)
+{
+  using ClampFilterType = itk::ClampImageFilter<InputImageType, OutputImageType>;
+  using SigmoidFilterType = itk::SigmoidImageFilter<OutputImageType, OutputImageType>;
+
+  const auto input = CreateImage<InputImageType>(37);
+
+  auto clamp = ClampFilterType::New();
+  clamp->SetInput(input);
+  clamp->SetBounds(20, 200);
+  auto sigmoid = SigmoidFilterType::New();
+  sigmoid->SetInput(clamp->GetOutput());
+  sigmoid->SetAlpha(10);
+  sigmoid->SetBeta(100);
+  sigmoid->Update();
+
+  const auto fusedFunctor = itk::Functor::Compose(clamp->GetFunctor(), sigmoid->GetFunctor());
+  using FusedFunctorType = std::remove_const_t<decltype(fusedFunctor)>;
+  auto fused = itk::UnaryFunctorImageFilter<InputImageType, OutputImageType, FusedFunctorType>::New();
+  fused->SetInput(input);
+  fused->SetFunctor(fusedFunctor);
+  EXPECT_EQ(fused->GetFunctor(), fusedFunctor);
+  fused->Update();
+
+  EXPECT_EQ(fused->GetOutput()->GetOrigin(), input->GetOrigin());
+  itk::ImageRegionConstIterator<OutputImageType> expectedIt(sigmoid->GetOutput(), input->GetBufferedRegion());
+  itk::ImageRegionConstIterator<OutputImageType> fusedIt(fused->GetOutput(), input->GetBufferedRegion());
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++fusedIt)
+  {
+    EXPECT_EQ(fusedIt.Get(), expectedIt.Get());
+  }
+}
+
+
+// Tests the fusion of a chain with a mask input, into a binary filter.
+TEST(FunctorComposition, FusedBinaryFilterMatchesChain)
+{
+  using ClampFilterType = itk::ClampImageFilter<InputImageType, OutputImageType>;
+  using MaskFilterType = itk::MaskImageFilter<OutputImageType, MaskImageType, OutputImageType>;
+  using SigmoidFilterType = itk::SigmoidImageFilter<OutputImageType, OutputImageType>;
+
+  const auto input = CreateImage<InputImageType>(37);
+  const auto mask = CreateImage<MaskImageType>(1);
+
+  auto clamp = ClampFilterType::New();
+  clamp->SetInput(input);
+  clamp->SetBounds(20, 200);
+  auto maskFilter = MaskFilterType::New();
+  maskFilter->SetInput(clamp->GetOutput());
+  maskFilter->SetMaskImage(mask);
+  maskFilter->SetMaskingValue(3);
+  maskFilter->SetOutsideValue(-1);
+  auto sigmoid = SigmoidFilterType::New();
+  sigmoid->SetInput(maskFilter->GetOutput());
+  sigmoid->SetBeta(100);
+  sigmoid->Update();
+
+  itk::Functor::MaskInput<float, unsigned char, float> maskFunctor;
+  maskFunctor.SetMaskingValue(3);
+  maskFunctor.SetOutsideValue(-1);
+
+  auto fused = itk::BinaryGeneratorImageFilter<InputImageType, MaskImageType, OutputImageType>::New();
+  fused->SetInput1(input);
+  fused->SetInput2(mask);
+  fused->SetFunctor(itk::Functor::Compose(clamp->GetFunctor(), maskFunctor, sigmoid->GetFunctor()));
+  fused->Update();
+
+  itk::ImageRegionConstIterator<OutputImageType> expectedIt(sigmoid->GetOutput(), input->GetBufferedRegion());
+  itk::ImageRegionConstIterator<OutputImageType> fusedIt(fused->GetOutput(), input->GetBufferedRegion());
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++fusedIt)
+  {
+    EXPECT_EQ(fusedIt.Get(), expectedIt.Get());
+  }
+}
+
+
+// Tests that a composition of lambdas, which are neither default constructible nor copy assignable, nor comparable
+// when they capture, can be the functor of a UnaryFunctorImageFilter.
+TEST(FunctorComposition, ComposedLambdasAsFunctorOfUnaryFunctorImageFilter)
+{
+  const float offset = 0.5f;
+  const auto  addOffset = [offset](short value) { return value + offset; };
+  const auto  twice = [](float value) { return 2 * value; };
+
+  const auto composedLambdas = itk::Functor::Compose(addOffset, twice);
+  using ComposedLambdasType = std::remove_const_t<decltype(composedLambdas)>;
+  EXPECT_FALSE(composedLambdas == composedLambdas);
+
+  const auto input = CreateImage<InputImageType>(37);
+  auto filter = itk::UnaryFunctorImageFilter<InputImageType, OutputImageType, ComposedLambdasType>::New();
+  filter->SetInput(input);
+  filter->SetFunctor(composedLambdas);
+  filter->Update();
+
+  itk::ImageRegionConstIterator<InputImageType>  inputIt(input, input->GetBufferedRegion());
+  itk::ImageRegionConstIterator<OutputImageType> outputIt(filter->GetOutput(), input->GetBufferedRegion());
+  for (; !inputIt.IsAtEnd(); ++inputIt, ++outputIt)
+  {
+    EXPECT_EQ(outputIt.Get(), 2 * (inputIt.Get() + offset));
+  }
+}
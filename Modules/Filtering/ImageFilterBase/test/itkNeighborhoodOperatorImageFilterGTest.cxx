@@ -0,0 +1,163 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkNeighborhoodOperatorImageFilter.h"
+
+#include "itkConstantBoundaryCondition.h"
+#include "itkDerivativeOperator.h"
+#include "itkGaussianOperator.h"
+#include "itkImage.h"
+#include "itkImageRegionRange.h"
+#include "itkPeriodicBoundaryCondition.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTestingRandomImage.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// Returns the operator along with a radius of one, with zero elements, along
+// another axis, so that it is applied by inner products rather than along
+// lines, with the same sums.
+template <typename TOperator>
+itk::Neighborhood<typename TOperator::PixelType, TOperator::NeighborhoodDimension>
+PadOperatorAlongAnotherAxis(const TOperator & op, const unsigned int direction)
+{
+  constexpr unsigned int Dimension = TOperator::NeighborhoodDimension;
+  const unsigned int     otherDirection = (direction + 1) % Dimension;
+
+  auto radius = op.GetRadius();
+  radius[otherDirection] = 1;
+  itk::Neighborhood<typename TOperator::PixelType, Dimension> paddedOperator;
+  paddedOperator.SetRadius(radius);
+  for (auto & value : paddedOperator.GetBufferReference())
+  {
+    value = 0;
+  }
+  for (unsigned int i = 0; i < op.Size(); ++i)
+  {
+    paddedOperator[op.GetOffset(i)] = op[i];
+  }
+  return paddedOperator;
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+std::vector<typename TOutputImage::PixelType>
+ApplyOperator(const TInputImage &                                            inputImage,
+              const itk::Neighborhood<double, TInputImage::ImageDimension> & op,
+              itk::ImageBoundaryCondition<TInputImage> *                     boundaryCondition,
+              const typename TOutputImage::RegionType &                      requestedRegion,
+              const unsigned int                                             numberOfStreamDivisions)
+{
+  const auto filter = itk::NeighborhoodOperatorImageFilter<TInputImage, TOutputImage, double>::New();
+  filter->SetInput(&inputImage);
+  filter->SetOperator(op);
+  if (boundaryCondition != nullptr)
+  {
+    filter->OverrideBoundaryCondition(boundaryCondition);
+  }
+  const auto streamer = itk::StreamingImageFilter<TOutputImage, TOutputImage>::New();
+  streamer->SetInput(filter->GetOutput());
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  streamer->GetOutput()->SetRequestedRegion(requestedRegion);
+  streamer->Update();
+
+  const auto outputRange = itk::ImageRegionRange<const TOutputImage>(*streamer->GetOutput(), requestedRegion);
+  return { outputRange.cbegin(), outputRange.cend() };
+}
+
+
+// Expects an operator along each axis to give the same output along lines as
+// by inner products, with the given boundary condition.
+template <typename TInputImage, typename TOutputImage, typename TOperator>
+void
+Expect_same_output_along_lines_as_by_inner_products(const TInputImage &                        inputImage,
+                                                    TOperator &                                op,
+                                                    itk::ImageBoundaryCondition<TInputImage> * boundaryCondition)
+{
+  constexpr unsigned int Dimension = TInputImage::ImageDimension;
+
+  const typename TOutputImage::RegionType largestRegion = inputImage.GetLargestPossibleRegion();
+  auto                                    subregion = largestRegion;
+  subregion.ShrinkByRadius(2);
+
+  for (unsigned int direction = 0; direction < Dimension; ++direction)
+  {
+    op.SetDirection(direction);
+    op.CreateDirectional();
+    const auto paddedOperator = PadOperatorAlongAnotherAxis(op, direction);
+
+    for (const auto & requestedRegion : { largestRegion, subregion })
+    {
+      const auto expected =
+        ApplyOperator<TInputImage, TOutputImage>(inputImage, paddedOperator, boundaryCondition, requestedRegion, 1);
+      for (const unsigned int numberOfStreamDivisions : { 1, 3 })
+      {
+        const auto actual = ApplyOperator<TInputImage, TOutputImage>(
+          inputImage, op, boundaryCondition, requestedRegion, numberOfStreamDivisions);
+        EXPECT_EQ(actual, expected) << "direction " << direction << ", requested region " << requestedRegion;
+      }
+    }
+  }
+}
+} // namespace
+
+
+// Tests that operators along a single axis, which are applied along lines
+// in bundles, give the same output as inner products, with kernels longer
+// than the image along some axes, and with lines which are not a multiple
+// of the bundles.
+TEST(NeighborhoodOperatorImageFilter, SameOutputAlongLinesAsByInnerProducts)
+{
+  using FloatImageType = itk::Image<float, 3>;
+  using ShortImageType = itk::Image<short, 2>;
+  using UCharImageType = itk::Image<unsigned char, 3>;
+
+  itk::GaussianOperator<double, 3> gaussianOperator;
+  gaussianOperator.SetVariance(9.0);
+  gaussianOperator.SetMaximumKernelWidth(64);
+
+  itk::DerivativeOperator<double, 3> derivativeOperator;
+  derivativeOperator.SetOrder(1);
+
+  itk::DerivativeOperator<double, 2> derivativeOperator2D;
+  derivativeOperator2D.SetOrder(2);
+
+  const auto floatImage = itk::Testing::CreateRandomImage<FloatImageType>({ { 37, 19, 6 } }, 0.0f, 100.0f);
+  const auto shortImage = itk::Testing::CreateRandomImage<ShortImageType>({ { 53, 41 } }, 0, 100);
+  const auto ucharImage = itk::Testing::CreateRandomImage<UCharImageType>({ { 21, 16, 18 } }, 0, 100);
+
+  itk::ConstantBoundaryCondition<FloatImageType> constantBoundaryCondition;
+  constantBoundaryCondition.SetConstant(-7.0f);
+  itk::PeriodicBoundaryCondition<FloatImageType> periodicBoundaryCondition;
+
+  Expect_same_output_along_lines_as_by_inner_products<FloatImageType, FloatImageType>(
+    *floatImage, gaussianOperator, nullptr);
+  Expect_same_output_along_lines_as_by_inner_products<FloatImageType, FloatImageType>(
+    *floatImage, gaussianOperator, &constantBoundaryCondition);
+  Expect_same_output_along_lines_as_by_inner_products<FloatImageType, FloatImageType>(
+    *floatImage, derivativeOperator, &periodicBoundaryCondition);
+  Expect_same_output_along_lines_as_by_inner_products<ShortImageType, ShortImageType>(
+    *shortImage, derivativeOperator2D, nullptr);
+  Expect_same_output_along_lines_as_by_inner_products<UCharImageType, FloatImageType>(
+    *ucharImage, gaussianOperator, nullptr);
+}
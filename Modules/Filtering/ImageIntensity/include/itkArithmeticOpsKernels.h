@@ -0,0 +1,134 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkArithmeticOpsKernels_h
+#define itkArithmeticOpsKernels_h
+
+#include "ITKImageIntensityExport.h"
+#include "itkArithmeticOpsFunctors.h"
+#include "itkIntTypes.h"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace itk
+{
+/** \class ArithmeticOpsKernels
+ * \brief Vectorized arithmetic on contiguous arrays of scalars.
+ *
+ * These kernels implement the Add2, Sub2, Mult and Div functors with
+ * explicit SIMD code, for arrays of a same scalar type. Each kernel is
+ * compiled for the instruction sets of CPUDispatch, and the best one
+ * supported by the processor is selected at run time, so that a binary built
+ * for a baseline instruction set still uses the wide vectors of recent
+ * processors. The kernels are registered as "ArithmeticOpsKernels" in
+ * CPUDispatch.
+ *
+ * AddImageFilter, SubtractImageFilter, MultiplyImageFilter and
+ * DivideImageFilter use them for images of the supported types, through the
+ * Functor::ApplyBinaryFunctorToLine overloads of this header, which the
+ * headers of these filters include. The functors themselves remain
+ * header-only.
+ *
+ * The results are the same as those of the functors, including the
+ * wrap-around of the integer types, and the division by (almost) zero of
+ * Div. The output may be the same array as one of the inputs.
+ *
+ * \ingroup ITKImageIntensity
+ */
+class ITKImageIntensity_EXPORT ArithmeticOpsKernels
+{
+public:
+  enum class Operation : uint8_t
+  {
+    Add,
+    Subtract,
+    Multiply,
+    Divide
+  };
+
+  /** Whether the kernels are compiled for a pixel type. */
+  template <typename T>
+  static constexpr bool IsSupportedPixelType =
+    std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t> ||
+    std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t> || std::is_same_v<T, int32_t> ||
+    std::is_same_v<T, uint32_t>;
+
+  /** Whether an operation has a kernel for a pixel type. Division is only
+   * supported for floating point types. */
+  template <typename T, Operation VOperation>
+  static constexpr bool IsSupported =
+    IsSupportedPixelType<T> && (VOperation != Operation::Divide || std::is_floating_point_v<T>);
+
+  /** output[i] = input1[i] op input2[i], for i in [0, numberOfElements). */
+  template <typename T>
+  static void
+  Apply(Operation operation, const T * input1, const T * input2, T * output, SizeValueType numberOfElements);
+
+  /** output[i] = constant1 op input2[i], for i in [0, numberOfElements). */
+  template <typename T>
+  static void
+  ApplyWithConstant1(Operation operation, T constant1, const T * input2, T * output, SizeValueType numberOfElements);
+
+  /** output[i] = input1[i] op constant2, for i in [0, numberOfElements). */
+  template <typename T>
+  static void
+  ApplyWithConstant2(Operation operation, const T * input1, T constant2, T * output, SizeValueType numberOfElements);
+};
+
+namespace Functor
+{
+/** Vectorized implementations of Add2, Sub2, Mult and Div for the lines of
+ * pixels processed by BinaryGeneratorImageFilter, when the inputs and the
+ * output have the same scalar type.
+ * \sa ArithmeticOpsKernels */
+#define ITK_ARITHMETIC_OPS_FUNCTOR_LINE_KERNELS(functorName, operation)                                               \
+  template <typename T>                                                                                              \
+  std::enable_if_t<ArithmeticOpsKernels::IsSupported<T, ArithmeticOpsKernels::Operation::operation>>                 \
+  ApplyBinaryFunctorToLine(                                                                                          \
+    const functorName<T, T, T> &, const T * input1, const T * input2, T * output, SizeValueType numberOfPixels)      \
+  {                                                                                                                  \
+    ArithmeticOpsKernels::Apply(ArithmeticOpsKernels::Operation::operation, input1, input2, output, numberOfPixels); \
+  }                                                                                                                  \
+  template <typename T>                                                                                              \
+  std::enable_if_t<ArithmeticOpsKernels::IsSupported<T, ArithmeticOpsKernels::Operation::operation>>                 \
+  ApplyBinaryFunctorToLineWithConstant1(                                                                             \
+    const functorName<T, T, T> &, const T & constant1, const T * input2, T * output, SizeValueType numberOfPixels)   \
+  {                                                                                                                  \
+    ArithmeticOpsKernels::ApplyWithConstant1(                                                                        \
+      ArithmeticOpsKernels::Operation::operation, constant1, input2, output, numberOfPixels);                        \
+  }                                                                                                                  \
+  template <typename T>                                                                                              \
+  std::enable_if_t<ArithmeticOpsKernels::IsSupported<T, ArithmeticOpsKernels::Operation::operation>>                 \
+  ApplyBinaryFunctorToLineWithConstant2(                                                                             \
+    const functorName<T, T, T> &, const T * input1, const T & constant2, T * output, SizeValueType numberOfPixels)   \
+  {                                                                                                                  \
+    ArithmeticOpsKernels::ApplyWithConstant2(                                                                        \
+      ArithmeticOpsKernels::Operation::operation, input1, constant2, output, numberOfPixels);                        \
+  }                                                                                                                  \
+  ITK_MACROEND_NOOP_STATEMENT
+
+ITK_ARITHMETIC_OPS_FUNCTOR_LINE_KERNELS(Add2, Add);
+ITK_ARITHMETIC_OPS_FUNCTOR_LINE_KERNELS(Sub2, Subtract);
+ITK_ARITHMETIC_OPS_FUNCTOR_LINE_KERNELS(Mult, Multiply);
+ITK_ARITHMETIC_OPS_FUNCTOR_LINE_KERNELS(Div, Divide);
+
+#undef ITK_ARITHMETIC_OPS_FUNCTOR_LINE_KERNELS
+} // namespace Functor
+} // end namespace itk
+
+#endif
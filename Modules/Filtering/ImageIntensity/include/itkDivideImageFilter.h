@@ -20,6 +20,7 @@
 
 #include "itkBinaryGeneratorImageFilter.h"
 #include "itkArithmeticOpsFunctors.h"
+#include "itkArithmeticOpsKernels.h"
 #include "itkNumericTraits.h"
 #include "itkMath.h"
 
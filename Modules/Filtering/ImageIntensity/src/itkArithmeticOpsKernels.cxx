@@ -0,0 +1,263 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkArithmeticOpsKernels.h"
+#include "itkCPUDispatch.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// The kernels are written with the vector extensions of GCC and Clang, which
+// are compiled to the instructions of the target of each variant.
+#if defined(__GNUC__)
+#  define ITK_ARITHMETIC_OPS_KERNELS_USE_VECTOR_EXTENSIONS
+#endif
+
+namespace itk
+{
+namespace
+{
+using OperationEnum = ArithmeticOpsKernels::Operation;
+
+// An operand read from an array.
+template <typename T>
+struct ArrayOperand
+{
+  const T * m_Pointer;
+
+  ITK_CPU_DISPATCH_INLINE T
+  operator[](SizeValueType i) const
+  {
+    return m_Pointer[i];
+  }
+
+  template <typename TVector>
+  ITK_CPU_DISPATCH_INLINE TVector
+  Load(SizeValueType i) const
+  {
+    TVector vector;
+    std::memcpy(&vector, m_Pointer + i, sizeof(TVector));
+    return vector;
+  }
+};
+
+// A constant operand, broadcast to all the elements.
+template <typename T>
+struct ConstantOperand
+{
+  T m_Value;
+
+  ITK_CPU_DISPATCH_INLINE T
+  operator[](SizeValueType) const
+  {
+    return m_Value;
+  }
+
+  template <typename TVector>
+  ITK_CPU_DISPATCH_INLINE TVector
+  Load(SizeValueType) const
+  {
+    return TVector{} + m_Value;
+  }
+};
+
+// The operations, on scalars (with the conversion of Functor::Add2 and its
+// siblings) and on vectors.
+template <typename T>
+struct AddOperation
+{
+  template <typename TValue>
+  ITK_CPU_DISPATCH_INLINE TValue
+  operator()(const TValue & a, const TValue & b) const
+  {
+    return static_cast<TValue>(a + b);
+  }
+};
+
+template <typename T>
+struct SubtractOperation
+{
+  template <typename TValue>
+  ITK_CPU_DISPATCH_INLINE TValue
+  operator()(const TValue & a, const TValue & b) const
+  {
+    return static_cast<TValue>(a - b);
+  }
+};
+
+template <typename T>
+struct MultiplyOperation
+{
+  template <typename TValue>
+  ITK_CPU_DISPATCH_INLINE TValue
+  operator()(const TValue & a, const TValue & b) const
+  {
+    return static_cast<TValue>(a * b);
+  }
+};
+
+// Like Functor::Div: a denominator which is almost zero, according to
+// Math::AlmostEquals, gives the largest value of the type.
+template <typename T>
+struct DivideOperation
+{
+  static constexpr T tolerance = static_cast<T>(0.1 * std::numeric_limits<T>::epsilon());
+
+  ITK_CPU_DISPATCH_INLINE T
+  operator()(const T & a, const T & b) const
+  {
+    return (std::abs(b) <= tolerance) ? std::numeric_limits<T>::max() : a / b;
+  }
+
+#ifdef ITK_ARITHMETIC_OPS_KERNELS_USE_VECTOR_EXTENSIONS
+  template <typename TVector>
+  ITK_CPU_DISPATCH_INLINE TVector
+  operator()(const TVector & a, const TVector & b) const
+  {
+    const auto isAlmostZero = (b <= tolerance) & (b >= -tolerance);
+    // Divide by one instead of zero, to not raise floating point exceptions.
+    const TVector quotient = a / (isAlmostZero ? TVector{} + T{ 1 } : b);
+    return isAlmostZero ? TVector{} + std::numeric_limits<T>::max() : quotient;
+  }
+#endif
+};
+
+template <unsigned int VVectorBytes, typename T, typename TOperand1, typename TOperand2, typename TOperation>
+ITK_CPU_DISPATCH_INLINE void
+ApplyVectorized(const TOperand1 & input1,
+                const TOperand2 & input2,
+                T *               output,
+                SizeValueType     numberOfElements,
+                TOperation        operation)
+{
+  SizeValueType i = 0;
+#ifdef ITK_ARITHMETIC_OPS_KERNELS_USE_VECTOR_EXTENSIONS
+  typedef T                     VectorType __attribute__((vector_size(VVectorBytes)));
+  constexpr SizeValueType       lanes = VVectorBytes / sizeof(T);
+  for (; i + lanes <= numberOfElements; i += lanes)
+  {
+    const VectorType result =
+      operation(input1.template Load<VectorType>(i), input2.template Load<VectorType>(i));
+    std::memcpy(output + i, &result, sizeof(VectorType));
+  }
+#endif
+  for (; i < numberOfElements; ++i)
+  {
+    output[i] = operation(input1[i], input2[i]);
+  }
+}
+
+// The width of the vectors of an instruction set.
+template <CPUDispatchEnums::InstructionSet VInstructionSet>
+constexpr unsigned int VectorBytes = VInstructionSet == CPUDispatchEnums::InstructionSet::AVX512 ? 64
+                                     : VInstructionSet == CPUDispatchEnums::InstructionSet::AVX2 ? 32
+                                                                                                 : 16;
+
+template <typename T, typename TOperand1, typename TOperand2, typename TOperation>
+struct ArithmeticOpsKernel
+{
+  template <CPUDispatchEnums::InstructionSet VInstructionSet>
+  static ITK_CPU_DISPATCH_INLINE void
+  Run(TOperand1 input1, TOperand2 input2, T * output, SizeValueType numberOfElements)
+  {
+    ApplyVectorized<VectorBytes<VInstructionSet>>(input1, input2, output, numberOfElements, TOperation{});
+  }
+};
+
+// One table per combination of types, all registered as ArithmeticOpsKernels.
+template <typename T, typename TOperand1, typename TOperand2, typename TOperation>
+const auto arithmeticOpsKernelTable =
+  CPUDispatchTable<void(TOperand1, TOperand2, T *, SizeValueType)>::template FromKernel<
+    ArithmeticOpsKernel<T, TOperand1, TOperand2, TOperation>>("ArithmeticOpsKernels");
+
+template <typename T, typename TOperand1, typename TOperand2>
+void
+ApplyOperation(OperationEnum operation, const TOperand1 & input1, const TOperand2 & input2, T * output, SizeValueType n)
+{
+  switch (operation)
+  {
+    case OperationEnum::Add:
+      arithmeticOpsKernelTable<T, TOperand1, TOperand2, AddOperation<T>>(input1, input2, output, n);
+      return;
+    case OperationEnum::Subtract:
+      arithmeticOpsKernelTable<T, TOperand1, TOperand2, SubtractOperation<T>>(input1, input2, output, n);
+      return;
+    case OperationEnum::Multiply:
+      arithmeticOpsKernelTable<T, TOperand1, TOperand2, MultiplyOperation<T>>(input1, input2, output, n);
+      return;
+    case OperationEnum::Divide:
+      if constexpr (std::is_floating_point_v<T>)
+      {
+        arithmeticOpsKernelTable<T, TOperand1, TOperand2, DivideOperation<T>>(input1, input2, output, n);
+        return;
+      }
+      break;
+  }
+  itkGenericExceptionMacro("Unsupported arithmetic operation for this pixel type.");
+}
+} // namespace
+
+template <typename T>
+void
+ArithmeticOpsKernels::Apply(Operation operation, const T * input1, const T * input2, T * output, SizeValueType n)
+{
+  ApplyOperation(operation, ArrayOperand<T>{ input1 }, ArrayOperand<T>{ input2 }, output, n);
+}
+
+template <typename T>
+void
+ArithmeticOpsKernels::ApplyWithConstant1(Operation     operation,
+                                         T             constant1,
+                                         const T *     input2,
+                                         T *           output,
+                                         SizeValueType n)
+{
+  ApplyOperation(operation, ConstantOperand<T>{ constant1 }, ArrayOperand<T>{ input2 }, output, n);
+}
+
+template <typename T>
+void
+ArithmeticOpsKernels::ApplyWithConstant2(Operation     operation,
+                                         const T *     input1,
+                                         T             constant2,
+                                         T *           output,
+                                         SizeValueType n)
+{
+  ApplyOperation(operation, ArrayOperand<T>{ input1 }, ConstantOperand<T>{ constant2 }, output, n);
+}
+
+#define ITK_INSTANTIATE_ARITHMETIC_OPS_KERNELS(T)                                                                     \
+  template ITKImageIntensity_EXPORT void ArithmeticOpsKernels::Apply<T>(                                             \
+    Operation, const T *, const T *, T *, SizeValueType);                                                             \
+  template ITKImageIntensity_EXPORT void ArithmeticOpsKernels::ApplyWithConstant1<T>(                                \
+    Operation, T, const T *, T *, SizeValueType);                                                                     \
+  template ITKImageIntensity_EXPORT void ArithmeticOpsKernels::ApplyWithConstant2<T>(                                \
+    Operation, const T *, T, T *, SizeValueType)
+
+ITK_INSTANTIATE_ARITHMETIC_OPS_KERNELS(float);
+ITK_INSTANTIATE_ARITHMETIC_OPS_KERNELS(double);
+ITK_INSTANTIATE_ARITHMETIC_OPS_KERNELS(int8_t);
+ITK_INSTANTIATE_ARITHMETIC_OPS_KERNELS(uint8_t);
+ITK_INSTANTIATE_ARITHMETIC_OPS_KERNELS(int16_t);
+ITK_INSTANTIATE_ARITHMETIC_OPS_KERNELS(uint16_t);
+ITK_INSTANTIATE_ARITHMETIC_OPS_KERNELS(int32_t);
+ITK_INSTANTIATE_ARITHMETIC_OPS_KERNELS(uint32_t);
+
+#undef ITK_INSTANTIATE_ARITHMETIC_OPS_KERNELS
+
+} // end namespace itk
@@ -19,6 +19,7 @@
 #define itkGrayscaleErodeImageFilter_hxx
 
 #include "itkNumericTraits.h"
+#include "itkVanHerkGilWermanUtilities.h"
 #include "itkProgressAccumulator.h"
 #include <string>
 
@@ -58,6 +59,11 @@ GrayscaleErodeImageFilter<TInputImage, TOutputImage, TKernel>::SetKernel(const K
     m_AnchorFilter->SetKernel(*flatKernel);
     m_Algorithm = AlgorithmEnum::ANCHOR;
   }
+  else if (IsKernelFasterByChords(kernel))
+  {
+    m_VHGWFilter->SetKernel(MakeChordKernel<FlatKernelType>(kernel));
+    m_Algorithm = AlgorithmEnum::VHGW;
+  }
   else if (m_HistogramFilter->GetUseVectorBasedAlgorithm())
   {
     // histogram based filter is as least as good as the basic one, so always
@@ -126,6 +132,10 @@ GrayscaleErodeImageFilter<TInputImage, TOutputImage, TKernel>::SetAlgorithm(Algo
     {
       m_VHGWFilter->SetKernel(*flatKernel);
     }
+    else if (algo == AlgorithmEnum::VHGW && GetNumberOfKernelChords(this->GetKernel()) > 0)
+    {
+      m_VHGWFilter->SetKernel(MakeChordKernel<FlatKernelType>(this->GetKernel()));
+    }
     else
     {
       itkExceptionMacro("Invalid algorithm");
@@ -19,6 +19,7 @@
 #define itkGrayscaleMorphologicalOpeningImageFilter_hxx
 
 #include "itkNumericTraits.h"
+#include "itkVanHerkGilWermanUtilities.h"
 #include "itkProgressAccumulator.h"
 #include <string>
 #include "itkCropImageFilter.h"
@@ -48,6 +49,13 @@ GrayscaleMorphologicalOpeningImageFilter<TInputImage, TOutputImage, TKernel>::Se
     m_AnchorFilter->SetKernel(*flatKernel);
     m_Algorithm = AlgorithmEnum::ANCHOR;
   }
+  else if (IsKernelFasterByChords(kernel))
+  {
+    const auto chordKernel = MakeChordKernel<FlatKernelType>(kernel);
+    m_VanHerkGilWermanDilateFilter->SetKernel(chordKernel);
+    m_VanHerkGilWermanErodeFilter->SetKernel(chordKernel);
+    m_Algorithm = AlgorithmEnum::VHGW;
+  }
   else if (m_HistogramDilateFilter->GetUseVectorBasedAlgorithm())
   {
     // histogram based filter is as least as good as the basic one, so always
@@ -109,6 +117,12 @@ GrayscaleMorphologicalOpeningImageFilter<TInputImage, TOutputImage, TKernel>::Se
       m_VanHerkGilWermanDilateFilter->SetKernel(*flatKernel);
       m_VanHerkGilWermanErodeFilter->SetKernel(*flatKernel);
     }
+    else if (algo == AlgorithmEnum::VHGW && GetNumberOfKernelChords(this->GetKernel()) > 0)
+    {
+      const auto chordKernel = MakeChordKernel<FlatKernelType>(this->GetKernel());
+      m_VanHerkGilWermanDilateFilter->SetKernel(chordKernel);
+      m_VanHerkGilWermanErodeFilter->SetKernel(chordKernel);
+    }
     else
     {
       itkExceptionMacro("Invalid algorithm");
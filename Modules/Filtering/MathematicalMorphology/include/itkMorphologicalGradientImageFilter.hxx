@@ -19,6 +19,7 @@
 #define itkMorphologicalGradientImageFilter_hxx
 
 #include "itkNumericTraits.h"
+#include "itkVanHerkGilWermanUtilities.h"
 #include "itkProgressAccumulator.h"
 #include <string>
 
@@ -49,6 +50,13 @@ MorphologicalGradientImageFilter<TInputImage, TOutputImage, TKernel>::SetKernel(
     m_AnchorErodeFilter->SetKernel(*flatKernel);
     m_Algorithm = AlgorithmEnum::ANCHOR;
   }
+  else if (IsKernelFasterByChords(kernel))
+  {
+    const auto chordKernel = MakeChordKernel<FlatKernelType>(kernel);
+    m_VanHerkGilWermanDilateFilter->SetKernel(chordKernel);
+    m_VanHerkGilWermanErodeFilter->SetKernel(chordKernel);
+    m_Algorithm = AlgorithmEnum::VHGW;
+  }
   else if (m_HistogramFilter->GetUseVectorBasedAlgorithm())
   {
     // histogram based filter is as least as good as the basic one, so always
@@ -108,6 +116,12 @@ MorphologicalGradientImageFilter<TInputImage, TOutputImage, TKernel>::SetAlgorit
       m_VanHerkGilWermanDilateFilter->SetKernel(*flatKernel);
       m_VanHerkGilWermanErodeFilter->SetKernel(*flatKernel);
     }
+    else if (algo == AlgorithmEnum::VHGW && GetNumberOfKernelChords(this->GetKernel()) > 0)
+    {
+      const auto chordKernel = MakeChordKernel<FlatKernelType>(this->GetKernel());
+      m_VanHerkGilWermanDilateFilter->SetKernel(chordKernel);
+      m_VanHerkGilWermanErodeFilter->SetKernel(chordKernel);
+    }
     else
     {
       itkExceptionMacro("Invalid algorithm");
@@ -22,6 +22,7 @@
 #include "itkIntTypes.h"
 #include "itkNumericTraits.h"
 
+#include <algorithm>
 #include <map>
 #include <vector>
 
@@ -35,7 +36,10 @@ namespace Function
  * be maps, the other vectors.
  *
  * This version is intended for keeping track of arbitrary ranks. It
- * is based on the code from consolidatedMorphology.
+ * is based on the code from consolidatedMorphology. The 8 bit pixel
+ * types use a VectorRankHistogram instead of a map. The 16 bit ones keep
+ * the map, since the moving histogram filters copy their histograms as
+ * they change lines, which costs more than the map saves.
  *
  * This is a modified version for use with masks. Need to allow for
  * the situation in which the map is empty.
@@ -270,6 +274,18 @@ private:
 };
 
 
+/** \class VectorRankHistogram
+ * \brief A rank histogram with a bin for each value of a small integer
+ * pixel type.
+ *
+ * The bins are grouped in coarse bins of the square root of the number of
+ * values, so that a rank is found by summing the coarse bins, then the fine
+ * bins of a single coarse bin. It is the coarse to fine search of the
+ * constant time median filter of Perreault and Hebert, "Median Filtering in
+ * Constant Time", IEEE Transactions on Image Processing 16(9), 2007.
+ *
+ * \sa RankHistogram
+ */
 template <typename TInputPixel>
 class VectorRankHistogram
 {
@@ -281,16 +297,8 @@ public:
     m_Size = (OffsetValueType)NumericTraits<TInputPixel>::max() -
              (OffsetValueType)NumericTraits<TInputPixel>::NonpositiveMin() + 1;
     m_Vec.resize(m_Size, 0);
-    if (m_Compare(NumericTraits<TInputPixel>::max(), NumericTraits<TInputPixel>::NonpositiveMin()))
-    {
-      m_InitVal = NumericTraits<TInputPixel>::NonpositiveMin();
-    }
-    else
-    {
-      m_InitVal = NumericTraits<TInputPixel>::max();
-    }
-    m_Entries = m_Below = 0;
-    m_RankValue = m_InitVal - NumericTraits<TInputPixel>::NonpositiveMin();
+    m_Coarse.resize(((m_Size - 1) >> CoarseShift) + 1, 0);
+    m_Entries = 0;
     m_Rank = 0.5;
   }
 
@@ -321,7 +329,28 @@ public:
   TInputPixel
   GetValue(const TInputPixel &)
   {
-    return GetValueBruteForce();
+    const SizeValueType target = (SizeValueType)(m_Rank * (m_Entries - 1)) + 1;
+    SizeValueType       count = 0;
+
+    // find the coarse bin holding the rank, then the fine bin within it
+    SizeValueType coarse = 0;
+    while (coarse + 1 < m_Coarse.size() && count + m_Coarse[coarse] < target)
+    {
+      count += m_Coarse[coarse];
+      ++coarse;
+    }
+    const SizeValueType end = std::min((coarse + 1) << CoarseShift, m_Size);
+    for (SizeValueType i = coarse << CoarseShift; i < end; ++i)
+    {
+      count += m_Vec[i];
+      if (count >= target)
+      {
+        const TInputPixel value = i + NumericTraits<TInputPixel>::NonpositiveMin();
+        itkAssertInDebugAndIgnoreInReleaseMacro(value == GetValueBruteForce());
+        return value;
+      }
+    }
+    return NumericTraits<TInputPixel>::max();
   }
 
   void
@@ -330,10 +359,7 @@ public:
     const OffsetValueType q = (OffsetValueType)p - NumericTraits<TInputPixel>::NonpositiveMin();
 
     m_Vec[q]++;
-    if (m_Compare(p, m_RankValue) || p == m_RankValue)
-    {
-      ++m_Below;
-    }
+    m_Coarse[q >> CoarseShift]++;
     ++m_Entries;
   }
 
@@ -348,12 +374,8 @@ public:
     itkAssertInDebugAndIgnoreInReleaseMacro(m_Vec[q] > 0);
 
     m_Vec[q]--;
+    m_Coarse[q >> CoarseShift]--;
     --m_Entries;
-
-    if (m_Compare(p, m_RankValue) || p == m_RankValue)
-    {
-      --m_Below;
-    }
   }
 
   void
@@ -382,12 +404,12 @@ protected:
 private:
   using VecType = typename std::vector<SizeValueType>;
 
+  // a coarse bin for each value of the upper half of the bits
+  static constexpr unsigned int CoarseShift = 4 * sizeof(TInputPixel);
+
   VecType       m_Vec;
+  VecType       m_Coarse;
   SizeValueType m_Size;
-  Compare       m_Compare;
-  TInputPixel   m_RankValue;
-  TInputPixel   m_InitVal;
-  int           m_Below;
   int           m_Entries;
 };
 
@@ -36,6 +36,15 @@ class KernelImageFilter;
  * The SetBoundary facility isn't necessary for operation of the
  * anchor method but is included for compatibility with other
  * morphology classes in itk.
+ *
+ * Kernels which are not decomposable, such as balls and ellipses, are
+ * applied a chord at a time, if each of their lines along the first
+ * dimension holds a single run of pixels, or chord. Each line of the
+ * output is the extremum of the lines of the input around it, filtered
+ * along the first dimension with the van Herk/Gil-Werman algorithm over
+ * the chord at their offset. The cost per pixel grows with the number of
+ * lines of the kernel instead of its number of pixels, and is exact, unlike
+ * a polygonal decomposition of the kernel.
  * \ingroup ITKMathematicalMorphology
  */
 template <typename TImage, typename TKernel, typename TFunction1>
@@ -93,6 +102,10 @@ protected:
 private:
   using BresType = BresenhamLine<Self::InputImageDimension>;
 
+  /** Applies a kernel which is not decomposable a chord at a time. */
+  void
+  GenerateDataWithChords(const InputImageRegionType & outputRegionForThread);
+
 }; // end of class
 } // end namespace itk
 
@@ -19,6 +19,8 @@
 #define itkVanHerkGilWermanErodeDilateImageFilter_hxx
 
 #include "itkImageRegionIterator.h"
+#include "itkIndexRange.h"
+#include "itkTotalProgressReporter.h"
 
 #include "itkVanHerkGilWermanUtilities.h"
 
@@ -37,10 +39,10 @@ void
 VanHerkGilWermanErodeDilateImageFilter<TImage, TKernel, TFunction1>::DynamicThreadedGenerateData(
   const InputImageRegionType & outputRegionForThread)
 {
-  // check that we are using a decomposable kernel
   if (!this->GetKernel().GetDecomposable())
   {
-    itkExceptionMacro("VanHerkGilWerman morphology only works with decomposable structuring elements");
+    this->GenerateDataWithChords(outputRegionForThread);
+    return;
   }
 
   // TFunction1 will be < for erosions
@@ -114,6 +116,101 @@ VanHerkGilWermanErodeDilateImageFilter<TImage, TKernel, TFunction1>::DynamicThre
   ImageAlgorithm::Copy(input.GetPointer(), this->GetOutput(), OReg, OReg);
 }
 
+template <typename TImage, typename TKernel, typename TFunction1>
+void
+VanHerkGilWermanErodeDilateImageFilter<TImage, TKernel, TFunction1>::GenerateDataWithChords(
+  const InputImageRegionType & outputRegionForThread)
+{
+  std::vector<std::pair<typename KernelType::OffsetType, typename KernelType::OffsetType>> chords;
+  if (!GetKernelChords(this->GetKernel(), chords))
+  {
+    itkExceptionMacro("VanHerkGilWerman morphology only works with decomposable structuring elements, or those "
+                      "whose lines along the first dimension hold a single run of pixels");
+  }
+
+  const InputImageType *     input = this->GetInput();
+  InputImageType *           output = this->GetOutput();
+  const InputImageRegionType bufferedRegion = input->GetBufferedRegion();
+  const InputImagePixelType  boundary = m_Boundary;
+  TFunction1                 function;
+
+  // the line buffer spans the pixels of all the chords around a line of the
+  // output, with the boundary value outside the input
+  const IndexValueType lineStart = outputRegionForThread.GetIndex(0);
+  const auto           lineLength = static_cast<IndexValueType>(outputRegionForThread.GetSize(0));
+  OffsetValueType      chordsBegin = 0;
+  OffsetValueType      chordsEnd = 0;
+  for (const auto & chord : chords)
+  {
+    chordsBegin = std::min(chordsBegin, chord.first[0]);
+    chordsEnd = std::max(chordsEnd, chord.second[0]);
+  }
+  const IndexValueType bufferStart = lineStart + chordsBegin;
+  const IndexValueType bufferLength = lineLength + chordsEnd - chordsBegin;
+  const IndexValueType copyBegin = std::max(bufferStart, bufferedRegion.GetIndex(0));
+  const IndexValueType copyEnd = std::min(bufferStart + bufferLength,
+                                          bufferedRegion.GetIndex(0) +
+                                            static_cast<IndexValueType>(bufferedRegion.GetSize(0)));
+
+  std::vector<InputImagePixelType> buffer(bufferLength);
+  std::vector<InputImagePixelType> forward(bufferLength);
+  std::vector<InputImagePixelType> reverse(bufferLength);
+  std::vector<InputImagePixelType> result(lineLength, boundary);
+
+  TotalProgressReporter progress(this, output->GetRequestedRegion().GetNumberOfPixels());
+
+  InputImageRegionType lineRegion = outputRegionForThread;
+  lineRegion.SetSize(0, 1);
+  for (const auto & index : ImageRegionIndexRange<InputImageDimension>(lineRegion))
+  {
+    for (size_t c = 0; c < chords.size(); ++c)
+    {
+      IndexType chordIndex = index + chords[c].first;
+      chordIndex[0] = copyBegin;
+      if (copyBegin >= copyEnd || !bufferedRegion.IsInside(chordIndex))
+      {
+        // the line is outside the input
+        for (auto & value : result)
+        {
+          value = c == 0 ? boundary : function(value, boundary);
+        }
+        continue;
+      }
+      std::fill(buffer.begin(), buffer.begin() + (copyBegin - bufferStart), boundary);
+      std::copy_n(&input->GetPixel(chordIndex), copyEnd - copyBegin, buffer.begin() + (copyBegin - bufferStart));
+      std::fill(buffer.begin() + (copyEnd - bufferStart), buffer.end(), boundary);
+
+      // the extrema from the start of each block of the chord length to the
+      // pixel, and from the pixel to the end of its block, so that the
+      // extremum over a chord is that of two of them
+      const OffsetValueType chordLength = chords[c].second[0] - chords[c].first[0] + 1;
+      const OffsetValueType first = chords[c].first[0] - chordsBegin;
+      const OffsetValueType last = first + lineLength + chordLength - 1;
+      for (OffsetValueType i = first; i < last; i += chordLength)
+      {
+        const OffsetValueType blockEnd = std::min(i + chordLength, last);
+        forward[i] = buffer[i];
+        for (OffsetValueType j = i + 1; j < blockEnd; ++j)
+        {
+          forward[j] = function(buffer[j], forward[j - 1]);
+        }
+        reverse[blockEnd - 1] = buffer[blockEnd - 1];
+        for (OffsetValueType j = blockEnd - 2; j >= i; --j)
+        {
+          reverse[j] = function(buffer[j], reverse[j + 1]);
+        }
+      }
+      for (IndexValueType x = 0; x < lineLength; ++x)
+      {
+        const InputImagePixelType value = function(reverse[first + x], forward[first + x + chordLength - 1]);
+        result[x] = c == 0 ? value : function(result[x], value);
+      }
+    }
+    std::copy(result.begin(), result.end(), &output->GetPixel(index));
+    progress.Completed(lineLength);
+  }
+}
+
 template <typename TImage, typename TKernel, typename TFunction1>
 void
 VanHerkGilWermanErodeDilateImageFilter<TImage, TKernel, TFunction1>::PrintSelf(std::ostream & os, Indent indent) const
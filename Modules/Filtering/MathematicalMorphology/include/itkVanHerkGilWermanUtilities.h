@@ -19,6 +19,8 @@
 #define itkVanHerkGilWermanUtilities_h
 
 #include <list>
+#include <utility>
+#include <vector>
 
 #include "itkSharedMorphologyUtilities.h"
 
@@ -58,6 +60,35 @@ DoFace(typename TImage::ConstPointer             input,
        std::vector<typename TImage::PixelType> & rExtBuffer,
        const typename TImage::RegionType         AllImage,
        const typename TImage::RegionType         face);
+
+/** Decomposes a kernel into chords, the runs of its pixels along the first
+ * dimension, given by the offsets of their first and last pixels. Returns
+ * false when a line of the kernel holds several chords. A pixel belongs to
+ * the kernel when it is positive, as in BasicDilateImageFilter. */
+template <typename TKernel>
+bool
+GetKernelChords(const TKernel &                                                                  kernel,
+                std::vector<std::pair<typename TKernel::OffsetType, typename TKernel::OffsetType>> & chords);
+
+/** Returns the number of chords of a kernel, or zero when a line of the
+ * kernel holds several chords. */
+template <typename TKernel>
+SizeValueType
+GetNumberOfKernelChords(const TKernel & kernel);
+
+/** Returns whether a kernel which is not decomposable is applied faster a
+ * chord at a time by VanHerkGilWermanErodeDilateImageFilter than by the
+ * basic and histogram based filters. The grayscale morphology filters select
+ * their algorithm with it. */
+template <typename TKernel>
+bool
+IsKernelFasterByChords(const TKernel & kernel);
+
+/** Returns the flat structuring element of the pixels of a kernel, which
+ * is applied a chord at a time when it is not decomposable. */
+template <typename TFlatKernel, typename TKernel>
+TFlatKernel
+MakeChordKernel(const TKernel & kernel);
 } // namespace itk
 
 #ifndef ITK_MANUAL_INSTANTIATION
@@ -216,6 +216,79 @@ DoFace(typename TImage::ConstPointer             input,
   }
 }
 
+template <typename TKernel>
+bool
+GetKernelChords(const TKernel &                                                                  kernel,
+                std::vector<std::pair<typename TKernel::OffsetType, typename TKernel::OffsetType>> & chords)
+{
+  chords.clear();
+  // the pixels of a line along the first dimension are contiguous in the
+  // kernel
+  const SizeValueType lineLength = kernel.GetSize(0);
+  for (SizeValueType lineStart = 0; lineStart < kernel.Size(); lineStart += lineLength)
+  {
+    bool lineHasChord = false;
+    bool inChord = false;
+    for (SizeValueType i = lineStart; i < lineStart + lineLength; ++i)
+    {
+      if (kernel[i] > typename TKernel::PixelType{})
+      {
+        if (inChord)
+        {
+          chords.back().second = kernel.GetOffset(i);
+        }
+        else if (lineHasChord)
+        {
+          return false;
+        }
+        else
+        {
+          chords.emplace_back(kernel.GetOffset(i), kernel.GetOffset(i));
+          lineHasChord = true;
+          inChord = true;
+        }
+      }
+      else
+      {
+        inChord = false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename TKernel>
+SizeValueType
+GetNumberOfKernelChords(const TKernel & kernel)
+{
+  std::vector<std::pair<typename TKernel::OffsetType, typename TKernel::OffsetType>> chords;
+  return GetKernelChords(kernel, chords) ? chords.size() : 0;
+}
+
+template <typename TKernel>
+bool
+IsKernelFasterByChords(const TKernel & kernel)
+{
+  // kernels such as balls are applied a chord at a time along the first
+  // dimension, which is faster than both the basic and histogram based
+  // filters unless the kernel is tiny
+  const SizeValueType numberOfChords = GetNumberOfKernelChords(kernel);
+  return numberOfChords > 0 && 2 * numberOfChords < kernel.Size();
+}
+
+template <typename TFlatKernel, typename TKernel>
+TFlatKernel
+MakeChordKernel(const TKernel & kernel)
+{
+  TFlatKernel chordKernel;
+  chordKernel.SetRadius(kernel.GetRadius());
+  for (SizeValueType i = 0; i < kernel.Size(); ++i)
+  {
+    chordKernel[i] = kernel[i] > typename TKernel::PixelType{};
+  }
+  return chordKernel;
+}
+
 } // namespace itk
 
 #endif
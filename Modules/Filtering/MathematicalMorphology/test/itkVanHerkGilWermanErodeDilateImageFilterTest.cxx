@@ -16,10 +16,93 @@
  *
  *=========================================================================*/
 
+#include "itkBasicDilateImageFilter.h"
+#include "itkBasicErodeImageFilter.h"
+#include "itkConstantBoundaryCondition.h"
 #include "itkFlatStructuringElement.h"
-#include "itkVanHerkGilWermanErodeDilateImageFilter.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkVanHerkGilWermanDilateImageFilter.h"
+#include "itkVanHerkGilWermanErodeImageFilter.h"
 #include "itkTestingMacros.h"
 
+namespace
+{
+template <typename TImage>
+typename TImage::Pointer
+MakeInputImage(const typename TImage::SizeType & size)
+{
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  unsigned int seed = 17;
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    seed = seed * 1103515245 + 12345;
+    it.Set(static_cast<typename TImage::PixelType>((seed >> 16) % 200));
+  }
+  return image;
+}
+
+template <typename TImage>
+bool
+CompareImages(const TImage * expected, const TImage * actual, const std::string & description)
+{
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(expected, expected->GetBufferedRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    if (it.Get() != actual->GetPixel(it.GetIndex()))
+    {
+      std::cerr << "Test failed for " << description << '!' << std::endl;
+      std::cerr << "Expected " << it.Get() << " at " << it.GetIndex() << ", but got "
+                << actual->GetPixel(it.GetIndex()) << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Erode and dilate the image with a kernel which is not decomposable into
+// lines, one chord at a time, and compare with the basic filters.
+template <typename TImage, typename TKernel>
+bool
+CompareWithBasicFilters(const TImage * input, const TKernel & kernel, const std::string & description)
+{
+  using PixelType = typename TImage::PixelType;
+
+  itk::ConstantBoundaryCondition<TImage> erodeBoundaryCondition;
+  erodeBoundaryCondition.SetConstant(itk::NumericTraits<PixelType>::max());
+  itk::ConstantBoundaryCondition<TImage> dilateBoundaryCondition;
+  dilateBoundaryCondition.SetConstant(itk::NumericTraits<PixelType>::NonpositiveMin());
+
+  auto basicErode = itk::BasicErodeImageFilter<TImage, TImage, TKernel>::New();
+  basicErode->SetInput(input);
+  basicErode->SetKernel(kernel);
+  basicErode->OverrideBoundaryCondition(&erodeBoundaryCondition);
+  basicErode->Update();
+
+  auto erode = itk::VanHerkGilWermanErodeImageFilter<TImage, TKernel>::New();
+  erode->SetInput(input);
+  erode->SetKernel(kernel);
+  erode->SetBoundary(itk::NumericTraits<PixelType>::max());
+  erode->Update();
+
+  auto basicDilate = itk::BasicDilateImageFilter<TImage, TImage, TKernel>::New();
+  basicDilate->SetInput(input);
+  basicDilate->SetKernel(kernel);
+  basicDilate->OverrideBoundaryCondition(&dilateBoundaryCondition);
+  basicDilate->Update();
+
+  auto dilate = itk::VanHerkGilWermanDilateImageFilter<TImage, TKernel>::New();
+  dilate->SetInput(input);
+  dilate->SetKernel(kernel);
+  dilate->SetBoundary(itk::NumericTraits<PixelType>::NonpositiveMin());
+  dilate->Update();
+
+  return CompareImages<TImage>(basicErode->GetOutput(), erode->GetOutput(), "erosion with " + description) &&
+         CompareImages<TImage>(basicDilate->GetOutput(), dilate->GetOutput(), "dilation with " + description);
+}
+} // namespace
 
 int
 itkVanHerkGilWermanErodeDilateImageFilterTest(int, char ** const)
@@ -41,7 +124,36 @@ itkVanHerkGilWermanErodeDilateImageFilterTest(int, char ** const)
   filter->SetBoundary(boundary);
   ITK_TEST_SET_GET_VALUE(boundary, filter->GetBoundary());
 
+  bool success = true;
+
+  // Balls, ellipses and crosses are applied a chord at a time, on images
+  // which are smaller than the kernel along some of the dimensions.
+  const auto image = MakeInputImage<ImageType>({ { 41, 7 } });
+  success &= CompareWithBasicFilters<ImageType>(image, KernelType::Ball({ { 5, 5 } }), "a ball");
+  success &= CompareWithBasicFilters<ImageType>(image, KernelType::Ball({ { 9, 2 } }), "an ellipse");
+  success &= CompareWithBasicFilters<ImageType>(image, KernelType::Cross({ { 3, 3 } }), "a cross");
+
+  using VolumeType = itk::Image<short, 3>;
+  using VolumeKernelType = itk::FlatStructuringElement<3>;
+  const auto volume = MakeInputImage<VolumeType>({ { 23, 19, 17 } });
+  success &= CompareWithBasicFilters<VolumeType>(volume, VolumeKernelType::Ball({ { 4, 4, 4 } }), "a 3D ball");
+  success &= CompareWithBasicFilters<VolumeType>(volume, VolumeKernelType::Ball({ { 2, 5, 3 } }), "a 3D ellipsoid");
+
+  // Kernels with several chords on a line cannot be applied a chord at a time.
+  auto erode = itk::VanHerkGilWermanErodeImageFilter<ImageType, KernelType>::New();
+  erode->SetInput(image);
+  erode->SetKernel(KernelType::Annulus({ { 4, 4 } }, 1));
+  ITK_TRY_EXPECT_EXCEPTION(erode->Update());
+
+  // The chords are selected for balls, but not for kernels which are not
+  // unions of chords.
+  using DilateFilterType = itk::GrayscaleDilateImageFilter<ImageType, ImageType, KernelType>;
+  auto dilate = DilateFilterType::New();
+  dilate->SetKernel(KernelType::Ball({ { 5, 5 } }));
+  ITK_TEST_EXPECT_EQUAL(dilate->GetAlgorithm(), DilateFilterType::AlgorithmEnum::VHGW);
+  dilate->SetKernel(KernelType::Annulus({ { 4, 4 } }, 1));
+  ITK_TEST_EXPECT_TRUE(dilate->GetAlgorithm() != DilateFilterType::AlgorithmEnum::VHGW);
 
   std::cout << "Test finished." << std::endl;
-  return EXIT_SUCCESS;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -27,6 +27,11 @@ namespace itk
  * \brief Implements a fast rectangular mean filter using the
  * accumulator approach
  *
+ * The sums of the pixels in the boxes are computed along one dimension at
+ * a time, with running sums along the lines of the region of each thread,
+ * so that only that region padded by the radius is buffered.
+ * The pixels outside the image are left out of the boxes.
+ *
  *
  * This code was contributed in the Insight Journal paper:
  * "Efficient implementation of kernel filtering"
@@ -44,29 +44,11 @@ void
 BoxMeanImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
   const OutputImageRegionType & outputRegionForThread)
 {
-  // Accumulate type is too small
-  using AccPixType = typename NumericTraits<PixelType>::RealType;
-  using AccumImageType = Image<AccPixType, TInputImage::ImageDimension>;
-
-  typename TInputImage::SizeType internalRadius;
-  for (unsigned int i = 0; i < TInputImage::ImageDimension; ++i)
-  {
-    internalRadius[i] = this->GetRadius()[i] + 1;
-  }
-
+  // the sums are computed along one dimension at a time, so that only the
+  // region of the thread padded by the radius is buffered
   const InputImageType * inputImage = this->GetInput();
-  OutputImageType *      outputImage = this->GetOutput();
-  RegionType             accumRegion = outputRegionForThread;
-  accumRegion.PadByRadius(internalRadius);
-  accumRegion.Crop(inputImage->GetRequestedRegion());
-
-  auto accImage = AccumImageType::New();
-  accImage->SetRegions(accumRegion);
-  accImage->Allocate();
-
-  BoxAccumulateFunction<TInputImage, AccumImageType>(inputImage, accImage, accumRegion, accumRegion);
-  BoxMeanCalculatorFunction<AccumImageType, TOutputImage>(
-    accImage.GetPointer(), outputImage, accumRegion, outputRegionForThread, this->GetRadius());
+  BoxMeanRunningSumFunction<TInputImage, TOutputImage>(
+    inputImage, this->GetOutput(), inputImage->GetRequestedRegion(), outputRegionForThread, this->GetRadius());
 }
 } // end namespace itk
 #endif
@@ -45,30 +45,11 @@ void
 BoxSigmaImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
   const OutputImageRegionType & outputRegionForThread)
 {
-  // Accumulate type is too small
-  using AccValueType = typename itk::NumericTraits<PixelType>::RealType;
-  using AccPixType = typename itk::Vector<AccValueType, 2>;
-  using AccumImageType = typename itk::Image<AccPixType, TInputImage::ImageDimension>;
-
-  typename TInputImage::SizeType internalRadius;
-  for (unsigned int i = 0; i < TInputImage::ImageDimension; ++i)
-  {
-    internalRadius[i] = this->GetRadius()[i] + 1;
-  }
-
+  // the sums are computed along one dimension at a time, so that only the
+  // region of the thread padded by the radius is buffered
   const InputImageType * inputImage = this->GetInput();
-  OutputImageType *      outputImage = this->GetOutput();
-  RegionType             accumRegion = outputRegionForThread;
-  accumRegion.PadByRadius(internalRadius);
-  accumRegion.Crop(inputImage->GetRequestedRegion());
-
-  auto accImage = AccumImageType::New();
-  accImage->SetRegions(accumRegion);
-  accImage->Allocate();
-
-  BoxSquareAccumulateFunction<TInputImage, AccumImageType>(inputImage, accImage, accumRegion, accumRegion);
-  BoxSigmaCalculatorFunction<AccumImageType, TOutputImage>(
-    accImage, outputImage, accumRegion, outputRegionForThread, this->GetRadius());
+  BoxSigmaRunningSumFunction<TInputImage, TOutputImage>(
+    inputImage, this->GetOutput(), inputImage->GetRequestedRegion(), outputRegionForThread, this->GetRadius());
 }
 } // end namespace itk
 #endif
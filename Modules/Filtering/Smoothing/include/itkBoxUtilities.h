@@ -24,10 +24,13 @@
 #include "itkConstantBoundaryCondition.h"
 #include "itkImageRegionIteratorWithIndex.h"
 #include "itkImageRegionIterator.h"
+#include "itkIndexRange.h"
+#include "itkImageScanlineIterator.h"
 #include "itkOffset.h"
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkZeroFluxNeumannBoundaryCondition.h"
 #include <algorithm> // For min.
+#include <vector>
 
 /*
  *
@@ -89,6 +92,191 @@ setConnectivityEarlyBox(TIterator * it, bool fullyConnected = false)
   return it;
 }
 
+// Sum the values of a line in windows of the given radius. The values of
+// the line span [lineBegin, lineEnd), and the sums [sumsBegin, sumsEnd),
+// one every stride elements of sums. The pixels of the windows which are
+// outside the line are left out.
+template <typename TSum>
+inline void
+BoxRunningSums(const TSum *         line,
+               itk::IndexValueType  lineBegin,
+               itk::IndexValueType  lineEnd,
+               itk::IndexValueType  sumsBegin,
+               itk::IndexValueType  sumsEnd,
+               itk::OffsetValueType radius,
+               TSum *               sums,
+               itk::OffsetValueType stride)
+{
+  // the window before the first sum, from which the pixel before the
+  // window of the first sum is removed along with the next pixel added
+  TSum sum{};
+  for (itk::IndexValueType x = std::max(lineBegin, sumsBegin - radius - 1); x < std::min(lineEnd, sumsBegin + radius);
+       ++x)
+  {
+    sum += line[x - lineBegin];
+  }
+  for (itk::IndexValueType x = sumsBegin; x < sumsEnd; ++x)
+  {
+    if (x + radius < lineEnd)
+    {
+      sum += line[x + radius - lineBegin];
+    }
+    if (x - radius - 1 >= lineBegin)
+    {
+      sum -= line[x - radius - 1 - lineBegin];
+    }
+    sums[(x - sumsBegin) * stride] = sum;
+  }
+}
+
+// Sum the values of the pixels of the input image in the box of the given
+// radius around each pixel of the output region, leaving out the pixels
+// outside the image region. The box is separable: the sums are computed
+// along one dimension at a time, with a running sum along each line, in a
+// buffer which spans the output region padded along the dimensions not
+// summed yet. The sums are returned in the order of the pixels of the
+// output region.
+template <typename TSum, typename TInputImage, typename TPixelToSum>
+std::vector<TSum>
+BoxSums(const TInputImage *                      inputImage,
+        const typename TInputImage::RegionType & imageRegion,
+        const typename TInputImage::RegionType & outputRegion,
+        const typename TInputImage::SizeType &   radius,
+        TPixelToSum                              pixelToSum)
+{
+  using RegionType = typename TInputImage::RegionType;
+  using IndexType = typename TInputImage::IndexType;
+  using OffsetType = typename TInputImage::OffsetType;
+  constexpr unsigned int Dimension = TInputImage::ImageDimension;
+
+  const IndexType & imageStart = imageRegion.GetIndex();
+  IndexType         imageEnd;
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    imageEnd[d] = imageStart[d] + static_cast<itk::IndexValueType>(imageRegion.GetSize(d));
+  }
+
+  RegionType sumRegion = outputRegion;
+  for (unsigned int d = 1; d < Dimension; ++d)
+  {
+    sumRegion.SetIndex(d, sumRegion.GetIndex(d) - static_cast<itk::IndexValueType>(radius[d]));
+    sumRegion.SetSize(d, sumRegion.GetSize(d) + 2 * radius[d]);
+  }
+  sumRegion.Crop(imageRegion);
+
+  OffsetType strides;
+  strides[0] = 1;
+  for (unsigned int d = 1; d < Dimension; ++d)
+  {
+    strides[d] = strides[d - 1] * static_cast<itk::OffsetValueType>(sumRegion.GetSize(d - 1));
+  }
+  const auto sumOffset = [&sumRegion, &strides](const IndexType & index) {
+    itk::OffsetValueType offset = 0;
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      offset += (index[d] - sumRegion.GetIndex(d)) * strides[d];
+    }
+    return offset;
+  };
+
+  std::vector<TSum> sums(sumRegion.GetNumberOfPixels());
+  std::vector<TSum> line;
+
+  // along the first dimension, the lines of the input image are read in
+  // turn, in the order of the lines of the buffer
+  const auto                radius0 = static_cast<itk::OffsetValueType>(radius[0]);
+  const itk::IndexValueType sumsBegin0 = outputRegion.GetIndex(0);
+  const itk::IndexValueType sumsEnd0 = sumsBegin0 + static_cast<itk::IndexValueType>(outputRegion.GetSize(0));
+  const itk::IndexValueType lineBegin0 = std::max(imageStart[0], sumsBegin0 - radius0);
+  const itk::IndexValueType lineEnd0 = std::min(imageEnd[0], sumsEnd0 + radius0);
+  RegionType                lineRegion = sumRegion;
+  lineRegion.SetIndex(0, lineBegin0);
+  lineRegion.SetSize(0, lineEnd0 - lineBegin0);
+  line.resize(lineEnd0 - lineBegin0);
+  TSum * lineSums = sums.data();
+  for (itk::ImageRegionConstIterator<TInputImage> it(inputImage, lineRegion); !it.IsAtEnd();
+       lineSums += outputRegion.GetSize(0))
+  {
+    for (auto & value : line)
+    {
+      value = pixelToSum(it.Get());
+      ++it;
+    }
+    BoxRunningSums(line.data(), lineBegin0, lineEnd0, sumsBegin0, sumsEnd0, radius0, lineSums, 1);
+  }
+
+  // along the other dimensions, the lines of the buffer are summed in
+  // place, on the pixels of the output region only
+  RegionType summedRegion = sumRegion;
+  for (unsigned int d = 1; d < Dimension; ++d)
+  {
+    const auto                radiusD = static_cast<itk::OffsetValueType>(radius[d]);
+    const itk::IndexValueType lineBegin = sumRegion.GetIndex(d);
+    const itk::IndexValueType lineEnd = lineBegin + static_cast<itk::IndexValueType>(sumRegion.GetSize(d));
+    const itk::IndexValueType sumsBegin = outputRegion.GetIndex(d);
+    const itk::IndexValueType sumsEnd = sumsBegin + static_cast<itk::IndexValueType>(outputRegion.GetSize(d));
+    line.resize(lineEnd - lineBegin);
+
+    RegionType linesRegion = summedRegion;
+    linesRegion.SetIndex(d, lineBegin);
+    linesRegion.SetSize(d, 1);
+    for (const IndexType & index : itk::ImageRegionIndexRange<Dimension>(linesRegion))
+    {
+      TSum * const lineStart = sums.data() + sumOffset(index);
+      for (size_t i = 0; i < line.size(); ++i)
+      {
+        line[i] = lineStart[i * strides[d]];
+      }
+      BoxRunningSums(line.data(),
+                     lineBegin,
+                     lineEnd,
+                     sumsBegin,
+                     sumsEnd,
+                     radiusD,
+                     lineStart + (sumsBegin - lineBegin) * strides[d],
+                     strides[d]);
+    }
+    summedRegion.SetIndex(d, sumsBegin);
+    summedRegion.SetSize(d, outputRegion.GetSize(d));
+  }
+
+  // gather the sums of the output region at the start of the buffer, which
+  // never overwrites the sums still to be gathered
+  if (sumRegion != outputRegion)
+  {
+    RegionType linesRegion = outputRegion;
+    linesRegion.SetSize(0, 1);
+    TSum * gathered = sums.data();
+    for (const IndexType & index : itk::ImageRegionIndexRange<Dimension>(linesRegion))
+    {
+      gathered = std::copy_n(sums.data() + sumOffset(index), outputRegion.GetSize(0), gathered);
+    }
+    sums.resize(outputRegion.GetNumberOfPixels());
+  }
+  return sums;
+}
+
+// The number of pixels of the image region in the box of the given radius
+// around each pixel of the output region, along each dimension.
+template <typename TRegion, typename TSize>
+std::vector<std::vector<itk::SizeValueType>>
+BoxCounts(const TRegion & imageRegion, const TRegion & outputRegion, const TSize & radius)
+{
+  std::vector<std::vector<itk::SizeValueType>> counts(TRegion::ImageDimension);
+  for (unsigned int d = 0; d < TRegion::ImageDimension; ++d)
+  {
+    const itk::IndexValueType imageBegin = imageRegion.GetIndex(d);
+    const itk::IndexValueType imageEnd = imageBegin + static_cast<itk::IndexValueType>(imageRegion.GetSize(d));
+    const auto                radiusD = static_cast<itk::OffsetValueType>(radius[d]);
+    for (itk::SizeValueType i = 0; i < outputRegion.GetSize(d); ++i)
+    {
+      const itk::IndexValueType x = outputRegion.GetIndex(d) + static_cast<itk::IndexValueType>(i);
+      counts[d].push_back(std::min(imageEnd, x + radiusD + 1) - std::max(imageBegin, x - radiusD));
+    }
+  }
+  return counts;
+}
+
 } // namespace itk_impl_details
 
 namespace itk
@@ -615,6 +803,94 @@ BoxSquareAccumulateFunction(const TInputImage *               inputImage,
     noutIt.SetCenterPixel(o);
   }
 }
+
+/** Compute the mean of the input image in the box of the given radius
+ * around each pixel of the output region, leaving out the pixels outside
+ * the input region. The sums are computed along one dimension at a time
+ * with running sums, in double precision for float images, so that
+ * only the output region padded by the radius is buffered. */
+template <typename TInputImage, typename TOutputImage>
+void
+BoxMeanRunningSumFunction(const TInputImage *               inputImage,
+                          TOutputImage *                    outputImage,
+                          typename TInputImage::RegionType  inputRegion,
+                          typename TOutputImage::RegionType outputRegion,
+                          typename TInputImage::SizeType    radius)
+{
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using SumType = typename NumericTraits<typename NumericTraits<InputPixelType>::RealType>::AccumulateType;
+
+  const std::vector<SumType> sums = itk_impl_details::BoxSums<SumType>(
+    inputImage, inputRegion, outputRegion, radius, [](const InputPixelType & value) {
+      return static_cast<SumType>(value);
+    });
+  const auto counts = itk_impl_details::BoxCounts(inputRegion, outputRegion, radius);
+
+  auto sumIt = sums.cbegin();
+  for (ImageScanlineIterator<TOutputImage> it(outputImage, outputRegion); !it.IsAtEnd(); it.NextLine())
+  {
+    SumType lineCount = 1;
+    for (unsigned int d = 1; d < TInputImage::ImageDimension; ++d)
+    {
+      lineCount *= counts[d][it.GetIndex()[d] - outputRegion.GetIndex(d)];
+    }
+    for (const SizeValueType count : counts[0])
+    {
+      it.Set(static_cast<OutputPixelType>(*sumIt / (lineCount * count)));
+      ++it;
+      ++sumIt;
+    }
+  }
+}
+
+/** Compute the standard deviation of the input image in the box of the
+ * given radius around each pixel of the output region, leaving out the
+ * pixels outside the input region, from running sums of the pixels and of
+ * their squares as in BoxMeanRunningSumFunction. */
+template <typename TInputImage, typename TOutputImage>
+void
+BoxSigmaRunningSumFunction(const TInputImage *               inputImage,
+                           TOutputImage *                    outputImage,
+                           typename TInputImage::RegionType  inputRegion,
+                           typename TOutputImage::RegionType outputRegion,
+                           typename TInputImage::SizeType    radius)
+{
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using SumValueType = typename NumericTraits<typename NumericTraits<InputPixelType>::RealType>::AccumulateType;
+  using SumType = Vector<SumValueType, 2>;
+
+  const std::vector<SumType> sums = itk_impl_details::BoxSums<SumType>(
+    inputImage, inputRegion, outputRegion, radius, [](const InputPixelType & value) {
+      SumType sum;
+      sum[0] = static_cast<SumValueType>(value);
+      sum[1] = sum[0] * sum[0];
+      return sum;
+    });
+  const auto counts = itk_impl_details::BoxCounts(inputRegion, outputRegion, radius);
+
+  auto sumIt = sums.cbegin();
+  for (ImageScanlineIterator<TOutputImage> it(outputImage, outputRegion); !it.IsAtEnd(); it.NextLine())
+  {
+    SumValueType lineCount = 1;
+    for (unsigned int d = 1; d < TInputImage::ImageDimension; ++d)
+    {
+      lineCount *= counts[d][it.GetIndex()[d] - outputRegion.GetIndex(d)];
+    }
+    for (const SizeValueType count : counts[0])
+    {
+      const SumValueType pixelsCount = lineCount * count;
+      const SumValueType sum = (*sumIt)[0];
+      const SumValueType squareSum = (*sumIt)[1];
+      // rounding may leave a small negative variance in uniform boxes
+      const SumValueType variance = std::max(SumValueType{}, (squareSum - sum * sum / pixelsCount) / (pixelsCount - 1));
+      it.Set(static_cast<OutputPixelType>(std::sqrt(variance)));
+      ++it;
+      ++sumIt;
+    }
+  }
+}
 } // namespace itk
 
 #endif
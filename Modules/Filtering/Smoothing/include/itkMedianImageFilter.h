@@ -21,6 +21,8 @@
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
 
+#include <vector>
+
 namespace itk
 {
 /**
@@ -36,6 +38,19 @@ namespace itk
  * This filter requires that the input pixel type provides an operator<()
  * (LessThan Comparable).
  *
+ * The median is computed by the fastest of three methods for the pixel
+ * type. Images of integer pixels with a small range of values keep a
+ * histogram for each column of the neighborhood, along the first
+ * dimension, and add and remove whole columns to the histogram of the
+ * neighborhood, with coarse and fine bins, as in Perreault and Hebert,
+ * "Median Filtering in Constant Time", IEEE Transactions on Image
+ * Processing 16(9), 2007. The cost per pixel does not depend on the
+ * radius in 2D, and grows with the radius instead of its square in 3D.
+ * Images of other scalar pixels keep the sorted pixels of the
+ * neighborhood, and merge the column which enters it and remove the one
+ * which leaves it. Other pixel types select the median of each
+ * neighborhood.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -83,6 +98,7 @@ public:
   using OutputImageRegionType = typename OutputImageType::RegionType;
 
   using InputSizeType = typename InputImageType::SizeType;
+  using InputIndexType = typename InputImageType::IndexType;
 
   itkConceptMacro(SameDimensionCheck, (Concept::SameDimension<InputImageDimension, OutputImageDimension>));
   itkConceptMacro(InputConvertibleToOutputCheck, (Concept::Convertible<InputPixelType, OutputPixelType>));
@@ -104,6 +120,35 @@ protected:
    *     ImageToImageFilter::GenerateData() */
   void
   DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+private:
+  /** Selects the median of the pixels of each neighborhood. */
+  void
+  GenerateDataWithSelection(const OutputImageRegionType & outputRegionForThread);
+
+  /** Computes the median of each line from the histograms of the columns
+   * of its neighborhoods. Returns false, without computing anything, when
+   * the range of the pixel values of the region makes the histograms too
+   * large, or slower than sorted windows. */
+  bool
+  GenerateDataWithHistograms(const OutputImageRegionType & outputRegionForThread);
+
+  /** Computes the median of each line from the sorted pixels of its
+   * neighborhoods, which are updated a column at a time. */
+  void
+  GenerateDataWithSortedWindows(const OutputImageRegionType & outputRegionForThread);
+
+  /** Returns the offsets in the input buffer of the pixels of the
+   * neighborhood of the given index, in the dimensions from the given one
+   * onward. The pixels outside the buffer are those of its border, as with
+   * a zero flux Neumann boundary condition. */
+  std::vector<OffsetValueType>
+  ComputeNeighborhoodBufferOffsets(const InputIndexType & index, unsigned int firstDimension) const;
+
+  /** Returns the offset in the input buffer of the given index along the
+   * given dimension, clamped to the buffer. */
+  OffsetValueType
+  ComputeBufferOffset(unsigned int dimension, IndexValueType index) const;
 };
 } // end namespace itk
 
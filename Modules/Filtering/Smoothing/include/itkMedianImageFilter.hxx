@@ -29,6 +29,8 @@
 
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <type_traits>
 
 namespace itk
 {
@@ -43,6 +45,31 @@ template <typename TInputImage, typename TOutputImage>
 void
 MedianImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
   const OutputImageRegionType & outputRegionForThread)
+{
+  // The histograms and sorted windows read the pixels of scalar images
+  // from their buffer.
+  if constexpr (std::is_arithmetic_v<InputPixelType> &&
+                std::is_same_v<InputImageType, Image<InputPixelType, InputImageDimension>>)
+  {
+    if constexpr (std::is_integral_v<InputPixelType>)
+    {
+      if (this->GenerateDataWithHistograms(outputRegionForThread))
+      {
+        return;
+      }
+    }
+    this->GenerateDataWithSortedWindows(outputRegionForThread);
+  }
+  else
+  {
+    this->GenerateDataWithSelection(outputRegionForThread);
+  }
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+MedianImageFilter<TInputImage, TOutputImage>::GenerateDataWithSelection(
+  const OutputImageRegionType & outputRegionForThread)
 {
   // Allocate output
   OutputImageType *      output = this->GetOutput();
@@ -104,6 +131,359 @@ MedianImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
     }
   }
 }
+
+template <typename TInputImage, typename TOutputImage>
+bool
+MedianImageFilter<TInputImage, TOutputImage>::GenerateDataWithHistograms(
+  const OutputImageRegionType & outputRegionForThread)
+{
+  using CountType = std::uint32_t;
+
+  OutputImageType *      output = this->GetOutput();
+  const InputImageType * input = this->GetInput();
+  const InputPixelType * buffer = input->GetBufferPointer();
+
+  const auto          radius = this->GetRadius();
+  const SizeValueType neighborhoodSize =
+    GenerateRectangularImageNeighborhoodOffsets<InputImageDimension>(radius).size();
+
+  // The bins span the values of the pixels read for this region. The
+  // differences are computed modulo 2^64, which gives the right result
+  // for signed pixels too.
+  InputImageRegionType inputRegion = outputRegionForThread;
+  inputRegion.PadByRadius(radius);
+  inputRegion.Crop(input->GetBufferedRegion());
+  const auto inputRange = ImageRegionRange<const InputImageType>(*input, inputRegion);
+  const auto minMax = std::minmax_element(inputRange.cbegin(), inputRange.cend());
+  const auto minimum = static_cast<std::uintmax_t>(static_cast<InputPixelType>(*minMax.first));
+  const std::uintmax_t valueRange = static_cast<std::uintmax_t>(static_cast<InputPixelType>(*minMax.second)) - minimum;
+
+  // The histograms of the columns must fit the memory budget of a work unit.
+  constexpr SizeValueType maximumNumberOfColumnBins = SizeValueType{ 1 } << 22;
+  if (valueRange >= maximumNumberOfColumnBins)
+  {
+    return false;
+  }
+
+  // Each coarse bin groups the square root of the number of fine bins.
+  unsigned int fineShift = 0;
+  while ((valueRange >> (2 * fineShift)) > 0)
+  {
+    ++fineShift;
+  }
+  const SizeValueType numberOfFineBins = SizeValueType{ 1 } << fineShift;
+  const SizeValueType numberOfCoarseBins = static_cast<SizeValueType>(valueRange >> fineShift) + 1;
+  const SizeValueType numberOfBins = numberOfCoarseBins << fineShift;
+
+  const IndexValueType lineStart = outputRegionForThread.GetIndex(0);
+  const IndexValueType lineEnd = lineStart + static_cast<IndexValueType>(outputRegionForThread.GetSize(0));
+  const auto           radius0 = static_cast<IndexValueType>(radius[0]);
+  const IndexValueType firstColumn = inputRegion.GetIndex(0);
+  const SizeValueType  numberOfColumns = inputRegion.GetSize(0);
+  const IndexValueType lastColumn = firstColumn + static_cast<IndexValueType>(numberOfColumns) - 1;
+
+  // Searching the bins of a neighborhood must also cost less than merging
+  // its sorted pixels.
+  if (numberOfCoarseBins + numberOfFineBins > neighborhoodSize ||
+      numberOfColumns * (numberOfBins + numberOfCoarseBins) > maximumNumberOfColumnBins)
+  {
+    return false;
+  }
+
+  // The fine and coarse histograms of each column, whose pixels span the
+  // neighborhood along all the dimensions but the first one.
+  std::vector<CountType> columnFine(numberOfColumns * numberOfBins);
+  std::vector<CountType> columnCoarse(numberOfColumns * numberOfCoarseBins);
+  const InputPixelType * firstColumnPixel = buffer + this->ComputeBufferOffset(0, firstColumn);
+  const auto             columnOf = [firstColumn, lastColumn](IndexValueType x) {
+    return static_cast<SizeValueType>(std::clamp(x, firstColumn, lastColumn) - firstColumn);
+  };
+  const auto updateColumns = [&](OffsetValueType pixelOffset, CountType increment) {
+    const InputPixelType * pixel = firstColumnPixel + pixelOffset;
+    for (SizeValueType column = 0; column < numberOfColumns; ++column)
+    {
+      const auto bin = static_cast<SizeValueType>(static_cast<std::uintmax_t>(pixel[column]) - minimum);
+      columnFine[column * numberOfBins + bin] += increment;
+      columnCoarse[column * numberOfCoarseBins + (bin >> fineShift)] += increment;
+    }
+  };
+
+  // The histogram of the neighborhood. Its coarse bins are updated at each
+  // pixel, and its fine bins only when the median falls in them, from the
+  // index at which they were last updated.
+  std::vector<CountType>      kernelCoarse(numberOfCoarseBins);
+  std::vector<CountType>      kernelFine(numberOfBins);
+  std::vector<IndexValueType> kernelFineIndex(numberOfCoarseBins);
+  const SizeValueType         medianRank = neighborhoodSize / 2;
+
+  TotalProgressReporter progress(this, output->GetRequestedRegion().GetNumberOfPixels());
+
+  OutputImageRegionType lineRegion = outputRegionForThread;
+  lineRegion.SetSize(0, 1);
+  auto lineSize = OutputImageRegionType::SizeType::Filled(1);
+  lineSize[0] = outputRegionForThread.GetSize(0);
+  bool           columnsAreValid = false;
+  InputIndexType previousIndex{};
+  for (const auto & index : ImageRegionIndexRange<InputImageDimension>(lineRegion))
+  {
+    // Slide the columns along the second dimension when the line follows
+    // the previous one, and build them again otherwise.
+    bool isNextLine = columnsAreValid && InputImageDimension > 1;
+    for (unsigned int i = 1; i < InputImageDimension && isNextLine; ++i)
+    {
+      isNextLine = index[i] == previousIndex[i] + (i == 1 ? 1 : 0);
+    }
+    if (isNextLine)
+    {
+      const auto            radius1 = static_cast<IndexValueType>(radius[1]);
+      const OffsetValueType removedRow = this->ComputeBufferOffset(1, index[1] - 1 - radius1);
+      const OffsetValueType addedRow = this->ComputeBufferOffset(1, index[1] + radius1);
+      if (removedRow != addedRow)
+      {
+        for (const OffsetValueType offset : this->ComputeNeighborhoodBufferOffsets(index, 2))
+        {
+          updateColumns(offset + removedRow, CountType(-1));
+          updateColumns(offset + addedRow, 1);
+        }
+      }
+    }
+    else
+    {
+      std::fill(columnFine.begin(), columnFine.end(), 0);
+      std::fill(columnCoarse.begin(), columnCoarse.end(), 0);
+      for (const OffsetValueType offset : this->ComputeNeighborhoodBufferOffsets(index, 1))
+      {
+        updateColumns(offset, 1);
+      }
+      columnsAreValid = true;
+    }
+    previousIndex = index;
+
+    std::fill(kernelCoarse.begin(), kernelCoarse.end(), 0);
+    std::fill(kernelFineIndex.begin(), kernelFineIndex.end(), lineStart - radius0 - 2);
+    for (IndexValueType x = lineStart - radius0; x <= lineStart + radius0; ++x)
+    {
+      const CountType * coarse = &columnCoarse[columnOf(x) * numberOfCoarseBins];
+      for (SizeValueType bin = 0; bin < numberOfCoarseBins; ++bin)
+      {
+        kernelCoarse[bin] += coarse[bin];
+      }
+    }
+
+    auto outputIterator = ImageRegionRange<OutputImageType>(*output, OutputImageRegionType(index, lineSize)).begin();
+    for (IndexValueType x = lineStart; x < lineEnd; ++x, ++outputIterator)
+    {
+      if (x > lineStart)
+      {
+        const SizeValueType added = columnOf(x + radius0);
+        const SizeValueType removed = columnOf(x - radius0 - 1);
+        if (added != removed)
+        {
+          const CountType * addedCoarse = &columnCoarse[added * numberOfCoarseBins];
+          const CountType * removedCoarse = &columnCoarse[removed * numberOfCoarseBins];
+          for (SizeValueType bin = 0; bin < numberOfCoarseBins; ++bin)
+          {
+            kernelCoarse[bin] += addedCoarse[bin] - removedCoarse[bin];
+          }
+        }
+      }
+
+      SizeValueType count = 0;
+      SizeValueType coarseBin = 0;
+      while (count + kernelCoarse[coarseBin] <= medianRank)
+      {
+        count += kernelCoarse[coarseBin];
+        ++coarseBin;
+      }
+
+      // Bring the fine bins of the coarse bin up to date, from scratch when
+      // that is cheaper than from their last update.
+      CountType *         fine = &kernelFine[coarseBin << fineShift];
+      const SizeValueType fineOffset = coarseBin << fineShift;
+      if (x - kernelFineIndex[coarseBin] > radius0)
+      {
+        std::fill_n(fine, numberOfFineBins, 0);
+        for (IndexValueType column = x - radius0; column <= x + radius0; ++column)
+        {
+          const CountType * columnBins = &columnFine[columnOf(column) * numberOfBins + fineOffset];
+          for (SizeValueType bin = 0; bin < numberOfFineBins; ++bin)
+          {
+            fine[bin] += columnBins[bin];
+          }
+        }
+      }
+      else
+      {
+        for (IndexValueType column = kernelFineIndex[coarseBin] + 1; column <= x; ++column)
+        {
+          const SizeValueType added = columnOf(column + radius0);
+          const SizeValueType removed = columnOf(column - radius0 - 1);
+          if (added != removed)
+          {
+            const CountType * addedBins = &columnFine[added * numberOfBins + fineOffset];
+            const CountType * removedBins = &columnFine[removed * numberOfBins + fineOffset];
+            for (SizeValueType bin = 0; bin < numberOfFineBins; ++bin)
+            {
+              fine[bin] += addedBins[bin] - removedBins[bin];
+            }
+          }
+        }
+      }
+      kernelFineIndex[coarseBin] = x;
+
+      SizeValueType fineBin = 0;
+      while (count + fine[fineBin] <= medianRank)
+      {
+        count += fine[fineBin];
+        ++fineBin;
+      }
+      // The bin is an offset modulo 2^64, which is an input pixel value
+      // before it is converted to the output pixel type.
+      const auto median = static_cast<InputPixelType>(minimum + fineOffset + fineBin);
+      *outputIterator = static_cast<OutputPixelType>(median);
+    }
+    progress.Completed(outputRegionForThread.GetSize(0));
+  }
+  return true;
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+MedianImageFilter<TInputImage, TOutputImage>::GenerateDataWithSortedWindows(
+  const OutputImageRegionType & outputRegionForThread)
+{
+  OutputImageType *      output = this->GetOutput();
+  const InputImageType * input = this->GetInput();
+  const InputPixelType * buffer = input->GetBufferPointer();
+
+  const auto           radius0 = static_cast<IndexValueType>(this->GetRadius()[0]);
+  const IndexValueType lineStart = outputRegionForThread.GetIndex(0);
+  const IndexValueType lineEnd = lineStart + static_cast<IndexValueType>(outputRegionForThread.GetSize(0));
+
+  // Along the first dimension, the buffer offset of a column is its index
+  // in the buffer.
+  const IndexValueType firstColumn = input->GetBufferedRegion().GetIndex(0);
+  const IndexValueType lastColumn =
+    firstColumn + static_cast<IndexValueType>(input->GetBufferedRegion().GetSize(0)) - 1;
+  const auto columnOffsetOf = [firstColumn, lastColumn](IndexValueType x) {
+    return static_cast<OffsetValueType>(std::clamp(x, firstColumn, lastColumn) - firstColumn);
+  };
+
+  std::vector<InputPixelType> window;
+  std::vector<InputPixelType> mergedWindow;
+  std::vector<InputPixelType> addedColumn;
+  std::vector<InputPixelType> removedColumn;
+
+  const auto getColumn = [buffer](const std::vector<OffsetValueType> & columnOffsets,
+                                  OffsetValueType                      offset,
+                                  std::vector<InputPixelType> &        column) {
+    column.clear();
+    for (const OffsetValueType columnOffset : columnOffsets)
+    {
+      column.push_back(buffer[offset + columnOffset]);
+    }
+    std::sort(column.begin(), column.end());
+  };
+
+  TotalProgressReporter progress(this, output->GetRequestedRegion().GetNumberOfPixels());
+
+  OutputImageRegionType lineRegion = outputRegionForThread;
+  lineRegion.SetSize(0, 1);
+  auto lineSize = OutputImageRegionType::SizeType::Filled(1);
+  lineSize[0] = outputRegionForThread.GetSize(0);
+  for (const auto & index : ImageRegionIndexRange<InputImageDimension>(lineRegion))
+  {
+    const std::vector<OffsetValueType> columnOffsets = this->ComputeNeighborhoodBufferOffsets(index, 1);
+
+    window.clear();
+    for (IndexValueType x = lineStart - radius0; x <= lineStart + radius0; ++x)
+    {
+      for (const OffsetValueType columnOffset : columnOffsets)
+      {
+        window.push_back(buffer[columnOffsetOf(x) + columnOffset]);
+      }
+    }
+    std::sort(window.begin(), window.end());
+    const auto medianIndex = window.size() / 2;
+
+    auto outputIterator = ImageRegionRange<OutputImageType>(*output, OutputImageRegionType(index, lineSize)).begin();
+    *outputIterator = window[medianIndex];
+    for (IndexValueType x = lineStart + 1; x < lineEnd; ++x)
+    {
+      const OffsetValueType added = columnOffsetOf(x + radius0);
+      const OffsetValueType removed = columnOffsetOf(x - radius0 - 1);
+      if (added != removed)
+      {
+        // Remove the sorted pixels of the column which leaves the window,
+        // and merge those of the column which enters it, in a single pass.
+        getColumn(columnOffsets, added, addedColumn);
+        getColumn(columnOffsets, removed, removedColumn);
+        auto addedIterator = addedColumn.cbegin();
+        auto removedIterator = removedColumn.cbegin();
+        mergedWindow.clear();
+        for (const InputPixelType & value : window)
+        {
+          if (removedIterator != removedColumn.cend() && !(value < *removedIterator) && !(*removedIterator < value))
+          {
+            ++removedIterator;
+            continue;
+          }
+          while (addedIterator != addedColumn.cend() && *addedIterator < value)
+          {
+            mergedWindow.push_back(*addedIterator);
+            ++addedIterator;
+          }
+          mergedWindow.push_back(value);
+        }
+        mergedWindow.insert(mergedWindow.end(), addedIterator, addedColumn.cend());
+        std::swap(window, mergedWindow);
+      }
+      *(++outputIterator) = window[medianIndex];
+    }
+    progress.Completed(outputRegionForThread.GetSize(0));
+  }
+}
+
+template <typename TInputImage, typename TOutputImage>
+auto
+MedianImageFilter<TInputImage, TOutputImage>::ComputeNeighborhoodBufferOffsets(const InputIndexType & index,
+                                                                              unsigned int firstDimension) const
+  -> std::vector<OffsetValueType>
+{
+  const auto radius = this->GetRadius();
+
+  InputImageRegionType neighborhoodRegion(index, InputSizeType::Filled(1));
+  for (unsigned int i = firstDimension; i < InputImageDimension; ++i)
+  {
+    neighborhoodRegion.SetIndex(i, index[i] - static_cast<IndexValueType>(radius[i]));
+    neighborhoodRegion.SetSize(i, 2 * radius[i] + 1);
+  }
+
+  std::vector<OffsetValueType> offsets;
+  offsets.reserve(neighborhoodRegion.GetNumberOfPixels());
+  for (const auto & neighbor : ImageRegionIndexRange<InputImageDimension>(neighborhoodRegion))
+  {
+    OffsetValueType offset = 0;
+    for (unsigned int i = firstDimension; i < InputImageDimension; ++i)
+    {
+      offset += this->ComputeBufferOffset(i, neighbor[i]);
+    }
+    offsets.push_back(offset);
+  }
+  return offsets;
+}
+
+template <typename TInputImage, typename TOutputImage>
+OffsetValueType
+MedianImageFilter<TInputImage, TOutputImage>::ComputeBufferOffset(unsigned int   dimension,
+                                                                  IndexValueType index) const
+{
+  const InputImageType *       input = this->GetInput();
+  const InputImageRegionType & bufferedRegion = input->GetBufferedRegion();
+  const IndexValueType         first = bufferedRegion.GetIndex(dimension);
+  const IndexValueType         last = first + static_cast<IndexValueType>(bufferedRegion.GetSize(dimension)) - 1;
+  return (std::clamp(index, first, last) - first) * input->GetOffsetTable()[dimension];
+}
 } // end namespace itk
 
 #endif
@@ -0,0 +1,193 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header files to be tested:
+#include "itkBoxMeanImageFilter.h"
+#include "itkBoxSigmaImageFilter.h"
+
+#include "itkImage.h"
+#include "itkImageRegionRange.h"
+#include "itkIndexRange.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTestingRandomImage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// The mean and the standard deviation of the pixels in a box.
+struct BoxStatistics
+{
+  double Mean;
+  double Sigma;
+};
+
+
+// Computes the mean and the standard deviation of the pixels of the image in
+// the box around each pixel of the given region, leaving out the pixels
+// outside the image.
+template <typename TImage>
+std::vector<BoxStatistics>
+ComputeBoxStatisticsBruteForce(const TImage &                      image,
+                               const typename TImage::RegionType & region,
+                               const typename TImage::SizeType &   radius)
+{
+  constexpr unsigned int ImageDimension = TImage::ImageDimension;
+
+  std::vector<BoxStatistics> statistics;
+  for (const auto & index : itk::ImageRegionIndexRange<ImageDimension>(region))
+  {
+    typename TImage::RegionType boxRegion(index, TImage::SizeType::Filled(1));
+    boxRegion.PadByRadius(radius);
+    boxRegion.Crop(image.GetLargestPossibleRegion());
+    const double count = boxRegion.GetNumberOfPixels();
+    double       sum = 0.0;
+    double       squareSum = 0.0;
+    for (const auto pixel : itk::ImageRegionRange<const TImage>(image, boxRegion))
+    {
+      sum += pixel;
+      squareSum += static_cast<double>(pixel) * pixel;
+    }
+    statistics.push_back({ sum / count, std::sqrt(std::max(0.0, (squareSum - sum * sum / count) / (count - 1))) });
+  }
+  return statistics;
+}
+
+
+// Expects each pixel of the requested region of the output of the box filter
+// to be the given statistic of its box in the input, when the filter runs in
+// the given number of stream divisions.
+template <template <typename, typename> class TBoxFilter, typename TImage>
+void
+Expect_output_pixels_are_statistics_of_boxes(double BoxStatistics::*             statistic,
+                                             const TImage &                      inputImage,
+                                             const typename TImage::SizeType &   radius,
+                                             const typename TImage::RegionType & requestedRegion,
+                                             const unsigned int                  numberOfStreamDivisions,
+                                             const double                        tolerance)
+{
+  const auto filter = TBoxFilter<TImage, TImage>::New();
+  filter->SetInput(&inputImage);
+  filter->SetRadius(radius);
+  const auto streamer = itk::StreamingImageFilter<TImage, TImage>::New();
+  streamer->SetInput(filter->GetOutput());
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  streamer->GetOutput()->SetRequestedRegion(requestedRegion);
+  streamer->Update();
+
+  const std::vector<BoxStatistics> expectedStatistics =
+    ComputeBoxStatisticsBruteForce(inputImage, requestedRegion, radius);
+  auto expected = expectedStatistics.cbegin();
+  for (const auto pixel : itk::ImageRegionRange<const TImage>(*streamer->GetOutput(), requestedRegion))
+  {
+    if (tolerance == 0.0)
+    {
+      EXPECT_EQ(pixel, static_cast<typename TImage::PixelType>((*expected).*statistic));
+    }
+    else
+    {
+      EXPECT_NEAR(pixel, (*expected).*statistic, tolerance);
+    }
+    ++expected;
+  }
+}
+
+
+// Expects each pixel of the output of the box filter to be the given
+// statistic of its box, also at the border of the image, with boxes larger
+// than the image, and when the output is streamed.
+template <template <typename, typename> class TBoxFilter>
+void
+Expect_output_pixels_are_statistics_of_boxes_of_integer_images(double BoxStatistics::* statistic)
+{
+  using UCharImageType = itk::Image<unsigned char>;
+  using ShortImageType = itk::Image<short, 3>;
+
+  const auto image2D = itk::Testing::CreateRandomImage<UCharImageType>({ { 37, 23 } }, 0, 255);
+  for (const unsigned int numberOfStreamDivisions : { 1, 3 })
+  {
+    Expect_output_pixels_are_statistics_of_boxes<TBoxFilter>(
+      statistic, *image2D, { { 3, 2 } }, image2D->GetLargestPossibleRegion(), numberOfStreamDivisions, 0.0);
+    Expect_output_pixels_are_statistics_of_boxes<TBoxFilter>(
+      statistic, *image2D, { { 40, 1 } }, image2D->GetLargestPossibleRegion(), numberOfStreamDivisions, 0.0);
+    Expect_output_pixels_are_statistics_of_boxes<TBoxFilter>(
+      statistic, *image2D, { { 0, 5 } }, { { { 10, 2 } }, { { 15, 13 } } }, numberOfStreamDivisions, 0.0);
+  }
+
+  const auto image3D = itk::Testing::CreateRandomImage<ShortImageType>({ { 19, 14, 11 } }, -300, 300);
+  for (const unsigned int numberOfStreamDivisions : { 1, 4 })
+  {
+    Expect_output_pixels_are_statistics_of_boxes<TBoxFilter>(
+      statistic, *image3D, { { 2, 3, 1 } }, image3D->GetLargestPossibleRegion(), numberOfStreamDivisions, 0.0);
+    Expect_output_pixels_are_statistics_of_boxes<TBoxFilter>(
+      statistic, *image3D, { { 4, 0, 6 } }, { { { 3, 5, 2 } }, { { 9, 7, 8 } } }, numberOfStreamDivisions, 0.0);
+  }
+}
+} // namespace
+
+
+// Tests that each pixel of the output is the mean of its box.
+TEST(BoxMeanImageFilter, OutputPixelsAreMeansOfBoxes)
+{
+  Expect_output_pixels_are_statistics_of_boxes_of_integer_images<itk::BoxMeanImageFilter>(&BoxStatistics::Mean);
+
+  using DoubleImageType = itk::Image<double, 1>;
+
+  const auto image1D = itk::Testing::CreateRandomImage<DoubleImageType>({ { 50 } }, -1.0, 1.0);
+  Expect_output_pixels_are_statistics_of_boxes<itk::BoxMeanImageFilter>(
+    &BoxStatistics::Mean, *image1D, { { 7 } }, image1D->GetLargestPossibleRegion(), 2, 1e-12);
+}
+
+
+// Tests that the means of a float image are accurate, even with a large
+// offset and large boxes.
+TEST(BoxMeanImageFilter, MeansOfFloatImageAreAccurate)
+{
+  using FloatImageType = itk::Image<float, 3>;
+
+  const auto image = itk::Testing::CreateRandomImage<FloatImageType>({ { 40, 35, 30 } }, 10000.0f, 10001.0f);
+  Expect_output_pixels_are_statistics_of_boxes<itk::BoxMeanImageFilter>(
+    &BoxStatistics::Mean, *image, { { 15, 12, 10 } }, image->GetLargestPossibleRegion(), 1, 5e-4);
+}
+
+
+// Tests that each pixel of the output is the standard deviation of its box.
+TEST(BoxSigmaImageFilter, OutputPixelsAreSigmasOfBoxes)
+{
+  Expect_output_pixels_are_statistics_of_boxes_of_integer_images<itk::BoxSigmaImageFilter>(&BoxStatistics::Sigma);
+}
+
+
+// Tests that the standard deviations of a float image are accurate with a
+// large offset, and zero rather than not a number in uniform boxes.
+TEST(BoxSigmaImageFilter, SigmasOfFloatImageAreAccurate)
+{
+  using FloatImageType = itk::Image<float, 3>;
+
+  const auto image = itk::Testing::CreateRandomImage<FloatImageType>({ { 30, 25, 20 } }, 10000.0f, 10001.0f);
+  Expect_output_pixels_are_statistics_of_boxes<itk::BoxSigmaImageFilter>(
+    &BoxStatistics::Sigma, *image, { { 6, 5, 4 } }, image->GetLargestPossibleRegion(), 1, 1e-4);
+
+  image->FillBuffer(1000.1f);
+  Expect_output_pixels_are_statistics_of_boxes<itk::BoxSigmaImageFilter>(
+    &BoxStatistics::Sigma, *image, { { 3, 3, 3 } }, image->GetLargestPossibleRegion(), 1, 1e-4);
+}
@@ -21,7 +21,12 @@
 
 #include "itkImage.h"
 #include "itkImageBufferRange.h"
+#include "itkImageRegionRange.h"
+#include "itkIndexRange.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTestingRandomImage.h"
 
+#include <algorithm>
 #include <numeric> // For iota.
 #include <vector>
 
@@ -92,6 +97,85 @@ Expect_output_has_specified_pixel_values_when_input_has_sequence_of_natural_numb
   EXPECT_EQ(outputPixelValues, expectedPixelValues);
 }
 
+
+// Computes the median of the neighborhood of each pixel of the given region,
+// with the indices outside the image clamped to its border.
+template <typename TImage>
+std::vector<typename TImage::PixelType>
+ComputeMediansBruteForce(const TImage &                      image,
+                         const typename TImage::RegionType & region,
+                         const typename TImage::SizeType &   radius)
+{
+  using PixelType = typename TImage::PixelType;
+  constexpr unsigned int ImageDimension = TImage::ImageDimension;
+
+  const typename TImage::RegionType imageRegion = image.GetLargestPossibleRegion();
+  typename TImage::RegionType       neighborhoodRegion;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    neighborhoodRegion.SetIndex(i, -static_cast<itk::IndexValueType>(radius[i]));
+    neighborhoodRegion.SetSize(i, 2 * radius[i] + 1);
+  }
+
+  std::vector<PixelType> medians;
+  std::vector<PixelType> pixels;
+  for (const auto & index : itk::ImageRegionIndexRange<ImageDimension>(region))
+  {
+    pixels.clear();
+    for (const auto & offset : itk::ImageRegionIndexRange<ImageDimension>(neighborhoodRegion))
+    {
+      auto neighbor = index;
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+        neighbor[i] = std::clamp(index[i] + offset[i], imageRegion.GetIndex(i), imageRegion.GetUpperIndex()[i]);
+      }
+      pixels.push_back(image.GetPixel(neighbor));
+    }
+    std::nth_element(pixels.begin(), pixels.begin() + pixels.size() / 2, pixels.end());
+    medians.push_back(pixels[pixels.size() / 2]);
+  }
+  return medians;
+}
+
+
+// Expects the median of each pixel of the requested region of the output to
+// be that of its neighborhood in the input. The input of the filter comes
+// from a pipeline, so that its buffer is only the requested region, padded
+// by the radius.
+template <typename TImage>
+void
+Expect_output_pixels_are_medians_of_neighborhoods(const TImage &                      inputImage,
+                                                  const typename TImage::SizeType &   radius,
+                                                  const typename TImage::RegionType & requestedRegion)
+{
+  using PixelType = typename TImage::PixelType;
+
+  const auto streamer = itk::StreamingImageFilter<TImage, TImage>::New();
+  streamer->SetInput(&inputImage);
+  const auto filter = itk::MedianImageFilter<TImage, TImage>::New();
+  filter->SetInput(streamer->GetOutput());
+  filter->SetRadius(radius);
+  filter->GetOutput()->SetRequestedRegion(requestedRegion);
+  filter->Update();
+
+  const auto                   outputRange = itk::ImageRegionRange<const TImage>(*filter->GetOutput(), requestedRegion);
+  const std::vector<PixelType> outputPixelValues(outputRange.cbegin(), outputRange.cend());
+
+  EXPECT_EQ(outputPixelValues, ComputeMediansBruteForce(inputImage, requestedRegion, radius));
+}
+
+
+template <typename TImage>
+void
+Expect_output_pixels_are_medians_of_neighborhoods(const typename TImage::SizeType & imageSize,
+                                                  const typename TImage::SizeType & radius,
+                                                  const typename TImage::PixelType  minimum,
+                                                  const typename TImage::PixelType  maximum)
+{
+  const auto inputImage = itk::Testing::CreateRandomImage<TImage>(imageSize, minimum, maximum);
+  Expect_output_pixels_are_medians_of_neighborhoods(*inputImage, radius, inputImage->GetLargestPossibleRegion());
+}
+
 } // namespace
 
 
@@ -122,3 +206,60 @@ TEST(MedianImageFilter, ExpectedOutputPixelValuesForSequenceOfNaturalNumbers)
   Expect_output_has_specified_pixel_values_when_input_has_sequence_of_natural_numbers<itk::Image<int, 3>>(
     itk::Size<3>{ { 2, 2, 2 } }, { 3, 3, 3, 4, 5, 6, 6, 6 });
 }
+
+
+// Tests that each of the methods to compute the medians, histograms for small
+// ranges of integers, sorted windows for other scalars, gives the median of
+// each neighborhood, also at the border of the image.
+TEST(MedianImageFilter, OutputPixelsAreMediansOfNeighborhoods)
+{
+  using UCharImageType = itk::Image<unsigned char>;
+  using ShortImageType = itk::Image<short, 3>;
+  using IntImageType = itk::Image<int, 3>;
+  using FloatImageType = itk::Image<float, 3>;
+
+  // Histograms.
+  Expect_output_pixels_are_medians_of_neighborhoods<UCharImageType>({ { 37, 23 } }, { { 3, 2 } }, 0, 255);
+  Expect_output_pixels_are_medians_of_neighborhoods<UCharImageType>({ { 4, 3 } }, { { 5, 5 } }, 10, 20);
+  Expect_output_pixels_are_medians_of_neighborhoods<ShortImageType>({ { 19, 14, 11 } }, { { 2, 3, 1 } }, -300, 300);
+  Expect_output_pixels_are_medians_of_neighborhoods<IntImageType>({ { 15, 12, 9 } }, { { 4, 0, 2 } }, -40, 40);
+
+  // Sorted windows.
+  Expect_output_pixels_are_medians_of_neighborhoods<UCharImageType>({ { 31, 17 } }, { { 1, 1 } }, 0, 255);
+  Expect_output_pixels_are_medians_of_neighborhoods<IntImageType>(
+    { { 15, 12, 9 } }, { { 2, 1, 3 } }, -1000000000, 1000000000);
+  Expect_output_pixels_are_medians_of_neighborhoods<FloatImageType>({ { 13, 16, 7 } }, { { 0, 2, 1 } }, -1.0f, 1.0f);
+  Expect_output_pixels_are_medians_of_neighborhoods<FloatImageType>({ { 3, 2, 2 } }, { { 3, 3, 3 } }, 0.0f, 1.0f);
+
+  // Requested regions inside the image, whose input buffer is cropped.
+  const auto shortImage = itk::Testing::CreateRandomImage<ShortImageType>({ { 25, 20, 15 } }, 0, 1000);
+  Expect_output_pixels_are_medians_of_neighborhoods(
+    *shortImage, { { 3, 2, 2 } }, ShortImageType::RegionType({ { 2, 5, 4 } }, { { 20, 8, 6 } }));
+  const auto floatImage = itk::Testing::CreateRandomImage<FloatImageType>({ { 25, 20, 15 } }, 0.0f, 1000.0f);
+  Expect_output_pixels_are_medians_of_neighborhoods(
+    *floatImage, { { 3, 2, 2 } }, FloatImageType::RegionType({ { 2, 5, 4 } }, { { 20, 8, 6 } }));
+}
+
+
+// Tests that the medians computed with histograms are converted to the
+// output pixel type, also when they are negative.
+TEST(MedianImageFilter, HistogramMediansAreConvertedToOutputPixelType)
+{
+  using ShortImageType = itk::Image<short, 3>;
+  using FloatImageType = itk::Image<float, 3>;
+
+  const ShortImageType::SizeType radius{ { 2, 1, 1 } };
+
+  const auto inputImage = itk::Testing::CreateRandomImage<ShortImageType>({ { 17, 12, 5 } }, -300, 300);
+  const auto filter = itk::MedianImageFilter<ShortImageType, FloatImageType>::New();
+  filter->SetInput(inputImage);
+  filter->SetRadius(radius);
+  filter->Update();
+
+  const auto               outputRange = itk::ImageRegionRange<const FloatImageType>(*filter->GetOutput());
+  const std::vector<float> outputPixelValues(outputRange.cbegin(), outputRange.cend());
+  const std::vector<short> medians =
+    ComputeMediansBruteForce(*inputImage, inputImage->GetLargestPossibleRegion(), radius);
+
+  EXPECT_EQ(outputPixelValues, std::vector<float>(medians.cbegin(), medians.cend()));
+}
@@ -80,6 +80,11 @@ namespace itk
  *                             in the MetaDataDictionary
  * re-arrangement.
  *
+ * The voxel data is stored in deflate compressed chunks, by default of
+ * one N-1 dimensional slice each. A ChunkSize such as 64 x 64 x 64 makes
+ * the reading of arbitrary regions of the image faster. The chunks which
+ * a region covers whole are compressed, and decompressed, on multiple
+ * threads; the others go through the HDF5 library.
  *
  */
 
@@ -138,6 +143,22 @@ public:
   void
   Write(const void * buffer) override;
 
+  /** The size of the chunks of the voxel data, for each dimension of the
+   * image, the fastest moving first. Dimensions without a size, or with a
+   * size of zero, are chunked whole, except for the slowest moving one,
+   * which is chunked one slice at a time when no size is given at all.
+   * Must be set before writing the image information. */
+  using ChunkSizeType = std::vector<SizeValueType>;
+  itkSetMacro(ChunkSize, ChunkSizeType);
+  itkGetConstReferenceMacro(ChunkSize, ChunkSizeType);
+
+  /** Set/Get whether to shuffle the bytes of the components before they are
+   * deflated, grouping the bytes of the same significance, which compresses
+   * multi-byte components better. Off by default. */
+  itkSetMacro(UseShuffleFilter, bool);
+  itkGetConstMacro(UseShuffleFilter, bool);
+  itkBooleanMacro(UseShuffleFilter);
+
 protected:
   HDF5ImageIO();
   ~HDF5ImageIO() override;
@@ -204,6 +225,19 @@ private:
   void
   SetupStreaming(H5::DataSpace * imageSpace, H5::DataSpace * slabSpace);
 
+  /** Read or write the chunks of the voxel data which intersect the IORegion,
+   * decompressing or compressing them on multiple threads, when the filters
+   * of the voxel data allow it. Returns false otherwise. */
+  bool
+  ReadChunks(void * buffer);
+  bool
+  WriteChunks(const void * buffer);
+
+  /** Whether the voxel data is chunked, with filters which ReadChunks and
+   * WriteChunks apply: deflate, optionally preceded by shuffle. */
+  bool
+  HasSupportedChunkFilters(bool & shuffle) const;
+
   /* A convenience function to ensure that the
    * state of the HDF5ImageIO object is returned
    * to a state similar to constructing a new
@@ -217,6 +251,8 @@ private:
   std::unique_ptr<H5::H5File>  m_H5File;
   std::unique_ptr<H5::DataSet> m_VoxelDataSet;
   bool                         m_ImageInformationWritten{ false };
+  ChunkSizeType                m_ChunkSize{};
+  bool                         m_UseShuffleFilter{ false };
 };
 } // end namespace itk
 
@@ -21,9 +21,14 @@
 #include "itkArray.h"
 #include "itksys/SystemTools.hxx"
 #include "itk_H5Cpp.h"
+#include "itk_zlib.h"
 #include "itkMakeUniqueForOverwrite.h"
+#include "itkMultiThreaderBase.h"
+#include "itkPrintHelper.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 
 namespace itk
 {
@@ -50,8 +55,13 @@ void
 HDF5ImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+
+  using namespace print_helper;
+
   // just prints out the pointer value.
   os << indent << "H5File: " << m_H5File.get() << std::endl;
+  os << indent << "ChunkSize: " << m_ChunkSize << std::endl;
+  os << indent << "UseShuffleFilter: " << (m_UseShuffleFilter ? "On" : "Off") << std::endl;
 }
 
 //
@@ -905,54 +915,513 @@ HDF5ImageIO::ReadImageInformation()
   }
 }
 
+namespace
+{
+// The extent of the voxel data, and the offset and size of the IORegion in
+// it, in the HDF5 order: the slowest moving dimension first, and the
+// components last.
+void
+GetHDF5Region(const ImageIOBase &    imageIO,
+              std::vector<hsize_t> & extent,
+              std::vector<hsize_t> & offset,
+              std::vector<hsize_t> & size)
+{
+  const ImageIORegion regionToRead = imageIO.GetIORegion();
+  const unsigned int  numComponents = imageIO.GetNumberOfComponents();
+  const unsigned int  numDims = imageIO.GetNumberOfDimensions();
+  const unsigned int  HDFDim = numDims + (numComponents > 1 ? 1 : 0);
+
+  extent.assign(HDFDim, 1);
+  offset.assign(HDFDim, 0);
+  size.assign(HDFDim, 1);
+  if (numComponents > 1)
+  {
+    extent[HDFDim - 1] = numComponents;
+    size[HDFDim - 1] = numComponents;
+  }
+  for (unsigned int j = 0; j < numDims; ++j)
+  {
+    extent[numDims - j - 1] = imageIO.GetDimensions(j);
+    if (j < regionToRead.GetImageDimension())
+    {
+      offset[numDims - j - 1] = regionToRead.GetIndex(j);
+      size[numDims - j - 1] = regionToRead.GetSize(j);
+    }
+  }
+}
+
+// Copy a box of elements between two arrays of the given extents, stored in
+// the HDF5 order, from the given start in the source to the given start in
+// the destination.
+void
+CopyBox(const unsigned char *        source,
+        const std::vector<hsize_t> & sourceExtent,
+        const hsize_t *              sourceStart,
+        unsigned char *              destination,
+        const std::vector<hsize_t> & destinationExtent,
+        const hsize_t *              destinationStart,
+        const hsize_t *              boxSize,
+        size_t                       elementSize)
+{
+  const auto          rank = static_cast<int>(sourceExtent.size());
+  std::vector<size_t> sourceStride(rank, elementSize);
+  std::vector<size_t> destinationStride(rank, elementSize);
+  for (int d = rank - 2; d >= 0; --d)
+  {
+    sourceStride[d] = sourceStride[d + 1] * sourceExtent[d + 1];
+    destinationStride[d] = destinationStride[d + 1] * destinationExtent[d + 1];
+  }
+  size_t sourceOffset = 0;
+  size_t destinationOffset = 0;
+  for (int d = 0; d < rank; ++d)
+  {
+    sourceOffset += sourceStart[d] * sourceStride[d];
+    destinationOffset += destinationStart[d] * destinationStride[d];
+  }
+
+  // The last dimension is contiguous in both arrays.
+  const size_t         runLength = boxSize[rank - 1] * elementSize;
+  std::vector<hsize_t> position(rank, 0);
+  for (;;)
+  {
+    std::memcpy(destination + destinationOffset, source + sourceOffset, runLength);
+    int d = rank - 2;
+    for (; d >= 0; --d)
+    {
+      sourceOffset += sourceStride[d];
+      destinationOffset += destinationStride[d];
+      if (++position[d] < boxSize[d])
+      {
+        break;
+      }
+      sourceOffset -= boxSize[d] * sourceStride[d];
+      destinationOffset -= boxSize[d] * destinationStride[d];
+      position[d] = 0;
+    }
+    if (d < 0)
+    {
+      return;
+    }
+  }
+}
+
+// The byte shuffle of the HDF5 shuffle filter: the bytes of the same
+// significance of all the elements are grouped together.
+void
+ShuffleBytes(const unsigned char * source, unsigned char * destination, size_t numberOfElements, size_t elementSize)
+{
+  for (size_t i = 0; i < numberOfElements; ++i)
+  {
+    for (size_t b = 0; b < elementSize; ++b)
+    {
+      destination[b * numberOfElements + i] = source[i * elementSize + b];
+    }
+  }
+}
+
+void
+UnshuffleBytes(const unsigned char * source, unsigned char * destination, size_t numberOfElements, size_t elementSize)
+{
+  for (size_t i = 0; i < numberOfElements; ++i)
+  {
+    for (size_t b = 0; b < elementSize; ++b)
+    {
+      destination[i * elementSize + b] = source[b * numberOfElements + i];
+    }
+  }
+}
+
+// The chunks of the voxel data which intersect the IORegion, and their
+// intersection with it.
+struct RegionChunks
+{
+  RegionChunks(const std::vector<hsize_t> & extent,
+               const std::vector<hsize_t> & chunkSize,
+               const std::vector<hsize_t> & offset,
+               const std::vector<hsize_t> & size)
+    : rank(extent.size())
+  {
+    std::vector<hsize_t> first(rank);
+    std::vector<hsize_t> last(rank);
+    for (size_t d = 0; d < rank; ++d)
+    {
+      first[d] = offset[d] / chunkSize[d];
+      last[d] = (offset[d] + size[d] - 1) / chunkSize[d];
+    }
+    std::vector<hsize_t> position(first);
+    for (;;)
+    {
+      bool isWhole = true;
+      for (size_t d = 0; d < rank; ++d)
+      {
+        const hsize_t chunkStart = position[d] * chunkSize[d];
+        const hsize_t chunkEnd = std::min(chunkStart + chunkSize[d], extent[d]);
+        const hsize_t start = std::max(chunkStart, offset[d]);
+        const hsize_t end = std::min(chunkEnd, offset[d] + size[d]);
+        chunkOffsets.push_back(chunkStart);
+        starts.push_back(start);
+        counts.push_back(end - start);
+        isWhole = isWhole && start == chunkStart && end == chunkEnd;
+      }
+      isWholeChunk.push_back(isWhole);
+
+      size_t d = rank;
+      while (d > 0 && position[d - 1] == last[d - 1])
+      {
+        position[d - 1] = first[d - 1];
+        --d;
+      }
+      if (d == 0)
+      {
+        break;
+      }
+      ++position[d - 1];
+    }
+  }
+
+  size_t
+  GetNumberOfChunks() const
+  {
+    return isWholeChunk.size();
+  }
+
+  const size_t         rank;
+  std::vector<hsize_t> chunkOffsets{};
+  std::vector<hsize_t> starts{};
+  std::vector<hsize_t> counts{};
+  std::vector<bool>    isWholeChunk{};
+};
+
+// Transfer the given box of the IORegion between the buffer and the voxel
+// data set through the HDF5 library, which applies the filters.
+void
+TransferBox(H5::DataSet &                dataSet,
+            const H5::DataType &         memoryType,
+            const std::vector<hsize_t> & offset,
+            const std::vector<hsize_t> & size,
+            const hsize_t *              start,
+            const hsize_t *              count,
+            const void *                 constBuffer,
+            void *                       buffer)
+{
+  const auto           rank = static_cast<int>(size.size());
+  std::vector<hsize_t> memoryStart(rank);
+  for (int d = 0; d < rank; ++d)
+  {
+    memoryStart[d] = start[d] - offset[d];
+  }
+  H5::DataSpace memorySpace(rank, size.data());
+  memorySpace.selectHyperslab(H5S_SELECT_SET, count, memoryStart.data());
+  H5::DataSpace fileSpace = dataSet.getSpace();
+  fileSpace.selectHyperslab(H5S_SELECT_SET, count, start);
+  if (buffer != nullptr)
+  {
+    dataSet.read(buffer, memoryType, memorySpace, fileSpace);
+  }
+  else
+  {
+    dataSet.write(constBuffer, memoryType, memorySpace, fileSpace);
+  }
+}
+
+// The number of chunks processed together: read or written sequentially,
+// then decompressed or compressed concurrently.
+SizeValueType
+GetNumberOfChunksPerBatch(const MultiThreaderBase * multiThreader)
+{
+  return 4 * static_cast<SizeValueType>(multiThreader->GetNumberOfWorkUnits());
+}
+} // namespace
+
 void
 HDF5ImageIO::SetupStreaming(H5::DataSpace * imageSpace, H5::DataSpace * slabSpace)
 {
-  const ImageIORegion      regionToRead = this->GetIORegion();
-  ImageIORegion::SizeType  size = regionToRead.GetSize();
-  ImageIORegion::IndexType start = regionToRead.GetIndex();
-  //
-  const int numComponents = this->GetNumberOfComponents();
+  std::vector<hsize_t> extent;
+  std::vector<hsize_t> offset;
+  std::vector<hsize_t> size;
+  GetHDF5Region(*this, extent, offset, size);
 
-  const int HDFDim(this->GetNumberOfDimensions() + (numComponents > 1 ? 1 : 0));
+  slabSpace->setExtentSimple(static_cast<int>(size.size()), size.data());
+  imageSpace->selectHyperslab(H5S_SELECT_SET, size.data(), offset.data());
+}
 
-  const auto offset = make_unique_for_overwrite<hsize_t[]>(HDFDim);
-  const auto HDFSize = make_unique_for_overwrite<hsize_t[]>(HDFDim);
-  const int  limit = regionToRead.GetImageDimension();
-  //
-  // fastest moving dimension is intra-voxel
-  // index
-  int i = 0;
-  if (numComponents > 1)
+bool
+HDF5ImageIO::HasSupportedChunkFilters(bool & shuffle) const
+{
+  const H5::DSetCreatPropList plist = m_VoxelDataSet->getCreatePlist();
+  if (plist.getLayout() != H5D_CHUNKED)
+  {
+    return false;
+  }
+  std::vector<H5Z_filter_t> filters;
+  for (int i = 0; i < plist.getNfilters(); ++i)
   {
-    offset[HDFDim - 1] = 0;
-    HDFSize[HDFDim - 1] = numComponents;
-    ++i;
+    unsigned int flags = 0;
+    size_t       numberOfValues = 0;
+    unsigned int filterConfig = 0;
+    filters.push_back(plist.getFilter(i, flags, numberOfValues, nullptr, 0, nullptr, filterConfig));
   }
+  shuffle = filters.size() == 2 && filters[0] == H5Z_FILTER_SHUFFLE;
+  return (filters.size() == 1 || shuffle) && filters.back() == H5Z_FILTER_DEFLATE;
+}
 
-  for (int j = 0; j < limit && i < HDFDim; ++i, ++j)
+bool
+HDF5ImageIO::ReadChunks(void * buffer)
+{
+  bool shuffle = false;
+  if (!this->HasSupportedChunkFilters(shuffle))
+  {
+    return false;
+  }
+  const H5::DataType voxelType = m_VoxelDataSet->getDataType();
+  if (!(voxelType == ComponentToPredType(this->GetComponentType())))
   {
-    offset[HDFDim - i - 1] = start[j];
-    HDFSize[HDFDim - i - 1] = size[j];
+    return false;
   }
 
-  while (i < HDFDim)
+  std::vector<hsize_t> extent;
+  std::vector<hsize_t> offset;
+  std::vector<hsize_t> size;
+  GetHDF5Region(*this, extent, offset, size);
+  const size_t         rank = extent.size();
+  std::vector<hsize_t> chunkSize(rank);
+  if (m_VoxelDataSet->getCreatePlist().getChunk(static_cast<int>(rank), chunkSize.data()) != static_cast<int>(rank))
   {
-    offset[HDFDim - i - 1] = 0;
-    HDFSize[HDFDim - i - 1] = 1;
-    ++i;
+    return false;
   }
 
-  slabSpace->setExtentSimple(HDFDim, HDFSize.get());
-  imageSpace->selectHyperslab(H5S_SELECT_SET, HDFSize.get(), offset.get());
+  const size_t elementSize = this->GetComponentSize();
+  size_t       chunkBytes = elementSize;
+  for (const hsize_t s : chunkSize)
+  {
+    chunkBytes *= s;
+  }
+  // The filter mask of a chunk flags the filters which were skipped.
+  const unsigned int deflateMask = shuffle ? 2 : 1;
+  const unsigned int shuffleMask = shuffle ? 1 : 0;
+
+  const RegionChunks chunks(extent, chunkSize, offset, size);
+  const auto         multiThreader = MultiThreaderBase::New();
+  const auto         chunksPerBatch = GetNumberOfChunksPerBatch(multiThreader);
+  auto *             out = static_cast<unsigned char *>(buffer);
+
+  std::vector<size_t>                     batch;
+  std::vector<std::vector<unsigned char>> rawChunks(chunksPerBatch);
+  std::vector<uint32_t>                   filterMasks(chunksPerBatch);
+  std::atomic<bool>                       failed{ false };
+  for (size_t first = 0; first < chunks.GetNumberOfChunks(); first += chunksPerBatch)
+  {
+    // Read the stored chunks of the batch. The chunks which were never
+    // written hold the fill value, which the library reads.
+    batch.clear();
+    const size_t end = std::min(first + chunksPerBatch, chunks.GetNumberOfChunks());
+    for (size_t c = first; c < end; ++c)
+    {
+      const hsize_t * chunkOffset = &chunks.chunkOffsets[c * rank];
+      hsize_t         storageSize = 0;
+      if (H5Dget_chunk_storage_size(m_VoxelDataSet->getId(), chunkOffset, &storageSize) < 0 || storageSize == 0)
+      {
+        TransferBox(*m_VoxelDataSet,
+                    voxelType,
+                    offset,
+                    size,
+                    &chunks.starts[c * rank],
+                    &chunks.counts[c * rank],
+                    nullptr,
+                    buffer);
+        continue;
+      }
+      std::vector<unsigned char> & rawChunk = rawChunks[batch.size()];
+      uint32_t &                   filterMask = filterMasks[batch.size()];
+      rawChunk.resize(storageSize);
+      if (H5Dread_chunk(m_VoxelDataSet->getId(), H5P_DEFAULT, chunkOffset, &filterMask, rawChunk.data()) < 0)
+      {
+        itkExceptionMacro("Could not read a chunk of " << this->GetFileName());
+      }
+      batch.push_back(c);
+    }
+
+    // Decompress them concurrently, and copy their intersection with the
+    // region to read.
+    multiThreader->ParallelizeArray(
+      0,
+      batch.size(),
+      [&](SizeValueType b) {
+        const size_t               c = batch[b];
+        std::vector<unsigned char> chunk;
+        const unsigned char *      data = rawChunks[b].data();
+        if ((filterMasks[b] & deflateMask) == 0)
+        {
+          chunk.resize(chunkBytes);
+          auto decompressedSize = static_cast<uLongf>(chunkBytes);
+          if (uncompress(chunk.data(), &decompressedSize, data, static_cast<uLong>(rawChunks[b].size())) != Z_OK ||
+              decompressedSize != chunkBytes)
+          {
+            failed = true;
+            return;
+          }
+          data = chunk.data();
+        }
+        else if (rawChunks[b].size() != chunkBytes)
+        {
+          failed = true;
+          return;
+        }
+        std::vector<unsigned char> unshuffled;
+        if (shuffle && (filterMasks[b] & shuffleMask) == 0 && elementSize > 1)
+        {
+          unshuffled.resize(chunkBytes);
+          UnshuffleBytes(data, unshuffled.data(), chunkBytes / elementSize, elementSize);
+          data = unshuffled.data();
+        }
+        std::vector<hsize_t> startInChunk(rank);
+        std::vector<hsize_t> startInRegion(rank);
+        for (size_t d = 0; d < rank; ++d)
+        {
+          startInChunk[d] = chunks.starts[c * rank + d] - chunks.chunkOffsets[c * rank + d];
+          startInRegion[d] = chunks.starts[c * rank + d] - offset[d];
+        }
+        CopyBox(data,
+                chunkSize,
+                startInChunk.data(),
+                out,
+                size,
+                startInRegion.data(),
+                &chunks.counts[c * rank],
+                elementSize);
+      },
+      nullptr);
+    if (failed)
+    {
+      itkExceptionMacro("Could not decompress a chunk of " << this->GetFileName());
+    }
+  }
+  return true;
+}
+
+bool
+HDF5ImageIO::WriteChunks(const void * buffer)
+{
+  bool shuffle = false;
+  if (!this->HasSupportedChunkFilters(shuffle))
+  {
+    return false;
+  }
+
+  std::vector<hsize_t> extent;
+  std::vector<hsize_t> offset;
+  std::vector<hsize_t> size;
+  GetHDF5Region(*this, extent, offset, size);
+  const size_t         rank = extent.size();
+  std::vector<hsize_t> chunkSize(rank);
+  if (m_VoxelDataSet->getCreatePlist().getChunk(static_cast<int>(rank), chunkSize.data()) != static_cast<int>(rank))
+  {
+    return false;
+  }
+
+  const size_t elementSize = this->GetComponentSize();
+  size_t       chunkBytes = elementSize;
+  for (const hsize_t s : chunkSize)
+  {
+    chunkBytes *= s;
+  }
+  const H5::PredType dataType = ComponentToPredType(this->GetComponentType());
+
+  // The chunks which the region covers partially are merged with their
+  // stored data by the library.
+  const RegionChunks  chunks(extent, chunkSize, offset, size);
+  std::vector<size_t> wholeChunks;
+  for (size_t c = 0; c < chunks.GetNumberOfChunks(); ++c)
+  {
+    if (chunks.isWholeChunk[c])
+    {
+      wholeChunks.push_back(c);
+    }
+    else
+    {
+      TransferBox(
+        *m_VoxelDataSet, dataType, offset, size, &chunks.starts[c * rank], &chunks.counts[c * rank], buffer, nullptr);
+    }
+  }
+
+  const auto                              multiThreader = MultiThreaderBase::New();
+  const auto                              chunksPerBatch = GetNumberOfChunksPerBatch(multiThreader);
+  const auto *                            in = static_cast<const unsigned char *>(buffer);
+  const int                               level = this->GetCompressionLevel();
+  std::vector<std::vector<unsigned char>> compressedChunks(chunksPerBatch);
+  std::atomic<bool>                       failed{ false };
+  for (size_t first = 0; first < wholeChunks.size(); first += chunksPerBatch)
+  {
+    // Compress the chunks of the batch concurrently. The part of the edge
+    // chunks outside of the image is zero.
+    const size_t numberOfChunks = std::min(static_cast<size_t>(chunksPerBatch), wholeChunks.size() - first);
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfChunks,
+      [&](SizeValueType b) {
+        const size_t               c = wholeChunks[first + b];
+        std::vector<unsigned char> chunk(chunkBytes, 0);
+        std::vector<hsize_t>       startInChunk(rank, 0);
+        std::vector<hsize_t>       startInRegion(rank);
+        for (size_t d = 0; d < rank; ++d)
+        {
+          startInRegion[d] = chunks.starts[c * rank + d] - offset[d];
+        }
+        CopyBox(in,
+                size,
+                startInRegion.data(),
+                chunk.data(),
+                chunkSize,
+                startInChunk.data(),
+                &chunks.counts[c * rank],
+                elementSize);
+        if (shuffle && elementSize > 1)
+        {
+          std::vector<unsigned char> shuffled(chunkBytes);
+          ShuffleBytes(chunk.data(), shuffled.data(), chunkBytes / elementSize, elementSize);
+          chunk.swap(shuffled);
+        }
+        std::vector<unsigned char> & compressedChunk = compressedChunks[b];
+        auto                         compressedSize = compressBound(static_cast<uLong>(chunkBytes));
+        compressedChunk.resize(compressedSize);
+        if (compress2(compressedChunk.data(), &compressedSize, chunk.data(), static_cast<uLong>(chunkBytes), level) !=
+            Z_OK)
+        {
+          failed = true;
+          return;
+        }
+        compressedChunk.resize(compressedSize);
+      },
+      nullptr);
+    if (failed)
+    {
+      itkExceptionMacro("Could not compress a chunk of " << this->GetFileName());
+    }
+
+    for (size_t b = 0; b < numberOfChunks; ++b)
+    {
+      const size_t c = wholeChunks[first + b];
+      if (H5Dwrite_chunk(m_VoxelDataSet->getId(),
+                         H5P_DEFAULT,
+                         0,
+                         &chunks.chunkOffsets[c * rank],
+                         compressedChunks[b].size(),
+                         compressedChunks[b].data()) < 0)
+      {
+        itkExceptionMacro("Could not write a chunk of " << this->GetFileName());
+      }
+    }
+  }
+  return true;
 }
 
 void
 HDF5ImageIO::Read(void * buffer)
 {
-  const ImageIORegion            regionToRead = this->GetIORegion();
-  const ImageIORegion::SizeType  size = regionToRead.GetSize();
-  const ImageIORegion::IndexType start = regionToRead.GetIndex();
+  if (this->ReadChunks(buffer))
+  {
+    return;
+  }
 
   const H5::DataType voxelType = m_VoxelDataSet->getDataType();
   H5::DataSpace      imageSpace = m_VoxelDataSet->getSpace();
@@ -1072,14 +1541,29 @@ HDF5ImageIO::WriteImageInformation()
     const H5::PredType  dataType = ComponentToPredType(this->GetComponentType());
 
     // set up properties for chunked, compressed writes.
-    // in this case, set the chunk size to be the N-1 dimension
+    // by default, set the chunk size to be the N-1 dimension
     // region
     const H5::DSetCreatPropList plist;
 
     // we have implicit compression enabled here?
+    if (m_UseShuffleFilter)
+    {
+      plist.setShuffle();
+    }
     plist.setDeflate(this->GetCompressionLevel());
 
-    dims[0] = 1;
+    const int imageDims = this->GetNumberOfDimensions();
+    for (int i(0), j(imageDims - 1); i < imageDims; i++, j--)
+    {
+      if (m_ChunkSize.empty())
+      {
+        dims[j] = (i == imageDims - 1) ? 1 : this->m_Dimensions[i];
+      }
+      else if (i < static_cast<int>(m_ChunkSize.size()) && m_ChunkSize[i] > 0)
+      {
+        dims[j] = std::min<hsize_t>(m_ChunkSize[i], this->m_Dimensions[i]);
+      }
+    }
     plist.setChunk(numDims, dims.get());
     dims.reset();
 
@@ -1283,9 +1767,16 @@ HDF5ImageIO::Write(const void * buffer)
     }
     H5::DataSpace      imageSpace(numDims, dims.get());
     const H5::PredType dataType = ComponentToPredType(this->GetComponentType());
-    H5::DataSpace      dspace;
-    this->SetupStreaming(&imageSpace, &dspace);
-    m_VoxelDataSet->write(buffer, dataType, dspace, imageSpace);
+    if (!this->WriteChunks(buffer))
+    {
+      H5::DataSpace dspace;
+      this->SetupStreaming(&imageSpace, &dspace);
+      m_VoxelDataSet->write(buffer, dataType, dspace, imageSpace);
+    }
+  }
+  catch (const ExceptionObject &)
+  {
+    throw;
   }
   // catch failure caused by the H5File operations
   catch (const H5::FileIException & error)
@@ -0,0 +1,187 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageSource.h"
+#include "itkVector.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template <typename TImage>
+typename TImage::PixelType
+ExpectedValue(const typename TImage::IndexType & index)
+{
+  return typename TImage::PixelType(index[0] + 10 * index[1] + 100 * index[2]);
+}
+
+// Generates the pixels of the requested region only, so that writers
+// stream it.
+template <typename TImage>
+class IndexImageSource : public itk::ImageSource<TImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(IndexImageSource);
+
+  using Self = IndexImageSource;
+  using Superclass = itk::ImageSource<TImage>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(IndexImageSource);
+
+  itkSetMacro(Region, typename TImage::RegionType);
+
+protected:
+  IndexImageSource() = default;
+  ~IndexImageSource() override = default;
+
+  void
+  GenerateOutputInformation() override
+  {
+    this->GetOutput()->SetLargestPossibleRegion(m_Region);
+  }
+
+  void
+  GenerateData() override
+  {
+    TImage * output = this->GetOutput();
+    output->SetBufferedRegion(output->GetRequestedRegion());
+    output->Allocate();
+    for (itk::ImageRegionIteratorWithIndex<TImage> it(output, output->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+    {
+      it.Set(ExpectedValue<TImage>(it.GetIndex()));
+    }
+  }
+
+private:
+  typename TImage::RegionType m_Region{};
+};
+
+// Write an image in chunks of the given size, in the given number of stream
+// divisions, then read regions of it back.
+template <typename TImage>
+bool
+WriteAndReadChunks(const std::string &                              fileName,
+                   const itk::HDF5ImageIO::ChunkSizeType &          chunkSize,
+                   bool                                             useShuffleFilter,
+                   unsigned int                                     numberOfStreamDivisions,
+                   const std::vector<typename TImage::RegionType> & regionsToRead)
+{
+  const typename TImage::RegionType largestRegion(typename TImage::SizeType{ { 21, 18, 13 } });
+  const auto                        source = IndexImageSource<TImage>::New();
+  source->SetRegion(largestRegion);
+
+  const auto imageIO = itk::HDF5ImageIO::New();
+  imageIO->SetChunkSize(chunkSize);
+  imageIO->SetUseShuffleFilter(useShuffleFilter);
+  const auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetImageIO(imageIO);
+  writer->SetFileName(fileName);
+  writer->SetInput(source->GetOutput());
+  writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  writer->Update();
+
+  for (const auto & regionToRead : regionsToRead)
+  {
+    const auto reader = itk::ImageFileReader<TImage>::New();
+    reader->SetImageIO(itk::HDF5ImageIO::New());
+    reader->SetFileName(fileName);
+    reader->GetOutput()->SetRequestedRegion(regionToRead);
+    reader->Update();
+
+    const TImage * output = reader->GetOutput();
+    if (output->GetBufferedRegion() != regionToRead)
+    {
+      std::cerr << "Test failed for " << fileName << '!' << std::endl;
+      std::cerr << "Expected to read region " << regionToRead << ", but read " << output->GetBufferedRegion()
+                << std::endl;
+      return false;
+    }
+    for (itk::ImageRegionConstIteratorWithIndex<TImage> it(output, regionToRead); !it.IsAtEnd(); ++it)
+    {
+      if (it.Get() != ExpectedValue<TImage>(it.GetIndex()))
+      {
+        std::cerr << "Test failed for " << fileName << '!' << std::endl;
+        std::cerr << "Expected " << ExpectedValue<TImage>(it.GetIndex()) << " at " << it.GetIndex() << ", but got "
+                  << it.Get() << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkHDF5ImageIOChunkTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  const auto imageIO = itk::HDF5ImageIO::New();
+  ITK_TEST_EXPECT_TRUE(imageIO->GetChunkSize().empty());
+  ITK_TEST_SET_GET_BOOLEAN(imageIO, UseShuffleFilter, true);
+
+  using ImageType = itk::Image<short, 3>;
+  using VectorImageType = itk::Image<itk::Vector<float, 2>, 3>;
+  const std::vector<ImageType::RegionType> regions = { ImageType::RegionType({ { 3, 5, 2 } }, { { 10, 9, 8 } }),
+                                                       ImageType::RegionType({ { 8, 0, 0 } }, { { 1, 18, 13 } }),
+                                                       ImageType::RegionType({ { 16, 16, 8 } }, { { 5, 2, 5 } }),
+                                                       ImageType::RegionType(ImageType::SizeType{ { 21, 18, 13 } }) };
+
+  bool success = true;
+
+  // Slices, the default chunks, and blocks which do not divide the image.
+  // Stream divisions split some of the blocks, which the library then
+  // merges with the stored data.
+  const std::vector<itk::HDF5ImageIO::ChunkSizeType> chunkSizes = { {}, { 8, 8, 8 }, { 0, 5 } };
+  for (size_t i = 0; i < chunkSizes.size(); ++i)
+  {
+    for (const bool useShuffleFilter : { false, true })
+    {
+      for (const unsigned int numberOfStreamDivisions : { 1, 4 })
+      {
+        const std::string fileName = outputDirectory + "/itkHDF5ImageIOChunkTest" + std::to_string(i) +
+                                     (useShuffleFilter ? "Shuffle" : "") + std::to_string(numberOfStreamDivisions) +
+                                     ".hdf5";
+        ITK_TRY_EXPECT_NO_EXCEPTION(
+          success &= WriteAndReadChunks<ImageType>(
+            fileName, chunkSizes[i], useShuffleFilter, numberOfStreamDivisions, regions));
+      }
+    }
+  }
+
+  // The components of the pixels are chunked together.
+  ITK_TRY_EXPECT_NO_EXCEPTION(
+    success &= WriteAndReadChunks<VectorImageType>(outputDirectory + "/itkHDF5ImageIOChunkTestVector.hdf5",
+                                                   { 8, 8, 8 },
+                                                   true,
+                                                   3,
+                                                   { VectorImageType::RegionType({ { 3, 5, 2 } }, { { 10, 9, 8 } }) }));
+
+  std::cout << "Test finished." << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -27,6 +27,8 @@
 #include "itkImageRegion.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include <future>
+#include <memory>
 
 namespace itk
 {
@@ -118,9 +120,43 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
 
+  /** Set/Get whether to memory map the pixel data instead of reading it. Off
+   * by default. When on, and the ImageIO reports the location of the raw
+   * pixel data in the file (see ImageIOBase::GetRawPixelDataLocation()), and
+   * the pixel type of the file is the one of the output, and the region to
+   * read is contiguous in the file and starts at an offset aligned for the
+   * pixel components (which a header of arbitrary length, as the one of a
+   * ".mha" file, may prevent), the output imports a copy-on-write mapping
+   * of the file (see MemoryMappedImportImageContainer): the pixels are read
+   * from the file when first accessed, and modifying them does not modify the
+   * file. Otherwise the file is read as usual.
+   *
+   * \warning The file must not be modified while the output maps it. A
+   * private mapping only copies the pages which are written to: the pages
+   * which were not accessed yet are read from the file as it is then, and
+   * accessing a page past the end of a truncated file raises SIGBUS, which
+   * terminates the program. Hence ImageFileWriter refuses to write to the file
+   * which the buffer of its input maps. */
+  itkSetMacro(UseMemoryMapping, bool);
+  itkGetConstReferenceMacro(UseMemoryMapping, bool);
+  itkBooleanMacro(UseMemoryMapping);
+
+  /** Set/Get whether to read the next region ahead. Off by default. When on,
+   * and the reader is asked for a region which does not span the whole file
+   * along some dimension, as each piece of a StreamingImageFilter or of a
+   * streaming ImageFileWriter, it starts reading the region which follows it
+   * along the first such dimension on a background thread, while the current
+   * region is processed downstream. If the next region requested is that one,
+   * its pixels are taken from the read ahead buffer; otherwise they are
+   * discarded and the region is read as usual. The ImageIO must not be used
+   * directly while a region is being read ahead. */
+  itkSetMacro(UseReadAhead, bool);
+  itkGetConstReferenceMacro(UseReadAhead, bool);
+  itkBooleanMacro(UseReadAhead);
+
 protected:
   ImageFileReader();
-  ~ImageFileReader() override = default;
+  ~ImageFileReader() override;
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
@@ -153,6 +189,13 @@ protected:
   void
   GenerateData() override;
 
+  /** Make the output import a copy-on-write mapping (MAP_PRIVATE on POSIX)
+   * of the pixel data of the file, when possible. Returns whether it did.
+   * Until the mapped pages are accessed, truncating or rewriting the file
+   * changes them, or makes them raise SIGBUS; see SetUseMemoryMapping(). */
+  bool
+  MapPixelData();
+
   ImageIOBase::Pointer m_ImageIO{};
 
   bool m_UserSpecifiedImageIO{}; // keep track whether the
@@ -160,12 +203,33 @@ protected:
 
   bool m_UseStreaming{};
 
+  bool m_UseMemoryMapping{};
+
+  bool m_UseReadAhead{};
+
 private:
+  /** Start reading the region which follows m_ActualIORegion on a
+   * background thread, if there is one. */
+  void
+  StartReadAhead();
+
+  /** Wait until the region being read ahead, if any, is read. The read ahead
+   * buffer is released when the read failed, or when it is discarded. */
+  void
+  FinishReadAhead(bool discard = false);
+
   std::string m_ExceptionMessage{};
 
   // The region that the ImageIO class will return when we ask to
   // produce the requested region.
   ImageIORegion m_ActualIORegion{};
+
+  // The region being read ahead, in the pixel type of the file, and the
+  // background read. The future is declared last, so that it is waited for
+  // before the buffer is destroyed.
+  ImageIORegion           m_ReadAheadIORegion{};
+  std::unique_ptr<char[]> m_ReadAheadBuffer{};
+  std::future<void>       m_ReadAhead{};
 };
 
 
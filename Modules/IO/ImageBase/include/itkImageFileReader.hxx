@@ -21,12 +21,14 @@
 #include "itkObjectFactory.h"
 #include "itkImageIOFactory.h"
 #include "itkConvertPixelBuffer.h"
+#include "itkMemoryMappedImportImageContainer.h"
 #include "itkPixelTraits.h"
 #include "itkVectorImage.h"
 #include "itkMetaDataObject.h"
 
 #include "itksys/SystemTools.hxx"
 #include "itkMakeUniqueForOverwrite.h"
+#include <algorithm>
 #include <fstream>
 
 namespace itk
@@ -40,6 +42,15 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::ImageFileReader()
   m_UseStreaming = true;
 }
 
+template <typename TOutputImage, typename ConvertPixelTraits>
+ImageFileReader<TOutputImage, ConvertPixelTraits>::~ImageFileReader()
+{
+  if (m_ReadAhead.valid())
+  {
+    m_ReadAhead.wait();
+  }
+}
+
 template <typename TOutputImage, typename ConvertPixelTraits>
 void
 ImageFileReader<TOutputImage, ConvertPixelTraits>::PrintSelf(std::ostream & os, Indent indent) const
@@ -50,9 +61,12 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::PrintSelf(std::ostream & os,
 
   itkPrintSelfBooleanMacro(UserSpecifiedImageIO);
   itkPrintSelfBooleanMacro(UseStreaming);
+  itkPrintSelfBooleanMacro(UseMemoryMapping);
+  itkPrintSelfBooleanMacro(UseReadAhead);
 
   os << indent << "ExceptionMessage: " << m_ExceptionMessage << std::endl;
   os << indent << "ActualIORegion: " << m_ActualIORegion << std::endl;
+  os << indent << "ReadAheadIORegion: " << m_ReadAheadIORegion << std::endl;
 }
 
 template <typename TOutputImage, typename ConvertPixelTraits>
@@ -74,6 +88,9 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateOutputInformation()
 {
   const typename TOutputImage::Pointer output = this->GetOutput();
 
+  // The file, or the ImageIO, may have changed since the region was read ahead.
+  this->FinishReadAhead(true);
+
   itkDebugMacro("Reading file for GenerateOutputInformation()" << this->GetFileName());
 
   // Check to see if we can read the file given the name or prefix
@@ -305,6 +322,8 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::EnlargeOutputRequestedRegion(
 
   ImageIOAdaptor::Convert(imageRequestedRegion, ioRequestedRegion, largestRegion.GetIndex());
 
+  this->FinishReadAhead();
+
   // Tell the IO if we should use streaming while reading
   m_ImageIO->SetUseStreamedReading(m_UseStreaming);
 
@@ -355,6 +374,14 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
 
   const typename TOutputImage::Pointer output = this->GetOutput();
 
+  if (m_UseMemoryMapping && this->MapPixelData())
+  {
+    itkDebugMacro("Mapped the pixel data of " << this->GetFileName() << " for the region "
+                                              << output->GetBufferedRegion());
+    this->UpdateProgress(1.0f);
+    return;
+  }
+
   itkDebugMacro("ImageFileReader::GenerateData() \n"
                 << "Allocating the buffer with the EnlargedRequestedRegion \n"
                 << output->GetRequestedRegion() << '\n');
@@ -378,6 +405,16 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
     m_ExceptionMessage = err.GetDescription();
   }
 
+  // Take the pixels read ahead, if they are the ones of the region to read.
+  this->FinishReadAhead();
+  std::unique_ptr<char[]> loadBuffer;
+  if (m_ReadAheadBuffer && m_ReadAheadIORegion == m_ActualIORegion)
+  {
+    itkDebugMacro("Using the pixels read ahead for the IORegion: " << m_ActualIORegion);
+    loadBuffer = std::move(m_ReadAheadBuffer);
+  }
+  m_ReadAheadBuffer.reset();
+
   // Tell the ImageIO to read the file
   m_ImageIO->SetFileName(this->GetFileName().c_str());
 
@@ -389,6 +426,14 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
   // (as opposed to the sizes of the output)
   const size_t sizeOfActualIORegion =
     m_ActualIORegion.GetNumberOfPixels() * (m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents());
+  const auto load = [this, &loadBuffer, sizeOfActualIORegion]() -> const void * {
+    if (!loadBuffer)
+    {
+      loadBuffer = make_unique_for_overwrite<char[]>(sizeOfActualIORegion);
+      m_ImageIO->Read(static_cast<void *>(loadBuffer.get()));
+    }
+    return loadBuffer.get();
+  };
 
   const IOComponentEnum ioType = ImageIOBase::MapPixelType<typename ConvertPixelTraits::ComponentType>::CType;
   if (m_ImageIO->GetComponentType() != ioType ||
@@ -402,12 +447,9 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
                   << ConvertPixelTraits::GetNumberOfComponents() << " m_ImageIO->NumComponents "
                   << m_ImageIO->GetNumberOfComponents());
 
-    const auto loadBuffer = make_unique_for_overwrite<char[]>(sizeOfActualIORegion);
-    m_ImageIO->Read(static_cast<void *>(loadBuffer.get()));
-
     // See note below as to why the buffered region is needed and
     // not actualIORegion
-    this->DoConvertBuffer(static_cast<void *>(loadBuffer.get()), output->GetBufferedRegion().GetNumberOfPixels());
+    this->DoConvertBuffer(load(), output->GetBufferedRegion().GetNumberOfPixels());
   }
   else if (m_ActualIORegion.GetNumberOfPixels() != output->GetBufferedRegion().GetNumberOfPixels())
   {
@@ -420,12 +462,9 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
 
     OutputImagePixelType * outputBuffer = output->GetPixelContainer()->GetBufferPointer();
 
-    const auto loadBuffer = make_unique_for_overwrite<char[]>(sizeOfActualIORegion);
-    m_ImageIO->Read(static_cast<void *>(loadBuffer.get()));
-
     // we use std::copy_n here as it should be optimized to memcpy for
     // plain old data, but still is object oriented programming
-    std::copy_n(reinterpret_cast<const OutputImagePixelType *>(loadBuffer.get()),
+    std::copy_n(reinterpret_cast<const OutputImagePixelType *>(load()),
                 output->GetBufferedRegion().GetNumberOfPixels(),
                 outputBuffer);
   }
@@ -434,12 +473,162 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
     itkDebugMacro("No buffer conversion required.");
 
     OutputImagePixelType * outputBuffer = output->GetPixelContainer()->GetBufferPointer();
-    m_ImageIO->Read(outputBuffer);
+    if (loadBuffer)
+    {
+      std::copy_n(loadBuffer.get(), sizeOfActualIORegion, reinterpret_cast<char *>(outputBuffer));
+    }
+    else
+    {
+      m_ImageIO->Read(outputBuffer);
+    }
+  }
+
+  if (m_UseReadAhead)
+  {
+    this->StartReadAhead();
   }
 
   this->UpdateProgress(1.0f);
 }
 
+template <typename TOutputImage, typename ConvertPixelTraits>
+void
+ImageFileReader<TOutputImage, ConvertPixelTraits>::StartReadAhead()
+{
+  // Streamed regions follow each other along the first dimension in which
+  // they do not span the whole file, the last one being possibly smaller.
+  ImageIORegion      nextIORegion = m_ActualIORegion;
+  const unsigned int numberOfDimensions =
+    std::min(m_ActualIORegion.GetImageDimension(), m_ImageIO->GetNumberOfDimensions());
+  unsigned int dimension = 0;
+  while (dimension < numberOfDimensions && m_ActualIORegion.GetSize(dimension) == m_ImageIO->GetDimensions(dimension))
+  {
+    ++dimension;
+  }
+  if (dimension == numberOfDimensions)
+  {
+    return;
+  }
+  const IndexValueType nextIndex =
+    m_ActualIORegion.GetIndex(dimension) + static_cast<IndexValueType>(m_ActualIORegion.GetSize(dimension));
+  const SizeValueType  numberOfPixels = m_ImageIO->GetDimensions(dimension);
+  if (nextIndex >= static_cast<IndexValueType>(numberOfPixels))
+  {
+    return;
+  }
+  nextIORegion.SetIndex(dimension, nextIndex);
+  nextIORegion.SetSize(
+    dimension, std::min(m_ActualIORegion.GetSize(dimension), numberOfPixels - static_cast<SizeValueType>(nextIndex)));
+  m_ReadAheadIORegion = m_ImageIO->GenerateStreamableReadRegionFromRequestedRegion(nextIORegion);
+
+  itkDebugMacro("Reading ahead the IORegion: " << m_ReadAheadIORegion);
+  m_ReadAheadBuffer = make_unique_for_overwrite<char[]>(
+    m_ReadAheadIORegion.GetNumberOfPixels() * (m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents()));
+  m_ImageIO->SetIORegion(m_ReadAheadIORegion);
+  m_ReadAhead = std::async(std::launch::async,
+                           [imageIO = m_ImageIO, buffer = m_ReadAheadBuffer.get()] { imageIO->Read(buffer); });
+}
+
+template <typename TOutputImage, typename ConvertPixelTraits>
+void
+ImageFileReader<TOutputImage, ConvertPixelTraits>::FinishReadAhead(bool discard)
+{
+  if (m_ReadAhead.valid())
+  {
+    try
+    {
+      m_ReadAhead.get();
+    }
+    catch (const std::exception & err)
+    {
+      // The region is read again, when requested, and fails as usual.
+      itkDebugMacro("Reading ahead failed: " << err.what());
+      discard = true;
+    }
+  }
+  if (discard)
+  {
+    m_ReadAheadBuffer.reset();
+  }
+}
+
+template <typename TOutputImage, typename ConvertPixelTraits>
+bool
+ImageFileReader<TOutputImage, ConvertPixelTraits>::MapPixelData()
+{
+  using PixelContainerType = typename TOutputImage::PixelContainer;
+  using ElementType = typename PixelContainerType::Element;
+
+  const typename TOutputImage::Pointer output = this->GetOutput();
+  const ImageRegionType                requestedRegion = output->GetRequestedRegion();
+
+  // As for reading directly into the output buffer, the pixel types must match
+  // and the file must hold exactly the requested pixels. A VectorImage stores
+  // the components of its pixels as elements.
+  const bool            isVectorImage(strcmp(output->GetNameOfClass(), "VectorImage") == 0);
+  const unsigned int    numberOfComponents =
+    isVectorImage ? output->GetNumberOfComponentsPerPixel() : ConvertPixelTraits::GetNumberOfComponents();
+  const IOComponentEnum ioType = ImageIOBase::MapPixelType<typename ConvertPixelTraits::ComponentType>::CType;
+  if (m_ImageIO->GetComponentType() != ioType || m_ImageIO->GetNumberOfComponents() != numberOfComponents ||
+      m_ActualIORegion.GetNumberOfPixels() != requestedRegion.GetNumberOfPixels() ||
+      requestedRegion.GetNumberOfPixels() == 0)
+  {
+    return false;
+  }
+
+  std::string   fileName;
+  SizeValueType offset = 0;
+  if (!m_ImageIO->GetRawPixelDataLocation(fileName, offset))
+  {
+    return false;
+  }
+
+  // The region must be contiguous in the file: it spans the whole file along
+  // the fastest dimensions, then any range along one dimension, then a single
+  // index along the slower dimensions.
+  const SizeValueType pixelSize = m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents();
+  SizeValueType       stride = pixelSize;
+  bool                isPartial = false;
+  for (unsigned int i = 0; i < m_ImageIO->GetNumberOfDimensions(); ++i)
+  {
+    const bool          inRegion = i < m_ActualIORegion.GetImageDimension();
+    const SizeValueType size = inRegion ? m_ActualIORegion.GetSize(i) : 1;
+    if (isPartial && size != 1)
+    {
+      return false;
+    }
+    isPartial = isPartial || size != m_ImageIO->GetDimensions(i);
+    offset += (inRegion ? m_ActualIORegion.GetIndex(i) : 0) * stride;
+    stride *= m_ImageIO->GetDimensions(i);
+  }
+
+  const SizeValueType numberOfElements =
+    requestedRegion.GetNumberOfPixels() * (isVectorImage ? output->GetNumberOfComponentsPerPixel() : 1);
+  const SizeValueType numberOfBytes = m_ActualIORegion.GetNumberOfPixels() * pixelSize;
+  if (numberOfElements * sizeof(ElementType) != numberOfBytes || offset % alignof(ElementType) != 0)
+  {
+    return false;
+  }
+
+  const auto mappedFile = MemoryMappedFile::New();
+  try
+  {
+    mappedFile->Map(fileName, offset, numberOfBytes);
+  }
+  catch (const ExceptionObject & err)
+  {
+    itkDebugMacro("Reading the pixel data, as mapping it failed: " << err.GetDescription());
+    return false;
+  }
+
+  const auto container =
+    MemoryMappedImportImageContainer<typename PixelContainerType::ElementIdentifier, ElementType>::New();
+  container->SetMemoryMappedFile(mappedFile);
+  output->SetBufferedRegion(requestedRegion);
+  output->SetPixelContainer(container);
+  return true;
+}
+
 template <typename TOutputImage, typename ConvertPixelTraits>
 void
 ImageFileReader<TOutputImage, ConvertPixelTraits>::DoConvertBuffer(const void * inputData, size_t numberOfPixels)
@@ -31,6 +31,8 @@
 #include "itkDiffusionTensor3D.h"
 #include "itkMatrix.h"
 #include "itkImageAlgorithm.h"
+#include "itkMemoryMappedImportImageContainer.h"
+#include "itksys/SystemTools.hxx"
 #include <complex>
 
 namespace itk
@@ -333,6 +335,20 @@ ImageFileWriter<TInputImage>::GenerateData()
 
   itkDebugMacro("Writing file: " << m_FileName);
 
+  // Writing the file which the input buffer maps would change the pages of the
+  // mapping which were not accessed yet, or make them fault once the file is
+  // truncated.
+  using PixelContainerType = typename InputImageType::PixelContainer;
+  using MappedContainerType = MemoryMappedImportImageContainer<typename PixelContainerType::ElementIdentifier,
+                                                               typename PixelContainerType::Element>;
+  const auto * const mappedContainer = dynamic_cast<const MappedContainerType *>(input->GetPixelContainer());
+  if (mappedContainer != nullptr && mappedContainer->GetMemoryMappedFile() != nullptr &&
+      itksys::SystemTools::SameFile(mappedContainer->GetMemoryMappedFile()->GetFileName(), m_FileName))
+  {
+    itkExceptionMacro("Cannot write " << m_FileName << ", which the buffer of the input maps into memory. Read it "
+                                      << "without memory mapping, or write to another file.");
+  }
+
   // now extract the data as a raw buffer pointer
   const void * dataPtr = input->GetBufferPointer();
 
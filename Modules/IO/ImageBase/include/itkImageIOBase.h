@@ -38,6 +38,7 @@
 #include "vcl_compiler.h"
 
 #include <fstream>
+#include <functional>
 #include <string>
 
 namespace itk
@@ -440,6 +441,18 @@ public:
   virtual void
   Read(void * buffer) = 0;
 
+  /** Get the file holding the pixel data, and the offset of the data in that
+   * file, when the file holds the whole image as Read() would produce it:
+   * binary, uncompressed, in a single file, in the byte order of this machine,
+   * and without any rescaling or reordering of the components. Returns false
+   * otherwise, which is the default. Assumes ReadImageInformation() has been
+   * called. Used by ImageFileReader to memory map the pixel data. */
+  virtual bool
+  GetRawPixelDataLocation(std::string & itkNotUsed(fileName), SizeValueType & itkNotUsed(offset))
+  {
+    return false;
+  }
+
   /*-------- This part of the interfaces deals with writing data ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -860,6 +873,39 @@ protected:
   bool
   ReadBufferAsBinary(std::istream & is, void * buffer, SizeType num);
 
+  /** Convenient method to write the buffer holding the IORegion into the
+   * uncompressed binary data of the whole image, which starts at the given
+   * offset of a stream opened for random access. Each run of the region
+   * which is contiguous in the data is written at once. Return true on
+   * success. */
+  bool
+  WriteIORegionAsBinary(std::ostream & os, const void * buffer, SizeValueType dataOffset);
+
+  /** Call the given function for each run of the IORegion which is
+   * contiguous in the data of the whole image, with the offset of the run
+   * in the data and its size in bytes. The runs are visited in the order of
+   * the buffer holding the IORegion, which is also increasing offset order.
+   * Stops and returns false as soon as the function returns false. */
+  bool
+  VisitIORegionRuns(const std::function<bool(SizeValueType, SizeValueType)> & visitor) const;
+
+  /** Get the offset and the size in bytes of the IORegion in the data of
+   * the whole image. Returns false when the region is not a single
+   * contiguous range of the data, that is when it does not span the whole
+   * image in the dimensions before the last one in which it has a size
+   * larger than one. */
+  bool
+  GetIORegionDataRange(SizeValueType & offset, SizeValueType & size) const;
+
+  /** Check that the image information read from an existing file by the
+   * given ImageIO matches the image to paste into the file: the component
+   * type and number of components, the number of dimensions, the size,
+   * spacing and origin, and the direction cosines. The latter are compared
+   * with the given relative tolerance, for formats which store them with
+   * less precision. Throws an exception otherwise. */
+  void
+  VerifyPasteCompatibility(const ImageIOBase * fileImageIO, double tolerance = 0.0) const;
+
   /** Insert an extension to the list of supported extensions for reading. */
   void
   AddSupportedReadExtension(const char * extension);
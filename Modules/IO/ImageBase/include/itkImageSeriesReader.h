@@ -24,6 +24,7 @@
 #include <string>
 #include "itkMetaDataDictionary.h"
 #include "itkImageFileReader.h"
+#include <exception>
 
 namespace itk
 {
@@ -35,6 +36,14 @@ namespace itk
  * the files, but the image data must have the same Size for all
  * dimensions.
  *
+ * The files of the slices in the requested region are read
+ * concurrently, each directly into its slab of the output, by as many
+ * threads as the number of work units allows. Since an ImageIO cannot
+ * be shared between threads, when the ImageIO is set, each thread reads
+ * with a new instance of its class, which has its UseStreamedReading,
+ * ExpandRGBPalette and MetaDataDictionary, and the ImageIO itself then
+ * reads the information of the last file read.
+ *
  * \sa GDCMSeriesFileNames
  * \sa NumericSeriesFileNames
  * \ingroup IOFilters
@@ -218,9 +227,34 @@ protected:
 private:
   using ReaderType = ImageFileReader<TOutputImage>;
 
+  /** What is kept of a file of the series once it has been read: the
+   * origin of its slice, and the meta data of its ImageIO. */
+  struct FileInformation
+  {
+    bool                             isInsideRequestedRegion{ false };
+    typename TOutputImage::PointType origin{};
+    bool                             hasMetaDataDictionary{ false };
+    DictionaryType                   metaDataDictionary{};
+    std::exception_ptr               exception{};
+  };
+
   int
   ComputeMovingDimensionIndex(ReaderType * reader);
 
+  /** Read the file of the given slice into its slab of the output when it
+   * is inside the requested region, and otherwise only its information,
+   * with the given ImageIO, or one from the factory when it is null. */
+  void
+  ReadFile(int                     fileIndex,
+           const ImageRegionType & sliceRegionToRequest,
+           const SizeType &        validSize,
+           ImageIOBase *           imageIO,
+           FileInformation &       information);
+
+  /** Get the name of the file of the given slice. */
+  const std::string &
+  GetSliceFileName(int fileIndex) const;
+
   /** Modified time of the MetaDataDictionaryArray */
   TimeStamp m_MetaDataDictionaryArrayMTime{};
 
@@ -23,8 +23,10 @@
 #include "itkArray.h"
 #include "itkVector.h"
 #include "itkMath.h"
-#include "itkProgressReporter.h"
+#include "itkTotalProgressReporter.h"
 #include "itkMetaDataObject.h"
+#include <algorithm>
+#include <atomic>
 #include <cstddef> // For ptrdiff_t.
 #include <iomanip>
 
@@ -277,9 +279,6 @@ ImageSeriesReader<TOutputImage>::GenerateData()
   output->SetBufferedRegion(requestedRegion);
   output->Allocate();
 
-  // progress reported on a per slice basis
-  ProgressReporter progress(this, 0, requestedRegion.GetSize(TOutputImage::ImageDimension - 1), 100);
-
   // We utilize the modified time of the output information to
   // know when the meta array needs to be updated, when the output
   // information is updated so should the meta array.
@@ -288,138 +287,119 @@ ImageSeriesReader<TOutputImage>::GenerateData()
   bool needToUpdateMetaDataDictionaryArray =
     this->m_OutputInformationMTime > this->m_MetaDataDictionaryArrayMTime && m_MetaDataDictionaryArrayUpdate;
 
-  typename TOutputImage::InternalPixelType * outputBuffer = output->GetBufferPointer();
-  IndexType                                  sliceStartIndex = requestedRegion.GetIndex();
-  const auto                                 numberOfFiles = static_cast<int>(m_FileNames.size());
-
-  typename TOutputImage::PointType   prevSliceOrigin = output->GetOrigin();
-  typename TOutputImage::SpacingType outputSpacing = output->GetSpacing();
-  double                             maxSpacingDeviation = 0.0;
-  bool                               prevSliceIsValid = false;
+  IndexType  sliceStartIndex = requestedRegion.GetIndex();
+  const auto numberOfFiles = static_cast<int>(m_FileNames.size());
 
+  // Select the files to read, in the order of the slices.
+  std::vector<FileInformation> files(numberOfFiles);
+  std::vector<int>             filesToRead;
   for (int i = 0; i != numberOfFiles; ++i)
   {
     if (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
     {
       sliceStartIndex[this->m_NumberOfDimensionsInImage] = i;
     }
-
-    const bool insideRequestedRegion = requestedRegion.IsInside(sliceStartIndex);
-    const int  iFileName = (m_ReverseOrder ? numberOfFiles - i - 1 : i);
-    bool       nonUniformSampling = false;
-    double     spacingDeviation = 0.0;
-
-    // check if we need this slice
-    if (!insideRequestedRegion && !needToUpdateMetaDataDictionaryArray)
+    files[i].isInsideRequestedRegion = requestedRegion.IsInside(sliceStartIndex);
+    if (files[i].isInsideRequestedRegion || needToUpdateMetaDataDictionaryArray)
     {
-      continue;
+      filesToRead.push_back(i);
     }
+  }
 
-    // configure reader
-    auto reader = ReaderType::New();
-    reader->SetFileName(m_FileNames[iFileName].c_str());
-
-    TOutputImage * readerOutput = reader->GetOutput();
-
-    if (m_ImageIO)
-    {
-      reader->SetImageIO(m_ImageIO);
-    }
-    reader->SetUseStreaming(m_UseStreaming);
-    readerOutput->SetRequestedRegion(sliceRegionToRequest);
-
-    // update the data or info
-    if (!insideRequestedRegion)
+  // Read the files concurrently, each thread claiming the next file, so
+  // that at most one file per thread is in flight. The files claimed
+  // before one which fails are all read, so that its exception is the
+  // first one in the order of the slices.
+  const SizeValueType numberOfSlicesToRead = requestedRegion.GetSize(TOutputImage::ImageDimension - 1);
+  const auto          numberOfThreads =
+    std::min({ static_cast<size_t>(this->GetMultiThreader()->GetMaximumNumberOfThreads()),
+               static_cast<size_t>(this->GetNumberOfWorkUnits()),
+               filesToRead.size() });
+  std::atomic<size_t> nextFileToRead{ 0 };
+  std::atomic<bool>   failed{ false };
+  const auto          readFiles = [&](SizeValueType) {
+    // An ImageIO reads one file at a time, so each thread reads with its
+    // own instance of the class of the ImageIO which is set.
+    ImageIOBase::Pointer imageIO = m_ImageIO;
+    if (m_ImageIO && numberOfThreads > 1)
     {
-      reader->UpdateOutputInformation();
+      imageIO = dynamic_cast<ImageIOBase *>(m_ImageIO->CreateAnother().GetPointer());
+      imageIO->SetUseStreamedReading(m_ImageIO->GetUseStreamedReading());
+      imageIO->SetExpandRGBPalette(m_ImageIO->GetExpandRGBPalette());
+      imageIO->SetMetaDataDictionary(m_ImageIO->GetMetaDataDictionary());
     }
-    else
+    TotalProgressReporter progress(this, numberOfSlicesToRead);
+    while (!failed.load(std::memory_order_relaxed))
     {
-      // read the meta data information
-      readerOutput->UpdateOutputInformation();
-
-      // propagate the requested region to determine what the region
-      // will actually be read
-      readerOutput->PropagateRequestedRegion();
-
-      // check that the size of each slice is the same
-      if (readerOutput->GetLargestPossibleRegion().GetSize() != validSize)
+      const size_t k = nextFileToRead++;
+      if (k >= filesToRead.size())
       {
-        itkExceptionMacro("Size mismatch! The size of  "
-                          << m_FileNames[iFileName].c_str() << " is "
-                          << readerOutput->GetLargestPossibleRegion().GetSize()
-                          << " and does not match the required size " << validSize << " from file "
-                          << m_FileNames[m_ReverseOrder ? numberOfFiles - 1 : 0].c_str());
+        return;
       }
-
-      // get the size of the region to be read
-      const SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
-
-      if (readSize == sliceRegionToRequest.GetSize())
+      FileInformation & file = files[filesToRead[k]];
+      try
       {
-        // if the buffer of the ImageReader is going to match that of
-        // ourselves, then set the ImageReader's buffer to a section
-        // of ours
-
-        const size_t numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
-
-        using AccessorFunctorType = typename TOutputImage::AccessorFunctorType;
-        const size_t numberOfInternalComponentsPerPixel = AccessorFunctorType::GetVectorLength(output);
-
-
-        const ptrdiff_t sliceOffset = (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
-                                        ? (i - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage))
-                                        : 0;
-
-        const ptrdiff_t numberOfPixelComponentsUpToSlice =
-          numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
-        const bool bufferDelete = false;
-
-        typename TOutputImage::InternalPixelType * outputSliceBuffer = outputBuffer + numberOfPixelComponentsUpToSlice;
-
-        if (strcmp(output->GetNameOfClass(), "VectorImage") == 0)
-        {
-          // if the input image type is a vector image then the number
-          // of components needs to be set for the size
-          readerOutput->GetPixelContainer()->SetImportPointer(
-            outputSliceBuffer,
-            static_cast<unsigned long>(numberOfPixelsInSlice * numberOfInternalComponentsPerPixel),
-            bufferDelete);
-        }
-        else
-        {
-          // otherwise the actual number of pixels needs to be passed
-          readerOutput->GetPixelContainer()->SetImportPointer(
-            outputSliceBuffer, static_cast<unsigned long>(numberOfPixelsInSlice), bufferDelete);
-        }
-        readerOutput->UpdateOutputData();
+        progress.CheckAbortGenerateData();
+        this->ReadFile(filesToRead[k], sliceRegionToRequest, validSize, imageIO, file);
       }
-      else
+      catch (...)
+      {
+        file.exception = std::current_exception();
+        failed = true;
+        return;
+      }
+      if (file.isInsideRequestedRegion)
       {
-        // the read region isn't going to match exactly what we need
-        // to update to buffer created by the reader, then copy
+        progress.CompletedPixel();
+      }
+    }
+  };
+  if (numberOfThreads > 1)
+  {
+    this->GetMultiThreader()->ParallelizeArray(0, numberOfThreads, readFiles, nullptr);
 
-        reader->Update();
+    // As when it reads all the files, the ImageIO which is set has the
+    // information of the last file read.
+    if (m_ImageIO && !failed)
+    {
+      m_ImageIO->SetFileName(this->GetSliceFileName(filesToRead.back()));
+      m_ImageIO->ReadImageInformation();
+    }
+  }
+  else
+  {
+    readFiles(0);
+  }
 
-        // output of buffer copy
-        ImageRegionType outRegion = requestedRegion;
-        outRegion.SetIndex(sliceStartIndex);
+  typename TOutputImage::PointType   prevSliceOrigin = output->GetOrigin();
+  typename TOutputImage::SpacingType outputSpacing = output->GetSpacing();
+  double                             maxSpacingDeviation = 0.0;
+  bool                               prevSliceIsValid = false;
 
-        // set the moving dimension to a size of 1
-        if (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
-        {
-          outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
-        }
+  for (int i = 0; i != numberOfFiles; ++i)
+  {
+    FileInformation & file = files[i];
+    bool              nonUniformSampling = false;
+    double            spacingDeviation = 0.0;
 
-        ImageAlgorithm::Copy(readerOutput, output, sliceRegionToRequest, outRegion);
-      }
+    // check if we need this slice
+    if (!file.isInsideRequestedRegion && !needToUpdateMetaDataDictionaryArray)
+    {
+      continue;
+    }
+    if (file.exception)
+    {
+      std::rethrow_exception(file.exception);
+    }
 
+    if (file.isInsideRequestedRegion)
+    {
       // verify that slice spacing is the expected one
       // since we can be skipping some slices because they are outside of requested region
       // I am using additional variable
       if (prevSliceIsValid)
       {
-        typename TOutputImage::PointType sliceOrigin = readerOutput->GetOrigin();
+        const typename TOutputImage::PointType & sliceOrigin = file.origin;
         using SpacingScalarType = typename TOutputImage::SpacingValueType;
         Vector<SpacingScalarType, TOutputImage::ImageDimension> dirN;
         for (size_t j = 0; j < TOutputImage::ImageDimension; ++j)
@@ -446,19 +426,16 @@ ImageSeriesReader<TOutputImage>::GenerateData()
       }
       else
       {
-        prevSliceOrigin = readerOutput->GetOrigin();
+        prevSliceOrigin = file.origin;
         prevSliceIsValid = true;
       }
-
-      // report progress for read slices
-      progress.CompletedPixel();
     } // end !insideRequestedRegion
 
     // Deep copy the MetaDataDictionary into the array
-    if (reader->GetImageIO() && needToUpdateMetaDataDictionaryArray)
+    if (file.hasMetaDataDictionary && needToUpdateMetaDataDictionaryArray)
     {
       auto newDictionary = new DictionaryType;
-      *newDictionary = reader->GetImageIO()->GetMetaDataDictionary();
+      *newDictionary = file.metaDataDictionary;
       if (nonUniformSampling)
       {
         // slice-specific information
@@ -489,6 +466,135 @@ ImageSeriesReader<TOutputImage>::GenerateData()
   }
 }
 
+template <typename TOutputImage>
+void
+ImageSeriesReader<TOutputImage>::ReadFile(int                     fileIndex,
+                                          const ImageRegionType & sliceRegionToRequest,
+                                          const SizeType &        validSize,
+                                          ImageIOBase *           imageIO,
+                                          FileInformation &       information)
+{
+  TOutputImage *        output = this->GetOutput();
+  const ImageRegionType requestedRegion = output->GetRequestedRegion();
+  const std::string &   fileName = this->GetSliceFileName(fileIndex);
+
+  // configure reader
+  auto reader = ReaderType::New();
+  reader->SetFileName(fileName);
+
+  TOutputImage * readerOutput = reader->GetOutput();
+
+  if (imageIO)
+  {
+    reader->SetImageIO(imageIO);
+  }
+  reader->SetUseStreaming(m_UseStreaming);
+  readerOutput->SetRequestedRegion(sliceRegionToRequest);
+
+  // update the data or info
+  if (!information.isInsideRequestedRegion)
+  {
+    reader->UpdateOutputInformation();
+  }
+  else
+  {
+    // read the meta data information
+    readerOutput->UpdateOutputInformation();
+
+    // propagate the requested region to determine what the region
+    // will actually be read
+    readerOutput->PropagateRequestedRegion();
+
+    // check that the size of each slice is the same
+    if (readerOutput->GetLargestPossibleRegion().GetSize() != validSize)
+    {
+      itkExceptionMacro("Size mismatch! The size of  "
+                        << fileName << " is " << readerOutput->GetLargestPossibleRegion().GetSize()
+                        << " and does not match the required size " << validSize << " from file "
+                        << this->GetSliceFileName(0));
+    }
+
+    // get the size of the region to be read
+    const SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
+
+    if (readSize == sliceRegionToRequest.GetSize())
+    {
+      // if the buffer of the ImageReader is going to match that of
+      // ourselves, then set the ImageReader's buffer to a section
+      // of ours
+
+      const size_t numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
+
+      using AccessorFunctorType = typename TOutputImage::AccessorFunctorType;
+      const size_t numberOfInternalComponentsPerPixel = AccessorFunctorType::GetVectorLength(output);
+
+
+      const ptrdiff_t sliceOffset = (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
+                                      ? (fileIndex - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage))
+                                      : 0;
+
+      const ptrdiff_t numberOfPixelComponentsUpToSlice =
+        numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
+      const bool bufferDelete = false;
+
+      typename TOutputImage::InternalPixelType * outputSliceBuffer =
+        output->GetBufferPointer() + numberOfPixelComponentsUpToSlice;
+
+      if (strcmp(output->GetNameOfClass(), "VectorImage") == 0)
+      {
+        // if the input image type is a vector image then the number
+        // of components needs to be set for the size
+        readerOutput->GetPixelContainer()->SetImportPointer(
+          outputSliceBuffer,
+          static_cast<unsigned long>(numberOfPixelsInSlice * numberOfInternalComponentsPerPixel),
+          bufferDelete);
+      }
+      else
+      {
+        // otherwise the actual number of pixels needs to be passed
+        readerOutput->GetPixelContainer()->SetImportPointer(
+          outputSliceBuffer, static_cast<unsigned long>(numberOfPixelsInSlice), bufferDelete);
+      }
+      readerOutput->UpdateOutputData();
+    }
+    else
+    {
+      // the read region isn't going to match exactly what we need
+      // to update to buffer created by the reader, then copy
+
+      reader->Update();
+
+      // output of buffer copy
+      ImageRegionType outRegion = requestedRegion;
+
+      // set the moving dimension to a size of 1
+      if (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
+      {
+        outRegion.SetIndex(this->m_NumberOfDimensionsInImage, fileIndex);
+        outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
+      }
+
+      ImageAlgorithm::Copy(readerOutput, output, sliceRegionToRequest, outRegion);
+    }
+    information.origin = readerOutput->GetOrigin();
+  }
+
+  // Keep the MetaDataDictionary, which is shared until modified.
+  if (reader->GetImageIO())
+  {
+    information.metaDataDictionary = reader->GetImageIO()->GetMetaDataDictionary();
+    information.hasMetaDataDictionary = true;
+  }
+}
+
+template <typename TOutputImage>
+const std::string &
+ImageSeriesReader<TOutputImage>::GetSliceFileName(int fileIndex) const
+{
+  const auto numberOfFiles = static_cast<int>(m_FileNames.size());
+  return m_FileNames[m_ReverseOrder ? numberOfFiles - fileIndex - 1 : fileIndex];
+}
+
 template <typename TOutputImage>
 auto
 ImageSeriesReader<TOutputImage>::GetMetaDataDictionaryArray() const -> DictionaryArrayRawPointer
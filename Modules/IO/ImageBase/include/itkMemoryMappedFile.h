@@ -0,0 +1,101 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedFile_h
+#define itkMemoryMappedFile_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+
+#include <string>
+
+namespace itk
+{
+/** \class MemoryMappedFile
+ * \brief Maps a range of the bytes of a file into memory.
+ *
+ * The mapping is copy-on-write: the mapped bytes can be read and written
+ * like any other memory, the pages are read from the file when first
+ * accessed, and writes go to private copies of the pages, so that the file is
+ * never modified. The mapping lasts until Unmap() is called, another range is
+ * mapped, or the object is destroyed.
+ *
+ * \sa ImageFileReader::SetUseMemoryMapping
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT MemoryMappedFile : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryMappedFile);
+
+  /** Standard class type aliases. */
+  using Self = MemoryMappedFile;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(MemoryMappedFile);
+
+  /** Map the given number of bytes of the file, from the given offset, which
+   * need not be aligned on a page. Throws an exception when the file cannot
+   * be opened or mapped, or is shorter than offset + size, or when size is
+   * zero. */
+  void
+  Map(const std::string & fileName, SizeValueType offset, SizeValueType size);
+
+  /** Release the mapping, if any. */
+  void
+  Unmap();
+
+  /** The first mapped byte, or nullptr when nothing is mapped. */
+  void *
+  GetData() const
+  {
+    return m_Data;
+  }
+
+  /** The number of mapped bytes. */
+  itkGetConstMacro(Size, SizeValueType);
+
+  /** The mapped file. */
+  itkGetConstReferenceMacro(FileName, std::string);
+
+protected:
+  MemoryMappedFile() = default;
+  ~MemoryMappedFile() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  std::string   m_FileName{};
+  void *        m_Data{ nullptr };
+  SizeValueType m_Size{ 0 };
+
+  /** The page aligned start and length of the mapping. */
+  void *        m_MappingAddress{ nullptr };
+  SizeValueType m_MappingLength{ 0 };
+};
+} // end namespace itk
+
+#endif
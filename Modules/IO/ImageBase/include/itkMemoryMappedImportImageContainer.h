@@ -0,0 +1,93 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedImportImageContainer_h
+#define itkMemoryMappedImportImageContainer_h
+
+#include "itkImportImageContainer.h"
+#include "itkMemoryMappedFile.h"
+
+namespace itk
+{
+/** \class MemoryMappedImportImageContainer
+ * \brief An ImportImageContainer whose elements are the bytes of a
+ * MemoryMappedFile.
+ *
+ * The container keeps the mapping alive for as long as it imports it. As the
+ * mapping is copy-on-write, the elements can be modified without modifying
+ * the file. Reserving more elements than are mapped replaces the mapping by
+ * an allocated buffer, into which the mapped elements are copied.
+ *
+ * \tparam TElementIdentifier An INTEGRAL type for use in indexing the
+ * imported buffer.
+ *
+ * \tparam TElement The element type stored in the container.
+ *
+ * \sa ImageFileReader::SetUseMemoryMapping
+ * \ingroup ITKIOImageBase
+ */
+template <typename TElementIdentifier, typename TElement>
+class ITK_TEMPLATE_EXPORT MemoryMappedImportImageContainer : public ImportImageContainer<TElementIdentifier, TElement>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryMappedImportImageContainer);
+
+  /** Standard class type aliases. */
+  using Self = MemoryMappedImportImageContainer;
+  using Superclass = ImportImageContainer<TElementIdentifier, TElement>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  using typename Superclass::ElementIdentifier;
+  using typename Superclass::Element;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(MemoryMappedImportImageContainer);
+
+  /** Import the elements of the mapped file. The number of elements is the
+   * size of the mapping divided by the size of an element. The first mapped
+   * byte must be aligned for TElement. */
+  void
+  SetMemoryMappedFile(MemoryMappedFile * mappedFile)
+  {
+    m_MemoryMappedFile = mappedFile;
+    this->SetImportPointer(static_cast<Element *>(mappedFile->GetData()),
+                           static_cast<ElementIdentifier>(mappedFile->GetSize() / sizeof(Element)),
+                           false);
+  }
+  itkGetModifiableObjectMacro(MemoryMappedFile, MemoryMappedFile);
+
+protected:
+  MemoryMappedImportImageContainer() = default;
+  ~MemoryMappedImportImageContainer() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override
+  {
+    Superclass::PrintSelf(os, indent);
+    itkPrintSelfObjectMacro(MemoryMappedFile);
+  }
+
+private:
+  MemoryMappedFile::Pointer m_MemoryMappedFile{};
+};
+} // end namespace itk
+
+#endif
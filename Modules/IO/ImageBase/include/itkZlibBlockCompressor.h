@@ -0,0 +1,202 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkZlibBlockCompressor_h
+#define itkZlibBlockCompressor_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+#include "itkThreadSupport.h"
+
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class ZlibBlockCompressor
+ * \brief Compresses data into a standard zlib or gzip stream on multiple
+ * threads, and decompresses such streams on multiple threads.
+ *
+ * As pigz does, the data is split into blocks which are deflated
+ * concurrently. Each block is deflated independently of the others and all
+ * but the last end with a sync flush, so that concatenating the deflated
+ * blocks gives a single deflate stream. The header and the checksum of the
+ * zlib (RFC 1950) or gzip (RFC 1952) format are added around it, the checksum
+ * being combined from the checksums of the blocks. The stream can therefore
+ * be decompressed by any zlib or gzip reader.
+ *
+ * The block index, that is the uncompressed block size and the compressed
+ * size of each block, allows the blocks to be inflated concurrently as well.
+ * The writers that use this class record it in the header of the file, under
+ * BlockIndexKey, and pass it back to SetBlockIndex() to read the file. A
+ * stream without a block index is decompressed on a single thread.
+ *
+ * As the blocks are independent, the block index also gives random access
+ * to the data: DecompressRanges() inflates only the blocks which overlap the
+ * requested bytes. Conversely, the data can be compressed in consecutive
+ * pieces, so that a streamed writer never holds more than one piece of the
+ * uncompressed data.
+ *
+ * \sa MetaImageIO, NrrdImageIO
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT ZlibBlockCompressor : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ZlibBlockCompressor);
+
+  /** Standard class type aliases. */
+  using Self = ZlibBlockCompressor;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(ZlibBlockCompressor);
+
+  /** The name of the header field in which the image IOs record the block
+   * index of the compressed data. */
+  static constexpr const char * BlockIndexKey = "CompressedDataBlocks";
+
+  /** The number of uncompressed bytes in each block but the last one.
+   * Smaller blocks allow more parallelism but compress slightly worse. The
+   * default is 1 MiB. */
+  itkSetClampMacro(BlockSize, SizeValueType, 1, SizeValueType{ 1 } << 30);
+  itkGetConstMacro(BlockSize, SizeValueType);
+
+  /** The zlib compression level, from 0 (no compression) to 9 (best
+   * compression), or -1 for the default level of zlib. */
+  itkSetClampMacro(CompressionLevel, int, -1, 9);
+  itkGetConstMacro(CompressionLevel, int);
+
+  /** Whether to write gzip rather than zlib streams. Decompression accepts
+   * both. */
+  itkSetMacro(UseGzipFormat, bool);
+  itkGetConstMacro(UseGzipFormat, bool);
+  itkBooleanMacro(UseGzipFormat);
+
+  /** The number of work units over which the blocks are distributed. The
+   * default is the global default number of threads. */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+
+  /** A range of bytes of the uncompressed data, and the buffer into which
+   * DecompressRanges() decompresses it. */
+  struct DataRange
+  {
+    SizeValueType Offset;
+    SizeValueType Size;
+    void *        Buffer;
+  };
+
+  /** Compress the given number of bytes into a stream, and update the block
+   * index to describe it. Throws an exception when zlib fails. */
+  void
+  Compress(const void * data, SizeValueType size, std::vector<unsigned char> & stream);
+
+  /** Compress data given in consecutive pieces of any size. StartCompression()
+   * appends the header of the stream to the given one, each CompressPiece()
+   * the blocks which the pieces given so far complete, and
+   * FinishCompression() the last block and the trailer, after which the block
+   * index describes the stream. The stream can be written out and cleared
+   * between the calls. Throws an exception when zlib fails. */
+  void
+  StartCompression(std::vector<unsigned char> & stream);
+  void
+  CompressPiece(const void * data, SizeValueType size, std::vector<unsigned char> & stream);
+  void
+  FinishCompression(std::vector<unsigned char> & stream);
+
+  /** The number of bytes given to CompressPiece() since StartCompression(). */
+  itkGetConstMacro(UncompressedSize, SizeValueType);
+
+  /** Decompress a stream into exactly the given number of bytes. When a
+   * block index is set and matches the stream, the blocks are inflated
+   * concurrently, otherwise the stream is inflated on a single thread.
+   * Returns false when the stream is not valid, for instance when its
+   * checksum does not match, or does not decompress to the given size. */
+  bool
+  Decompress(const void * stream, SizeValueType streamSize, void * data, SizeValueType size) const;
+
+  /** Decompress only the given ranges of data of the given size. The stream,
+   * described by the block index, starts at the current position of the
+   * input stream, from which only the blocks overlapping the ranges are read.
+   * These blocks are inflated concurrently. The ranges must be sorted by
+   * offset, and must not overlap. As the data is not decompressed as a whole,
+   * the checksum of the stream is not verified. Returns false when no block
+   * index matching the stream is set, or when a block cannot be read or
+   * inflated. */
+  bool
+  DecompressRanges(std::istream & stream, SizeValueType size, const std::vector<DataRange> & ranges) const;
+
+  /** The block index, as the block size followed by the compressed size of
+   * each block, separated by spaces, or an empty string when no block index
+   * is set. */
+  std::string
+  GetBlockIndex() const;
+
+  /** Set the block index to decompress a stream with, as written by
+   * GetBlockIndex(). The block size is set from the index. An empty string
+   * clears the block index. Returns false, and clears the block index, when
+   * the given one cannot be parsed. */
+  bool
+  SetBlockIndex(const std::string & blockIndex);
+
+protected:
+  ZlibBlockCompressor();
+  ~ZlibBlockCompressor() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Inflate the blocks of a stream described by the block index. */
+  bool
+  DecompressBlocks(const unsigned char * stream, SizeValueType streamSize, void * data, SizeValueType size) const;
+
+  /** Deflate blocks of the given data concurrently, and append them to the
+   * stream. */
+  void
+  DeflateBlocks(const std::vector<const unsigned char *> & blocks,
+                SizeValueType                              blockSize,
+                bool                                       last,
+                std::vector<unsigned char> &               stream);
+
+  SizeValueType m_BlockSize{ SizeValueType{ 1 } << 20 };
+  int           m_CompressionLevel{ -1 };
+  bool          m_UseGzipFormat{ false };
+  ThreadIdType  m_NumberOfWorkUnits{ 1 };
+
+  /** The compressed size of each block, excluding the header and the
+   * trailer of the stream. */
+  std::vector<SizeValueType> m_CompressedBlockSizes{};
+
+  /** The state of the compression in pieces: the bytes given so far, the
+   * checksum of their blocks, and the start of a block to complete. */
+  SizeValueType              m_UncompressedSize{ 0 };
+  unsigned long              m_Checksum{ 0 };
+  std::vector<unsigned char> m_PendingBlock{};
+};
+} // end namespace itk
+
+#endif
@@ -13,10 +13,15 @@ itk_module(
   ENABLE_SHARED
   DEPENDS
   ITKCommon
+  PRIVATE_DEPENDS
+  ITKZLIB
   TEST_DEPENDS
   ITKTestKernel
   ITKIOGDCM
   ITKIOMeta
+  ITKIONIFTI
+  ITKIONRRD
+  ITKIORAW
   ITKImageIntensity
   DESCRIPTION
   "${DOCUMENTATION}")
@@ -18,6 +18,8 @@
 
 #include "itkImageIOBase.h"
 #include "itkImageRegionSplitterSlowDimension.h"
+#include <algorithm>
+#include <cmath>
 #include <mutex>
 #include "itksys/SystemTools.hxx"
 #include "itkPrintHelper.h"
@@ -312,6 +314,98 @@ ImageIOBase::ReadBufferAsBinary(std::istream & is, void * buffer, ImageIOBase::S
   return true;
 }
 
+bool
+ImageIOBase::WriteIORegionAsBinary(std::ostream & os, const void * buffer, SizeValueType dataOffset)
+{
+  const auto * bytes = static_cast<const char *>(buffer);
+  return this->VisitIORegionRuns([&os, &bytes, dataOffset](SizeValueType position, SizeValueType sizeOfRun) {
+    os.seekp(static_cast<std::streamoff>(dataOffset + position), std::ios::beg);
+    os.write(bytes, Math::CastWithRangeCheck<std::streamsize>(sizeOfRun));
+    bytes += sizeOfRun;
+    return !os.fail();
+  });
+}
+
+bool
+ImageIOBase::VisitIORegionRuns(const std::function<bool(SizeValueType, SizeValueType)> & visitor) const
+{
+  // the dimensions of the region beyond those of the image are a single index
+  const unsigned int numberOfDimensions = std::min(m_IORegion.GetImageDimension(), this->GetNumberOfDimensions());
+  const auto         pixelSize = static_cast<SizeValueType>(this->GetPixelSize());
+
+  // compute the number of bytes which are contiguous in the data
+  SizeValueType sizeOfRun = pixelSize;
+  unsigned int  movingDirection = 0;
+  while (movingDirection < numberOfDimensions)
+  {
+    sizeOfRun *= m_IORegion.GetSize(movingDirection);
+    ++movingDirection;
+    if (m_IORegion.GetSize(movingDirection - 1) != this->GetDimensions(movingDirection - 1))
+    {
+      break;
+    }
+  }
+
+  if (m_IORegion.GetNumberOfPixels() == 0)
+  {
+    return true;
+  }
+
+  ImageIORegion::IndexType currentIndex = m_IORegion.GetIndex();
+  while (true)
+  {
+    SizeValueType position = 0;
+    SizeValueType stride = pixelSize;
+    for (unsigned int i = 0; i < numberOfDimensions; ++i)
+    {
+      position += static_cast<SizeValueType>(currentIndex[i]) * stride;
+      stride *= this->GetDimensions(i);
+    }
+
+    if (!visitor(position, sizeOfRun))
+    {
+      return false;
+    }
+
+    // increment the index to the next run, carrying to higher dimensions
+    unsigned int i = movingDirection;
+    for (; i < numberOfDimensions; ++i)
+    {
+      ++currentIndex[i];
+      if (static_cast<SizeValueType>(currentIndex[i] - m_IORegion.GetIndex(i)) < m_IORegion.GetSize(i))
+      {
+        break;
+      }
+      currentIndex[i] = m_IORegion.GetIndex(i);
+    }
+    if (i >= numberOfDimensions)
+    {
+      return true;
+    }
+  }
+}
+
+bool
+ImageIOBase::GetIORegionDataRange(SizeValueType & offset, SizeValueType & size) const
+{
+  // The region is a range of the data when it spans the whole image in the
+  // dimensions before the first one which it does not span, and is a single
+  // index in the dimensions after it.
+  SizeValueType stride = this->GetPixelSize();
+  bool          isRange = true;
+  bool          isPartial = false;
+  offset = 0;
+  for (unsigned int i = 0; i < m_IORegion.GetImageDimension(); ++i)
+  {
+    offset += static_cast<SizeValueType>(m_IORegion.GetIndex(i)) * stride;
+    stride *= this->GetDimensions(i);
+    isRange &= !isPartial || m_IORegion.GetSize(i) == 1;
+    isPartial |= m_IORegion.GetSize(i) != this->GetDimensions(i);
+  }
+  size = static_cast<SizeValueType>(m_IORegion.GetNumberOfPixels()) * this->GetPixelSize();
+  return isRange;
+}
+
 unsigned int
 ImageIOBase::GetPixelSize() const
 {
@@ -1042,6 +1136,53 @@ ImageIOBase::GetActualNumberOfSplitsForWriting(unsigned int          numberOfReq
   return 1;
 }
 
+void
+ImageIOBase::VerifyPasteCompatibility(const ImageIOBase * fileImageIO, double tolerance) const
+{
+  const auto differ = [tolerance](double a, double b) {
+    return Math::NotExactlyEquals(a, b) &&
+           std::abs(a - b) > tolerance * std::max({ 1.0, std::abs(a), std::abs(b) });
+  };
+  std::string errorMessage;
+  if (fileImageIO->GetNumberOfComponents() != this->GetNumberOfComponents() ||
+      fileImageIO->GetComponentType() != this->GetComponentType())
+  {
+    errorMessage = "Component type does not match in file: " + m_FileName;
+  }
+  else if (fileImageIO->GetNumberOfDimensions() != this->GetNumberOfDimensions())
+  {
+    errorMessage = "Dimensions does not match in file: " + m_FileName;
+  }
+  else
+  {
+    for (unsigned int i = 0; i < this->GetNumberOfDimensions(); ++i)
+    {
+      if (fileImageIO->GetDimensions(i) != this->GetDimensions(i) ||
+          differ(fileImageIO->GetSpacing(i), this->GetSpacing(i)) ||
+          differ(fileImageIO->GetOrigin(i), this->GetOrigin(i)))
+      {
+        errorMessage = "Size, spacing or origin does not match in file: " + m_FileName;
+        break;
+      }
+      const std::vector<double> fileDirection = fileImageIO->GetDirection(i);
+      const std::vector<double> direction = this->GetDirection(i);
+      if (fileDirection.size() != direction.size() ||
+          !std::equal(direction.begin(), direction.end(), fileDirection.begin(), [&differ](double a, double b) {
+            return !differ(a, b);
+          }))
+      {
+        errorMessage = "Direction cosines does not match in file: " + m_FileName;
+        break;
+      }
+    }
+  }
+
+  if (!errorMessage.empty())
+  {
+    itkExceptionMacro("Unable to paste because pasting file exists and is different. " << errorMessage);
+  }
+}
+
 ImageIORegion
 ImageIOBase::GetSplitRegionForWritingCanStreamWrite(unsigned int          ithPiece,
                                                     unsigned int          numberOfActualSplits,
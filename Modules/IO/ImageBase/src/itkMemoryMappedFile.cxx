@@ -0,0 +1,161 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMemoryMappedFile.h"
+#include "itksys/SystemTools.hxx"
+
+#if defined(_WIN32)
+#  include "itkWindows.h"
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+MemoryMappedFile::~MemoryMappedFile() { this->Unmap(); }
+
+void
+MemoryMappedFile::Map(const std::string & fileName, SizeValueType offset, SizeValueType size)
+{
+  this->Unmap();
+  if (size == 0)
+  {
+    itkExceptionMacro("Cannot map zero bytes of " << fileName);
+  }
+
+#if defined(_WIN32)
+  const HANDLE file = CreateFileW(itksys::SystemTools::ConvertToWindowsExtendedPath(fileName.c_str()).c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ,
+                                  nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL,
+                                  nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    itkExceptionMacro("Could not open file: " << fileName << " for mapping." << std::endl
+                                              << "Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || static_cast<SizeValueType>(fileSize.QuadPart) < offset + size)
+  {
+    CloseHandle(file);
+    itkExceptionMacro("File: " << fileName << " is shorter than the " << size << " bytes to map at offset "
+                               << offset);
+  }
+  const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr)
+  {
+    itkExceptionMacro("Could not map file: " << fileName << std::endl
+                                             << "Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+
+  // Views start on a multiple of the allocation granularity.
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  const SizeValueType alignedOffset = offset - offset % systemInfo.dwAllocationGranularity;
+  const SizeValueType length = offset - alignedOffset + size;
+  void * const        address = MapViewOfFile(mapping,
+                                       FILE_MAP_COPY,
+                                       static_cast<DWORD>(static_cast<unsigned long long>(alignedOffset) >> 32),
+                                       static_cast<DWORD>(alignedOffset & 0xFFFFFFFF),
+                                       static_cast<SIZE_T>(length));
+  // The view keeps the mapping alive.
+  CloseHandle(mapping);
+  if (address == nullptr)
+  {
+    itkExceptionMacro("Could not map file: " << fileName << std::endl
+                                             << "Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+#else
+  const int file = open(fileName.c_str(), O_RDONLY);
+  if (file == -1)
+  {
+    itkExceptionMacro("Could not open file: " << fileName << " for mapping." << std::endl
+                                              << "Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+  struct stat fileStatus;
+  if (fstat(file, &fileStatus) != 0 || static_cast<SizeValueType>(fileStatus.st_size) < offset + size)
+  {
+    close(file);
+    itkExceptionMacro("File: " << fileName << " is shorter than the " << size << " bytes to map at offset "
+                               << offset);
+  }
+
+  // Mappings start on a page.
+  const auto          pageSize = static_cast<SizeValueType>(sysconf(_SC_PAGESIZE));
+  const SizeValueType alignedOffset = offset - offset % pageSize;
+  const SizeValueType length = offset - alignedOffset + size;
+  int                 flags = MAP_PRIVATE;
+#  ifdef MAP_NORESERVE
+  // The private copies of the pages are only made on write, so do not reserve
+  // swap space for all of them.
+  flags |= MAP_NORESERVE;
+#  endif
+  void * address = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, file, static_cast<off_t>(alignedOffset));
+  // The mapping keeps the file open.
+  close(file);
+  if (address == MAP_FAILED)
+  {
+    itkExceptionMacro("Could not map file: " << fileName << std::endl
+                                             << "Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+#endif
+
+  m_FileName = fileName;
+  m_MappingAddress = address;
+  m_MappingLength = length;
+  m_Data = static_cast<char *>(address) + (offset - alignedOffset);
+  m_Size = size;
+  this->Modified();
+}
+
+void
+MemoryMappedFile::Unmap()
+{
+  if (m_MappingAddress == nullptr)
+  {
+    return;
+  }
+#if defined(_WIN32)
+  UnmapViewOfFile(m_MappingAddress);
+#else
+  munmap(m_MappingAddress, m_MappingLength);
+#endif
+  m_MappingAddress = nullptr;
+  m_MappingLength = 0;
+  m_Data = nullptr;
+  m_Size = 0;
+  this->Modified();
+}
+
+void
+MemoryMappedFile::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "Data: " << m_Data << std::endl;
+  os << indent << "Size: " << m_Size << std::endl;
+  os << indent << "MappingAddress: " << m_MappingAddress << std::endl;
+  os << indent << "MappingLength: " << m_MappingLength << std::endl;
+}
+} // end namespace itk
@@ -0,0 +1,620 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkZlibBlockCompressor.h"
+#include "itkMultiThreaderBase.h"
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace itk
+{
+namespace
+{
+constexpr SizeValueType ZlibHeaderSize = 2;
+constexpr SizeValueType ZlibTrailerSize = 4;
+constexpr SizeValueType GzipHeaderSize = 10;
+constexpr SizeValueType GzipTrailerSize = 8;
+// zlib takes the size of a block as a uInt.
+constexpr SizeValueType MaximumCompressedBlockSize = std::numeric_limits<uInt>::max();
+
+SizeValueType
+NumberOfBlocks(SizeValueType size, SizeValueType blockSize)
+{
+  // Even no data is deflated into one block, which ends the stream.
+  return std::max(SizeValueType{ 1 }, (size + blockSize - 1) / blockSize);
+}
+
+unsigned long
+Checksum(bool gzip, const unsigned char * data, SizeValueType size)
+{
+  return gzip ? crc32(crc32(0, Z_NULL, 0), data, static_cast<uInt>(size))
+              : adler32(adler32(0, Z_NULL, 0), data, static_cast<uInt>(size));
+}
+
+unsigned long
+CombineChecksums(bool gzip, unsigned long first, unsigned long second, SizeValueType secondSize)
+{
+  return gzip ? crc32_combine(first, second, static_cast<z_off_t>(secondSize))
+              : adler32_combine(first, second, static_cast<z_off_t>(secondSize));
+}
+
+void
+AppendBigEndian32(std::vector<unsigned char> & stream, unsigned long value)
+{
+  for (int shift = 24; shift >= 0; shift -= 8)
+  {
+    stream.push_back(static_cast<unsigned char>((value >> shift) & 0xFF));
+  }
+}
+
+void
+AppendLittleEndian32(std::vector<unsigned char> & stream, unsigned long value)
+{
+  for (int shift = 0; shift <= 24; shift += 8)
+  {
+    stream.push_back(static_cast<unsigned char>((value >> shift) & 0xFF));
+  }
+}
+
+unsigned long
+ReadBigEndian32(const unsigned char * bytes)
+{
+  return (static_cast<unsigned long>(bytes[0]) << 24) | (static_cast<unsigned long>(bytes[1]) << 16) |
+         (static_cast<unsigned long>(bytes[2]) << 8) | static_cast<unsigned long>(bytes[3]);
+}
+
+unsigned long
+ReadLittleEndian32(const unsigned char * bytes)
+{
+  return (static_cast<unsigned long>(bytes[3]) << 24) | (static_cast<unsigned long>(bytes[2]) << 16) |
+         (static_cast<unsigned long>(bytes[1]) << 8) | static_cast<unsigned long>(bytes[0]);
+}
+
+/** Check the header of a stream, which is expected to be one written by
+ * ZlibBlockCompressor::StartCompression(), and find its format and size. */
+bool
+ParseHeader(const unsigned char * stream, SizeValueType streamSize, bool & gzip, SizeValueType & headerSize)
+{
+  gzip = streamSize >= 2 && stream[0] == 0x1f && stream[1] == 0x8b;
+  headerSize = gzip ? GzipHeaderSize : ZlibHeaderSize;
+  if (streamSize < headerSize)
+  {
+    return false;
+  }
+  return gzip ? stream[2] == Z_DEFLATED && stream[3] == 0
+              : (stream[0] & 0x0F) == Z_DEFLATED && (stream[1] & 0x20) == 0 && (stream[0] * 256 + stream[1]) % 31 == 0;
+}
+
+/** Deflate one block into a raw deflate stream, which ends the whole stream
+ * for the last block, and ends on a byte boundary otherwise. */
+bool
+DeflateBlock(const unsigned char * data, SizeValueType size, int level, bool last, std::vector<unsigned char> & block)
+{
+  z_stream z{};
+  if (deflateInit2(&z, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+  {
+    return false;
+  }
+  // Leave room for the empty stored block of the sync flush.
+  block.resize(deflateBound(&z, static_cast<uLong>(size)) + 16);
+  z.next_in = const_cast<unsigned char *>(data);
+  z.avail_in = static_cast<uInt>(size);
+  z.next_out = block.data();
+  z.avail_out = static_cast<uInt>(block.size());
+
+  const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+  bool      succeeded = true;
+  for (;;)
+  {
+    const int result = deflate(&z, flush);
+    if (result == Z_STREAM_ERROR)
+    {
+      succeeded = false;
+      break;
+    }
+    if (last ? result == Z_STREAM_END : z.avail_in == 0 && z.avail_out != 0)
+    {
+      break;
+    }
+    // Out of room, which the bound should prevent.
+    const SizeValueType used = block.size() - z.avail_out;
+    block.resize(2 * block.size());
+    z.next_out = block.data() + used;
+    z.avail_out = static_cast<uInt>(block.size() - used);
+  }
+  block.resize(block.size() - z.avail_out);
+  deflateEnd(&z);
+  return succeeded;
+}
+
+/** Inflate one raw deflate block into exactly the given number of bytes. */
+bool
+InflateBlock(const unsigned char * block, SizeValueType blockSize, unsigned char * data, SizeValueType size, bool last)
+{
+  z_stream z{};
+  if (inflateInit2(&z, -MAX_WBITS) != Z_OK)
+  {
+    return false;
+  }
+  z.next_in = const_cast<unsigned char *>(block);
+  z.avail_in = static_cast<uInt>(blockSize);
+  z.next_out = data;
+  z.avail_out = static_cast<uInt>(size);
+  int result = inflate(&z, Z_NO_FLUSH);
+  if (result == Z_OK && z.avail_out == 0 && z.avail_in != 0)
+  {
+    // The output is full, but the end of the block, which produces no
+    // output, may remain to be consumed.
+    unsigned char extra;
+    z.next_out = &extra;
+    z.avail_out = 1;
+    result = inflate(&z, Z_NO_FLUSH);
+    if (z.avail_out == 0)
+    {
+      result = Z_DATA_ERROR;
+    }
+  }
+  const bool succeeded = z.avail_in == 0 && z.avail_out == 0 &&
+                         (last ? result == Z_STREAM_END : result == Z_OK || result == Z_BUF_ERROR);
+  inflateEnd(&z);
+  return succeeded;
+}
+
+/** Inflate a zlib or gzip stream on a single thread. */
+bool
+InflateStream(const unsigned char * stream, SizeValueType streamSize, unsigned char * data, SizeValueType size)
+{
+  z_stream z{};
+  // Detect the zlib or gzip header.
+  if (inflateInit2(&z, MAX_WBITS + 32) != Z_OK)
+  {
+    return false;
+  }
+  constexpr SizeValueType maximumChunkSize = std::numeric_limits<uInt>::max();
+  SizeValueType           streamPosition = 0;
+  SizeValueType           dataPosition = 0;
+  int                     result = Z_OK;
+  while (result == Z_OK)
+  {
+    if (z.avail_in == 0)
+    {
+      z.next_in = const_cast<unsigned char *>(stream) + streamPosition;
+      z.avail_in = static_cast<uInt>(std::min(streamSize - streamPosition, maximumChunkSize));
+      streamPosition += z.avail_in;
+    }
+    if (z.avail_out == 0)
+    {
+      z.next_out = data + dataPosition;
+      z.avail_out = static_cast<uInt>(std::min(size - dataPosition, maximumChunkSize));
+      dataPosition += z.avail_out;
+    }
+    // Z_BUF_ERROR, as no progress is possible with all the input and output
+    // provided, means that the stream is truncated or too long.
+    result = inflate(&z, Z_NO_FLUSH);
+  }
+  const bool succeeded = result == Z_STREAM_END && z.avail_out == 0 && dataPosition == size;
+  inflateEnd(&z);
+  return succeeded;
+}
+} // namespace
+
+ZlibBlockCompressor::ZlibBlockCompressor()
+  : m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+{}
+
+void
+ZlibBlockCompressor::Compress(const void * data, SizeValueType size, std::vector<unsigned char> & stream)
+{
+  stream.clear();
+  this->StartCompression(stream);
+  this->CompressPiece(data, size, stream);
+  this->FinishCompression(stream);
+}
+
+void
+ZlibBlockCompressor::StartCompression(std::vector<unsigned char> & stream)
+{
+  // The level flags of the headers are the ones zlib writes.
+  const int level = m_CompressionLevel == Z_DEFAULT_COMPRESSION ? 6 : m_CompressionLevel;
+  if (m_UseGzipFormat)
+  {
+    // No file name nor modification time, and an unknown operating system.
+    const unsigned char extraFlags = level == 9 ? 2 : (level == 1 ? 4 : 0);
+    stream.insert(stream.end(), { 0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, extraFlags, 255 });
+  }
+  else
+  {
+    const unsigned int levelFlags = level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3));
+    unsigned int       header = ((Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8) | (levelFlags << 6);
+    header += 31 - header % 31;
+    stream.push_back(static_cast<unsigned char>(header >> 8));
+    stream.push_back(static_cast<unsigned char>(header & 0xFF));
+  }
+
+  m_CompressedBlockSizes.clear();
+  m_UncompressedSize = 0;
+  m_Checksum = Checksum(m_UseGzipFormat, nullptr, 0);
+  m_PendingBlock.clear();
+  this->Modified();
+}
+
+void
+ZlibBlockCompressor::CompressPiece(const void * data, SizeValueType size, std::vector<unsigned char> & stream)
+{
+  const auto * bytes = static_cast<const unsigned char *>(data);
+  m_UncompressedSize += size;
+
+  // A block is only deflated once data follows it, as the last block is
+  // deflated differently.
+  if (!m_PendingBlock.empty() || size <= m_BlockSize)
+  {
+    const SizeValueType pendingSize = std::min(m_BlockSize - m_PendingBlock.size(), size);
+    m_PendingBlock.insert(m_PendingBlock.end(), bytes, bytes + pendingSize);
+    bytes += pendingSize;
+    size -= pendingSize;
+    if (size == 0)
+    {
+      return;
+    }
+    this->DeflateBlocks({ m_PendingBlock.data() }, m_BlockSize, false, stream);
+  }
+
+  // Deflate the blocks of the piece which are followed by more data, and keep
+  // the rest for the next piece or the last block.
+  const SizeValueType                numberOfBlocks = (size - 1) / m_BlockSize;
+  std::vector<const unsigned char *> blocks(numberOfBlocks);
+  for (SizeValueType i = 0; i < numberOfBlocks; ++i)
+  {
+    blocks[i] = bytes + i * m_BlockSize;
+  }
+  this->DeflateBlocks(blocks, m_BlockSize, false, stream);
+  m_PendingBlock.assign(bytes + numberOfBlocks * m_BlockSize, bytes + size);
+}
+
+void
+ZlibBlockCompressor::FinishCompression(std::vector<unsigned char> & stream)
+{
+  this->DeflateBlocks({ m_PendingBlock.data() }, m_PendingBlock.size(), true, stream);
+  std::vector<unsigned char>().swap(m_PendingBlock);
+
+  if (m_UseGzipFormat)
+  {
+    AppendLittleEndian32(stream, m_Checksum);
+    AppendLittleEndian32(stream, static_cast<unsigned long>(m_UncompressedSize & 0xFFFFFFFF));
+  }
+  else
+  {
+    AppendBigEndian32(stream, m_Checksum);
+  }
+  this->Modified();
+}
+
+void
+ZlibBlockCompressor::DeflateBlocks(const std::vector<const unsigned char *> & blocks,
+                                   SizeValueType                              blockSize,
+                                   bool                                       last,
+                                   std::vector<unsigned char> &               stream)
+{
+  const SizeValueType                     numberOfBlocks = blocks.size();
+  const bool                              gzip = m_UseGzipFormat;
+  std::vector<std::vector<unsigned char>> deflatedBlocks(numberOfBlocks);
+  std::vector<unsigned long>              checksums(numberOfBlocks);
+  std::vector<char>                       failures(numberOfBlocks, false);
+
+  const auto multiThreader = MultiThreaderBase::New();
+  multiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&](SizeValueType i) {
+      failures[i] =
+        !DeflateBlock(blocks[i], blockSize, m_CompressionLevel, last && i + 1 == numberOfBlocks, deflatedBlocks[i]);
+      checksums[i] = Checksum(gzip, blocks[i], blockSize);
+    },
+    nullptr);
+  if (std::find(failures.cbegin(), failures.cend(), true) != failures.cend())
+  {
+    itkExceptionMacro("Deflating with compression level " << m_CompressionLevel << " failed");
+  }
+
+  for (SizeValueType i = 0; i < numberOfBlocks; ++i)
+  {
+    m_Checksum = CombineChecksums(gzip, m_Checksum, checksums[i], blockSize);
+    m_CompressedBlockSizes.push_back(deflatedBlocks[i].size());
+    stream.insert(stream.end(), deflatedBlocks[i].cbegin(), deflatedBlocks[i].cend());
+    // Release each block once it is in the stream.
+    std::vector<unsigned char>().swap(deflatedBlocks[i]);
+  }
+}
+
+bool
+ZlibBlockCompressor::Decompress(const void * stream, SizeValueType streamSize, void * data, SizeValueType size) const
+{
+  const auto * bytes = static_cast<const unsigned char *>(stream);
+  if (!m_CompressedBlockSizes.empty() && this->DecompressBlocks(bytes, streamSize, data, size))
+  {
+    return true;
+  }
+  return InflateStream(bytes, streamSize, static_cast<unsigned char *>(data), size);
+}
+
+bool
+ZlibBlockCompressor::DecompressBlocks(const unsigned char * stream,
+                                      SizeValueType         streamSize,
+                                      void *                data,
+                                      SizeValueType         size) const
+{
+  bool          gzip = false;
+  SizeValueType headerSize = 0;
+  if (!ParseHeader(stream, streamSize, gzip, headerSize))
+  {
+    return false;
+  }
+  const SizeValueType trailerSize = gzip ? GzipTrailerSize : ZlibTrailerSize;
+  if (streamSize < headerSize + trailerSize)
+  {
+    return false;
+  }
+
+  const SizeValueType numberOfBlocks = NumberOfBlocks(size, m_BlockSize);
+  if (m_CompressedBlockSizes.size() != numberOfBlocks)
+  {
+    return false;
+  }
+  std::vector<SizeValueType> blockOffsets(numberOfBlocks);
+  SizeValueType              blockOffset = headerSize;
+  for (SizeValueType i = 0; i < numberOfBlocks; ++i)
+  {
+    // Each block must fit in the stream before its trailer, which also
+    // keeps the offsets from overflowing.
+    if (m_CompressedBlockSizes[i] > MaximumCompressedBlockSize ||
+        m_CompressedBlockSizes[i] > streamSize - trailerSize - blockOffset)
+    {
+      return false;
+    }
+    blockOffsets[i] = blockOffset;
+    blockOffset += m_CompressedBlockSizes[i];
+  }
+  if (blockOffset + trailerSize != streamSize)
+  {
+    return false;
+  }
+
+  auto *                     bytes = static_cast<unsigned char *>(data);
+  std::vector<unsigned long> checksums(numberOfBlocks);
+  std::vector<char>          failures(numberOfBlocks, false);
+
+  const auto multiThreader = MultiThreaderBase::New();
+  multiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&](SizeValueType i) {
+      const SizeValueType offset = i * m_BlockSize;
+      const SizeValueType blockSize = std::min(m_BlockSize, size - offset);
+      failures[i] = !InflateBlock(
+        stream + blockOffsets[i], m_CompressedBlockSizes[i], bytes + offset, blockSize, i + 1 == numberOfBlocks);
+      checksums[i] = Checksum(gzip, bytes + offset, blockSize);
+    },
+    nullptr);
+  if (std::find(failures.cbegin(), failures.cend(), true) != failures.cend())
+  {
+    return false;
+  }
+
+  unsigned long checksum = checksums[0];
+  for (SizeValueType i = 1; i < numberOfBlocks; ++i)
+  {
+    checksum = CombineChecksums(gzip, checksum, checksums[i], std::min(m_BlockSize, size - i * m_BlockSize));
+  }
+  const unsigned char * trailer = stream + blockOffset;
+  if (gzip)
+  {
+    return ReadLittleEndian32(trailer) == checksum && ReadLittleEndian32(trailer + 4) == (size & 0xFFFFFFFF);
+  }
+  return ReadBigEndian32(trailer) == checksum;
+}
+
+bool
+ZlibBlockCompressor::DecompressRanges(std::istream &                 stream,
+                                      SizeValueType                  size,
+                                      const std::vector<DataRange> & ranges) const
+{
+  const SizeValueType numberOfBlocks = NumberOfBlocks(size, m_BlockSize);
+  if (m_CompressedBlockSizes.size() != numberOfBlocks)
+  {
+    return false;
+  }
+  const std::streampos streamStart = stream.tellg();
+  unsigned char        header[GzipHeaderSize]{};
+  stream.read(reinterpret_cast<char *>(header), GzipHeaderSize);
+  const auto    headerBytesRead = static_cast<SizeValueType>(stream.gcount());
+  bool          gzip = false;
+  SizeValueType headerSize = 0;
+  if (streamStart == std::streampos(-1) || !ParseHeader(header, headerBytesRead, gzip, headerSize))
+  {
+    return false;
+  }
+  stream.clear();
+  stream.seekg(0, std::ios::end);
+  const std::streampos streamEnd = stream.tellg();
+  if (streamEnd == std::streampos(-1) || streamEnd < streamStart)
+  {
+    return false;
+  }
+  const auto streamSize = static_cast<SizeValueType>(streamEnd - streamStart);
+  if (streamSize < headerSize)
+  {
+    return false;
+  }
+
+  // The blocks which overlap the ranges, in order.
+  std::vector<SizeValueType> blockIndices;
+  for (const DataRange & range : ranges)
+  {
+    if (range.Size == 0)
+    {
+      continue;
+    }
+    if (range.Offset + range.Size > size)
+    {
+      return false;
+    }
+    SizeValueType i = range.Offset / m_BlockSize;
+    if (!blockIndices.empty())
+    {
+      i = std::max(i, blockIndices.back() + 1);
+    }
+    for (; i <= (range.Offset + range.Size - 1) / m_BlockSize; ++i)
+    {
+      blockIndices.push_back(i);
+    }
+  }
+
+  // Read the compressed blocks, seeking over the others.
+  const SizeValueType                     numberOfBlocksToRead = blockIndices.size();
+  std::vector<std::vector<unsigned char>> compressedBlocks(numberOfBlocksToRead);
+  SizeValueType                           blockOffset = headerSize;
+  SizeValueType                           nextBlock = 0;
+  for (SizeValueType k = 0; k < numberOfBlocksToRead; ++k)
+  {
+    for (; nextBlock < blockIndices[k]; ++nextBlock)
+    {
+      if (m_CompressedBlockSizes[nextBlock] > streamSize - blockOffset)
+      {
+        return false;
+      }
+      blockOffset += m_CompressedBlockSizes[nextBlock];
+    }
+    // No more memory is allocated for a block than the stream holds.
+    const SizeValueType compressedBlockSize = m_CompressedBlockSizes[blockIndices[k]];
+    if (compressedBlockSize > MaximumCompressedBlockSize || compressedBlockSize > streamSize - blockOffset)
+    {
+      return false;
+    }
+    std::vector<unsigned char> & compressedBlock = compressedBlocks[k];
+    compressedBlock.resize(compressedBlockSize);
+    stream.seekg(streamStart + static_cast<std::streamoff>(blockOffset));
+    stream.read(reinterpret_cast<char *>(compressedBlock.data()), static_cast<std::streamsize>(compressedBlock.size()));
+    if (stream.fail())
+    {
+      return false;
+    }
+  }
+
+  std::vector<char> failures(numberOfBlocksToRead, false);
+  const auto        multiThreader = MultiThreaderBase::New();
+  multiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfBlocksToRead,
+    [&](SizeValueType k) {
+      const SizeValueType        i = blockIndices[k];
+      const SizeValueType        offset = i * m_BlockSize;
+      const SizeValueType        blockSize = std::min(m_BlockSize, size - offset);
+      std::vector<unsigned char> block(blockSize);
+      if (!InflateBlock(compressedBlocks[k].data(),
+                        compressedBlocks[k].size(),
+                        block.data(),
+                        blockSize,
+                        i + 1 == numberOfBlocks))
+      {
+        failures[k] = true;
+        return;
+      }
+      // Copy the parts of the ranges within the block, which no other block
+      // copies.
+      auto range = std::partition_point(ranges.cbegin(), ranges.cend(), [offset](const DataRange & r) {
+        return r.Offset + r.Size <= offset;
+      });
+      for (; range != ranges.cend() && range->Offset < offset + blockSize; ++range)
+      {
+        const SizeValueType begin = std::max(range->Offset, offset);
+        const SizeValueType end = std::min(range->Offset + range->Size, offset + blockSize);
+        if (begin < end)
+        {
+          std::copy(block.cbegin() + (begin - offset),
+                    block.cbegin() + (end - offset),
+                    static_cast<unsigned char *>(range->Buffer) + (begin - range->Offset));
+        }
+      }
+    },
+    nullptr);
+  return std::find(failures.cbegin(), failures.cend(), true) == failures.cend();
+}
+
+std::string
+ZlibBlockCompressor::GetBlockIndex() const
+{
+  if (m_CompressedBlockSizes.empty())
+  {
+    return {};
+  }
+  std::ostringstream blockIndex;
+  blockIndex << m_BlockSize;
+  for (const SizeValueType compressedBlockSize : m_CompressedBlockSizes)
+  {
+    blockIndex << ' ' << compressedBlockSize;
+  }
+  return blockIndex.str();
+}
+
+bool
+ZlibBlockCompressor::SetBlockIndex(const std::string & blockIndex)
+{
+  m_CompressedBlockSizes.clear();
+  this->Modified();
+
+  std::istringstream stream(blockIndex);
+  SizeValueType      blockSize = 0;
+  if (!(stream >> blockSize))
+  {
+    // Only an empty index is valid without a block size.
+    return blockIndex.find_first_not_of(" \t\r\n") == std::string::npos;
+  }
+
+  std::vector<SizeValueType> compressedBlockSizes;
+  SizeValueType              compressedBlockSize = 0;
+  while (stream >> compressedBlockSize)
+  {
+    compressedBlockSizes.push_back(compressedBlockSize);
+  }
+  if (!stream.eof() || blockSize == 0 || compressedBlockSizes.empty())
+  {
+    return false;
+  }
+  this->SetBlockSize(blockSize);
+  m_CompressedBlockSizes = std::move(compressedBlockSizes);
+  return true;
+}
+
+void
+ZlibBlockCompressor::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "BlockSize: " << m_BlockSize << std::endl;
+  os << indent << "CompressionLevel: " << m_CompressionLevel << std::endl;
+  os << indent << "UseGzipFormat: " << (m_UseGzipFormat ? "On" : "Off") << std::endl;
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
+  os << indent << "NumberOfCompressedBlocks: " << m_CompressedBlockSizes.size() << std::endl;
+  os << indent << "UncompressedSize: " << m_UncompressedSize << std::endl;
+}
+} // end namespace itk
@@ -0,0 +1,285 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMemoryMappedImportImageContainer.h"
+#include "itkRawImageIO.h"
+#include "itkVectorImage.h"
+
+#include "itkGTest.h"
+#include "itksys/SystemTools.hxx"
+#include "itkTestDriverIncludeRequiredFactories.h"
+
+#define _STRING(s) #s
+#define TOSTRING(s) _STRING(s)
+
+namespace
+{
+
+struct ITKImageFileReaderMemoryMappingTest : public ::testing::Test
+{
+  void
+  SetUp() override
+  {
+    RegisterRequiredFactories();
+    itksys::SystemTools::ChangeDirectory(TOSTRING(ITK_TEST_OUTPUT_DIR));
+  }
+
+  using ImageType = itk::Image<short, 3>;
+  using RegionType = ImageType::RegionType;
+  using ReaderType = itk::ImageFileReader<ImageType>;
+
+  template <typename TImage = ImageType>
+  static typename TImage::PixelType
+  ExpectedValue(const typename TImage::IndexType & index)
+  {
+    return static_cast<typename TImage::PixelType>(index[0] + 10 * index[1] + 100 * index[2]);
+  }
+
+  template <typename TImage = ImageType>
+  static typename TImage::Pointer
+  CreateTestImage()
+  {
+    auto image = TImage::New();
+    image->SetRegions(typename TImage::RegionType(typename TImage::SizeType{ { 7, 5, 4 } }));
+    image->Allocate();
+    for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+    {
+      it.Set(ExpectedValue<TImage>(it.GetIndex()));
+    }
+    return image;
+  }
+
+  template <typename TImage = ImageType>
+  static void
+  WriteTestImage(const std::string & fileName, bool useCompression = false)
+  {
+    itk::WriteImage(CreateTestImage<TImage>(), fileName, useCompression);
+  }
+
+  template <typename TImage>
+  static bool
+  IsMapped(const TImage * image)
+  {
+    using MappedContainerType = itk::MemoryMappedImportImageContainer<itk::SizeValueType, typename TImage::PixelType>;
+    return dynamic_cast<const MappedContainerType *>(image->GetPixelContainer()) != nullptr;
+  }
+
+  template <typename TImage>
+  static void
+  ExpectPixels(const TImage * image, const typename TImage::RegionType & region)
+  {
+    EXPECT_EQ(image->GetBufferedRegion(), region);
+    for (itk::ImageRegionConstIteratorWithIndex<TImage> it(image, region); !it.IsAtEnd(); ++it)
+    {
+      ASSERT_EQ(it.Get(), ExpectedValue<TImage>(it.GetIndex())) << it.GetIndex();
+    }
+  }
+
+  // Whether the pixel data of the file of the reader starts at an offset
+  // aligned for the pixels, which the length of a header may prevent.
+  template <typename TReader>
+  static bool
+  IsPixelDataAligned(TReader * reader)
+  {
+    std::string         fileName;
+    itk::SizeValueType offset = 0;
+    EXPECT_TRUE(reader->GetModifiableImageIO()->GetRawPixelDataLocation(fileName, offset));
+    return offset % alignof(typename TReader::OutputImagePixelType) == 0;
+  }
+};
+
+} // namespace
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, MapsUncompressedFiles)
+{
+  for (const std::string fileName : { "MemoryMapping.mha",
+                                      "MemoryMapping.mhd",
+                                      "MemoryMapping.nrrd",
+                                      "MemoryMapping.nhdr",
+                                      "MemoryMapping.nii",
+                                      "MemoryMapping.hdr" })
+  {
+    WriteTestImage(fileName);
+
+    auto reader = ReaderType::New();
+    reader->SetFileName(fileName);
+    EXPECT_FALSE(reader->GetUseMemoryMapping());
+    reader->Update();
+    EXPECT_FALSE(IsMapped(reader->GetOutput()));
+
+    reader->UseMemoryMappingOn();
+    reader->Modified();
+    reader->Update();
+    const ImageType::Pointer image = reader->GetOutput();
+    // The data of a file with an attached header is only mapped when the
+    // length of the header keeps it aligned.
+    EXPECT_EQ(IsMapped(image.GetPointer()), IsPixelDataAligned(reader.GetPointer())) << fileName;
+    ExpectPixels(image.GetPointer(), image->GetLargestPossibleRegion());
+
+    // The mapping is copy-on-write.
+    image->SetPixel({ { 1, 2, 3 } }, -1);
+    EXPECT_EQ(image->GetPixel({ { 1, 2, 3 } }), -1);
+    const ImageType::Pointer reread = itk::ReadImage<ImageType>(fileName);
+    ExpectPixels(reread.GetPointer(), reread->GetLargestPossibleRegion());
+  }
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, ReadsCompressedFiles)
+{
+  WriteTestImage("MemoryMappingCompressed.mha", true);
+
+  auto reader = ReaderType::New();
+  reader->SetFileName("MemoryMappingCompressed.mha");
+  reader->UseMemoryMappingOn();
+  reader->Update();
+  EXPECT_FALSE(IsMapped(reader->GetOutput()));
+  ExpectPixels(reader->GetOutput(), reader->GetOutput()->GetLargestPossibleRegion());
+}
+
+
+// Bytes need no alignment, so the data of any uncompressed file is mapped,
+// from the offset which follows the header.
+TEST_F(ITKImageFileReaderMemoryMappingTest, MapsDataAfterHeadersOfAnyLength)
+{
+  using ByteImageType = itk::Image<unsigned char, 3>;
+  for (const std::string fileName : { "MemoryMappingBytes.mha", "MemoryMappingBytes.nrrd", "MemoryMappingBytes.nii" })
+  {
+    WriteTestImage<ByteImageType>(fileName);
+
+    auto reader = itk::ImageFileReader<ByteImageType>::New();
+    reader->SetFileName(fileName);
+    reader->UseMemoryMappingOn();
+    reader->Update();
+    EXPECT_TRUE(IsMapped(reader->GetOutput())) << fileName;
+    ExpectPixels(reader->GetOutput(), reader->GetOutput()->GetLargestPossibleRegion());
+  }
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, MapsRawFilesWithAlignedHeaders)
+{
+  const ImageType::Pointer image = CreateTestImage();
+  const std::string        fileName = "MemoryMapping.raw";
+
+  for (const unsigned int headerSize : { 4u, 3u })
+  {
+    {
+      std::ofstream file(fileName, std::ios::binary);
+      file.write("head", headerSize);
+      file.write(reinterpret_cast<const char *>(image->GetBufferPointer()),
+                 image->GetPixelContainer()->Size() * sizeof(short));
+    }
+
+    auto rawImageIO = itk::RawImageIO<short, 3>::New();
+    rawImageIO->SetHeaderSize(headerSize);
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      rawImageIO->SetDimensions(i, image->GetLargestPossibleRegion().GetSize(i));
+    }
+    rawImageIO->SetByteOrderToLittleEndian();
+    if (itk::ByteSwapper<short>::SystemIsBigEndian())
+    {
+      rawImageIO->SetByteOrderToBigEndian();
+    }
+
+    auto reader = ReaderType::New();
+    reader->SetFileName(fileName);
+    reader->SetImageIO(rawImageIO);
+    reader->UseMemoryMappingOn();
+    reader->Update();
+    EXPECT_EQ(IsMapped(reader->GetOutput()), headerSize % alignof(short) == 0) << headerSize;
+    ExpectPixels(reader->GetOutput(), reader->GetOutput()->GetLargestPossibleRegion());
+  }
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, RefusesToWriteTheMappedFile)
+{
+  // The NIfTI header has a fixed length, which keeps the data aligned.
+  WriteTestImage("MemoryMappingOverwritten.nii");
+
+  auto reader = ReaderType::New();
+  reader->SetFileName("MemoryMappingOverwritten.nii");
+  reader->UseMemoryMappingOn();
+  reader->Update();
+  ASSERT_TRUE(IsMapped(reader->GetOutput()));
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(reader->GetOutput());
+  writer->SetFileName("MemoryMappingOverwritten.nii");
+  EXPECT_THROW(writer->Update(), itk::ExceptionObject);
+  ExpectPixels(reader->GetOutput(), reader->GetOutput()->GetLargestPossibleRegion());
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, MapsContiguousStreamedRegions)
+{
+  // The data file of a ".mhd" file starts aligned for any pixel type.
+  WriteTestImage("MemoryMappingStreamed.mhd");
+
+  const auto read = [](const RegionType & region) {
+    auto reader = ReaderType::New();
+    reader->SetFileName("MemoryMappingStreamed.mhd");
+    reader->UseMemoryMappingOn();
+    reader->UseStreamingOn();
+    reader->GetOutput()->SetRequestedRegion(region);
+    reader->Update();
+    ExpectPixels(reader->GetOutput(), region);
+    return IsMapped(reader->GetOutput());
+  };
+
+  // Slices 1 and 2 are contiguous in the file, and so are rows 1 to 3 of
+  // slice 2, but not a box within the slices.
+  EXPECT_TRUE(read(RegionType({ { 0, 0, 1 } }, { { 7, 5, 2 } })));
+  EXPECT_TRUE(read(RegionType({ { 0, 1, 2 } }, { { 7, 3, 1 } })));
+  EXPECT_FALSE(read(RegionType({ { 1, 1, 1 } }, { { 3, 3, 2 } })));
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, MapsVectorImages)
+{
+  using VectorImageType = itk::VectorImage<float, 2>;
+  auto image = VectorImageType::New();
+  image->SetRegions(VectorImageType::RegionType(VectorImageType::SizeType{ { 4, 3 } }));
+  image->SetVectorLength(3);
+  image->Allocate();
+  for (itk::SizeValueType i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    image->GetBufferPointer()[i] = static_cast<float>(i);
+  }
+  // The data file of a ".mhd" file starts aligned for any pixel type.
+  itk::WriteImage(image, "MemoryMappingVector.mhd");
+
+  auto reader = itk::ImageFileReader<VectorImageType>::New();
+  reader->SetFileName("MemoryMappingVector.mhd");
+  reader->UseMemoryMappingOn();
+  reader->Update();
+  using MappedContainerType = itk::MemoryMappedImportImageContainer<itk::SizeValueType, float>;
+  const VectorImageType * output = reader->GetOutput();
+  EXPECT_NE(dynamic_cast<const MappedContainerType *>(output->GetPixelContainer()), nullptr);
+  ASSERT_EQ(output->GetPixelContainer()->Size(), 36u);
+  for (itk::SizeValueType i = 0; i < 36; ++i)
+  {
+    EXPECT_EQ(output->GetBufferPointer()[i], static_cast<float>(i));
+  }
+}
@@ -0,0 +1,178 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMetaImageIO.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTestingMacros.h"
+#include <atomic>
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+using FloatImageType = itk::Image<float, 3>;
+
+short
+ExpectedValue(const ImageType::IndexType & index)
+{
+  return static_cast<short>(index[0] + 20 * index[1] + 400 * index[2]);
+}
+
+// Counts the regions read, some of them on the read ahead thread.
+class CountingMetaImageIO : public itk::MetaImageIO
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(CountingMetaImageIO);
+
+  using Self = CountingMetaImageIO;
+  using Superclass = itk::MetaImageIO;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(CountingMetaImageIO);
+
+  void
+  Read(void * buffer) override
+  {
+    ++m_NumberOfReads;
+    Superclass::Read(buffer);
+  }
+
+  unsigned int
+  GetNumberOfReads() const
+  {
+    return m_NumberOfReads;
+  }
+
+protected:
+  CountingMetaImageIO() = default;
+  ~CountingMetaImageIO() override = default;
+
+private:
+  std::atomic<unsigned int> m_NumberOfReads{ 0 };
+};
+
+template <typename TImage>
+bool
+CheckRegion(const TImage * image, const typename TImage::RegionType & region)
+{
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != static_cast<typename TImage::PixelType>(ExpectedValue(it.GetIndex())))
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Expected " << ExpectedValue(it.GetIndex()) << " at " << it.GetIndex() << ", but got " << it.Get()
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Stream the file in the given number of divisions, and check that each
+// region is read once, whether or not the next one is read ahead.
+template <typename TImage>
+bool
+StreamFile(const std::string & fileName,
+           bool                useReadAhead,
+           unsigned int        numberOfStreamDivisions,
+           unsigned int        expectedNumberOfReads)
+{
+  const auto imageIO = CountingMetaImageIO::New();
+  const auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetImageIO(imageIO);
+  reader->SetFileName(fileName);
+  reader->SetUseReadAhead(useReadAhead);
+  const auto streamer = itk::StreamingImageFilter<TImage, TImage>::New();
+  streamer->SetInput(reader->GetOutput());
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  streamer->Update();
+
+  if (imageIO->GetNumberOfReads() != expectedNumberOfReads)
+  {
+    std::cerr << "Test failed for " << numberOfStreamDivisions << " stream divisions!" << std::endl;
+    std::cerr << "Expected " << expectedNumberOfReads << " reads, but got " << imageIO->GetNumberOfReads() << std::endl;
+    return false;
+  }
+  return CheckRegion<TImage>(streamer->GetOutput(), streamer->GetOutput()->GetLargestPossibleRegion());
+}
+} // namespace
+
+int
+itkImageFileReaderReadAheadTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string fileName = std::string(argv[1]) + "/itkImageFileReaderReadAheadTest.mha";
+
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 13, 11, 17 } });
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(ExpectedValue(it.GetIndex()));
+  }
+  const auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetImageIO(itk::MetaImageIO::New());
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  const auto reader = itk::ImageFileReader<ImageType>::New();
+  ITK_TEST_SET_GET_BOOLEAN(reader, UseReadAhead, false);
+
+  bool success = true;
+
+  // Five divisions of 17 slices end with a single slice. A single division
+  // has no next region.
+  for (const bool useReadAhead : { false, true })
+  {
+    ITK_TRY_EXPECT_NO_EXCEPTION(success &= StreamFile<ImageType>(fileName, useReadAhead, 1, 1));
+    ITK_TRY_EXPECT_NO_EXCEPTION(success &= StreamFile<ImageType>(fileName, useReadAhead, 5, 5));
+    ITK_TRY_EXPECT_NO_EXCEPTION(success &= StreamFile<ImageType>(fileName, useReadAhead, 17, 17));
+  }
+
+  // The pixels read ahead are converted to the pixel type of the output.
+  ITK_TRY_EXPECT_NO_EXCEPTION(success &= StreamFile<FloatImageType>(fileName, true, 4, 4));
+
+  // Regions which are not the ones read ahead are read as usual.
+  const auto imageIO = CountingMetaImageIO::New();
+  reader->SetImageIO(imageIO);
+  reader->SetFileName(fileName);
+  reader->UseReadAheadOn();
+  for (const auto & region : { ImageType::RegionType({ { 0, 0, 0 } }, { { 13, 11, 4 } }),
+                               ImageType::RegionType({ { 0, 0, 10 } }, { { 13, 11, 4 } }),
+                               ImageType::RegionType({ { 0, 0, 14 } }, { { 13, 11, 3 } }) })
+  {
+    reader->GetOutput()->SetRequestedRegion(region);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+    ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), region);
+    success &= CheckRegion<ImageType>(reader->GetOutput(), region);
+  }
+  // The first two regions were read, and the third one ahead, along with a
+  // region which was not requested.
+  ITK_TEST_EXPECT_EQUAL(imageIO->GetNumberOfReads(), 4);
+
+  std::cout << "Test finished." << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
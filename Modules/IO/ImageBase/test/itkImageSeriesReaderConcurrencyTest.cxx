@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageSeriesReader.h"
+#include "itkMetaImageIO.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using SliceType = itk::Image<short, 2>;
+using VolumeType = itk::Image<short, 3>;
+
+constexpr int numberOfSlices = 37;
+
+short
+ExpectedValue(itk::IndexValueType x, itk::IndexValueType y, itk::IndexValueType z)
+{
+  return static_cast<short>(x + 20 * y + 200 * z);
+}
+
+// Read the series with the given number of work units, optionally with an
+// explicit ImageIO, in reverse order or in stream divisions, and check
+// that each slice is in its place.
+bool
+ReadSeries(const std::vector<std::string> & fileNames,
+           unsigned int                     numberOfWorkUnits,
+           bool                             setImageIO,
+           bool                             reverseOrder,
+           unsigned int                     numberOfStreamDivisions)
+{
+  const auto reader = itk::ImageSeriesReader<VolumeType>::New();
+  reader->SetFileNames(fileNames);
+  reader->SetNumberOfWorkUnits(numberOfWorkUnits);
+  reader->SetReverseOrder(reverseOrder);
+  if (setImageIO)
+  {
+    reader->SetImageIO(itk::MetaImageIO::New());
+  }
+  const auto streamer = itk::StreamingImageFilter<VolumeType, VolumeType>::New();
+  streamer->SetInput(reader->GetOutput());
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  streamer->Update();
+
+  const VolumeType * output = streamer->GetOutput();
+  for (itk::ImageRegionConstIteratorWithIndex<VolumeType> it(output, output->GetLargestPossibleRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    const VolumeType::IndexType index = it.GetIndex();
+    const short expected = ExpectedValue(index[0], index[1], reverseOrder ? numberOfSlices - 1 - index[2] : index[2]);
+    if (it.Get() != expected)
+    {
+      std::cerr << "Test failed with " << numberOfWorkUnits << " work units!" << std::endl;
+      std::cerr << "Expected " << expected << " at " << index << ", but got " << it.Get() << std::endl;
+      return false;
+    }
+  }
+  if (reader->GetMetaDataDictionaryArray()->size() != fileNames.size())
+  {
+    std::cerr << "Test failed with " << numberOfWorkUnits << " work units!" << std::endl;
+    std::cerr << "Expected " << fileNames.size() << " meta data dictionaries, but got "
+              << reader->GetMetaDataDictionaryArray()->size() << std::endl;
+    return false;
+  }
+  // The ImageIO which is set has the information of the last file read.
+  const std::string & lastFileName = reverseOrder ? fileNames.front() : fileNames.back();
+  if (setImageIO && reader->GetImageIO()->GetFileName() != lastFileName)
+  {
+    std::cerr << "Test failed with " << numberOfWorkUnits << " work units!" << std::endl;
+    std::cerr << "Expected the ImageIO to have read " << lastFileName << ", but it read "
+              << reader->GetImageIO()->GetFileName() << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+int
+itkImageSeriesReaderConcurrencyTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  std::vector<std::string> fileNames;
+  for (int z = 0; z < numberOfSlices; ++z)
+  {
+    const auto slice = SliceType::New();
+    slice->SetRegions(SliceType::SizeType{ { 13, 7 } });
+    slice->Allocate();
+    for (itk::ImageRegionIteratorWithIndex<SliceType> it(slice, slice->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+    {
+      it.Set(ExpectedValue(it.GetIndex()[0], it.GetIndex()[1], z));
+    }
+    fileNames.push_back(outputDirectory + "/itkImageSeriesReaderConcurrencyTest" + std::to_string(z) + ".mha");
+    ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(slice, fileNames.back()));
+  }
+
+  bool success = true;
+  for (const unsigned int numberOfWorkUnits : { 1, 3, 16 })
+  {
+    for (const bool setImageIO : { false, true })
+    {
+      ITK_TRY_EXPECT_NO_EXCEPTION(success &= ReadSeries(fileNames, numberOfWorkUnits, setImageIO, false, 1));
+    }
+    ITK_TRY_EXPECT_NO_EXCEPTION(success &= ReadSeries(fileNames, numberOfWorkUnits, false, true, 1));
+    ITK_TRY_EXPECT_NO_EXCEPTION(success &= ReadSeries(fileNames, numberOfWorkUnits, true, true, 1));
+    ITK_TRY_EXPECT_NO_EXCEPTION(success &= ReadSeries(fileNames, numberOfWorkUnits, false, false, 5));
+  }
+
+  // A missing file fails the read, whichever thread reads it.
+  std::vector<std::string> fileNamesWithMissingFile = fileNames;
+  fileNamesWithMissingFile[numberOfSlices / 2] = outputDirectory + "/itkImageSeriesReaderConcurrencyTestMissing.mha";
+  ITK_TRY_EXPECT_EXCEPTION(ReadSeries(fileNamesWithMissingFile, 16, false, false, 1));
+  ITK_TRY_EXPECT_EXCEPTION(ReadSeries(fileNamesWithMissingFile, 16, true, false, 1));
+
+  std::cout << "Test finished." << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,321 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkZlibBlockCompressor.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMetaImageIO.h"
+
+#include "itkGTest.h"
+#include "itksys/SystemTools.hxx"
+#include "itkTestDriverIncludeRequiredFactories.h"
+
+#include <iterator>
+#include <numeric>
+#include <sstream>
+
+#define _STRING(s) #s
+#define TOSTRING(s) _STRING(s)
+
+namespace
+{
+
+std::vector<unsigned char>
+MakeData(size_t size)
+{
+  // Compressible, but not trivially.
+  std::vector<unsigned char> data(size);
+  unsigned int               state = 12345;
+  for (size_t i = 0; i < size; ++i)
+  {
+    state = state * 1103515245 + 12345;
+    data[i] = static_cast<unsigned char>((i / 7) % 50 + ((state >> 16) & 3));
+  }
+  return data;
+}
+
+} // namespace
+
+
+TEST(ZlibBlockCompressor, RoundTrips)
+{
+  for (const bool gzip : { false, true })
+  {
+    for (const size_t size : { 0, 1, 999, 1000, 1001, 12345 })
+    {
+      const std::vector<unsigned char> data = MakeData(size);
+
+      auto compressor = itk::ZlibBlockCompressor::New();
+      compressor->SetBlockSize(1000);
+      compressor->SetNumberOfWorkUnits(3);
+      compressor->SetCompressionLevel(6);
+      compressor->SetUseGzipFormat(gzip);
+      std::vector<unsigned char> stream;
+      compressor->Compress(data.data(), size, stream);
+      ASSERT_GE(stream.size(), 2u);
+      if (gzip)
+      {
+        EXPECT_EQ(stream[0], 0x1f);
+        EXPECT_EQ(stream[1], 0x8b);
+      }
+      else
+      {
+        EXPECT_EQ((stream[0] * 256 + stream[1]) % 31, 0);
+      }
+
+      const std::string   blockIndex = compressor->GetBlockIndex();
+      std::istringstream  indexStream(blockIndex);
+      std::vector<size_t> index{ std::istream_iterator<size_t>(indexStream), std::istream_iterator<size_t>() };
+      ASSERT_EQ(index.size(), 1 + std::max<size_t>(1, (size + 999) / 1000)) << blockIndex;
+      EXPECT_EQ(index[0], 1000u);
+      EXPECT_EQ(std::accumulate(index.cbegin() + 1, index.cend(), size_t{ 0 }) + (gzip ? 18 : 6), stream.size());
+
+      // In parallel with the block index, and as a plain stream without it.
+      for (const bool useBlockIndex : { true, false })
+      {
+        auto decompressor = itk::ZlibBlockCompressor::New();
+        ASSERT_TRUE(decompressor->SetBlockIndex(useBlockIndex ? blockIndex : ""));
+        std::vector<unsigned char> decompressed(size + 1, 0xAA);
+        EXPECT_TRUE(decompressor->Decompress(stream.data(), stream.size(), decompressed.data(), size))
+          << "gzip: " << gzip << ", size: " << size << ", block index: " << useBlockIndex;
+        EXPECT_TRUE(std::equal(data.cbegin(), data.cend(), decompressed.cbegin()));
+        EXPECT_EQ(decompressed[size], 0xAA);
+      }
+    }
+  }
+}
+
+
+TEST(ZlibBlockCompressor, RejectsInvalidStreams)
+{
+  const std::vector<unsigned char> data = MakeData(5000);
+
+  auto compressor = itk::ZlibBlockCompressor::New();
+  compressor->SetBlockSize(1024);
+  std::vector<unsigned char> stream;
+  compressor->Compress(data.data(), data.size(), stream);
+
+  std::vector<unsigned char> decompressed(data.size());
+  EXPECT_FALSE(compressor->Decompress(stream.data(), stream.size(), decompressed.data(), data.size() - 1));
+  EXPECT_FALSE(compressor->Decompress(stream.data(), stream.size(), decompressed.data(), data.size() + 1));
+  EXPECT_FALSE(compressor->Decompress(stream.data(), stream.size() - 1, decompressed.data(), data.size()));
+
+  std::vector<unsigned char> corrupted = stream;
+  corrupted.back() ^= 1;
+  EXPECT_FALSE(compressor->Decompress(corrupted.data(), corrupted.size(), decompressed.data(), data.size()));
+
+  // A block index which does not match the stream falls back to inflating it
+  // on a single thread.
+  EXPECT_TRUE(compressor->SetBlockIndex("1024 10 20 30 40 50"));
+  EXPECT_TRUE(compressor->Decompress(stream.data(), stream.size(), decompressed.data(), data.size()));
+  EXPECT_EQ(decompressed, data);
+
+  // Block sizes beyond the stream are rejected rather than read.
+  EXPECT_TRUE(compressor->SetBlockIndex("1024 18446744073709551615 10 20 30 40"));
+  EXPECT_TRUE(compressor->Decompress(stream.data(), stream.size(), decompressed.data(), data.size()));
+  EXPECT_EQ(decompressed, data);
+
+  EXPECT_FALSE(compressor->SetBlockIndex("1024 10 x"));
+  EXPECT_FALSE(compressor->SetBlockIndex("1024"));
+  EXPECT_TRUE(compressor->GetBlockIndex().empty());
+}
+
+
+TEST(ZlibBlockCompressor, CompressesInPieces)
+{
+  const std::vector<unsigned char> data = MakeData(10000);
+
+  auto compressor = itk::ZlibBlockCompressor::New();
+  compressor->SetBlockSize(1000);
+  std::vector<unsigned char> stream;
+  compressor->Compress(data.data(), data.size(), stream);
+  const std::string blockIndex = compressor->GetBlockIndex();
+
+  // Pieces smaller than, equal to, and larger than a block, and empty ones.
+  std::vector<unsigned char> piecewiseStream;
+  compressor->StartCompression(piecewiseStream);
+  size_t offset = 0;
+  for (const size_t size : { 10, 0, 990, 1000, 2500, 1, 0, 5499 })
+  {
+    compressor->CompressPiece(data.data() + offset, size, piecewiseStream);
+    offset += size;
+    EXPECT_EQ(compressor->GetUncompressedSize(), offset);
+  }
+  ASSERT_EQ(offset, data.size());
+  compressor->FinishCompression(piecewiseStream);
+  EXPECT_EQ(piecewiseStream, stream);
+  EXPECT_EQ(compressor->GetBlockIndex(), blockIndex);
+}
+
+
+TEST(ZlibBlockCompressor, DecompressesRanges)
+{
+  for (const bool gzip : { false, true })
+  {
+    const std::vector<unsigned char> data = MakeData(10000);
+
+    auto compressor = itk::ZlibBlockCompressor::New();
+    compressor->SetBlockSize(1000);
+    compressor->SetUseGzipFormat(gzip);
+    std::vector<unsigned char> stream;
+    compressor->Compress(data.data(), data.size(), stream);
+
+    // The stream follows other data, and is read from its position.
+    std::stringstream file;
+    file << "prefix";
+    file.write(reinterpret_cast<const char *>(stream.data()), static_cast<std::streamsize>(stream.size()));
+
+    std::vector<unsigned char> ranges(3 + 1500 + 2000 + 1, 0);
+    const std::vector<itk::ZlibBlockCompressor::DataRange> dataRanges{ { 0, 3, ranges.data() },
+                                                                       { 5, 0, nullptr },
+                                                                       { 900, 1500, ranges.data() + 3 },
+                                                                       { 2400, 2000, ranges.data() + 1503 },
+                                                                       { 9999, 1, ranges.data() + 3503 } };
+    file.seekg(6);
+    ASSERT_TRUE(compressor->DecompressRanges(file, data.size(), dataRanges)) << "gzip: " << gzip;
+    for (const auto & range : dataRanges)
+    {
+      EXPECT_TRUE(std::equal(data.cbegin() + range.Offset,
+                             data.cbegin() + range.Offset + range.Size,
+                             static_cast<const unsigned char *>(range.Buffer)));
+    }
+
+    // Ranges beyond the data, and streams which do not match the block index.
+    file.seekg(6);
+    EXPECT_FALSE(compressor->DecompressRanges(file, data.size(), { { 9999, 2, ranges.data() } }));
+    file.seekg(6);
+    EXPECT_FALSE(compressor->DecompressRanges(file, data.size() + 1000, dataRanges));
+    file.seekg(0);
+    EXPECT_FALSE(compressor->DecompressRanges(file, data.size(), dataRanges));
+
+    // Block sizes beyond the stream are rejected before any is read.
+    for (const char * blockIndex : { "1000 4294967296 1 1 1 1 1 1 1 1 1", "1000 1 1000000 1 1 1 1 1 1 1 1" })
+    {
+      ASSERT_TRUE(compressor->SetBlockIndex(blockIndex));
+      file.clear();
+      file.seekg(6);
+      EXPECT_FALSE(compressor->DecompressRanges(file, data.size(), dataRanges)) << blockIndex;
+    }
+  }
+}
+
+
+TEST(ZlibBlockCompressor, StreamsCompressedMetaImages)
+{
+  RegisterRequiredFactories();
+  itksys::SystemTools::ChangeDirectory(TOSTRING(ITK_TEST_OUTPUT_DIR));
+
+  using ImageType = itk::Image<short, 3>;
+  using RegionType = ImageType::RegionType;
+  auto image = ImageType::New();
+  image->SetRegions(RegionType(ImageType::SizeType{ { 64, 48, 30 } }));
+  image->Allocate();
+  const auto expectedValue = [](const ImageType::IndexType & index) {
+    return static_cast<short>(index[0] + 64 * index[1] + 1000 * index[2]);
+  };
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(expectedValue(it.GetIndex()));
+  }
+  itk::WriteImage(image, "ZlibBlockCompressorStreamedInput.mha");
+
+  for (const std::string fileName : { "ZlibBlockCompressorStreamed.mha", "ZlibBlockCompressorStreamed.mhd" })
+  {
+    // Blocks of a fraction of a slice, written in pieces of several slices
+    // streamed from an uncompressed file.
+    auto input = itk::ImageFileReader<ImageType>::New();
+    input->SetFileName("ZlibBlockCompressorStreamedInput.mha");
+    input->UseStreamingOn();
+    auto imageIO = itk::MetaImageIO::New();
+    imageIO->SetCompressedBlockSize(1000);
+    auto writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetInput(input->GetOutput());
+    writer->SetFileName(fileName);
+    writer->SetImageIO(imageIO);
+    writer->UseCompressionOn();
+    writer->SetNumberOfStreamDivisions(4);
+    writer->Update();
+    EXPECT_EQ(input->GetOutput()->GetBufferedRegion(), RegionType({ { 0, 0, 24 } }, { { 64, 48, 6 } }));
+
+    // The whole image, and regions within one block, across blocks and
+    // across slices.
+    EXPECT_EQ(itk::ReadImage<ImageType>(fileName)->GetPixel({ { 63, 47, 29 } }), expectedValue({ { 63, 47, 29 } }));
+    for (const RegionType & region : { RegionType({ { 3, 1, 2 } }, { { 5, 2, 1 } }),
+                                       RegionType({ { 0, 10, 5 } }, { { 64, 20, 1 } }),
+                                       RegionType({ { 10, 40, 3 } }, { { 20, 8, 7 } }),
+                                       RegionType({ { 0, 0, 29 } }, { { 64, 48, 1 } }) })
+    {
+      auto reader = itk::ImageFileReader<ImageType>::New();
+      reader->SetFileName(fileName);
+      reader->UseStreamingOn();
+      reader->GetOutput()->SetRequestedRegion(region);
+      reader->Update();
+      EXPECT_TRUE(reader->GetImageIO()->CanStreamRead());
+      const ImageType * output = reader->GetOutput();
+      EXPECT_EQ(output->GetBufferedRegion(), region);
+      for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(output, region); !it.IsAtEnd(); ++it)
+      {
+        ASSERT_EQ(it.Get(), expectedValue(it.GetIndex())) << fileName << ' ' << it.GetIndex();
+      }
+    }
+  }
+}
+
+
+TEST(ZlibBlockCompressor, CompressesMetaImages)
+{
+  RegisterRequiredFactories();
+  itksys::SystemTools::ChangeDirectory(TOSTRING(ITK_TEST_OUTPUT_DIR));
+
+  // More than one block of 1 MiB.
+  using ImageType = itk::Image<short, 3>;
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::RegionType(ImageType::SizeType{ { 128, 128, 40 } }));
+  image->Allocate();
+  short * const buffer = image->GetBufferPointer();
+  for (size_t i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    buffer[i] = static_cast<short>((i / 3) % 1000);
+  }
+
+  for (const std::string fileName : { "ZlibBlockCompressor.mha", "ZlibBlockCompressor.mhd" })
+  {
+    itk::WriteImage(image, fileName, true);
+
+    // The header has the block index, which is not part of the dictionary.
+    auto reader = itk::ImageFileReader<ImageType>::New();
+    reader->SetFileName(fileName);
+    reader->Update();
+    const ImageType * output = reader->GetOutput();
+    EXPECT_FALSE(output->GetMetaDataDictionary().HasKey(itk::ZlibBlockCompressor::BlockIndexKey));
+    EXPECT_TRUE(std::equal(buffer, buffer + image->GetPixelContainer()->Size(), output->GetBufferPointer()));
+
+    // MetaIO reads the data as a single zlib stream.
+    MetaImage metaImage;
+    ASSERT_TRUE(metaImage.Read(fileName.c_str()));
+    EXPECT_TRUE(metaImage.CompressedData());
+    bool hasBlockIndex = false;
+    for (int i = 0; i < metaImage.GetNumberOfAdditionalReadFields(); ++i)
+    {
+      hasBlockIndex |= std::string(metaImage.GetAdditionalReadFieldName(i)) == itk::ZlibBlockCompressor::BlockIndexKey;
+    }
+    EXPECT_TRUE(hasBlockIndex);
+    EXPECT_TRUE(std::equal(buffer, buffer + metaImage.Quantity(), static_cast<const short *>(metaImage.ElementData())));
+  }
+}
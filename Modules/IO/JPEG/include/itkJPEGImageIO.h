@@ -32,6 +32,11 @@ namespace itk
  * Compression is supported with only the default compressor. The
  * compression level option is supported in the range 0-100.
  *
+ * A sequential (not progressive) file with restart markers at the start of
+ * MCU rows is decoded in bands of rows on multiple threads, as many as
+ * MultiThreaderBase::GetGlobalDefaultNumberOfThreads(). Other files are
+ * decoded on a single thread.
+ *
  * \ingroup IOFilters
  *
  * \ingroup ITKIOJPEG
@@ -74,6 +79,12 @@ public:
   itkGetConstMacro(CMYKtoRGB, bool);
   itkBooleanMacro(CMYKtoRGB);
 
+  /** Set/Get the number of MCU rows between the restart markers written, or
+   * 0 (the default) to write none. Restart markers let a file which is not
+   * progressive be decoded on multiple threads. */
+  itkSetMacro(RestartInterval, unsigned int);
+  itkGetConstMacro(RestartInterval, unsigned int);
+
   /*-------- This part of the interface deals with reading data. ------ */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -124,6 +135,8 @@ protected:
   bool m_CMYKtoRGB{ true };
 
   bool m_IsCMYK{ false };
+
+  unsigned int m_RestartInterval{ 0 };
 };
 } // end namespace itk
 
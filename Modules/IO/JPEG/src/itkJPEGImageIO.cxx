@@ -17,10 +17,15 @@
  *=========================================================================*/
 
 #include "itkJPEGImageIO.h"
+#include "itkMultiThreaderBase.h"
 #include "itksys/SystemTools.hxx"
 
 #include "itk_jpeg.h"
+#include <atomic>
 #include <csetjmp>
+#include <fstream>
+#include <numeric>
+#include <vector>
 
 #define JPEGIO_JPEG_MESSAGES 1
 
@@ -83,6 +88,346 @@ public:
   FILE * volatile m_FilePointer{ nullptr };
 };
 
+namespace
+{
+// Gimp approach: the following code assumes inverted CMYK values,
+// even when an APP14 marker doesn't exist. This is the behavior
+// of recent versions of PhotoShop as well.
+void
+ConvertCMYKToRGB(const JSAMPLE * cmyk, JSAMPLE * rgb, JDIMENSION width)
+{
+  for (size_t i = 0; i < width; ++i)
+  {
+    const float K = cmyk[4 * i + 3];
+    rgb[3 * i + 0] = static_cast<JSAMPLE>(cmyk[4 * i + 0] * K / 255.0f);
+    rgb[3 * i + 1] = static_cast<JSAMPLE>(cmyk[4 * i + 1] * K / 255.0f);
+    rgb[3 * i + 2] = static_cast<JSAMPLE>(cmyk[4 * i + 2] * K / 255.0f);
+  }
+}
+
+// The layout of a sequential file of a single scan with restart markers.
+// Restart markers reset the entropy decoder, so that the segments between
+// them, and in particular the bands of MCU rows starting with one, are
+// decoded independently.
+struct RestartSegments
+{
+  size_t              heightOffset{ 0 }; // of the image height, in the frame header
+  size_t              scanOffset{ 0 };   // of the entropy coded data
+  size_t              endOffset{ 0 };    // of the end of image marker
+  std::vector<size_t> restartOffsets;    // of the restart markers
+  unsigned int        restartInterval{ 0 };
+  unsigned int        height{ 0 };
+  unsigned int        mcusPerRow{ 0 };
+  unsigned int        mcuHeight{ 0 };
+  // Whether some components are subsampled vertically, so that upsampling
+  // them uses the neighboring MCU rows.
+  bool hasContextRows{ false };
+
+  size_t
+  GetNumberOfSegments() const
+  {
+    return restartOffsets.size() + 1;
+  }
+
+  // The number of segments from one band to the next, and the number of
+  // bands.
+  size_t
+  GetSegmentsPerBand() const
+  {
+    return mcusPerRow / std::gcd(restartInterval, mcusPerRow);
+  }
+  size_t
+  GetNumberOfBands() const
+  {
+    return (this->GetNumberOfSegments() + this->GetSegmentsPerBand() - 1) / this->GetSegmentsPerBand();
+  }
+
+  // The first segment and pixel row of a band, or the end of the image.
+  size_t
+  GetFirstSegment(size_t band) const
+  {
+    return std::min(band * this->GetSegmentsPerBand(), this->GetNumberOfSegments());
+  }
+  unsigned int
+  GetFirstRow(size_t band) const
+  {
+    const size_t segment = this->GetFirstSegment(band);
+    return segment == this->GetNumberOfSegments()
+             ? height
+             : static_cast<unsigned int>(segment * restartInterval / mcusPerRow * mcuHeight);
+  }
+};
+
+bool
+ParseRestartSegments(const std::vector<unsigned char> & data, RestartSegments & segments)
+{
+  const size_t size = data.size();
+  if (size < 4 || data[0] != 0xFF || data[1] != 0xD8)
+  {
+    return false;
+  }
+
+  // Read the markers up to the start of the scan.
+  unsigned int width = 0;
+  unsigned int numberOfComponents = 0;
+  unsigned int maxVerticalSampling = 1;
+  unsigned int maxHorizontalSampling = 1;
+  unsigned int minVerticalSampling = 4;
+  size_t       pos = 2;
+  while (segments.scanOffset == 0)
+  {
+    if (pos >= size || data[pos] != 0xFF)
+    {
+      return false;
+    }
+    while (pos < size && data[pos] == 0xFF)
+    {
+      ++pos;
+    }
+    if (pos + 2 >= size)
+    {
+      return false;
+    }
+    const unsigned char marker = data[pos++];
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8))
+    {
+      continue;
+    }
+    const size_t length = (size_t{ data[pos] } << 8) | data[pos + 1];
+    if (length < 2 || pos + length > size)
+    {
+      return false;
+    }
+    const unsigned char * segment = &data[pos + 2];
+    switch (marker)
+    {
+      case 0xC0: // baseline
+      case 0xC1: // extended sequential, Huffman coded
+        numberOfComponents = length >= 8 ? segment[5] : 0;
+        if (numberOfComponents == 0 || length < 8 + 3 * size_t{ numberOfComponents })
+        {
+          return false;
+        }
+        segments.heightOffset = pos + 3;
+        segments.height = (segment[1] << 8) | segment[2];
+        width = (segment[3] << 8) | segment[4];
+        for (unsigned int c = 0; c < numberOfComponents; ++c)
+        {
+          const unsigned int horizontalSampling = segment[7 + 3 * c] >> 4;
+          const unsigned int verticalSampling = segment[7 + 3 * c] & 0x0F;
+          maxHorizontalSampling = std::max(maxHorizontalSampling, horizontalSampling);
+          maxVerticalSampling = std::max(maxVerticalSampling, verticalSampling);
+          minVerticalSampling = std::min(minVerticalSampling, verticalSampling);
+        }
+        break;
+      case 0xDD: // define restart interval
+        segments.restartInterval = length >= 4 ? (segment[0] << 8) | segment[1] : 0;
+        break;
+      case 0xDA: // start of scan, which must hold all the components
+        if (numberOfComponents == 0 || segment[0] != numberOfComponents)
+        {
+          return false;
+        }
+        segments.scanOffset = pos + length;
+        break;
+      default:
+        // Progressive, lossless, hierarchical and arithmetic coded frames.
+        if (marker >= 0xC2 && marker <= 0xCF && marker != 0xC4)
+        {
+          return false;
+        }
+        break;
+    }
+    pos += length;
+  }
+  if (segments.restartInterval == 0 || segments.height == 0 || width == 0)
+  {
+    return false;
+  }
+
+  // Find the restart markers, which the entropy coded data does not hold
+  // otherwise, as its 0xFF bytes are followed by 0x00.
+  for (pos = segments.scanOffset; pos + 1 < size && segments.endOffset == 0; ++pos)
+  {
+    if (data[pos] != 0xFF || data[pos + 1] == 0x00 || data[pos + 1] == 0xFF)
+    {
+      continue;
+    }
+    const unsigned char marker = data[pos + 1];
+    if (marker >= 0xD0 && marker <= 0xD7)
+    {
+      if (marker != static_cast<unsigned char>(0xD0 + segments.restartOffsets.size() % 8))
+      {
+        return false;
+      }
+      segments.restartOffsets.push_back(pos++);
+    }
+    else if (marker == 0xD9)
+    {
+      segments.endOffset = pos;
+    }
+    else
+    {
+      // Another scan, or the number of lines defined after the scan.
+      return false;
+    }
+  }
+
+  // A scan of a single component has MCUs of one block.
+  const unsigned int mcuWidth = numberOfComponents == 1 ? 8 : 8 * maxHorizontalSampling;
+  segments.mcuHeight = numberOfComponents == 1 ? 8 : 8 * maxVerticalSampling;
+  segments.mcusPerRow = (width + mcuWidth - 1) / mcuWidth;
+  segments.hasContextRows = numberOfComponents > 1 && minVerticalSampling < maxVerticalSampling;
+  const size_t numberOfMCUs =
+    size_t{ segments.mcusPerRow } * ((segments.height + segments.mcuHeight - 1) / segments.mcuHeight);
+  return segments.endOffset != 0 &&
+         segments.GetNumberOfSegments() == (numberOfMCUs + segments.restartInterval - 1) / segments.restartInterval;
+}
+
+// Decode the given JPEG stream, skipping its first rows, and store the next
+// ones, one after the other, from the given output.
+bool
+DecodeRows(std::vector<unsigned char> & stream,
+           JDIMENSION                   numberOfRowsToSkip,
+           JDIMENSION                   numberOfRows,
+           JSAMPLE *                    output,
+           size_t                       outputRowBytes,
+           bool                         convertCMYKToRGB,
+           std::vector<JSAMPLE> &       scratchRow)
+{
+  struct jpeg_decompress_struct cinfo;
+  struct itk_jpeg_error_mgr     jerr;
+
+  cinfo.err = jpeg_std_error(&jerr.pub);
+  jerr.pub.error_exit = itk_jpeg_error_exit;
+  jerr.pub.output_message = itk_jpeg_output_message;
+
+  if (setjmp(jerr.setjmp_buffer))
+  {
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+
+  jpeg_create_decompress(&cinfo);
+  jpeg_mem_src(&cinfo, stream.data(), static_cast<unsigned long>(stream.size()));
+  jpeg_read_header(&cinfo, TRUE);
+  jpeg_start_decompress(&cinfo);
+  if (scratchRow.size() < size_t{ cinfo.output_width } * cinfo.output_components)
+  {
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+
+  JSAMPROW scratch[1] = { scratchRow.data() };
+  while (cinfo.output_scanline < numberOfRowsToSkip + numberOfRows)
+  {
+    const JDIMENSION row = cinfo.output_scanline;
+    if (row < numberOfRowsToSkip || convertCMYKToRGB)
+    {
+      jpeg_read_scanlines(&cinfo, scratch, 1);
+      if (row >= numberOfRowsToSkip)
+      {
+        ConvertCMYKToRGB(scratchRow.data(), output + (row - numberOfRowsToSkip) * outputRowBytes, cinfo.output_width);
+      }
+    }
+    else
+    {
+      JSAMPROW rowPointer[1] = { output + (row - numberOfRowsToSkip) * outputRowBytes };
+      jpeg_read_scanlines(&cinfo, rowPointer, 1);
+    }
+  }
+
+  // The rows which follow are not needed.
+  jpeg_destroy_decompress(&cinfo);
+  return true;
+}
+
+// Decode the bands of the file concurrently. Returns false when the file
+// does not have such bands, or a band could not be decoded.
+bool
+ReadBands(const std::string & fileName,
+          unsigned int        width,
+          unsigned int        numberOfComponents,
+          bool                convertCMYKToRGB,
+          void *              buffer)
+{
+  std::ifstream file(fileName, std::ios::binary);
+  if (!file)
+  {
+    return false;
+  }
+  const std::vector<unsigned char> data{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+  RestartSegments segments;
+  if (!ParseRestartSegments(data, segments) || segments.GetNumberOfBands() < 2)
+  {
+    return false;
+  }
+
+  const auto         multiThreader = MultiThreaderBase::New();
+  const size_t       numberOfBands = segments.GetNumberOfBands();
+  const unsigned int numberOfPieces =
+    static_cast<unsigned int>(std::min<size_t>(numberOfBands, multiThreader->GetNumberOfWorkUnits()));
+  if (numberOfPieces < 2)
+  {
+    return false;
+  }
+
+  const size_t      outputRowBytes = size_t{ width } * numberOfComponents;
+  auto *            output = static_cast<JSAMPLE *>(buffer);
+  std::atomic<bool> failed{ false };
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&](SizeValueType piece) {
+      const size_t firstBand = piece * numberOfBands / numberOfPieces;
+      const size_t endBand = (piece + 1) * numberOfBands / numberOfPieces;
+
+      // Decode a band more on each side, when upsampling uses the
+      // neighboring rows.
+      const size_t margin = segments.hasContextRows ? 1 : 0;
+      const size_t firstDecodedBand = firstBand >= margin ? firstBand - margin : 0;
+      const size_t endDecodedBand = std::min(endBand + margin, numberOfBands);
+      const size_t firstSegment = segments.GetFirstSegment(firstDecodedBand);
+      const size_t endSegment = segments.GetFirstSegment(endDecodedBand);
+      const unsigned int firstDecodedRow = segments.GetFirstRow(firstDecodedBand);
+      const unsigned int decodedHeight = segments.GetFirstRow(endDecodedBand) - firstDecodedRow;
+
+      // The headers, for an image of the decoded rows, then the segments,
+      // with their restart markers renumbered, then the end of image.
+      const size_t dataBegin = firstSegment == 0 ? segments.scanOffset : segments.restartOffsets[firstSegment - 1] + 2;
+      const size_t dataEnd =
+        endSegment == segments.GetNumberOfSegments() ? segments.endOffset : segments.restartOffsets[endSegment - 1];
+      std::vector<unsigned char> stream(data.begin(), data.begin() + segments.scanOffset);
+      stream.insert(stream.end(), data.begin() + dataBegin, data.begin() + dataEnd);
+      stream.push_back(0xFF);
+      stream.push_back(0xD9);
+      stream[segments.heightOffset] = static_cast<unsigned char>(decodedHeight >> 8);
+      stream[segments.heightOffset + 1] = static_cast<unsigned char>(decodedHeight & 0xFF);
+      for (size_t segment = firstSegment; segment + 1 < endSegment; ++segment)
+      {
+        const size_t markerOffset = segments.scanOffset + segments.restartOffsets[segment] - dataBegin;
+        stream[markerOffset + 1] = static_cast<unsigned char>(0xD0 + (segment - firstSegment) % 8);
+      }
+
+      const unsigned int   firstRow = segments.GetFirstRow(firstBand);
+      std::vector<JSAMPLE> scratchRow(size_t{ width } * 4);
+      if (!DecodeRows(stream,
+                      firstRow - firstDecodedRow,
+                      segments.GetFirstRow(endBand) - firstRow,
+                      output + firstRow * outputRowBytes,
+                      outputRowBytes,
+                      convertCMYKToRGB,
+                      scratchRow))
+      {
+        failed = true;
+      }
+    },
+    nullptr);
+  return !failed;
+}
+} // namespace
+
 bool
 JPEGImageIO::CanReadFile(const char * file)
 {
@@ -198,6 +543,20 @@ JPEGImageIO::Read(void * buffer)
   // so has to be used here too
   jpeg_calc_output_dimensions(&cinfo);
 
+  // Decode the bands of rows between restart markers concurrently, when
+  // the file has such bands. Otherwise, or should decoding a band fail,
+  // decode the file as a whole.
+  if (cinfo.restart_interval > 0 && !cinfo.progressive_mode &&
+      ReadBands(this->GetFileName(),
+                cinfo.output_width,
+                this->GetNumberOfComponents(),
+                m_IsCMYK && m_CMYKtoRGB,
+                buffer))
+  {
+    jpeg_destroy_decompress(&cinfo);
+    return;
+  }
+
   // prepare to read the bulk data
   jpeg_start_decompress(&cinfo);
 
@@ -234,17 +593,7 @@ JPEGImageIO::Read(void * buffer)
 
       if (cinfo.output_scanline > 0)
       {
-        const size_t scanline = cinfo.output_scanline - 1;
-        for (size_t i = 0; i < cinfo.output_width; ++i)
-        {
-          // Gimp approach: the following code assumes inverted CMYK values,
-          // even when an APP14 marker doesn't exist. This is the behavior
-          // of recent versions of PhotoShop as well.
-          const float K = buf1[0][4 * i + 3];
-          row_pointers[scanline][3 * i + 0] = static_cast<JSAMPLE>(buf1[0][4 * i + 0] * K / 255.0f);
-          row_pointers[scanline][3 * i + 1] = static_cast<JSAMPLE>(buf1[0][4 * i + 1] * K / 255.0f);
-          row_pointers[scanline][3 * i + 2] = static_cast<JSAMPLE>(buf1[0][4 * i + 2] * K / 255.0f);
-        }
+        ConvertCMYKToRGB(buf1[0], row_pointers[cinfo.output_scanline - 1], cinfo.output_width);
       }
     }
 
@@ -320,6 +669,7 @@ JPEGImageIO::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "Progressive : " << m_Progressive << '\n';
   os << indent << "CMYK to RGB : " << m_CMYKtoRGB << '\n';
   os << indent << "IsCMYK : " << m_IsCMYK << '\n';
+  os << indent << "RestartInterval : " << m_RestartInterval << '\n';
 }
 
 void
@@ -532,6 +882,7 @@ JPEGImageIO::WriteSlice(const std::string & fileName, const void * const buffer)
   {
     jpeg_simple_progression(&cinfo);
   }
+  cinfo.restart_in_rows = static_cast<int>(m_RestartInterval);
 
   if (m_Spacing[0] > 0 && m_Spacing[1] > 0)
   {
@@ -0,0 +1,133 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkJPEGImageIO.h"
+#include "itkMultiThreaderBase.h"
+#include "itkRGBPixel.h"
+#include "itkTestingMacros.h"
+#include <cmath>
+
+namespace
+{
+using ImageType = itk::Image<unsigned char, 2>;
+using RGBImageType = itk::Image<itk::RGBPixel<unsigned char>, 2>;
+
+template <typename TImage>
+typename TImage::Pointer
+ReadWithThreads(const std::string & fileName, unsigned int numberOfThreads)
+{
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(numberOfThreads);
+  const auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetImageIO(itk::JPEGImageIO::New());
+  reader->SetFileName(fileName);
+  reader->Update();
+  return reader->GetOutput();
+}
+
+// Write a smooth image of a size which is not a whole number of MCUs, with
+// the given number of MCU rows between restart markers, then check that
+// decoding it in bands gives the pixels of decoding it as a whole.
+template <typename TImage>
+bool
+WriteAndReadBands(const std::string & fileName, unsigned int restartInterval)
+{
+  using PixelType = typename TImage::PixelType;
+  using PixelTraits = itk::DefaultConvertPixelTraits<PixelType>;
+
+  const auto image = TImage::New();
+  image->SetRegions(typename TImage::SizeType{ { 203, 97 } });
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    PixelType    pixel;
+    for (unsigned int c = 0; c < PixelTraits::GetNumberOfComponents(); ++c)
+    {
+      const double value = 127.5 + 127.0 * std::sin(0.05 * (c + 1) * index[0] + 0.07 * index[1]);
+      PixelTraits::SetNthComponent(c, pixel, static_cast<typename PixelTraits::ComponentType>(value));
+    }
+    it.Set(pixel);
+  }
+
+  const auto imageIO = itk::JPEGImageIO::New();
+  imageIO->SetProgressive(false);
+  imageIO->SetRestartInterval(restartInterval);
+  const auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetImageIO(imageIO);
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->Update();
+
+  const typename TImage::Pointer wholeImage = ReadWithThreads<TImage>(fileName, 1);
+  for (const unsigned int numberOfThreads : { 2, 3, 8 })
+  {
+    const typename TImage::Pointer bandedImage = ReadWithThreads<TImage>(fileName, numberOfThreads);
+    for (itk::ImageRegionConstIteratorWithIndex<TImage> it(bandedImage, bandedImage->GetBufferedRegion());
+         !it.IsAtEnd();
+         ++it)
+    {
+      if (it.Get() != wholeImage->GetPixel(it.GetIndex()))
+      {
+        std::cerr << "Test failed for " << fileName << " with " << numberOfThreads << " threads!" << std::endl;
+        std::cerr << "Expected " << wholeImage->GetPixel(it.GetIndex()) << " at " << it.GetIndex() << ", but got "
+                  << it.Get() << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkJPEGImageIORestartIntervalTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  const auto imageIO = itk::JPEGImageIO::New();
+  ITK_TEST_SET_GET_VALUE(0, imageIO->GetRestartInterval());
+
+  const itk::ThreadIdType numberOfThreads = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  bool                    success = true;
+
+  // Files without restart markers are decoded as a whole. The color
+  // components are subsampled vertically, so that the bands are decoded
+  // along with their neighbors.
+  for (const unsigned int restartInterval : { 0, 1, 2, 5 })
+  {
+    const std::string suffix = std::to_string(restartInterval) + ".jpg";
+    ITK_TRY_EXPECT_NO_EXCEPTION(success &= WriteAndReadBands<ImageType>(
+                                  outputDirectory + "/itkJPEGImageIORestartIntervalTest" + suffix, restartInterval));
+    ITK_TRY_EXPECT_NO_EXCEPTION(success &= WriteAndReadBands<RGBImageType>(
+                                  outputDirectory + "/itkJPEGImageIORestartIntervalTestRGB" + suffix, restartInterval));
+  }
+
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(numberOfThreads);
+
+  std::cout << "Test finished." << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -79,6 +79,9 @@ extern ITKIOJPEG2000_EXPORT std::ostream &
  * by Mosaliganti K., Ibanez L., Megason S
  * https://doi.org/10.54294/bo53br
  *
+ * The code blocks of each tile are decoded, and encoded, on as many threads
+ * as MultiThreaderBase::GetGlobalDefaultNumberOfThreads(), or on the calling
+ * thread when OpenJPEG is built without its thread support.
  *
  *  \ingroup IOFilters
  * \ingroup ITKIOJPEG2000
@@ -17,6 +17,7 @@
  *=========================================================================*/
 
 #include "itkJPEG2000ImageIO.h"
+#include "itkMultiThreaderBase.h"
 #include "itksys/SystemTools.hxx"
 
 // for memset
@@ -438,6 +439,14 @@ JPEG2000ImageIO::Read(void * buffer)
                                                               << "Reason: opj_setup_decoder returns false");
   }
 
+  // Decode the code blocks of each tile concurrently, or on the calling
+  // thread when the library is built without thread support.
+  if (!opj_codec_set_threads(this->m_Internal->m_Dinfo,
+                             static_cast<int>(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())))
+  {
+    itkDebugMacro("opj_codec_set_threads returns false, decoding on one thread");
+  }
+
   bool bResult = opj_read_header(l_stream, this->m_Internal->m_Dinfo, &l_image);
 
   if (!bResult)
@@ -955,6 +964,13 @@ JPEG2000ImageIO::Write(const void * buffer)
                                                                << "Reason: opj_setup_encoder returns false");
   }
 
+  // Encode the code blocks of each tile concurrently, or on the calling
+  // thread when the library is built without thread support.
+  if (!opj_codec_set_threads(cinfo, static_cast<int>(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())))
+  {
+    itkDebugMacro("opj_codec_set_threads returns false, encoding on one thread");
+  }
+
   /* open a byte stream for writing */
   /* allocate memory for all tiles */
   opj_stream_t * cio = opj_stream_create_default_file_stream(parameters.outfile, false);
@@ -0,0 +1,130 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkJPEG2000ImageIO.h"
+#include "itkMultiThreaderBase.h"
+#include "itkRGBPixel.h"
+#include "itkTestingMacros.h"
+#include <cmath>
+
+namespace
+{
+using ImageType = itk::Image<unsigned char, 2>;
+using RGBImageType = itk::Image<itk::RGBPixel<unsigned char>, 2>;
+
+template <typename TImage>
+typename TImage::Pointer
+ReadWithThreads(const std::string & fileName, unsigned int numberOfThreads)
+{
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(numberOfThreads);
+  const auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetImageIO(itk::JPEG2000ImageIO::New());
+  reader->SetFileName(fileName);
+  reader->Update();
+  return reader->GetOutput();
+}
+
+// Losslessly write, with the given number of threads, an image of a size
+// which is not a whole number of code blocks, then check that decoding it
+// with any number of threads gives back its pixels.
+template <typename TImage>
+bool
+WriteAndReadWithThreads(const std::string & fileName, unsigned int numberOfWriteThreads)
+{
+  using PixelType = typename TImage::PixelType;
+  using PixelTraits = itk::DefaultConvertPixelTraits<PixelType>;
+
+  const auto image = TImage::New();
+  image->SetRegions(typename TImage::SizeType{ { 257, 193 } });
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    PixelType    pixel;
+    for (unsigned int c = 0; c < PixelTraits::GetNumberOfComponents(); ++c)
+    {
+      const double value = 127.5 + 127.0 * std::sin(0.05 * (c + 1) * index[0] + 0.07 * index[1]);
+      PixelTraits::SetNthComponent(c, pixel, static_cast<typename PixelTraits::ComponentType>(value));
+    }
+    it.Set(pixel);
+  }
+
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(numberOfWriteThreads);
+  const auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetImageIO(itk::JPEG2000ImageIO::New());
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->Update();
+
+  for (const unsigned int numberOfThreads : { 1, 2, 3, 8 })
+  {
+    const typename TImage::Pointer readImage = ReadWithThreads<TImage>(fileName, numberOfThreads);
+    if (readImage->GetBufferedRegion() != image->GetBufferedRegion())
+    {
+      std::cerr << "Test failed for " << fileName << " with " << numberOfThreads << " threads!" << std::endl;
+      std::cerr << "Expected region " << image->GetBufferedRegion() << ", but got " << readImage->GetBufferedRegion()
+                << std::endl;
+      return false;
+    }
+    for (itk::ImageRegionConstIteratorWithIndex<TImage> it(readImage, readImage->GetBufferedRegion()); !it.IsAtEnd();
+         ++it)
+    {
+      if (it.Get() != image->GetPixel(it.GetIndex()))
+      {
+        std::cerr << "Test failed for " << fileName << " with " << numberOfThreads << " threads!" << std::endl;
+        std::cerr << "Expected " << image->GetPixel(it.GetIndex()) << " at " << it.GetIndex() << ", but got "
+                  << it.Get() << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkJPEG2000ImageIOThreadsTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  const itk::ThreadIdType numberOfThreads = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  bool                    success = true;
+
+  for (const unsigned int numberOfWriteThreads : { 1, 4 })
+  {
+    const std::string prefix = outputDirectory + "/itkJPEG2000ImageIOThreadsTest";
+    const std::string suffix = std::to_string(numberOfWriteThreads) + ".j2k";
+    ITK_TRY_EXPECT_NO_EXCEPTION(success &= WriteAndReadWithThreads<ImageType>(prefix + suffix, numberOfWriteThreads));
+    ITK_TRY_EXPECT_NO_EXCEPTION(
+      success &= WriteAndReadWithThreads<RGBImageType>(prefix + "RGB" + suffix, numberOfWriteThreads));
+  }
+
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(numberOfThreads);
+
+  std::cout << "Test finished." << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -24,6 +24,7 @@
 #include "itkImageIOBase.h"
 #include "itkSingletonMacro.h"
 #include "itkMetaDataObject.h"
+#include "itkZlibBlockCompressor.h"
 #include "metaObject.h"
 #include "metaImage.h"
 
@@ -37,6 +38,18 @@ namespace itk
  *  For a detailed description of using this format, please see
  *  https://www.itk.org/Wiki/ITK/MetaIO/Documentation
  *
+ *  Compressed data is deflated in blocks on multiple threads by a
+ *  ZlibBlockCompressor, and its block index is recorded in the header, so
+ *  that it is inflated on multiple threads as well. The data remains a
+ *  single zlib stream, which other MetaImage readers read as usual.
+ *
+ *  The block index also makes compressed files streamable: reading a region
+ *  inflates only the blocks which overlap it, and writing in pieces
+ *  compresses each piece as it comes. The compressed data of the whole image
+ *  is held in memory until the last piece is written, as the header which
+ *  precedes it records its size and block index. Compressed files cannot be
+ *  pasted into.
+ *
  *  \ingroup IOFilters
  * \ingroup ITKIOMeta
  */
@@ -82,6 +95,12 @@ public:
   void
   Read(void * buffer) override;
 
+  /** The pixel data is mapped in place when it is binary, uncompressed, not
+   * subsampled, in the byte order of this machine, and either local to the
+   * header or in a single data file. */
+  bool
+  GetRawPixelDataLocation(std::string & fileName, SizeValueType & offset) override;
+
   MetaImage *
   GetMetaImagePointer();
 
@@ -134,20 +153,22 @@ public:
                            const ImageIORegion & largestPossibleRegion) override;
 
   /** Determine if the ImageIO can stream reading from this
-   *  file. Only time cannot stream read/write is if compression is used.
-   *  CanRead must be called prior to this function. */
+   *  file. Compressed data can only be streamed when the header has its
+   *  block index. ReadImageInformation must be called prior to this
+   *  function. */
   bool
   CanStreamRead() override
   {
     if (m_MetaImage.CompressedData())
     {
-      return false;
+      return !m_CompressedDataBlocks.empty();
     }
     return true;
   }
 
   /** Determine if the ImageIO can stream writing to this
-   *  file. Only time cannot stream read/write is if compression is used.
+   *  file. Compressed data can only be streamed as binary data, in
+   *  consecutive pieces.
    *  Assumes file passes a CanRead call and its pixels are of the same
    *  type as the template of the writer. Can verify by first calling
    *  CanRead and then CanStreamRead prior to calling CanStreamWrite. */
@@ -156,11 +177,18 @@ public:
   {
     if (this->GetUseCompression())
     {
-      return false;
+      return this->GetFileType() != IOFileEnum::ASCII;
     }
     return true;
   }
 
+  /** The number of uncompressed bytes in each block of compressed data
+   * written. Smaller blocks make reading small regions of the file faster,
+   * at the cost of a slightly larger file. The default is 1 MiB.
+   * \sa ZlibBlockCompressor */
+  itkSetClampMacro(CompressedBlockSize, SizeValueType, 1, SizeValueType{ 1 } << 30);
+  itkGetConstMacro(CompressedBlockSize, SizeValueType);
+
   /** Determining the subsampling factor in case
    *  we want a coarse version of the image/
    * \warning this is only used when streaming is on. */
@@ -197,10 +225,42 @@ private:
   /** Only used to synchronize the global variable across static libraries.*/
   itkGetGlobalDeclarationMacro(unsigned int, DefaultDoublePrecision);
 
+  /** Find the file and the offset of data of the given size, as
+   * MetaImage::M_ReadElements() does. */
+  bool
+  GetElementDataLocation(SizeValueType dataSize, std::string & fileName, SizeValueType & offset) const;
+
+  /** Read compressed data which has a block index on multiple threads.
+   * Returns false when the data must be read by MetaImage instead. */
+  bool
+  ReadCompressedBlocks(void * buffer);
+
+  /** Read the region to read of compressed data which has a block index,
+   * inflating only the blocks which overlap it. Returns false when the
+   * region must be read by MetaImage instead. */
+  bool
+  ReadCompressedRegion(void * buffer);
+
+  /** Compress the region to write, which must follow the regions written
+   * before, on multiple threads. The compressed data is kept in memory until
+   * the last region is compressed, and then written after the header, which
+   * MetaImage writes. */
+  void
+  WriteCompressedBlocks(const void * buffer);
+
   MetaImage m_MetaImage{};
 
   unsigned int m_SubSamplingFactor{};
 
+  SizeValueType m_CompressedBlockSize{ SizeValueType{ 1 } << 20 };
+
+  /** The block index of the compressed data of the file read. */
+  std::string m_CompressedDataBlocks{};
+
+  /** The compression of the data written, until its last region. */
+  ZlibBlockCompressor::Pointer m_BlockCompressor{};
+  std::vector<unsigned char>   m_CompressedData{};
+
   static unsigned int * m_DefaultDoublePrecision;
 };
 
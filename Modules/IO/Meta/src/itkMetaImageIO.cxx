@@ -83,6 +83,7 @@ MetaImageIO::PrintSelf(std::ostream & os, Indent indent) const
   Superclass::PrintSelf(os, indent);
   m_MetaImage.PrintInfo();
   os << indent << "SubSamplingFactor: " << m_SubSamplingFactor << '\n';
+  os << indent << "CompressedBlockSize: " << m_CompressedBlockSize << '\n';
 }
 
 void
@@ -112,6 +113,7 @@ MetaImageIO::CanReadFile(const char * filename)
 void
 MetaImageIO::ReadImageInformation()
 {
+  m_CompressedDataBlocks.clear();
   if (!m_MetaImage.Read(m_FileName.c_str(), false))
   {
     itkExceptionMacro("File cannot be read: " << this->GetFileName() << " for reading." << std::endl
@@ -434,6 +436,12 @@ MetaImageIO::ReadImageInformation()
   {
     const std::string key(m_MetaImage.GetAdditionalReadFieldName(f));
     const std::string value(m_MetaImage.GetAdditionalReadFieldValue(f));
+    if (key == ZlibBlockCompressor::BlockIndexKey)
+    {
+      // The block index describes the data of this file only.
+      m_CompressedDataBlocks = value;
+      continue;
+    }
     EncapsulateMetaData<std::string>(thisMetaDict, key, value);
   }
 
@@ -473,6 +481,11 @@ MetaImageIO::Read(void * buffer)
 
   if (largestRegion != m_IORegion)
   {
+    if (this->ReadCompressedRegion(buffer))
+    {
+      return;
+    }
+
     const auto indexMin = make_unique_for_overwrite<int[]>(nDims);
     const auto indexMax = make_unique_for_overwrite<int[]>(nDims);
     for (unsigned int i = 0; i < nDims; ++i)
@@ -498,7 +511,7 @@ MetaImageIO::Read(void * buffer)
 
     m_MetaImage.ElementByteOrderFix(m_IORegion.GetNumberOfPixels());
   }
-  else
+  else if (!this->ReadCompressedBlocks(buffer))
   {
     if (!m_MetaImage.Read(m_FileName.c_str(), true, buffer))
     {
@@ -511,6 +524,197 @@ MetaImageIO::Read(void * buffer)
   }
 }
 
+bool
+MetaImageIO::GetRawPixelDataLocation(std::string & fileName, SizeValueType & offset)
+{
+  if (!m_MetaImage.BinaryData() || m_MetaImage.CompressedData() || m_SubSamplingFactor != 1)
+  {
+    return false;
+  }
+
+  int elementSize = 0;
+  MET_SizeOfType(m_MetaImage.ElementType(), &elementSize);
+  if (elementSize > 1 && m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB())
+  {
+    return false;
+  }
+  auto dataSize = static_cast<SizeValueType>(m_MetaImage.ElementNumberOfChannels()) *
+                  static_cast<SizeValueType>(elementSize);
+  for (int i = 0; i < m_MetaImage.NDims(); ++i)
+  {
+    dataSize *= static_cast<SizeValueType>(m_MetaImage.DimSize(i));
+  }
+  if (dataSize != static_cast<SizeValueType>(this->GetImageSizeInBytes()))
+  {
+    return false;
+  }
+
+  return this->GetElementDataLocation(dataSize, fileName, offset);
+}
+
+bool
+MetaImageIO::GetElementDataLocation(SizeValueType dataSize, std::string & fileName, SizeValueType & offset) const
+{
+  const std::string dataFileName = m_MetaImage.ElementDataFileName();
+  const bool        isLocal = itksys::SystemTools::UpperCase(dataFileName) == "LOCAL";
+  if (isLocal)
+  {
+    fileName = m_FileName;
+  }
+  else if (dataFileName.compare(0, 4, "LIST") == 0 || dataFileName.find('%') != std::string::npos)
+  {
+    return false;
+  }
+  else
+  {
+    fileName =
+      itksys::SystemTools::CollapseFullPath(dataFileName, itksys::SystemTools::GetFilenamePath(m_FileName));
+  }
+  // MetaIO falls back to a compressed file with a ".gz" or ".Z" suffix.
+  if (!itksys::SystemTools::FileExists(fileName, true))
+  {
+    return false;
+  }
+
+  // As in MetaImage::M_ReadElements(): the data follows a header of the given
+  // size, or, for a size of -1 or data local to the header, ends the file.
+  const SizeValueType fileLength = itksys::SystemTools::FileLength(fileName);
+  const int           headerSize = m_MetaImage.HeaderSize();
+  if (headerSize > 0)
+  {
+    offset = static_cast<SizeValueType>(headerSize);
+  }
+  else if (headerSize == -1 || isLocal)
+  {
+    if (fileLength < dataSize)
+    {
+      return false;
+    }
+    offset = fileLength - dataSize;
+  }
+  else
+  {
+    offset = 0;
+  }
+  return offset + dataSize <= fileLength;
+}
+
+bool
+MetaImageIO::ReadCompressedBlocks(void * buffer)
+{
+  if (m_CompressedDataBlocks.empty() || !m_MetaImage.BinaryData() || !m_MetaImage.CompressedData() ||
+      m_MetaImage.CompressedDataSize() <= 0)
+  {
+    return false;
+  }
+  // MetaImage::ElementByteOrderFix() only swaps the bytes of the data it read.
+  int elementSize = 0;
+  MET_SizeOfType(m_MetaImage.ElementType(), &elementSize);
+  if (elementSize > 1 && m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB())
+  {
+    return false;
+  }
+
+  const auto    compressor = ZlibBlockCompressor::New();
+  const auto    compressedSize = static_cast<SizeValueType>(m_MetaImage.CompressedDataSize());
+  std::string   fileName;
+  SizeValueType offset = 0;
+  if (!compressor->SetBlockIndex(m_CompressedDataBlocks) ||
+      !this->GetElementDataLocation(compressedSize, fileName, offset))
+  {
+    return false;
+  }
+
+  std::ifstream file;
+  this->OpenFileForReading(file, fileName);
+  file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+  std::vector<unsigned char> compressed(compressedSize);
+  if (!this->ReadBufferAsBinary(file, compressed.data(), compressedSize))
+  {
+    return false;
+  }
+  return compressor->Decompress(
+    compressed.data(), compressedSize, buffer, static_cast<SizeValueType>(this->GetImageSizeInBytes()));
+}
+
+bool
+MetaImageIO::ReadCompressedRegion(void * buffer)
+{
+  if (m_CompressedDataBlocks.empty() || !m_MetaImage.BinaryData() || !m_MetaImage.CompressedData() ||
+      m_MetaImage.CompressedDataSize() <= 0 || m_SubSamplingFactor != 1)
+  {
+    return false;
+  }
+  int elementSize = 0;
+  MET_SizeOfType(m_MetaImage.ElementType(), &elementSize);
+  if (elementSize > 1 && m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB())
+  {
+    return false;
+  }
+
+  const auto    compressor = ZlibBlockCompressor::New();
+  const auto    compressedSize = static_cast<SizeValueType>(m_MetaImage.CompressedDataSize());
+  std::string   fileName;
+  SizeValueType offset = 0;
+  if (!compressor->SetBlockIndex(m_CompressedDataBlocks) ||
+      !this->GetElementDataLocation(compressedSize, fileName, offset))
+  {
+    return false;
+  }
+
+  // Each row of the region is a range of the data, and consecutive rows
+  // which are contiguous in the data form a single range.
+  const unsigned int         nDims = m_MetaImage.NDims();
+  const SizeValueType        pixelSize =
+    static_cast<SizeValueType>(elementSize) * m_MetaImage.ElementNumberOfChannels();
+  std::vector<SizeValueType> strides(nDims);
+  std::vector<SizeValueType> regionIndex(nDims, 0);
+  std::vector<SizeValueType> regionSize(nDims, 1);
+  SizeValueType              stride = pixelSize;
+  for (unsigned int i = 0; i < nDims; ++i)
+  {
+    strides[i] = stride;
+    stride *= static_cast<SizeValueType>(m_MetaImage.DimSize(i));
+    if (i < m_IORegion.GetImageDimension())
+    {
+      regionIndex[i] = static_cast<SizeValueType>(m_IORegion.GetIndex(i));
+      regionSize[i] = static_cast<SizeValueType>(m_IORegion.GetSize(i));
+    }
+  }
+  const SizeValueType dataSize = stride;
+  const SizeValueType rowSize = regionSize[0] * pixelSize;
+  const SizeValueType numberOfRows = rowSize == 0 ? 0 : m_IORegion.GetNumberOfPixels() / regionSize[0];
+
+  std::vector<ZlibBlockCompressor::DataRange> ranges;
+  std::vector<SizeValueType>                  rowIndex(nDims, 0);
+  auto *                                      rowBuffer = static_cast<unsigned char *>(buffer);
+  for (SizeValueType row = 0; row < numberOfRows; ++row, rowBuffer += rowSize)
+  {
+    SizeValueType rowOffset = 0;
+    for (unsigned int i = 0; i < nDims; ++i)
+    {
+      rowOffset += (regionIndex[i] + rowIndex[i]) * strides[i];
+    }
+    if (!ranges.empty() && ranges.back().Offset + ranges.back().Size == rowOffset)
+    {
+      ranges.back().Size += rowSize;
+    }
+    else
+    {
+      ranges.push_back({ rowOffset, rowSize, rowBuffer });
+    }
+    for (unsigned int i = 1; i < nDims && ++rowIndex[i] == regionSize[i]; ++i)
+    {
+      rowIndex[i] = 0;
+    }
+  }
+
+  std::ifstream file;
+  this->OpenFileForReading(file, fileName);
+  file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+  return compressor->DecompressRanges(file, dataSize, ranges);
+}
+
 MetaImage *
 MetaImageIO::GetMetaImagePointer()
 {
@@ -569,7 +773,7 @@ MetaImageIO::WriteImageInformation()
   const std::vector<std::string> keys = metaDict.GetKeys();
   for (auto & key : keys)
   {
-    if (key == ITK_ExperimentDate || key == ITK_VoxelUnits)
+    if (key == ITK_ExperimentDate || key == ITK_VoxelUnits || key == ZlibBlockCompressor::BlockIndexKey)
     {
       continue;
     }
@@ -870,7 +1074,11 @@ MetaImageIO::Write(const void * buffer)
     largestRegion.SetSize(ii, this->GetDimensions(ii));
   }
 
-  if (m_UseCompression && (largestRegion != m_IORegion))
+  if (m_UseCompression && binaryData && !strchr(m_MetaImage.ElementDataFileName(), '%'))
+  {
+    this->WriteCompressedBlocks(buffer);
+  }
+  else if (m_UseCompression && (largestRegion != m_IORegion))
   {
     std::cout << "Compression in use: cannot stream the file writing" << std::endl;
   }
@@ -903,6 +1111,75 @@ MetaImageIO::Write(const void * buffer)
   }
 }
 
+void
+MetaImageIO::WriteCompressedBlocks(const void * buffer)
+{
+  SizeValueType regionOffset = 0;
+  SizeValueType regionSize = 0;
+  const bool    isRange = this->GetIORegionDataRange(regionOffset, regionSize);
+
+  if (regionOffset == 0)
+  {
+    m_BlockCompressor = ZlibBlockCompressor::New();
+    m_BlockCompressor->SetCompressionLevel(this->GetCompressionLevel());
+    m_BlockCompressor->SetBlockSize(m_CompressedBlockSize);
+    m_CompressedData.clear();
+    m_BlockCompressor->StartCompression(m_CompressedData);
+  }
+  if (!isRange || !m_BlockCompressor || m_BlockCompressor->GetUncompressedSize() != regionOffset)
+  {
+    itkExceptionMacro("Compressed data can only be written in consecutive regions: " << m_IORegion);
+  }
+  m_BlockCompressor->CompressPiece(buffer, regionSize, m_CompressedData);
+  if (regionOffset + regionSize < static_cast<SizeValueType>(this->GetImageSizeInBytes()))
+  {
+    return;
+  }
+  m_BlockCompressor->FinishCompression(m_CompressedData);
+  const std::string                blockIndex = m_BlockCompressor->GetBlockIndex();
+  const std::vector<unsigned char> compressed = std::move(m_CompressedData);
+  m_CompressedData.clear();
+  m_BlockCompressor = nullptr;
+
+  m_MetaImage.AddUserField(
+    ZlibBlockCompressor::BlockIndexKey, MET_STRING, static_cast<int>(blockIndex.size()), blockIndex.c_str(), true, -1);
+  m_MetaImage.CompressedDataSize(static_cast<std::streamoff>(compressed.size()));
+
+  // MetaImage writes the header only, with the size of the data compressed
+  // here, which follows a ".mha" header, and goes to a ".zraw" file otherwise,
+  // unless a data file is set.
+  std::string dataFileName = m_MetaImage.ElementDataFileName();
+  if (dataFileName.empty())
+  {
+    dataFileName = itksys::SystemTools::GetFilenameLastExtension(m_FileName) == ".mha"
+                     ? "LOCAL"
+                     : itksys::SystemTools::GetFilenameWithoutLastExtension(m_FileName) + ".zraw";
+  }
+  if (!m_MetaImage.Write(m_FileName.c_str(), nullptr, false))
+  {
+    itkExceptionMacro("File cannot be written: " << this->GetFileName() << std::endl
+                                                 << "Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+  std::ofstream file;
+  if (dataFileName == "LOCAL")
+  {
+    this->OpenFileForWriting(file, m_FileName, false);
+    file.seekp(0, std::ios::end);
+  }
+  else
+  {
+    this->OpenFileForWriting(
+      file, itksys::SystemTools::CollapseFullPath(dataFileName, itksys::SystemTools::GetFilenamePath(m_FileName)));
+  }
+  file.write(reinterpret_cast<const char *>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+  if (file.fail())
+  {
+    itkExceptionMacro("Compressed data cannot be written: " << dataFileName << std::endl
+                                                            << "Reason: "
+                                                            << itksys::SystemTools::GetLastSystemError());
+  }
+}
+
 /** Given a requested region, determine what could be the region that we can
  * read from the file. This is called the streamable region, which will be
  * smaller than the LargestPossibleRegion and greater or equal to the
@@ -939,17 +1216,20 @@ MetaImageIO::GetActualNumberOfSplitsForWriting(unsigned int          numberOfReq
 {
   if (this->GetUseCompression())
   {
-    // we can not stream or paste with compression
+    // we can not paste with compression, and can only stream binary data
     if (pasteRegion != largestPossibleRegion)
     {
       itkExceptionMacro("Pasting and compression is not supported! Can't write:" << this->GetFileName());
     }
-    else if (numberOfRequestedSplits != 1)
+    else if (numberOfRequestedSplits != 1 &&
+             (!this->CanStreamWrite() || strchr(m_MetaImage.ElementDataFileName(), '%') != nullptr))
     {
       itkDebugMacro("Requested streaming and compression");
       itkDebugMacro("Meta IO is not streaming now!");
+      return 1;
     }
-    return 1;
+    // the file is only written once the last piece is compressed
+    return GetActualNumberOfSplitsForWritingCanStreamWrite(numberOfRequestedSplits, pasteRegion);
   }
 
   if (!itksys::SystemTools::FileExists(m_FileName.c_str()))
@@ -24,6 +24,7 @@
 #include <fstream>
 #include <memory>
 #include "itkImageIOBase.h"
+#include "itkZlibBlockCompressor.h"
 
 namespace itk
 {
@@ -91,6 +92,16 @@ extern ITKIONIFTI_EXPORT std::ostream &
  * The specification for this file format is taken from the
  * web site https://analyzedirect.com/support/10.0Documents/Analyze_Resource_01.pdf
  *
+ * Images of scalar, complex, RGB and RGBA pixels are written in streamed
+ * regions. Regions are pasted into uncompressed files in place. Gzip
+ * compressed files are written in consecutive regions, each of which is
+ * compressed on multiple threads and appended to the file as it arrives.
+ *
+ * Any region of the image is read without reading the rest of its data:
+ * uncompressed data is read by seeking to each run of the region, and gzip
+ * compressed data is decompressed sequentially up to the end of the region,
+ * in a bounded amount of memory.
+ *
  * \ingroup IOFilters
  * \ingroup ITKIONIFTI
  */
@@ -145,10 +156,24 @@ public:
   void
   ReadImageInformation() override;
 
+  /** Determine if the ImageIO can stream reading from this file: any region
+   * of the image can be read, without reading the rest of the data. */
+  bool
+  CanStreamRead() override
+  {
+    return true;
+  }
+
   /** Reads the data from disk into the memory buffer provided. */
   void
   Read(void * buffer) override;
 
+  /** The pixel data is mapped in place when it is uncompressed, in the byte
+   * order of this machine, not rescaled, and either scalar, complex, RGB or
+   * RGBA, which NIfTI stores in the same layout as ITK. */
+  bool
+  GetRawPixelDataLocation(std::string & fileName, SizeValueType & offset) override;
+
   //-------- This part of the interfaces deals with writing data. -----
 
   /** Determine if the file can be written with this ImageIO implementation.
@@ -167,11 +192,24 @@ public:
   void
   WriteImageInformation() override;
 
+  /** Determine if the ImageIO can stream writing to this file: images of
+   * scalar, complex, RGB and RGBA pixels can be streamed, and pasted into
+   * uncompressed files. */
+  bool
+  CanStreamWrite() override;
+
   /** Writes the data to disk from the memory buffer provided. Make sure
    * that the IORegions has been set properly. */
   void
   Write(const void * buffer) override;
 
+  /** Check that a file to paste into is uncompressed and matches the image
+   * written, and remove the file before streaming the whole image. */
+  unsigned int
+  GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion) override;
+
   /** Calculate the region of the image that can be efficiently read
    *  in response to a given requested region. */
   ImageIORegion
@@ -249,6 +287,35 @@ private:
   bool
   MustRescale() const;
 
+  /** Whether NIfTI stores the components of the pixels interleaved, as ITK
+   * does: for scalar, complex, RGB and RGBA pixels. The components of other
+   * pixels are stored in separate volumes. */
+  bool
+  StoresComponentsInterleaved() const;
+
+  /** Find the file and the offset of the data of the file read or written,
+   * when it is uncompressed and in the byte order of this machine. */
+  bool
+  GetDataLocation(std::string & fileName, SizeValueType & offset);
+
+  /** Read the region to read straight into the buffer, one run of the
+   * region which is contiguous in the data at a time. The data of a gzip
+   * compressed file is decompressed sequentially, up to the end of the
+   * region. */
+  void
+  ReadRegion(void * buffer);
+
+  /** Paste the region to write into the uncompressed data of the file,
+   * writing the header first when the file does not exist. */
+  void
+  WriteRegion(const void * buffer);
+
+  /** Compress the region to write, which must follow the regions written
+   * before, on multiple threads, and append it to the gzip compressed file.
+   * The header is written with the first region. */
+  void
+  WriteCompressedBlocks(const void * buffer);
+
   void
   DefineHeaderObjectDataType();
 
@@ -284,6 +351,9 @@ private:
 
   bool m_SFORM_Permissive;
   bool m_SFORM_Corrected{ false };
+
+  /** The compression of the data written, until its last region. */
+  ZlibBlockCompressor::Pointer m_BlockCompressor{};
 };
 
 
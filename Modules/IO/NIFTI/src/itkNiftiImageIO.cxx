@@ -429,6 +429,10 @@ NiftiImageIO::NiftiImageIO()
     this->AddSupportedWriteExtension(ext);
     this->AddSupportedReadExtension(ext);
   }
+  // The levels of zlib, by default the level 6 with which the nifti library
+  // writes compressed files.
+  this->Self::SetMaximumCompressionLevel(9);
+  this->Self::SetCompressionLevel(6);
   std::string envVar;
   if (itksys::SystemTools::GetEnv("ITK_NIFTI_SFORM_PERMISSIVE", envVar))
   {
@@ -580,9 +584,18 @@ NiftiImageIO::Read(void * buffer)
     itkExceptionMacro("nifti_image_read (just header) failed for file: " << this->GetFileName());
   }
 
+  if (this->m_NiftiImage->iname_offset >= 0 && this->m_ComponentType == this->m_OnDiskComponentType &&
+      this->StoresComponentsInterleaved())
+  {
+    // NIfTI stores the pixels in the layout of the buffer, so that they are
+    // read in place, without holding another copy of the data.
+    this->ReadRegion(buffer);
+    data = buffer;
+  }
   //
   // decide whether to read whole region or subregion, by stepping
   // thru dims and comparing them to requested sizes
+  else
   {
     unsigned int i = 0;
 
@@ -681,14 +694,17 @@ NiftiImageIO::Read(void * buffer)
   if (numComponents == 1 || this->GetPixelType() == IOPixelEnum::COMPLEX || this->GetPixelType() == IOPixelEnum::RGB ||
       this->GetPixelType() == IOPixelEnum::RGBA)
   {
-    const size_t NumBytes = numElts * pixelSize;
-    memcpy(buffer, data, NumBytes);
-    //
-    // if read_subregion was called it allocates a buffer that needs to be
-    // freed.
-    if (data != this->m_NiftiImage->data)
+    if (data != buffer)
     {
-      free(data);
+      const size_t NumBytes = numElts * pixelSize;
+      memcpy(buffer, data, NumBytes);
+      //
+      // if read_subregion was called it allocates a buffer that needs to be
+      // freed.
+      if (data != this->m_NiftiImage->data)
+      {
+        free(data);
+      }
     }
   }
   else
@@ -697,10 +713,11 @@ NiftiImageIO::Read(void * buffer)
     // vec x y z t l m o
     const auto * niftibuf = (const char *)data;
     auto *       itkbuf = (char *)buffer;
-    const size_t rowdist = this->m_NiftiImage->dim[1];
-    const size_t slicedist = rowdist * this->m_NiftiImage->dim[2];
-    const size_t volumedist = slicedist * this->m_NiftiImage->dim[3];
-    const size_t seriesdist = volumedist * this->m_NiftiImage->dim[4];
+    // the data holds the region read, rather than the whole image
+    const size_t rowdist = _size[0];
+    const size_t slicedist = rowdist * _size[1];
+    const size_t volumedist = slicedist * _size[2];
+    const size_t seriesdist = volumedist * _size[3];
     //
     // as per ITK bug 0007485
     // NIfTI is lower triangular, ITK is upper triangular.
@@ -718,13 +735,13 @@ NiftiImageIO::Read(void * buffer)
         vecOrder[i] = i;
       }
     }
-    for (int t = 0; t < this->m_NiftiImage->dim[4]; ++t)
+    for (int t = 0; t < _size[3]; ++t)
     {
-      for (int z = 0; z < this->m_NiftiImage->dim[3]; ++z)
+      for (int z = 0; z < _size[2]; ++z)
       {
-        for (int y = 0; y < this->m_NiftiImage->dim[2]; ++y)
+        for (int y = 0; y < _size[1]; ++y)
         {
-          for (int x = 0; x < this->m_NiftiImage->dim[1]; ++x)
+          for (int x = 0; x < _size[0]; ++x)
           {
             for (unsigned int c = 0; c < numComponents; ++c)
             {
@@ -826,6 +843,81 @@ NiftiImageIO::Read(void * buffer)
   }
 }
 
+void
+NiftiImageIO::ReadRegion(void * buffer)
+{
+  nifti_image * nim = this->m_NiftiImage;
+  znzFile       dataFile = znzopen(nim->iname, "rb", nifti_is_gzfile(nim->iname));
+  if (znz_isnull(dataFile))
+  {
+    itkExceptionMacro("Cannot open data file: " << nim->iname);
+  }
+
+  // The runs are visited in increasing offset order, so that seeking a
+  // compressed file only skips forward.
+  const auto dataOffset = static_cast<SizeValueType>(nim->iname_offset);
+  auto *     bytes = static_cast<char *>(buffer);
+  const bool success = this->VisitIORegionRuns([&](SizeValueType position, SizeValueType sizeOfRun) {
+    if (znzseek(dataFile, static_cast<znz_off_t>(dataOffset + position), SEEK_SET) < 0)
+    {
+      return false;
+    }
+    // nifti_read_buffer() swaps the bytes and fixes non-finite floats, as
+    // when reading the whole image.
+    const auto sizeRead = nifti_read_buffer(dataFile, bytes, static_cast<size_t>(sizeOfRun), nim);
+    bytes += sizeOfRun;
+    return sizeRead == static_cast<size_t>(sizeOfRun);
+  });
+  znzclose(dataFile);
+  if (!success)
+  {
+    itkExceptionMacro("Failed to read region " << m_IORegion << " from data file: " << nim->iname);
+  }
+}
+
+bool
+NiftiImageIO::GetRawPixelDataLocation(std::string & fileName, SizeValueType & offset)
+{
+  if (this->MustRescale() || this->m_ConvertRAS || this->m_ComponentType != this->m_OnDiskComponentType ||
+      (this->GetNumberOfComponents() > 1 && this->GetPixelType() != IOPixelEnum::COMPLEX &&
+       this->GetPixelType() != IOPixelEnum::RGB && this->GetPixelType() != IOPixelEnum::RGBA))
+  {
+    return false;
+  }
+  return this->GetDataLocation(fileName, offset);
+}
+
+bool
+NiftiImageIO::StoresComponentsInterleaved() const
+{
+  const unsigned int numComponents = this->GetNumberOfComponents();
+  return numComponents == 1 || (numComponents == 2 && this->GetPixelType() == IOPixelEnum::COMPLEX) ||
+         (numComponents == 3 && this->GetPixelType() == IOPixelEnum::RGB) ||
+         (numComponents == 4 && this->GetPixelType() == IOPixelEnum::RGBA);
+}
+
+bool
+NiftiImageIO::GetDataLocation(std::string & fileName, SizeValueType & offset)
+{
+  // ReadImageInformation() does not keep the header.
+  nifti_image * nim = nifti_image_read(this->GetFileName(), false);
+  if (nim == nullptr)
+  {
+    return false;
+  }
+  const bool isRaw = nim->iname != nullptr && !nifti_is_gzfile(nim->iname) && nim->iname_offset >= 0 &&
+                     (nim->swapsize <= 1 || nim->byteorder == nifti_short_order()) &&
+                     static_cast<SizeValueType>(nim->nvox) * static_cast<SizeValueType>(nim->nbyper) ==
+                       static_cast<SizeValueType>(this->GetImageSizeInBytes());
+  if (isRaw)
+  {
+    fileName = nim->iname;
+    offset = static_cast<SizeValueType>(nim->iname_offset);
+  }
+  nifti_image_free(nim);
+  return isRaw;
+}
+
 NiftiImageIOEnums::NiftiFileEnum
 NiftiImageIO::DetermineFileType(const char * FileNameToRead)
 {
@@ -2380,15 +2472,215 @@ NiftiImageIO::SetNIfTIOrientationFromImageIO(unsigned short origdims, unsigned s
   this->m_NiftiImage->sform_code = NIFTI_XFORM_SCANNER_ANAT;
 }
 
+bool
+NiftiImageIO::CanStreamWrite()
+{
+  // The data of the ASCII variant follows a header of variable size.
+  const char * extension = nifti_find_file_extension(this->GetFileName());
+  return this->StoresComponentsInterleaved() && extension != nullptr && strcmp(extension, ".nia") != 0;
+}
+
+unsigned int
+NiftiImageIO::GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                                const ImageIORegion & pasteRegion,
+                                                const ImageIORegion & largestPossibleRegion)
+{
+  if (!this->CanStreamWrite())
+  {
+    return Superclass::GetActualNumberOfSplitsForWriting(numberOfRequestedSplits, pasteRegion, largestPossibleRegion);
+  }
+
+  if (nifti_is_gzfile(this->GetFileName()))
+  {
+    // the compressed regions are appended to the file
+    if (pasteRegion != largestPossibleRegion)
+    {
+      itkExceptionMacro("Pasting and compression is not supported! Can't write:" << this->GetFileName());
+    }
+  }
+  else if (!itksys::SystemTools::FileExists(m_FileName))
+  {
+    // the header is written with the first region
+  }
+  else if (pasteRegion != largestPossibleRegion)
+  {
+    const Pointer fileImageIO = Self::New();
+    try
+    {
+      fileImageIO->SetFileName(m_FileName);
+      fileImageIO->ReadImageInformation();
+    }
+    catch (...)
+    {
+      itkExceptionMacro("Unable to paste because pasting file exists and is different. "
+                        << "Unable to read information from file: " << m_FileName);
+    }
+    // The header stores the geometry in single precision.
+    this->VerifyPasteCompatibility(fileImageIO, 1e-5);
+  }
+  else if (numberOfRequestedSplits != 1)
+  {
+    // The header of the existing file may not match the image, so the file,
+    // or both the header and the data files, are written again from the
+    // first region.
+    const bool   singleFile = itksys::SystemTools::LowerCase(nifti_find_file_extension(m_FileName.c_str())) == ".nii";
+    const int    niftiType = singleFile ? NIFTI_FTYPE_NIFTI1_1 : NIFTI_FTYPE_NIFTI1_2;
+    char * const baseName = nifti_makebasename(m_FileName.c_str());
+    char * const fileNames[] = { nifti_makehdrname(baseName, niftiType, false, false),
+                                 nifti_makeimgname(baseName, niftiType, false, false) };
+    free(baseName);
+    bool removed = true;
+    for (char * const fileName : fileNames)
+    {
+      removed &= fileName != nullptr &&
+                 (!itksys::SystemTools::FileExists(fileName) || itksys::SystemTools::RemoveFile(fileName));
+      free(fileName);
+    }
+    if (!removed)
+    {
+      itkExceptionMacro("Unable to remove file for streaming: " << m_FileName);
+    }
+  }
+
+  return GetActualNumberOfSplitsForWritingCanStreamWrite(numberOfRequestedSplits, pasteRegion);
+}
+
+void
+NiftiImageIO::WriteRegion(const void * buffer)
+{
+  std::string dataFileName = this->m_NiftiImage->iname;
+  if (!itksys::SystemTools::FileExists(this->m_NiftiImage->fname) || !itksys::SystemTools::FileExists(dataFileName))
+  {
+    // Write the header, leaving the data file open at the start of the data.
+    znzFile dataFile = nifti_image_write_hdr_img(this->m_NiftiImage, 2, "wb");
+    if (znz_isnull(dataFile))
+    {
+      itkExceptionMacro("ERROR: nifti library failed to write image header: " << this->GetFileName());
+    }
+    znzclose(dataFile);
+
+    // Make room for the data of the whole image, into which the regions are
+    // pasted.
+    std::ofstream file;
+    this->OpenFileForWriting(file, dataFileName, false);
+    file.seekp(static_cast<std::streamoff>(this->m_NiftiImage->iname_offset) +
+                 static_cast<std::streamoff>(this->GetImageSizeInBytes()) - 1,
+               std::ios::beg);
+    file.put('\0');
+    if (file.fail())
+    {
+      itkExceptionMacro("ERROR: failed to write image data: " << dataFileName);
+    }
+  }
+
+  SizeValueType offset = 0;
+  if (!this->GetDataLocation(dataFileName, offset))
+  {
+    itkExceptionMacro("Cannot paste into " << this->GetFileName()
+                                           << ": its data is compressed or not in the byte order of this machine");
+  }
+  std::ofstream file;
+  this->OpenFileForWriting(file, dataFileName, false);
+  if (!this->WriteIORegionAsBinary(file, buffer, offset))
+  {
+    itkExceptionMacro("ERROR: failed to write region " << m_IORegion << " to " << dataFileName);
+  }
+}
+
+void
+NiftiImageIO::WriteCompressedBlocks(const void * buffer)
+{
+  SizeValueType regionOffset = 0;
+  SizeValueType regionSize = 0;
+  const bool    isRange = this->GetIORegionDataRange(regionOffset, regionSize);
+
+  const std::string          dataFileName = this->m_NiftiImage->iname;
+  std::ofstream              file;
+  std::vector<unsigned char> compressed;
+  if (regionOffset == 0)
+  {
+    m_BlockCompressor = ZlibBlockCompressor::New();
+    m_BlockCompressor->UseGzipFormatOn();
+    m_BlockCompressor->SetCompressionLevel(this->GetCompressionLevel());
+    m_BlockCompressor->StartCompression(compressed);
+    if (this->m_NiftiImage->nifti_type == NIFTI_FTYPE_NIFTI1_1)
+    {
+      // The header is compressed in front of the data, as
+      // nifti_image_write_hdr_img() writes it. ITK writes no extensions, so
+      // the extender which follows the header is zero.
+      nifti_set_iname_offset(this->m_NiftiImage);
+      const nifti_1_header       header = nifti_convert_nim2nhdr(this->m_NiftiImage);
+      std::vector<unsigned char> headerBytes(static_cast<size_t>(this->m_NiftiImage->iname_offset));
+      memcpy(headerBytes.data(), &header, sizeof(header));
+      m_BlockCompressor->CompressPiece(headerBytes.data(), headerBytes.size(), compressed);
+    }
+    else
+    {
+      // The header is written to its own file, and the data file is
+      // truncated below.
+      znzFile dataFile = nifti_image_write_hdr_img(this->m_NiftiImage, 2, "wb");
+      if (znz_isnull(dataFile))
+      {
+        itkExceptionMacro("ERROR: nifti library failed to write image header: " << this->GetFileName());
+      }
+      znzclose(dataFile);
+    }
+    this->OpenFileForWriting(file, dataFileName);
+  }
+  else
+  {
+    this->OpenFileForWriting(file, dataFileName, false);
+    file.seekp(0, std::ios::end);
+  }
+
+  const SizeValueType dataOffset = this->m_NiftiImage->nifti_type == NIFTI_FTYPE_NIFTI1_1
+                                     ? static_cast<SizeValueType>(this->m_NiftiImage->iname_offset)
+                                     : 0;
+  if (!isRange || !m_BlockCompressor || m_BlockCompressor->GetUncompressedSize() != dataOffset + regionOffset)
+  {
+    itkExceptionMacro("Compressed data can only be written in consecutive regions: " << m_IORegion);
+  }
+  m_BlockCompressor->CompressPiece(buffer, regionSize, compressed);
+  if (regionOffset + regionSize == static_cast<SizeValueType>(this->GetImageSizeInBytes()))
+  {
+    m_BlockCompressor->FinishCompression(compressed);
+    m_BlockCompressor = nullptr;
+  }
+  file.write(reinterpret_cast<const char *>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+  if (file.fail())
+  {
+    itkExceptionMacro("ERROR: failed to write compressed image data: " << dataFileName);
+  }
+}
+
 void
 NiftiImageIO::Write(const void * buffer)
 {
   // Write the image Information before writing data
   this->WriteImageInformation();
+
+  SizeValueType regionOffset = 0;
+  SizeValueType regionSize = 0;
+  this->GetIORegionDataRange(regionOffset, regionSize);
+  if (regionSize != static_cast<SizeValueType>(this->GetImageSizeInBytes()))
+  {
+    if (!this->CanStreamWrite())
+    {
+      itkExceptionMacro("Cannot write region " << m_IORegion << " of " << this->GetFileName());
+    }
+    if (nifti_is_gzfile(this->m_NiftiImage->iname))
+    {
+      this->WriteCompressedBlocks(buffer);
+    }
+    else
+    {
+      this->WriteRegion(buffer);
+    }
+    return;
+  }
+
   const unsigned int numComponents = this->GetNumberOfComponents();
-  if (numComponents == 1 || (numComponents == 2 && this->GetPixelType() == IOPixelEnum::COMPLEX) ||
-      (numComponents == 3 && this->GetPixelType() == IOPixelEnum::RGB) ||
-      (numComponents == 4 && this->GetPixelType() == IOPixelEnum::RGBA))
+  if (this->StoresComponentsInterleaved())
   {
     // Need a const cast here so that we don't have to copy the memory
     // for writing.
@@ -0,0 +1,134 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkNiftiImageIO.h"
+#include "itkVector.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template <typename TImage>
+typename TImage::PixelType
+ExpectedValue(const typename TImage::IndexType & index)
+{
+  double value = 0.0;
+  double scale = 1.0;
+  for (unsigned int i = 0; i < TImage::ImageDimension; ++i)
+  {
+    value += scale * index[i];
+    scale *= 10.0;
+  }
+  using PixelTraits = itk::DefaultConvertPixelTraits<typename TImage::PixelType>;
+  typename TImage::PixelType pixel;
+  for (unsigned int c = 0; c < PixelTraits::GetNumberOfComponents(); ++c)
+  {
+    PixelTraits::SetNthComponent(c, pixel, static_cast<typename PixelTraits::ComponentType>(value + 0.5 * c));
+  }
+  return pixel;
+}
+
+// Write an image of the given size, then read the given region of it back,
+// and check that only that region was read, with the expected pixels.
+template <typename TImage>
+bool
+WriteAndReadRegion(const std::string &                 fileName,
+                   const typename TImage::RegionType & largestRegion,
+                   const typename TImage::RegionType & regionToRead)
+{
+  const auto image = TImage::New();
+  image->SetRegions(largestRegion);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, largestRegion); !it.IsAtEnd(); ++it)
+  {
+    it.Set(ExpectedValue<TImage>(it.GetIndex()));
+  }
+  itk::WriteImage(image, fileName);
+
+  const auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetImageIO(itk::NiftiImageIO::New());
+  reader->SetFileName(fileName);
+  reader->GetOutput()->SetRequestedRegion(regionToRead);
+  reader->Update();
+
+  const TImage * output = reader->GetOutput();
+  if (output->GetBufferedRegion() != regionToRead)
+  {
+    std::cerr << "Test failed for " << fileName << '!' << std::endl;
+    std::cerr << "Expected to read region " << regionToRead << ", but read " << output->GetBufferedRegion()
+              << std::endl;
+    return false;
+  }
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(output, regionToRead); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != ExpectedValue<TImage>(it.GetIndex()))
+    {
+      std::cerr << "Test failed for " << fileName << '!' << std::endl;
+      std::cerr << "Expected " << ExpectedValue<TImage>(it.GetIndex()) << " at " << it.GetIndex() << ", but got "
+                << it.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkNiftiImageIOStreamingReadTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  ITK_TEST_EXPECT_TRUE(itk::NiftiImageIO::New()->CanStreamRead());
+
+  bool success = true;
+
+  // Read a slab of a time series, and a region which is not contiguous in
+  // the data, from uncompressed and gzip compressed files.
+  using SeriesType = itk::Image<short, 4>;
+  const SeriesType::RegionType seriesRegion(SeriesType::SizeType{ { 7, 6, 5, 4 } });
+  const SeriesType::RegionType slabRegion({ { 0, 0, 0, 2 } }, { { 7, 6, 5, 1 } });
+  const SeriesType::RegionType blockRegion({ { 1, 2, 1, 1 } }, { { 4, 3, 2, 2 } });
+  for (const char * extension : { ".nii", ".nii.gz", ".hdr", ".img.gz" })
+  {
+    const std::string fileName = outputDirectory + "/itkNiftiImageIOStreamingReadTest" + extension;
+    for (const auto & region : { slabRegion, blockRegion, seriesRegion })
+    {
+      ITK_TRY_EXPECT_NO_EXCEPTION(success &= WriteAndReadRegion<SeriesType>(fileName, seriesRegion, region));
+    }
+  }
+
+  // The components of vectors are stored in separate volumes.
+  using VectorImageType = itk::Image<itk::Vector<float, 2>, 3>;
+  const VectorImageType::RegionType vectorImageRegion(VectorImageType::SizeType{ { 6, 5, 4 } });
+  const VectorImageType::RegionType vectorBlockRegion({ { 1, 1, 2 } }, { { 3, 2, 2 } });
+  ITK_TRY_EXPECT_NO_EXCEPTION(success &= WriteAndReadRegion<VectorImageType>(
+                                outputDirectory + "/itkNiftiImageIOStreamingReadTestVector.nii",
+                                vectorImageRegion,
+                                vectorBlockRegion));
+
+  std::cout << "Test finished." << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
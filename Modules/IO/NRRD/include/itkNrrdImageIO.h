@@ -21,7 +21,9 @@
 
 
 #include "itkImageIOBase.h"
+#include "itkZlibBlockCompressor.h"
 #include <fstream>
+#include <vector>
 
 struct NrrdEncoding_t;
 
@@ -38,6 +40,18 @@ namespace itk
  * "bzip2".  Only the "gzip" compressor support the compression level
  * in the range 0-9.
  *
+ * Data compressed with "gzip" is deflated in blocks on multiple threads by
+ * a ZlibBlockCompressor, and its block index is recorded as a key/value
+ * pair of the header, so that it is inflated on multiple threads as well.
+ * The data remains a single gzip stream, which other NRRD readers read as
+ * usual.
+ *
+ * Raw data in the byte order of this machine is written in streamed
+ * regions, and regions can be pasted into existing files with such data.
+ * Gzip compressed data is written in consecutive streamed regions, each of
+ * which is compressed as it arrives, and the file is written once the last
+ * one is compressed.
+ *
  *  \ingroup IOFilters
  * \ingroup ITKIONRRD
  */
@@ -78,6 +92,12 @@ public:
   void
   Read(void * buffer) override;
 
+  /** The pixel data is mapped in place when it has the raw encoding, is in
+   * the byte order of this machine, is attached to the header or in a single
+   * data file, and has its non-scalar axis, if any, first. */
+  bool
+  GetRawPixelDataLocation(std::string & fileName, SizeValueType & offset) override;
+
   /** Determine the file type. Returns true if this ImageIO can write the
    * file specified. */
   bool
@@ -87,11 +107,24 @@ public:
   void
   WriteImageInformation() override;
 
+  /** Determine if the ImageIO can stream writing to this file: raw data
+   * in the byte order of this machine can be streamed and pasted into, and
+   * gzip compressed data can be streamed in consecutive regions. */
+  bool
+  CanStreamWrite() override;
+
   /** Writes the data to disk from the memory buffer provided. Make sure
    * that the IORegions has been set properly. */
   void
   Write(const void * buffer) override;
 
+  /** Check that a file to paste into has raw data which matches the image
+   * written, and remove the file before streaming the whole image. */
+  unsigned int
+  GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion) override;
+
 protected:
   NrrdImageIO();
   ~NrrdImageIO() override;
@@ -110,6 +143,46 @@ protected:
   NrrdToITKComponentType(const int) const;
 
   const NrrdEncoding_t * m_NrrdCompressionEncoding{ nullptr };
+
+private:
+  /** Find the file and the offset at which data in the given encoding
+   * starts, when the data can be read without any conversion. */
+  bool
+  GetDataLocation(const NrrdEncoding_t * encoding, std::string & fileName, SizeValueType & offset);
+
+  /** Read gzip compressed data which has a block index on multiple threads.
+   * Returns false when the data must be read by NrrdIO instead. */
+  bool
+  ReadCompressedBlocks(void * buffer);
+
+  /** Whether the data written is gzip compressed. */
+  bool
+  IsWritingGzipData() const;
+
+  /** Write the header, and either the data or, when writeData is false,
+   * room for the raw data of the whole image, into which regions are
+   * pasted. Gzip compressed data is compressed here unless it was compressed
+   * region by region. */
+  void
+  WriteFile(const void * buffer, bool writeData);
+
+  /** Paste the region to write into the raw data of the file, writing the
+   * header first when the file does not exist. */
+  void
+  WriteRegion(const void * buffer);
+
+  /** Compress the region to write, which must follow the regions written
+   * before, on multiple threads. Once the last region is compressed, write
+   * the file. */
+  void
+  WriteCompressedBlocks(const void * buffer);
+
+  /** The block index of the compressed data of the file read. */
+  std::string m_CompressedDataBlocks{};
+
+  /** The compression of the data written, until its last region. */
+  ZlibBlockCompressor::Pointer m_BlockCompressor{};
+  std::vector<unsigned char>   m_CompressedData{};
 };
 } // end namespace itk
 
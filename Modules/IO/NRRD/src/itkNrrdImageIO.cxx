@@ -22,7 +22,10 @@
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
 #include "itkFloatingPointExceptions.h"
+#include "itkZlibBlockCompressor.h"
+#include "itksys/SystemTools.hxx"
 
+#include <cstdio>
 #include <sstream>
 
 namespace itk
@@ -264,6 +267,7 @@ NrrdImageIO::ReadImageInformation()
   // image origin
   // meta data dictionary information
 
+  m_CompressedDataBlocks.clear();
   Nrrd *        nrrd = nrrdNew();
   NrrdIoState * nio = nrrdIoStateNew();
 
@@ -591,7 +595,15 @@ NrrdImageIO::ReadImageInformation()
     for (unsigned int kvpi = 0; kvpi < nrrdKeyValueSize(nrrd); ++kvpi)
     {
       nrrdKeyValueIndex(nrrd, &keyPtr, &valPtr, kvpi);
-      EncapsulateMetaData<std::string>(thisDic, std::string(keyPtr), std::string(valPtr));
+      if (!strcmp(keyPtr, ZlibBlockCompressor::BlockIndexKey))
+      {
+        // The block index describes the data of this file only.
+        m_CompressedDataBlocks = valPtr;
+      }
+      else
+      {
+        EncapsulateMetaData<std::string>(thisDic, std::string(keyPtr), std::string(valPtr));
+      }
       keyPtr = (char *)airFree(keyPtr);
       valPtr = (char *)airFree(valPtr);
     }
@@ -715,6 +727,11 @@ NrrdImageIO::ReadImageInformation()
 void
 NrrdImageIO::Read(void * buffer)
 {
+  if (this->ReadCompressedBlocks(buffer))
+  {
+    return;
+  }
+
   Nrrd * nrrd = nrrdNew();
   bool   nrrdAllocated;
 
@@ -852,6 +869,124 @@ NrrdImageIO::Read(void * buffer)
   }
 }
 
+bool
+NrrdImageIO::GetRawPixelDataLocation(std::string & fileName, SizeValueType & offset)
+{
+  if (IOPixelEnum::SYMMETRICSECONDRANKTENSOR == this->GetPixelType())
+  {
+    // The data may be a masked symmetric matrix, whose mask Read() crops out.
+    return false;
+  }
+  return this->GetDataLocation(nrrdEncodingRaw, fileName, offset);
+}
+
+bool
+NrrdImageIO::GetDataLocation(const NrrdEncoding_t * encoding, std::string & fileName, SizeValueType & offset)
+{
+  Nrrd *        nrrd = nrrdNew();
+  NrrdIoState * nio = nrrdIoStateNew();
+
+  // nrrd causes exceptions on purpose, so mask them
+  bool saveFPEState(false);
+  if (FloatingPointExceptions::HasFloatingPointExceptionsSupport())
+  {
+    saveFPEState = FloatingPointExceptions::GetEnabled();
+    FloatingPointExceptions::Disable();
+  }
+
+  // Read just the header, and keep the data file open at the start of the
+  // data, after any line and byte skipping.
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
+  bool found = false;
+  if (nrrdLoad(nrrd, this->GetFileName(), nio) != 0)
+  {
+    free(biffGetDone(NRRD));
+  }
+  else
+  {
+    unsigned int       rangeAxisIdx[NRRD_DIM_MAX];
+    const unsigned int rangeAxisNum = nrrdRangeAxesGet(nrrd, rangeAxisIdx);
+    // The byte skip of compressed data applies to the decompressed data.
+    found = nio->dataFile != nullptr && nio->dataFile != stdin && nio->dataFNFormat == nullptr &&
+            nio->dataFNArr->len <= 1 && nio->encoding == encoding &&
+            (!encoding->isCompression || 0 == nio->byteSkip) &&
+            (0 == rangeAxisNum || (1 == rangeAxisNum && 0 == rangeAxisIdx[0])) &&
+            (nrrdElementSize(nrrd) <= 1 || nio->endian == airMyEndian()) &&
+            nrrdElementSize(nrrd) * nrrdElementNumber(nrrd) == static_cast<size_t>(this->GetImageSizeInBytes());
+    if (found)
+    {
+#if defined(_WIN32)
+      const auto position = _ftelli64(nio->dataFile);
+#else
+      const auto position = ftello(nio->dataFile);
+#endif
+      if (0 == nio->dataFNArr->len)
+      {
+        // The data is attached to the header.
+        fileName = this->GetFileName();
+      }
+      else
+      {
+        fileName = itksys::SystemTools::CollapseFullPath(
+          nio->dataFN[0], itksys::SystemTools::GetFilenamePath(this->GetFileName()));
+      }
+      offset = static_cast<SizeValueType>(position);
+      found = position >= 0;
+    }
+  }
+  if (nio->dataFile != nullptr && nio->dataFile != stdin)
+  {
+    fclose(nio->dataFile);
+    nio->dataFile = nullptr;
+  }
+
+  // restore state
+  if (FloatingPointExceptions::HasFloatingPointExceptionsSupport())
+  {
+    FloatingPointExceptions::SetEnabled(saveFPEState);
+  }
+
+  nrrdNix(nrrd);
+  nrrdIoStateNix(nio);
+  return found;
+}
+
+bool
+NrrdImageIO::ReadCompressedBlocks(void * buffer)
+{
+  if (m_CompressedDataBlocks.empty() || IOPixelEnum::SYMMETRICSECONDRANKTENSOR == this->GetPixelType())
+  {
+    return false;
+  }
+
+  const auto    compressor = ZlibBlockCompressor::New();
+  std::string   fileName;
+  SizeValueType offset = 0;
+  if (!compressor->SetBlockIndex(m_CompressedDataBlocks) || !this->GetDataLocation(nrrdEncodingGzip, fileName, offset))
+  {
+    return false;
+  }
+
+  // The compressed data ends the file.
+  const SizeValueType fileLength = itksys::SystemTools::FileLength(fileName);
+  if (fileLength <= offset)
+  {
+    return false;
+  }
+  const SizeValueType compressedSize = fileLength - offset;
+  std::ifstream       file;
+  this->OpenFileForReading(file, fileName);
+  file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+  std::vector<unsigned char> compressed(compressedSize);
+  if (!this->ReadBufferAsBinary(file, compressed.data(), compressedSize))
+  {
+    return false;
+  }
+  return compressor->Decompress(
+    compressed.data(), compressedSize, buffer, static_cast<SizeValueType>(this->GetImageSizeInBytes()));
+}
+
 bool
 NrrdImageIO::CanWriteFile(const char * name)
 {
@@ -886,8 +1021,157 @@ _dump_metadata_to_stream(MetaDataDictionary & thisDic, const std::string & key,
   return false;
 }
 
+bool
+NrrdImageIO::CanStreamWrite()
+{
+  if (this->GetUseCompression() && this->m_NrrdCompressionEncoding != nullptr &&
+      this->m_NrrdCompressionEncoding->available())
+  {
+    return this->IsWritingGzipData();
+  }
+  // Regions are pasted into raw data in place, without swapping bytes.
+  const IOByteOrderEnum byteOrder = this->GetByteOrder();
+  return this->GetFileType() != IOFileEnum::ASCII &&
+         (byteOrder == IOByteOrderEnum::OrderNotApplicable ||
+          byteOrder == (airEndianBig == airMyEndian() ? IOByteOrderEnum::BigEndian : IOByteOrderEnum::LittleEndian));
+}
+
+bool
+NrrdImageIO::IsWritingGzipData() const
+{
+  return this->GetUseCompression() && nrrdEncodingGzip == this->m_NrrdCompressionEncoding &&
+         nrrdEncodingGzip->available();
+}
+
+unsigned int
+NrrdImageIO::GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                               const ImageIORegion & pasteRegion,
+                                               const ImageIORegion & largestPossibleRegion)
+{
+  if (!this->CanStreamWrite())
+  {
+    return Superclass::GetActualNumberOfSplitsForWriting(numberOfRequestedSplits, pasteRegion, largestPossibleRegion);
+  }
+
+  if (this->IsWritingGzipData())
+  {
+    // the file is only written once the last region is compressed
+    if (pasteRegion != largestPossibleRegion)
+    {
+      itkExceptionMacro("Pasting and compression is not supported! Can't write:" << this->GetFileName());
+    }
+  }
+  else if (!itksys::SystemTools::FileExists(m_FileName))
+  {
+    // the header is written with the first region
+  }
+  else if (pasteRegion != largestPossibleRegion)
+  {
+    const Pointer fileImageIO = Self::New();
+    try
+    {
+      fileImageIO->SetFileName(m_FileName);
+      fileImageIO->ReadImageInformation();
+    }
+    catch (...)
+    {
+      itkExceptionMacro("Unable to paste because pasting file exists and is different. "
+                        << "Unable to read information from file: " << m_FileName);
+    }
+    this->VerifyPasteCompatibility(fileImageIO);
+  }
+  else if (numberOfRequestedSplits != 1)
+  {
+    // The header of the existing file may not match the image, so the file
+    // is written again from its first region.
+    if (!itksys::SystemTools::RemoveFile(m_FileName))
+    {
+      itkExceptionMacro("Unable to remove file for streaming: " << m_FileName);
+    }
+  }
+
+  return GetActualNumberOfSplitsForWritingCanStreamWrite(numberOfRequestedSplits, pasteRegion);
+}
+
 void
 NrrdImageIO::Write(const void * buffer)
+{
+  SizeValueType regionOffset = 0;
+  SizeValueType regionSize = 0;
+  this->GetIORegionDataRange(regionOffset, regionSize);
+  if (regionSize == static_cast<SizeValueType>(this->GetImageSizeInBytes()))
+  {
+    this->WriteFile(buffer, true);
+  }
+  else if (!this->CanStreamWrite())
+  {
+    itkExceptionMacro("Write: Cannot write region " << m_IORegion << " of " << this->GetFileName()
+                                                    << " with its encoding and byte order");
+  }
+  else if (this->IsWritingGzipData())
+  {
+    this->WriteCompressedBlocks(buffer);
+  }
+  else
+  {
+    this->WriteRegion(buffer);
+  }
+}
+
+void
+NrrdImageIO::WriteRegion(const void * buffer)
+{
+  if (!itksys::SystemTools::FileExists(m_FileName))
+  {
+    this->WriteFile(buffer, false);
+  }
+
+  std::string   dataFileName;
+  SizeValueType offset = 0;
+  if (!this->GetDataLocation(nrrdEncodingRaw, dataFileName, offset))
+  {
+    itkExceptionMacro("Write: Cannot paste into " << this->GetFileName()
+                                                  << ": its data is not raw, in a single file, and in the byte order "
+                                                     "of this machine");
+  }
+  std::ofstream file;
+  this->OpenFileForWriting(file, dataFileName, false);
+  if (!this->WriteIORegionAsBinary(file, buffer, offset))
+  {
+    itkExceptionMacro("Write: Error writing region " << m_IORegion << " to " << dataFileName);
+  }
+}
+
+void
+NrrdImageIO::WriteCompressedBlocks(const void * buffer)
+{
+  SizeValueType regionOffset = 0;
+  SizeValueType regionSize = 0;
+  const bool    isRange = this->GetIORegionDataRange(regionOffset, regionSize);
+
+  if (regionOffset == 0)
+  {
+    m_BlockCompressor = ZlibBlockCompressor::New();
+    m_BlockCompressor->UseGzipFormatOn();
+    m_BlockCompressor->SetCompressionLevel(this->GetCompressionLevel());
+    m_CompressedData.clear();
+    m_BlockCompressor->StartCompression(m_CompressedData);
+  }
+  if (!isRange || !m_BlockCompressor || m_BlockCompressor->GetUncompressedSize() != regionOffset)
+  {
+    itkExceptionMacro("Compressed data can only be written in consecutive regions: " << m_IORegion);
+  }
+  m_BlockCompressor->CompressPiece(buffer, regionSize, m_CompressedData);
+  if (regionOffset + regionSize < static_cast<SizeValueType>(this->GetImageSizeInBytes()))
+  {
+    return;
+  }
+  m_BlockCompressor->FinishCompression(m_CompressedData);
+  this->WriteFile(buffer, true);
+}
+
+void
+NrrdImageIO::WriteFile(const void * buffer, bool writeData)
 {
   Nrrd *        nrrd = nrrdNew();
   NrrdIoState * nio = nrrdIoStateNew();
@@ -975,6 +1259,10 @@ NrrdImageIO::Write(const void * buffer)
   const std::vector<std::string> keys = thisDic.GetKeys();
   for (const auto & key : keys)
   {
+    if (key == ZlibBlockCompressor::BlockIndexKey)
+    {
+      continue;
+    }
     if (!strncmp(KEY_PREFIX, key.c_str(), strlen(KEY_PREFIX)))
     {
       const char * keyField = key.c_str() + strlen(KEY_PREFIX);
@@ -1102,12 +1390,31 @@ NrrdImageIO::Write(const void * buffer)
   }
 
   // set encoding for data: compressed (raw), (uncompressed) raw, or ascii
+  std::vector<unsigned char> compressed;
   if (this->GetUseCompression() && this->m_NrrdCompressionEncoding != nullptr &&
       this->m_NrrdCompressionEncoding->available())
   {
     nio->encoding = this->m_NrrdCompressionEncoding;
     nio->zlibLevel = this->GetCompressionLevel();
     // nio->zlibStrategy = default
+    if (nrrdEncodingGzip == nio->encoding)
+    {
+      // Deflate the data on multiple threads here, unless its regions were
+      // deflated as they were written, and let nrrd write just the header.
+      ZlibBlockCompressor::Pointer compressor = m_BlockCompressor;
+      m_BlockCompressor = nullptr;
+      compressed = std::move(m_CompressedData);
+      m_CompressedData.clear();
+      if (!compressor)
+      {
+        compressor = ZlibBlockCompressor::New();
+        compressor->UseGzipFormatOn();
+        compressor->SetCompressionLevel(this->GetCompressionLevel());
+        compressor->Compress(buffer, static_cast<SizeValueType>(this->GetImageSizeInBytes()), compressed);
+      }
+      nrrdKeyValueAdd(nrrd, ZlibBlockCompressor::BlockIndexKey, compressor->GetBlockIndex().c_str());
+      nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+    }
   }
   else
   {
@@ -1123,6 +1430,10 @@ NrrdImageIO::Write(const void * buffer)
         nio->encoding = nrrdEncodingAscii;
         break;
     }
+    if (!writeData)
+    {
+      nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+    }
   }
 
   // set desired endianness of output
@@ -1148,9 +1459,45 @@ NrrdImageIO::Write(const void * buffer)
     itkExceptionMacro("Write: Error writing " << this->GetFileName() << ":\n" << err);
   }
 
+  // The data follows the header, or is in the data file it names.
+  const bool        skipData = nio->skipData;
+  const std::string filePath = itksys::SystemTools::GetFilenamePath(this->GetFileName());
+  const std::string dataFileName =
+    0 == nio->dataFNArr->len ? this->GetFileName() : itksys::SystemTools::CollapseFullPath(nio->dataFN[0], filePath);
+
   // Free the nrrd struct but don't touch nrrd->data
   nrrdNix(nrrd);
   nrrdIoStateNix(nio);
+
+  if (!skipData)
+  {
+    return;
+  }
+  std::ofstream file;
+  if (dataFileName == this->GetFileName())
+  {
+    this->OpenFileForWriting(file, dataFileName, false);
+    file.seekp(0, std::ios::end);
+  }
+  else
+  {
+    this->OpenFileForWriting(file, dataFileName);
+  }
+  if (writeData)
+  {
+    file.write(reinterpret_cast<const char *>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+  }
+  else
+  {
+    // Make room for the raw data of the whole image, into which the regions
+    // are pasted.
+    file.seekp(static_cast<std::streamoff>(this->GetImageSizeInBytes()) - 1, std::ios::cur);
+    file.put('\0');
+  }
+  if (file.fail())
+  {
+    itkExceptionMacro("Write: Error writing data to " << dataFileName);
+  }
 }
 
 } // end namespace itk
@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageSource.h"
+#include "itkNrrdImageIO.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+
+short
+ExpectedValue(const ImageType::IndexType & index)
+{
+  return static_cast<short>(index[0] + 10 * index[1] + 100 * index[2]);
+}
+
+// Generates the pixels of the requested region only, so that writers
+// stream it.
+class IndexImageSource : public itk::ImageSource<ImageType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(IndexImageSource);
+
+  using Self = IndexImageSource;
+  using Superclass = itk::ImageSource<ImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(IndexImageSource);
+
+  itkSetMacro(Region, ImageType::RegionType);
+  itkGetConstMacro(NumberOfGeneratedRegions, unsigned int);
+
+protected:
+  IndexImageSource() = default;
+  ~IndexImageSource() override = default;
+
+  void
+  GenerateOutputInformation() override
+  {
+    this->GetOutput()->SetLargestPossibleRegion(m_Region);
+  }
+
+  void
+  GenerateData() override
+  {
+    ImageType * output = this->GetOutput();
+    output->SetBufferedRegion(output->GetRequestedRegion());
+    output->Allocate();
+    for (itk::ImageRegionIteratorWithIndex<ImageType> it(output, output->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+    {
+      it.Set(ExpectedValue(it.GetIndex()));
+    }
+    ++m_NumberOfGeneratedRegions;
+  }
+
+private:
+  ImageType::RegionType m_Region{};
+  unsigned int          m_NumberOfGeneratedRegions{ 0 };
+};
+
+// Write the image in the given number of stream divisions, pasting it into
+// the given region only when the region is not empty. Returns the number of
+// regions written.
+unsigned int
+WriteImage(const ImageType::RegionType & largestRegion,
+           const std::string &           fileName,
+           bool                          useCompression,
+           unsigned int                  numberOfStreamDivisions,
+           const ImageType::RegionType & pasteRegion = ImageType::RegionType())
+{
+  const auto source = IndexImageSource::New();
+  source->SetRegion(largestRegion);
+  const auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetImageIO(itk::NrrdImageIO::New());
+  writer->SetFileName(fileName);
+  writer->SetInput(source->GetOutput());
+  writer->SetUseCompression(useCompression);
+  writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  if (pasteRegion.GetNumberOfPixels() > 0)
+  {
+    itk::ImageIORegion ioRegion(ImageType::ImageDimension);
+    itk::ImageIORegionAdaptor<ImageType::ImageDimension>::Convert(pasteRegion, ioRegion, largestRegion.GetIndex());
+    writer->SetIORegion(ioRegion);
+  }
+  writer->Update();
+  return source->GetNumberOfGeneratedRegions();
+}
+
+// Read the image back and check that the pixels of the given region have
+// their expected value, and all others are zero.
+bool
+CheckImage(const std::string & fileName, const ImageType::RegionType & writtenRegion)
+{
+  const ImageType::Pointer image = itk::ReadImage<ImageType>(fileName);
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    const short expected = writtenRegion.IsInside(it.GetIndex()) ? ExpectedValue(it.GetIndex()) : 0;
+    if (it.Get() != expected)
+    {
+      std::cerr << "Test failed for " << fileName << '!' << std::endl;
+      std::cerr << "Expected " << expected << " at " << it.GetIndex() << ", but got " << it.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkNrrdImageIOStreamingWriteTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  const ImageType::RegionType largestRegion(ImageType::SizeType{ { 7, 5, 6 } });
+
+  const auto imageIO = itk::NrrdImageIO::New();
+  ITK_TEST_EXPECT_TRUE(imageIO->CanStreamWrite());
+  imageIO->SetFileType(itk::IOFileEnum::ASCII);
+  ITK_TEST_EXPECT_TRUE(!imageIO->CanStreamWrite());
+  imageIO->SetFileType(itk::IOFileEnum::Binary);
+  imageIO->SetUseCompression(true);
+  ITK_TEST_EXPECT_TRUE(imageIO->CanStreamWrite());
+
+  bool success = true;
+
+  // Stream raw data attached to the header, and in a detached data file.
+  for (const char * extension : { ".nrrd", ".nhdr" })
+  {
+    const std::string fileName = outputDirectory + "/itkNrrdImageIOStreamingWriteTest" + extension;
+    ITK_TEST_EXPECT_EQUAL(WriteImage(largestRegion, fileName, false, 3), 3);
+    success &= CheckImage(fileName, largestRegion);
+  }
+
+  // Stream gzip compressed data, compressing each region as it arrives.
+  const std::string compressedFileName = outputDirectory + "/itkNrrdImageIOStreamingWriteTestCompressed.nrrd";
+  ITK_TEST_EXPECT_EQUAL(WriteImage(largestRegion, compressedFileName, true, 3), 3);
+  success &= CheckImage(compressedFileName, largestRegion);
+
+  // Paste a region into an existing file, in two divisions.
+  const std::string pasteFileName = outputDirectory + "/itkNrrdImageIOStreamingWriteTestPaste.nrrd";
+  const auto        zeros = ImageType::New();
+  zeros->SetRegions(largestRegion);
+  zeros->Allocate(true);
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(zeros, pasteFileName));
+  const ImageType::RegionType pasteRegion({ { 2, 1, 1 } }, { { 3, 3, 4 } });
+  ITK_TEST_EXPECT_EQUAL(WriteImage(largestRegion, pasteFileName, false, 2, pasteRegion), 2);
+  success &= CheckImage(pasteFileName, pasteRegion);
+
+  // Pasting into compressed data is not supported.
+  ITK_TRY_EXPECT_EXCEPTION(WriteImage(largestRegion, compressedFileName, true, 1, pasteRegion));
+
+  std::cout << "Test finished." << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
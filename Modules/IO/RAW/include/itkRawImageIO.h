@@ -123,6 +123,11 @@ public:
   void
   Read(void * buffer) override;
 
+  /** The pixel data is mapped in place when the file is binary and in the
+   * byte order of this machine. */
+  bool
+  GetRawPixelDataLocation(std::string & fileName, SizeValueType & offset) override;
+
   /** Set/Get the Data mask. */
   itkGetConstReferenceMacro(ImageMask, unsigned short);
   void
@@ -161,6 +161,25 @@ RawImageIO<TPixel, VImageDimension>::Read(void * buffer)
   ReadRawBytesAfterSwapping(componentType, buffer, m_ByteOrder, numberOfComponents);
 }
 
+template <typename TPixel, unsigned int VImageDimension>
+bool
+RawImageIO<TPixel, VImageDimension>::GetRawPixelDataLocation(std::string & fileName, SizeValueType & offset)
+{
+  if (m_FileType != IOFileEnum::Binary)
+  {
+    return false;
+  }
+  if (sizeof(ComponentType) > 1 &&
+      ((m_ByteOrder == IOByteOrderEnum::BigEndian && ByteSwapperType::SystemIsLittleEndian()) ||
+       (m_ByteOrder == IOByteOrderEnum::LittleEndian && ByteSwapperType::SystemIsBigEndian())))
+  {
+    return false;
+  }
+  fileName = m_FileName;
+  offset = this->GetHeaderSize();
+  return true;
+}
+
 template <typename TPixel, unsigned int VImageDimension>
 bool
 RawImageIO<TPixel, VImageDimension>::CanWriteFile(const char * fname)
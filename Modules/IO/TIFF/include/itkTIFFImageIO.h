@@ -26,6 +26,7 @@ namespace itk
 {
 // BTX
 class TIFFReaderInternal;
+class TIFFWriterInternal;
 // ETX
 
 /**
@@ -38,6 +39,16 @@ class TIFFReaderInternal;
  * supports the compression level for JPEG quality parameter in the
  * range 0-100.
  *
+ * Regions of 2D images are read without decoding the strips or tiles
+ * which do not overlap them. The lower resolution levels of a pyramid,
+ * stored either in sub-IFDs or as reduced resolution subfiles, are read
+ * as separate images by selecting their ResolutionLevel.
+ *
+ * Images are written in strips of rows, or in square tiles when a
+ * TileSize is set. 2D images are written in streamed regions of whole
+ * rows, each of which is compressed and appended to the file as it
+ * arrives.
+ *
  * \ingroup IOFilters
  * \ingroup ITKIOTIFF
  *
@@ -83,6 +94,30 @@ public:
   virtual void
   ReadVolume(void * buffer);
 
+  /** Determine if the ImageIO can stream reading from this file: regions of
+   * 2D images read by the native reader are streamed. */
+  bool
+  CanStreamRead() override
+  {
+    return true;
+  }
+
+  /** Calculate the region of the image that can be efficiently read
+   *  in response to a given requested region. */
+  ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const override;
+
+  /** Set/Get the resolution level of a pyramid to read. Level 0, the
+   * default, is the full resolution image; the next levels are the lower
+   * resolution images, in the order in which the file stores them. Must be
+   * set before reading the image information. */
+  itkSetMacro(ResolutionLevel, unsigned int);
+  itkGetConstMacro(ResolutionLevel, unsigned int);
+
+  /** Get the number of resolution levels of the file, read with the image
+   * information. */
+  itkGetConstMacro(NumberOfResolutionLevels, unsigned int);
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -95,11 +130,27 @@ public:
   void
   WriteImageInformation() override;
 
+  /** Determine if the ImageIO can stream writing: 2D images are written in
+   * consecutive regions of whole rows. Pasting is not supported. */
+  bool
+  CanStreamWrite() override;
+
   /** Writes the data to disk from the memory buffer provided. Make sure
    * that the IORegion has been set properly. */
   void
   Write(const void * buffer) override;
 
+  unsigned int
+  GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion) override;
+
+  /** Set/Get the size of the square tiles in which the image is written,
+   * which must be a multiple of 16. The default, 0, writes strips of rows
+   * instead. */
+  itkSetMacro(TileSize, unsigned int);
+  itkGetConstMacro(TileSize, unsigned int);
+
   enum
   {
     NOFORMAT,
@@ -210,6 +261,14 @@ protected:
   void
   InternalWrite(const void * buffer);
 
+  // Open the file written, in the BigTIFF format when the image is large.
+  void
+  OpenTIFFForWriting();
+
+  // Set the fields of the directory of the given page of the file written.
+  void
+  WriteDirectoryFields(uint16_t page, uint16_t pages);
+
   void
   InitializeColors();
 
@@ -255,9 +314,18 @@ private:
   void
   ReadCurrentPage(void * buffer, size_t pixelOffset);
 
+  // Read the given region of the current page.
+  void
+  ReadGenericRegion(void * out, uint32_t xStart, uint32_t yStart, uint32_t regionWidth, uint32_t regionHeight);
+
   template <typename TComponent>
   void
-  ReadGenericImage(void * _out, unsigned int width, unsigned int height);
+  ReadGenericRegion(void * _out, uint32_t xStart, uint32_t yStart, uint32_t regionWidth, uint32_t regionHeight);
+
+  // Write the rows of the region to write, opening the file with the first
+  // region and closing it with the last one.
+  void
+  WriteRegion(const void * buffer);
 
   template <typename TComponent>
   void
@@ -309,6 +377,13 @@ private:
   uint16_t *   m_ColorBlue{};
   uint64_t     m_TotalColors{ 0 };
   unsigned int m_ImageFormat{ TIFFImageIO::NOFORMAT };
+
+  unsigned int m_ResolutionLevel{ 0 };
+  unsigned int m_NumberOfResolutionLevels{ 1 };
+  bool         m_CanReadRegions{ false };
+
+  unsigned int         m_TileSize{ 0 };
+  TIFFWriterInternal * m_InternalWriter{};
 };
 } // end namespace itk
 
@@ -18,15 +18,142 @@
 
 #include "itkTIFFImageIO.h"
 #include "itkTIFFReaderInternal.h"
+#include "itkTIFFWriterInternal.h"
 #include "itksys/SystemTools.hxx"
 #include "itkMetaDataObject.h"
 #include "itkMakeUniqueForOverwrite.h"
 
 #include "itk_tiff.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 namespace itk
 {
 
+namespace
+{
+// Compute the spacing from the resolution of the current directory.
+// Returns false, leaving the spacing unchanged, when the directory has no
+// resolution.
+bool
+ResolutionToSpacing(const TIFFReaderInternal & image, double & spacingX, double & spacingY)
+{
+  if (image.m_ResolutionUnit > 0 && image.m_XResolution > 0 && image.m_YResolution > 0)
+  {
+    if (image.m_ResolutionUnit == 2) // inches
+    {
+      spacingX = 25.4 / static_cast<double>(image.m_XResolution);
+      spacingY = 25.4 / static_cast<double>(image.m_YResolution);
+      return true;
+    }
+    if (image.m_ResolutionUnit == 3) // cm
+    {
+      spacingX = 10.0 / static_cast<double>(image.m_XResolution);
+      spacingY = 10.0 / static_cast<double>(image.m_YResolution);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Reads the rows of a range of columns of the current directory, decoding
+// only the strips or tiles which hold them. Rows read in increasing order
+// decode each strip or tile once.
+class TIFFColumnRangeReader
+{
+public:
+  TIFFColumnRangeReader(TIFF * tif, uint32_t firstColumn, uint32_t numberOfColumns, size_t pixelSize)
+    : m_Image(tif)
+    , m_FirstColumn(firstColumn)
+    , m_NumberOfColumns(numberOfColumns)
+    , m_PixelSize(pixelSize)
+  {
+    TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &m_Height);
+    if (TIFFIsTiled(tif) && TIFFGetField(tif, TIFFTAG_TILEWIDTH, &m_TileWidth) &&
+        TIFFGetField(tif, TIFFTAG_TILELENGTH, &m_TileHeight))
+    {
+      m_Tile.resize(static_cast<size_t>(TIFFTileSize64(tif)));
+      m_Rows.resize(m_PixelSize * numberOfColumns * m_TileHeight);
+    }
+    else
+    {
+      // A strip is decoded whole: rows of compressed strips cannot be read
+      // out of order.
+      m_TileWidth = 0;
+      if (!TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &m_StripHeight) || m_StripHeight > m_Height)
+      {
+        m_StripHeight = m_Height;
+      }
+      m_ScanlineSize = static_cast<size_t>(TIFFScanlineSize64(tif));
+      m_Rows.resize(m_ScanlineSize * m_StripHeight);
+    }
+  }
+
+  // Returns the first pixel of the range in the given row, or nullptr when
+  // the row cannot be read.
+  void *
+  ReadRow(uint32_t row)
+  {
+    if (m_TileWidth == 0)
+    {
+      const uint32_t firstRow = row - row % m_StripHeight;
+      if (firstRow != m_FirstRowOfBand)
+      {
+        if (TIFFReadEncodedStrip(m_Image, TIFFComputeStrip(m_Image, row, 0), m_Rows.data(), -1) < 0)
+        {
+          m_FirstRowOfBand = UINT32_MAX;
+          return nullptr;
+        }
+        m_FirstRowOfBand = firstRow;
+      }
+      return m_Rows.data() + m_ScanlineSize * (row - firstRow) + m_PixelSize * m_FirstColumn;
+    }
+
+    // Decode the row of tiles holding the row, once for all of its rows.
+    const uint32_t firstRow = row - row % m_TileHeight;
+    if (firstRow != m_FirstRowOfBand)
+    {
+      const uint32_t numberOfRows = std::min(m_TileHeight, m_Height - firstRow);
+      const uint32_t endColumn = m_FirstColumn + m_NumberOfColumns;
+      for (uint32_t x = m_FirstColumn - m_FirstColumn % m_TileWidth; x < endColumn; x += m_TileWidth)
+      {
+        if (TIFFReadTile(m_Image, m_Tile.data(), x, firstRow, 0, 0) < 0)
+        {
+          m_FirstRowOfBand = UINT32_MAX;
+          return nullptr;
+        }
+        const uint32_t begin = std::max(x, m_FirstColumn);
+        const uint32_t end = std::min(x + m_TileWidth, endColumn);
+        for (uint32_t i = 0; i < numberOfRows; ++i)
+        {
+          std::memcpy(&m_Rows[m_PixelSize * (i * m_NumberOfColumns + begin - m_FirstColumn)],
+                      &m_Tile[m_PixelSize * (i * m_TileWidth + begin - x)],
+                      m_PixelSize * (end - begin));
+        }
+      }
+      m_FirstRowOfBand = firstRow;
+    }
+    return m_Rows.data() + m_PixelSize * m_NumberOfColumns * (row - firstRow);
+  }
+
+private:
+  TIFF *               m_Image;
+  uint32_t             m_FirstColumn;
+  uint32_t             m_NumberOfColumns;
+  size_t               m_PixelSize;
+  uint32_t             m_TileWidth{ 0 };
+  uint32_t             m_TileHeight{ 0 };
+  uint32_t             m_StripHeight{ 0 };
+  uint32_t             m_Height{ 0 };
+  size_t               m_ScanlineSize{ 0 };
+  uint32_t             m_FirstRowOfBand{ UINT32_MAX };
+  std::vector<uint8_t> m_Tile{};
+  std::vector<uint8_t> m_Rows{};
+};
+} // namespace
+
 bool
 TIFFImageIO::CanReadFile(const char * file)
 {
@@ -51,27 +178,37 @@ TIFFImageIO::CanReadFile(const char * file)
 
 void
 TIFFImageIO::ReadGenericImage(void * out, unsigned int width, unsigned int height)
+{
+  this->ReadGenericRegion(out, 0, 0, width, height);
+}
+
+void
+TIFFImageIO::ReadGenericRegion(void *   out,
+                               uint32_t xStart,
+                               uint32_t yStart,
+                               uint32_t regionWidth,
+                               uint32_t regionHeight)
 {
 
   if (m_ComponentType == IOComponentEnum::UCHAR)
   {
-    this->ReadGenericImage<unsigned char>(out, width, height);
+    this->ReadGenericRegion<unsigned char>(out, xStart, yStart, regionWidth, regionHeight);
   }
   else if (m_ComponentType == IOComponentEnum::CHAR)
   {
-    this->ReadGenericImage<char>(out, width, height);
+    this->ReadGenericRegion<char>(out, xStart, yStart, regionWidth, regionHeight);
   }
   else if (m_ComponentType == IOComponentEnum::USHORT)
   {
-    this->ReadGenericImage<unsigned short>(out, width, height);
+    this->ReadGenericRegion<unsigned short>(out, xStart, yStart, regionWidth, regionHeight);
   }
   else if (m_ComponentType == IOComponentEnum::SHORT)
   {
-    this->ReadGenericImage<short>(out, width, height);
+    this->ReadGenericRegion<short>(out, xStart, yStart, regionWidth, regionHeight);
   }
   else if (m_ComponentType == IOComponentEnum::FLOAT)
   {
-    this->ReadGenericImage<float>(out, width, height);
+    this->ReadGenericRegion<float>(out, xStart, yStart, regionWidth, regionHeight);
   }
 }
 
@@ -175,6 +312,16 @@ TIFFImageIO::ReadVolume(void * buffer)
   }
 }
 
+ImageIORegion
+TIFFImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
+{
+  if (!m_UseStreamedReading || !m_CanReadRegions || requestedRegion.GetImageDimension() < 2)
+  {
+    return Superclass::GenerateStreamableReadRegionFromRequestedRegion(requestedRegion);
+  }
+  return requestedRegion;
+}
+
 void
 TIFFImageIO::Read(void * buffer)
 {
@@ -187,10 +334,25 @@ TIFFImageIO::Read(void * buffer)
       itkExceptionMacro("Cannot open file " << this->m_FileName << '!');
     }
   }
+  if (m_ResolutionLevel > 0 && !m_InternalImage->SetResolutionLevel(m_ResolutionLevel))
+  {
+    itkExceptionMacro("Cannot read resolution level " << m_ResolutionLevel << " of file " << this->m_FileName << '!');
+  }
 
+  const ImageIORegion & regionToRead = this->GetIORegion();
+  if (m_CanReadRegions && regionToRead.GetImageDimension() >= 2)
+  {
+    // Only the strips or tiles which overlap the region are decoded.
+    this->InitializeColors();
+    this->ReadGenericRegion(buffer,
+                            static_cast<uint32_t>(regionToRead.GetIndex(0)),
+                            static_cast<uint32_t>(regionToRead.GetIndex(1)),
+                            static_cast<uint32_t>(regionToRead.GetSize(0)),
+                            static_cast<uint32_t>(regionToRead.GetSize(1)));
+  }
   // The IO region should be of dimensions 3 otherwise we read only the first
   // page
-  if (m_InternalImage->m_NumberOfPages > 0 && this->GetIORegion().GetImageDimension() > 2)
+  else if (m_InternalImage->m_NumberOfPages > 0 && regionToRead.GetImageDimension() > 2)
   {
     this->ReadVolume(buffer);
   }
@@ -218,6 +380,7 @@ TIFFImageIO::TIFFImageIO()
   m_ColorBlue = nullptr;
 
   m_InternalImage = new TIFFReaderInternal;
+  m_InternalWriter = new TIFFWriterInternal;
 
   m_Spacing[0] = 1.0;
   m_Spacing[1] = 1.0;
@@ -238,6 +401,7 @@ TIFFImageIO::~TIFFImageIO()
 {
   m_InternalImage->Clean();
   delete m_InternalImage;
+  delete m_InternalWriter;
 }
 
 void
@@ -247,6 +411,9 @@ TIFFImageIO::PrintSelf(std::ostream & os, Indent indent) const
 
   os << indent << "Compression: " << m_Compression << std::endl;
   os << indent << "JPEGQuality: " << this->GetJPEGQuality() << std::endl;
+  os << indent << "TileSize: " << m_TileSize << std::endl;
+  os << indent << "ResolutionLevel: " << m_ResolutionLevel << std::endl;
+  os << indent << "NumberOfResolutionLevels: " << m_NumberOfResolutionLevels << std::endl;
   if (!m_ColorPalette.empty())
   {
     os << indent << "Image RGB palette:" << '\n';
@@ -343,10 +510,23 @@ TIFFImageIO::ReadImageInformation()
     }
   }
 
+  // The spacing of the full resolution image is scaled for the lower
+  // resolution levels which do not store their own.
+  m_NumberOfResolutionLevels = m_InternalImage->GetNumberOfResolutionLevels();
+  const uint32_t fullResolutionWidth = m_InternalImage->m_Width;
+  const uint32_t fullResolutionHeight = m_InternalImage->m_Height;
+  double         fullResolutionSpacing[2] = { 1.0, 1.0 };
+  ResolutionToSpacing(*m_InternalImage, fullResolutionSpacing[0], fullResolutionSpacing[1]);
+  if (m_ResolutionLevel > 0 && !m_InternalImage->SetResolutionLevel(m_ResolutionLevel))
+  {
+    itkExceptionMacro("Cannot read resolution level " << m_ResolutionLevel << " of file " << this->m_FileName
+                                                      << ", which has " << m_NumberOfResolutionLevels << " levels.");
+  }
+
   ReadTIFFTags();
 
   // if the tiff file is multi-pages
-  if (m_InternalImage->m_NumberOfPages - m_InternalImage->m_IgnoredSubFiles > 1)
+  if (m_ResolutionLevel == 0 && m_InternalImage->m_NumberOfPages - m_InternalImage->m_IgnoredSubFiles > 1)
   {
     this->SetNumberOfDimensions(3);
     if (m_InternalImage->m_SubFiles > 0)
@@ -369,22 +549,16 @@ TIFFImageIO::ReadImageInformation()
   m_Spacing[1] = 1.0;
 
   // If we have some spacing information we use it
-  if (m_InternalImage->m_ResolutionUnit > 0 && m_InternalImage->m_XResolution > 0 && m_InternalImage->m_YResolution > 0)
+  if (!ResolutionToSpacing(*m_InternalImage, m_Spacing[0], m_Spacing[1]) && m_ResolutionLevel > 0)
   {
-    if (m_InternalImage->m_ResolutionUnit == 2) // inches
-    {
-      m_Spacing[0] = 25.4 / static_cast<double>(m_InternalImage->m_XResolution);
-      m_Spacing[1] = 25.4 / static_cast<double>(m_InternalImage->m_YResolution);
-    }
-    else if (m_InternalImage->m_ResolutionUnit == 3) // cm
-    {
-      m_Spacing[0] = 10.0 / static_cast<double>(m_InternalImage->m_XResolution);
-      m_Spacing[1] = 10.0 / static_cast<double>(m_InternalImage->m_YResolution);
-    }
+    m_Spacing[0] = fullResolutionSpacing[0] * fullResolutionWidth / m_InternalImage->m_Width;
+    m_Spacing[1] = fullResolutionSpacing[1] * fullResolutionHeight / m_InternalImage->m_Height;
   }
 
-  m_Origin[0] = 0.0;
-  m_Origin[1] = 0.0;
+  // The pixels of a lower resolution level are centered on the pixels of
+  // the full resolution image which they cover.
+  m_Origin[0] = 0.5 * (m_Spacing[0] - fullResolutionSpacing[0]);
+  m_Origin[1] = 0.5 * (m_Spacing[1] - fullResolutionSpacing[1]);
 
   m_Dimensions[0] = m_InternalImage->m_Width;
   m_Dimensions[1] = m_InternalImage->m_Height;
@@ -534,6 +708,8 @@ TIFFImageIO::ReadImageInformation()
     // make sure the palette is empty
     m_ColorPalette.resize(0);
   }
+
+  m_CanReadRegions = m_NumberOfDimensions == 2 && m_InternalImage->CanRead();
 }
 
 bool
@@ -553,10 +729,38 @@ void
 TIFFImageIO::WriteImageInformation()
 {}
 
+bool
+TIFFImageIO::CanStreamWrite()
+{
+  return m_NumberOfDimensions == 2;
+}
+
+unsigned int
+TIFFImageIO::GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                               const ImageIORegion & pasteRegion,
+                                               const ImageIORegion & largestPossibleRegion)
+{
+  // the rows are appended to the file as they arrive
+  if (pasteRegion != largestPossibleRegion)
+  {
+    itkExceptionMacro("Pasting is not supported! Can't write:" << this->GetFileName());
+  }
+  return Superclass::GetActualNumberOfSplitsForWriting(numberOfRequestedSplits, pasteRegion, largestPossibleRegion);
+}
+
 void
 TIFFImageIO::Write(const void * buffer)
 {
-  if (m_NumberOfDimensions == 2 || m_NumberOfDimensions == 3)
+  if (m_TileSize % 16 != 0)
+  {
+    itkExceptionMacro("TIFF tile size must be a multiple of 16: " << m_TileSize);
+  }
+
+  if (m_NumberOfDimensions == 2 && m_IORegion.GetNumberOfPixels() != m_Dimensions[0] * m_Dimensions[1])
+  {
+    this->WriteRegion(buffer);
+  }
+  else if (m_NumberOfDimensions == 2 || m_NumberOfDimensions == 3)
   {
     this->InternalWrite(buffer);
   }
@@ -566,6 +770,35 @@ TIFFImageIO::Write(const void * buffer)
   }
 }
 
+void
+TIFFImageIO::WriteRegion(const void * buffer)
+{
+  const auto firstRow = static_cast<uint32_t>(m_IORegion.GetIndex(1));
+  if (firstRow == 0)
+  {
+    this->OpenTIFFForWriting();
+    this->WriteDirectoryFields(0, 1);
+  }
+
+  if (!m_InternalWriter->m_Image || m_IORegion.GetIndex(0) != 0 || m_IORegion.GetSize(0) != m_Dimensions[0] ||
+      firstRow != m_InternalWriter->m_NextRow)
+  {
+    m_InternalWriter->Clean();
+    itkExceptionMacro("TIFF images can only be written in consecutive regions of whole rows: " << m_IORegion);
+  }
+  if (!m_InternalWriter->WriteRows(buffer, static_cast<uint32_t>(m_IORegion.GetSize(1))))
+  {
+    m_InternalWriter->Clean();
+    itkExceptionMacro("TIFFImageIO: error out of disk space");
+  }
+
+  // the file is complete with the last row
+  if (m_InternalWriter->m_NextRow == m_InternalWriter->m_Height)
+  {
+    m_InternalWriter->Clean();
+  }
+}
+
 void
 TIFFImageIO::InternalWrite(const void * buffer)
 {
@@ -573,13 +806,84 @@ TIFFImageIO::InternalWrite(const void * buffer)
 
   uint16_t pages = 1;
 
-  const SizeValueType width = m_Dimensions[0];
   const SizeValueType height = m_Dimensions[1];
   if (m_NumberOfDimensions == 3)
   {
     pages = static_cast<uint16_t>(m_Dimensions[2]);
   }
 
+  const SizeValueType pageLength = this->GetPixelSize() * m_Dimensions[0] * height; // in bytes
+
+  this->OpenTIFFForWriting();
+  TIFF * tif = m_InternalWriter->m_Image;
+
+  if (m_NumberOfDimensions == 3)
+  {
+    TIFFCreateDirectory(tif);
+  }
+  for (uint16_t page = 0; page < pages; ++page)
+  {
+    TIFFSetDirectory(tif, page);
+    this->WriteDirectoryFields(page, pages);
+
+    if (!m_InternalWriter->WriteRows(outPtr, static_cast<uint32_t>(height)))
+    {
+      m_InternalWriter->Clean();
+      itkExceptionMacro("TIFFImageIO: error out of disk space");
+    }
+    outPtr += pageLength;
+
+    if (m_NumberOfDimensions == 3)
+    {
+      TIFFWriteDirectory(tif);
+    }
+  }
+  m_InternalWriter->Clean();
+}
+
+void
+TIFFImageIO::OpenTIFFForWriting()
+{
+  bool bigTIFF = false;
+
+  // If the size of the image is greater than 2 GiB then use big tiff
+  constexpr SizeType oneKibiByte = 1024;
+  constexpr SizeType oneMebiByte = 1024 * oneKibiByte;
+  constexpr SizeType oneGibiByte = 1024 * oneMebiByte;
+  constexpr SizeType twoGibiBytes = 2 * oneGibiByte;
+
+  if (this->GetImageSizeInBytes() > twoGibiBytes)
+  {
+#ifdef TIFF_INT64_T // detect if libtiff4
+    bigTIFF = true;
+#else
+    itkExceptionMacro("Size of image exceeds the limit of libtiff.");
+#endif
+  }
+
+  if (!m_InternalWriter->Open(m_FileName.c_str(), bigTIFF))
+  {
+    itkExceptionMacro("Error while trying to open file for writing: " << this->GetFileName() << std::endl
+                                                                      << "Reason: "
+                                                                      << itksys::SystemTools::GetLastSystemError());
+  }
+
+  TIFF * tif = m_InternalWriter->m_Image;
+  if (this->GetComponentType() == IOComponentEnum::SHORT || this->GetComponentType() == IOComponentEnum::CHAR)
+  {
+    TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_INT);
+  }
+  else if (this->GetComponentType() == IOComponentEnum::FLOAT)
+  {
+    TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_IEEEFP);
+  }
+}
+
+void
+TIFFImageIO::WriteDirectoryFields(uint16_t page, uint16_t pages)
+{
+  TIFF * tif = m_InternalWriter->m_Image;
+
   auto         scomponents = static_cast<uint16_t>(this->GetNumberOfComponents());
   const double resolution_x{ m_Spacing[0] != 0.0 ? 25.4 / m_Spacing[0] : 0.0 };
   const double resolution_y{ m_Spacing[1] != 0.0 ? 25.4 / m_Spacing[1] : 0.0 };
@@ -606,37 +910,21 @@ TIFFImageIO::InternalWrite(const void * buffer)
       bps = 32;
       break;
     default:
+      m_InternalWriter->Clean();
       itkExceptionMacro("TIFF supports unsigned/signed char, unsigned/signed short, and float");
   }
 
   uint16_t predictor;
 
-  const char * mode = "w";
-
-  // If the size of the image is greater than 2 GiB then use big tiff
-  constexpr SizeType oneKibiByte = 1024;
-  constexpr SizeType oneMebiByte = 1024 * oneKibiByte;
-  constexpr SizeType oneGibiByte = 1024 * oneMebiByte;
-  constexpr SizeType twoGibiBytes = 2 * oneGibiByte;
-
-  if (this->GetImageSizeInBytes() > twoGibiBytes)
-  {
-#ifdef TIFF_INT64_T // detect if libtiff4
-    // Adding the "8" option enables the use of big tiff
-    mode = "w8";
-#else
-    itkExceptionMacro("Size of image exceeds the limit of libtiff.");
-#endif
-  }
-
-  TIFF * tif = TIFFOpen(m_FileName.c_str(), mode);
-  if (!tif)
-  {
-    itkExceptionMacro("Error while trying to open file for writing: " << this->GetFileName() << std::endl
-                                                                      << "Reason: "
-                                                                      << itksys::SystemTools::GetLastSystemError());
-  }
+  auto w = static_cast<uint32_t>(m_Dimensions[0]);
+  auto h = static_cast<uint32_t>(m_Dimensions[1]);
 
+  TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, w);
+  TIFFSetField(tif, TIFFTAG_IMAGELENGTH, h);
+  TIFFSetField(tif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
+  TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, scomponents);
+  TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, bps); // Fix for stype
+  TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
   if (this->GetComponentType() == IOComponentEnum::SHORT || this->GetComponentType() == IOComponentEnum::CHAR)
   {
     TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_INT);
@@ -645,207 +933,158 @@ TIFFImageIO::InternalWrite(const void * buffer)
   {
     TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_IEEEFP);
   }
+  TIFFSetField(tif, TIFFTAG_SOFTWARE, "InsightToolkit");
 
-  auto w = static_cast<uint32_t>(width);
-  auto h = static_cast<uint32_t>(height);
-
-  if (m_NumberOfDimensions == 3)
+  if (scomponents > 3)
   {
-    TIFFCreateDirectory(tif);
-  }
-  for (uint16_t page = 0; page < pages; ++page)
-  {
-    TIFFSetDirectory(tif, page);
-    TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, w);
-    TIFFSetField(tif, TIFFTAG_IMAGELENGTH, h);
-    TIFFSetField(tif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
-    TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, scomponents);
-    TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, bps); // Fix for stype
-    TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
-    if (this->GetComponentType() == IOComponentEnum::SHORT || this->GetComponentType() == IOComponentEnum::CHAR)
+    // if number of scalar components is greater than 3, that means we assume
+    // there is alpha.
+    const uint16_t extra_samples = scomponents - 3;
+    const auto     sample_info = make_unique_for_overwrite<uint16_t[]>(scomponents - 3);
+    sample_info[0] = EXTRASAMPLE_ASSOCALPHA;
+    for (uint16_t cc = 1; cc < scomponents - 3; ++cc)
     {
-      TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_INT);
-    }
-    else if (this->GetComponentType() == IOComponentEnum::FLOAT)
-    {
-      TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_IEEEFP);
-    }
-    TIFFSetField(tif, TIFFTAG_SOFTWARE, "InsightToolkit");
-
-    if (scomponents > 3)
-    {
-      // if number of scalar components is greater than 3, that means we assume
-      // there is alpha.
-      const uint16_t extra_samples = scomponents - 3;
-      const auto     sample_info = make_unique_for_overwrite<uint16_t[]>(scomponents - 3);
-      sample_info[0] = EXTRASAMPLE_ASSOCALPHA;
-      for (uint16_t cc = 1; cc < scomponents - 3; ++cc)
-      {
-        sample_info[cc] = EXTRASAMPLE_UNSPECIFIED;
-      }
-      TIFFSetField(tif, TIFFTAG_EXTRASAMPLES, extra_samples, sample_info.get());
+      sample_info[cc] = EXTRASAMPLE_UNSPECIFIED;
     }
+    TIFFSetField(tif, TIFFTAG_EXTRASAMPLES, extra_samples, sample_info.get());
+  }
 
-    uint16_t compression;
+  uint16_t compression;
 
-    if (m_UseCompression)
-    {
-      switch (m_Compression)
-      {
-        case TIFFImageIO::LZW:
-          compression = COMPRESSION_LZW;
-          break;
-        case TIFFImageIO::PackBits:
-          compression = COMPRESSION_PACKBITS;
-          break;
-        case TIFFImageIO::JPEG:
-          compression = COMPRESSION_JPEG;
-          break;
-        case TIFFImageIO::Deflate:
-          compression = COMPRESSION_DEFLATE;
-          break;
-        default:
-          compression = COMPRESSION_NONE;
-      }
-    }
-    else
+  if (m_UseCompression)
+  {
+    switch (m_Compression)
     {
-      compression = COMPRESSION_NONE;
+      case TIFFImageIO::LZW:
+        compression = COMPRESSION_LZW;
+        break;
+      case TIFFImageIO::PackBits:
+        compression = COMPRESSION_PACKBITS;
+        break;
+      case TIFFImageIO::JPEG:
+        compression = COMPRESSION_JPEG;
+        break;
+      case TIFFImageIO::Deflate:
+        compression = COMPRESSION_DEFLATE;
+        break;
+      default:
+        compression = COMPRESSION_NONE;
     }
+  }
+  else
+  {
+    compression = COMPRESSION_NONE;
+  }
 
-    TIFFSetField(tif, TIFFTAG_COMPRESSION, compression); // Fix for compression
+  TIFFSetField(tif, TIFFTAG_COMPRESSION, compression); // Fix for compression
 
-    bool paletteAllocated = false;
-    if (scomponents == 1)
+  bool paletteAllocated = false;
+  if (scomponents == 1)
+  {
+    if (this->GetWritePalette())
     {
-      if (this->GetWritePalette())
-      {
-        TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_PALETTE);
-        this->AllocateTiffPalette(bps);
-        TIFFSetField(tif, TIFFTAG_COLORMAP, m_ColorRed, m_ColorGreen, m_ColorBlue);
-        paletteAllocated = true;
-      }
-      else
-      {
-        TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISBLACK);
-      }
+      TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_PALETTE);
+      this->AllocateTiffPalette(bps);
+      TIFFSetField(tif, TIFFTAG_COLORMAP, m_ColorRed, m_ColorGreen, m_ColorBlue);
+      paletteAllocated = true;
     }
     else
     {
-      if (this->GetWritePalette())
-      {
-        itkWarningMacro("Could not write this image as palette because pixel is not scalar");
-      }
-      TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
-    }
-    if (compression == COMPRESSION_JPEG)
-    {
-      TIFFSetField(tif, TIFFTAG_JPEGQUALITY, this->GetJPEGQuality());
-      TIFFSetField(tif, TIFFTAG_JPEGCOLORMODE, JPEGCOLORMODE_RGB);
+      TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISBLACK);
     }
-    else if (compression == COMPRESSION_DEFLATE)
+  }
+  else
+  {
+    if (this->GetWritePalette())
     {
-      predictor = PREDICTOR_NONE;
-      TIFFSetField(tif, TIFFTAG_PREDICTOR, predictor);
+      itkWarningMacro("Could not write this image as palette because pixel is not scalar");
     }
+    TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
+  }
+  if (compression == COMPRESSION_JPEG)
+  {
+    TIFFSetField(tif, TIFFTAG_JPEGQUALITY, this->GetJPEGQuality());
+    TIFFSetField(tif, TIFFTAG_JPEGCOLORMODE, JPEGCOLORMODE_RGB);
+  }
+  else if (compression == COMPRESSION_DEFLATE)
+  {
+    predictor = PREDICTOR_NONE;
+    TIFFSetField(tif, TIFFTAG_PREDICTOR, predictor);
+  }
 
 
-    // Previously, rowsperstrip was set to a default value so that it would be calculated using
-    // the STRIP_SIZE_DEFAULT defined to be 8 kB in tiffiop.h.
-    // However, this a very conservative small number, and it leads to very small strips resulting
-    // in many io operations, which can be slow when written over networks that require
-    // encryption/decryption of each packet (such as sshfs).
-    // Conversely, if the value is too high, a lot of extra memory is required to store the strips
-    // before they are written out.
-    // Experiments writing TIFF images to drives mapped by sshfs showed that a good tradeoff is
-    // achieved when the STRIP_SIZE_DEFAULT is increased to 1 MB.
-    // This results in an increase in memory usage but no increase in writing time when writing
-    // locally and significant writing time improvement when writing over sshfs.
-    // For example, writing a 2048x2048 uint16_t image with 8 kB per strip leads to 2 rows per strip
-    // and takes about 120 seconds writing over sshfs.
-    // Using 1 MB per strip leads to 256 rows per strip, which takes only 4 seconds to write over sshfs.
-    // Rather than change that value in the third party libtiff library, we instead compute the
-    // rowsperstrip here to lead to this same value.
+  // Previously, rowsperstrip was set to a default value so that it would be calculated using
+  // the STRIP_SIZE_DEFAULT defined to be 8 kB in tiffiop.h.
+  // However, this a very conservative small number, and it leads to very small strips resulting
+  // in many io operations, which can be slow when written over networks that require
+  // encryption/decryption of each packet (such as sshfs).
+  // Conversely, if the value is too high, a lot of extra memory is required to store the strips
+  // before they are written out.
+  // Experiments writing TIFF images to drives mapped by sshfs showed that a good tradeoff is
+  // achieved when the STRIP_SIZE_DEFAULT is increased to 1 MB.
+  // This results in an increase in memory usage but no increase in writing time when writing
+  // locally and significant writing time improvement when writing over sshfs.
+  // For example, writing a 2048x2048 uint16_t image with 8 kB per strip leads to 2 rows per strip
+  // and takes about 120 seconds writing over sshfs.
+  // Using 1 MB per strip leads to 256 rows per strip, which takes only 4 seconds to write over sshfs.
+  // Rather than change that value in the third party libtiff library, we instead compute the
+  // rowsperstrip here to lead to this same value.
 #ifdef TIFF_INT64_T // detect if libtiff4
-    uint64_t const scanlinesize = TIFFScanlineSize64(tif);
+  uint64_t const scanlinesize = TIFFScanlineSize64(tif);
 #else
-    tsize_t scanlinesize = TIFFScanlineSize(tif);
+  tsize_t scanlinesize = TIFFScanlineSize(tif);
 #endif
-    if (scanlinesize == 0)
-    {
-      itkExceptionMacro("TIFFScanlineSize returned 0");
-    }
-    rowsperstrip = static_cast<uint32_t>(1024 * 1024 / scanlinesize);
-    if (rowsperstrip < 1)
-    {
-      rowsperstrip = 1;
-    }
+  if (scanlinesize == 0)
+  {
+    m_InternalWriter->Clean();
+    itkExceptionMacro("TIFFScanlineSize returned 0");
+  }
+  rowsperstrip = static_cast<uint32_t>(1024 * 1024 / scanlinesize);
+  if (rowsperstrip < 1)
+  {
+    rowsperstrip = 1;
+  }
 
+  if (m_TileSize > 0)
+  {
+    // Each tile is compressed on its own, so that regions are read without
+    // decoding whole rows of the image.
+    TIFFSetField(tif, TIFFTAG_TILEWIDTH, static_cast<uint32_t>(m_TileSize));
+    TIFFSetField(tif, TIFFTAG_TILELENGTH, static_cast<uint32_t>(m_TileSize));
+  }
+  else
+  {
     TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(tif, rowsperstrip));
+  }
 
-    if (resolution_x > 0 && resolution_y > 0)
-    {
-      TIFFSetField(tif, TIFFTAG_XRESOLUTION, resolution_x);
-      TIFFSetField(tif, TIFFTAG_YRESOLUTION, resolution_y);
-      TIFFSetField(tif, TIFFTAG_RESOLUTIONUNIT, RESUNIT_INCH);
-    }
-
-    if (m_NumberOfDimensions == 3)
-    {
-      // We are writing single page of the multipage file
-      TIFFSetField(tif, TIFFTAG_SUBFILETYPE, FILETYPE_PAGE);
-      // Set the page number
-      TIFFSetField(tif, TIFFTAG_PAGENUMBER, page, pages);
-    }
-    SizeValueType rowLength; // in bytes
-
-    switch (this->GetComponentType())
-    {
-      case IOComponentEnum::UCHAR:
-        rowLength = sizeof(unsigned char);
-        break;
-      case IOComponentEnum::USHORT:
-        rowLength = sizeof(unsigned short);
-        break;
-      case IOComponentEnum::CHAR:
-        rowLength = sizeof(char);
-        break;
-      case IOComponentEnum::SHORT:
-        rowLength = sizeof(short);
-        break;
-      case IOComponentEnum::FLOAT:
-        rowLength = sizeof(float);
-        break;
-      default:
-        itkExceptionMacro("TIFF supports unsigned/signed char, unsigned/signed short, and float");
-    }
+  if (resolution_x > 0 && resolution_y > 0)
+  {
+    TIFFSetField(tif, TIFFTAG_XRESOLUTION, resolution_x);
+    TIFFSetField(tif, TIFFTAG_YRESOLUTION, resolution_y);
+    TIFFSetField(tif, TIFFTAG_RESOLUTIONUNIT, RESUNIT_INCH);
+  }
 
-    rowLength *= this->GetNumberOfComponents();
-    rowLength *= width;
+  if (m_NumberOfDimensions == 3)
+  {
+    // We are writing single page of the multipage file
+    TIFFSetField(tif, TIFFTAG_SUBFILETYPE, FILETYPE_PAGE);
+    // Set the page number
+    TIFFSetField(tif, TIFFTAG_PAGENUMBER, page, pages);
+  }
 
-    uint32_t row = 0;
-    for (unsigned int idx2 = 0; idx2 < height; ++idx2)
-    {
-      if (TIFFWriteScanline(tif, const_cast<char *>(outPtr), row, 0) < 0)
-      {
-        itkExceptionMacro("TIFFImageIO: error out of disk space");
-      }
-      outPtr += rowLength;
-      ++row;
-    }
+  // libtiff keeps a copy of the palette
+  if (paletteAllocated)
+  {
+    _TIFFfree(m_ColorRed);
+    _TIFFfree(m_ColorGreen);
+    _TIFFfree(m_ColorBlue);
+  }
 
-    if (m_NumberOfDimensions == 3)
-    {
-      TIFFWriteDirectory(tif);
-    }
-    if (paletteAllocated)
-    {
-      _TIFFfree(m_ColorRed);
-      _TIFFfree(m_ColorGreen);
-      _TIFFfree(m_ColorBlue);
-    }
+  if (!m_InternalWriter->StartPage())
+  {
+    m_InternalWriter->Clean();
+    itkExceptionMacro("Cannot start writing the page " << page << " of " << this->GetFileName());
   }
-  TIFFClose(tif);
 }
 
 
@@ -1315,19 +1554,17 @@ TIFFImageIO::ReadCurrentPage(void * buffer, size_t pixelOffset)
 
 template <typename TComponent>
 void
-TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int height)
+TIFFImageIO::ReadGenericRegion(void *   _out,
+                               uint32_t xStart,
+                               uint32_t yStart,
+                               uint32_t regionWidth,
+                               uint32_t regionHeight)
 {
   using ComponentType = TComponent;
 
-#ifdef TIFF_INT64_T // detect if libtiff4
-  uint64_t isize = TIFFScanlineSize64(m_InternalImage->m_Image);
-#else
-  tsize_t isize = TIFFScanlineSize(m_InternalImage->m_Image);
-#endif
+  const uint32_t height = m_InternalImage->m_Height;
 
-  size_t  inc;
-  tdata_t buf = _TIFFmalloc(static_cast<tmsize_t>(isize));
-  isize /= sizeof(ComponentType);
+  size_t inc;
 
   auto *          out = static_cast<ComponentType *>(_out);
   ComponentType * image;
@@ -1369,41 +1606,45 @@ TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int heig
       break;
   }
 
-  for (uint32_t row = 0; row < height; ++row)
+  // The rows of the file are read in increasing order; those of a bottom
+  // left image are flipped.
+  const bool     isTopLeft = m_InternalImage->m_Orientation == ORIENTATION_TOPLEFT;
+  const uint32_t firstRow = isTopLeft ? yStart : height - (yStart + regionHeight);
+  const size_t   pixelSize = static_cast<size_t>(m_InternalImage->m_SamplesPerPixel) *
+                           static_cast<size_t>(m_InternalImage->m_BitsPerSample / 8);
+  TIFFColumnRangeReader rowReader(m_InternalImage->m_Image, xStart, regionWidth, pixelSize);
+
+  for (uint32_t row = firstRow; row < firstRow + regionHeight; ++row)
   {
-    if (TIFFReadScanline(m_InternalImage->m_Image, buf, row, 0) <= 0)
+    void * buf = rowReader.ReadRow(row);
+    if (buf == nullptr)
     {
       itkExceptionMacro("Problem reading the row: " << row);
     }
 
-    if (m_InternalImage->m_Orientation == ORIENTATION_TOPLEFT)
-    {
-      image = out + inc * row * width;
-    }
-    else // bottom left
-    {
-      image = out + inc * width * (height - (row + 1));
-    }
+    const uint32_t y = isTopLeft ? row : height - (row + 1);
+    image = out + inc * regionWidth * static_cast<size_t>(y - yStart);
 
     switch (this->GetFormat())
     {
       case TIFFImageIO::GRAYSCALE:
         // check inverted
-        PutGrayscale<ComponentType>(image, static_cast<ComponentType *>(buf), width, 1, 0, 0);
+        PutGrayscale<ComponentType>(image, static_cast<ComponentType *>(buf), regionWidth, 1, 0, 0);
         break;
       case TIFFImageIO::RGB_:
-        PutRGB_<ComponentType>(image, static_cast<ComponentType *>(buf), width, 1, 0, 0);
+        PutRGB_<ComponentType>(image, static_cast<ComponentType *>(buf), regionWidth, 1, 0, 0);
         break;
 
       case TIFFImageIO::PALETTE_GRAYSCALE:
         switch (m_InternalImage->m_BitsPerSample)
         {
           case 8:
-            PutPaletteGrayscale<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
+            PutPaletteGrayscale<ComponentType, unsigned char>(
+              image, static_cast<unsigned char *>(buf), regionWidth, 1, 0, 0);
             break;
           case 16:
             PutPaletteGrayscale<ComponentType, unsigned short>(
-              image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
+              image, static_cast<unsigned short *>(buf), regionWidth, 1, 0, 0);
             break;
           default:
             itkExceptionMacro("Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
@@ -1416,10 +1657,12 @@ TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int heig
           switch (m_InternalImage->m_BitsPerSample)
           {
             case 8:
-              PutPaletteRGB<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
+              PutPaletteRGB<ComponentType, unsigned char>(
+                image, static_cast<unsigned char *>(buf), regionWidth, 1, 0, 0);
               break;
             case 16:
-              PutPaletteRGB<ComponentType, unsigned short>(image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
+              PutPaletteRGB<ComponentType, unsigned short>(
+                image, static_cast<unsigned short *>(buf), regionWidth, 1, 0, 0);
               break;
             default:
               itkExceptionMacro("Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
@@ -1431,11 +1674,12 @@ TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int heig
           switch (m_InternalImage->m_BitsPerSample)
           {
             case 8:
-              PutPaletteScalar<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
+              PutPaletteScalar<ComponentType, unsigned char>(
+                image, static_cast<unsigned char *>(buf), regionWidth, 1, 0, 0);
               break;
             case 16:
               PutPaletteScalar<ComponentType, unsigned short>(
-                image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
+                image, static_cast<unsigned short *>(buf), regionWidth, 1, 0, 0);
               break;
             default:
               itkExceptionMacro("Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
@@ -1448,8 +1692,6 @@ TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int heig
         itkExceptionMacro("Logic Error: Unexpected format!");
     }
   }
-
-  _TIFFfree(buf);
 }
 
 // iso component scalar
@@ -178,6 +178,8 @@ TIFFReaderInternal::Clean()
   this->m_IgnoredSubFiles = 0;
   this->m_SampleFormat = 1;
   this->m_ResolutionUnit = 1; // none
+  this->m_SubIFDOffsets.clear();
+  this->m_ReducedImageDirectories.clear();
   this->m_IsOpen = false;
 
   this->m_WarningSilence = false;
@@ -196,17 +198,11 @@ TIFFReaderInternal::Initialize()
 {
   if (this->m_Image)
   {
-    if (!TIFFGetField(this->m_Image, TIFFTAG_IMAGEWIDTH, &this->m_Width) ||
-        !TIFFGetField(this->m_Image, TIFFTAG_IMAGELENGTH, &this->m_Height))
+    if (!this->InitializeDirectory())
     {
       return 0;
     }
 
-    // Get the resolution in each direction
-    TIFFGetField(this->m_Image, TIFFTAG_XRESOLUTION, &this->m_XResolution);
-    TIFFGetField(this->m_Image, TIFFTAG_YRESOLUTION, &this->m_YResolution);
-    TIFFGetField(this->m_Image, TIFFTAG_RESOLUTIONUNIT, &this->m_ResolutionUnit);
-
     // Check the number of pages. First by looking at the number of directories
     this->m_NumberOfPages = TIFFNumberOfDirectories(this->m_Image);
 
@@ -215,20 +211,13 @@ TIFFReaderInternal::Initialize()
       itkGenericExceptionMacro("No directories found in TIFF file.");
     }
 
-    if (TIFFIsTiled(this->m_Image))
+    // The lower resolution levels of a pyramid are either stored in sub-IFDs
+    // of the first directory, or as reduced resolution subfiles.
+    uint16_t   numberOfSubIFDs = 0;
+    uint64_t * subIFDOffsets = nullptr;
+    if (TIFFGetField(this->m_Image, TIFFTAG_SUBIFD, &numberOfSubIFDs, &subIFDOffsets) && subIFDOffsets != nullptr)
     {
-      this->m_NumberOfTiles = TIFFNumberOfTiles(this->m_Image);
-
-      if (!TIFFGetField(this->m_Image, TIFFTAG_TILEWIDTH, &this->m_TileWidth) ||
-          !TIFFGetField(this->m_Image, TIFFTAG_TILELENGTH, &this->m_TileHeight))
-      {
-        itkGenericExceptionMacro("Cannot read tile width and tile length from file");
-      }
-      else
-      {
-        this->m_TileRows = this->m_Height / this->m_TileHeight;
-        this->m_TileColumns = this->m_Width / this->m_TileWidth;
-      }
+      this->m_SubIFDOffsets.assign(subIFDOffsets, subIFDOffsets + numberOfSubIFDs);
     }
 
     // Checking if the TIFF contains subfiles
@@ -250,6 +239,10 @@ TIFFReaderInternal::Initialize()
           else if (subfiletype & FILETYPE_REDUCEDIMAGE || subfiletype & FILETYPE_MASK)
           {
             ++this->m_IgnoredSubFiles;
+            if (!(subfiletype & FILETYPE_MASK))
+            {
+              this->m_ReducedImageDirectories.push_back(static_cast<tdir_t>(page));
+            }
           }
         }
         TIFFReadDirectory(this->m_Image);
@@ -258,39 +251,112 @@ TIFFReaderInternal::Initialize()
       // Set the directory to the first image, and reads it
       TIFFSetDirectory(this->m_Image, 0);
     }
+  }
 
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_ORIENTATION, &this->m_Orientation);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLESPERPIXEL, &this->m_SamplesPerPixel);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_COMPRESSION, &this->m_Compression);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_BITSPERSAMPLE, &this->m_BitsPerSample);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_PLANARCONFIG, &this->m_PlanarConfig);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLEFORMAT, &this->m_SampleFormat);
-
-    // If TIFFGetField returns false, there's no Photometric Interpretation
-    // set for this image, but that's a required field so we set a warning flag.
-    // (Because the "Photometrics" field is an enum, we can't rely on setting
-    // this->m_Photometrics to some signal value.)
-    if (TIFFGetField(this->m_Image, TIFFTAG_PHOTOMETRIC, &this->m_Photometrics))
+  return 1;
+}
+
+int
+TIFFReaderInternal::InitializeDirectory()
+{
+  if (!TIFFGetField(this->m_Image, TIFFTAG_IMAGEWIDTH, &this->m_Width) ||
+      !TIFFGetField(this->m_Image, TIFFTAG_IMAGELENGTH, &this->m_Height))
+  {
+    return 0;
+  }
+
+  // Get the resolution in each direction
+  this->m_ResolutionUnit = 1;
+  this->m_XResolution = 1;
+  this->m_YResolution = 1;
+  TIFFGetField(this->m_Image, TIFFTAG_XRESOLUTION, &this->m_XResolution);
+  TIFFGetField(this->m_Image, TIFFTAG_YRESOLUTION, &this->m_YResolution);
+  TIFFGetField(this->m_Image, TIFFTAG_RESOLUTIONUNIT, &this->m_ResolutionUnit);
+
+  this->m_NumberOfTiles = 0;
+  this->m_TileRows = 0;
+  this->m_TileColumns = 0;
+  this->m_TileWidth = 0;
+  this->m_TileHeight = 0;
+  if (TIFFIsTiled(this->m_Image))
+  {
+    this->m_NumberOfTiles = TIFFNumberOfTiles(this->m_Image);
+
+    if (!TIFFGetField(this->m_Image, TIFFTAG_TILEWIDTH, &this->m_TileWidth) ||
+        !TIFFGetField(this->m_Image, TIFFTAG_TILELENGTH, &this->m_TileHeight))
     {
-      this->m_HasValidPhotometricInterpretation = true;
+      itkGenericExceptionMacro("Cannot read tile width and tile length from file");
     }
     else
     {
-      this->m_HasValidPhotometricInterpretation = false;
+      this->m_TileRows = this->m_Height / this->m_TileHeight;
+      this->m_TileColumns = this->m_Width / this->m_TileWidth;
     }
   }
 
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_ORIENTATION, &this->m_Orientation);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLESPERPIXEL, &this->m_SamplesPerPixel);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_COMPRESSION, &this->m_Compression);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_BITSPERSAMPLE, &this->m_BitsPerSample);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_PLANARCONFIG, &this->m_PlanarConfig);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLEFORMAT, &this->m_SampleFormat);
+
+  // If TIFFGetField returns false, there's no Photometric Interpretation
+  // set for this image, but that's a required field so we set a warning flag.
+  // (Because the "Photometrics" field is an enum, we can't rely on setting
+  // this->m_Photometrics to some signal value.)
+  if (TIFFGetField(this->m_Image, TIFFTAG_PHOTOMETRIC, &this->m_Photometrics))
+  {
+    this->m_HasValidPhotometricInterpretation = true;
+  }
+  else
+  {
+    this->m_HasValidPhotometricInterpretation = false;
+  }
+
   return 1;
 }
 
+unsigned int
+TIFFReaderInternal::GetNumberOfResolutionLevels() const
+{
+  if (!this->m_SubIFDOffsets.empty())
+  {
+    return 1 + static_cast<unsigned int>(this->m_SubIFDOffsets.size());
+  }
+  return 1 + static_cast<unsigned int>(this->m_ReducedImageDirectories.size());
+}
+
+int
+TIFFReaderInternal::SetResolutionLevel(unsigned int level)
+{
+  if (!this->m_Image || level >= this->GetNumberOfResolutionLevels())
+  {
+    return 0;
+  }
+
+  int status = 0;
+  if (level == 0)
+  {
+    status = TIFFSetDirectory(this->m_Image, 0);
+  }
+  else if (!this->m_SubIFDOffsets.empty())
+  {
+    status = TIFFSetSubDirectory(this->m_Image, this->m_SubIFDOffsets[level - 1]);
+  }
+  else
+  {
+    status = TIFFSetDirectory(this->m_Image, this->m_ReducedImageDirectories[level - 1]);
+  }
+  return status && this->InitializeDirectory();
+}
+
 int
 TIFFReaderInternal::CanRead()
 {
   const bool compressionSupported = (TIFFIsCODECConfigured(this->m_Compression) == 1);
   return (this->m_Image && (this->m_Width > 0) && (this->m_Height > 0) && (this->m_SamplesPerPixel > 0) &&
-          compressionSupported && (m_NumberOfTiles == 0) // just use TIFFReadRGBAImage, an
-                                                         // native optimized version would be nice
-          && (this->m_HasValidPhotometricInterpretation) &&
+          compressionSupported && (this->m_HasValidPhotometricInterpretation) &&
           (this->m_Photometrics == PHOTOMETRIC_RGB || this->m_Photometrics == PHOTOMETRIC_MINISWHITE ||
            this->m_Photometrics == PHOTOMETRIC_MINISBLACK ||
            (this->m_Photometrics == PHOTOMETRIC_PALETTE && this->m_BitsPerSample != 32)) &&
@@ -21,6 +21,7 @@
 #include "ITKIOTIFFExport.h"
 #include "itkIntTypes.h"
 #include "itk_tiff.h"
+#include <vector>
 
 
 namespace itk
@@ -42,6 +43,16 @@ public:
   int
   Open(const char * filename, bool silent = false);
 
+  /** Make the directory of the given resolution level current, and read
+   * its fields. Level 0 is the first directory of the file. The next levels
+   * are its sub-IFDs, or else the reduced resolution subfiles of the file.
+   * Returns 0 when the level does not exist. */
+  int
+  SetResolutionLevel(unsigned int level);
+
+  unsigned int
+  GetNumberOfResolutionLevels() const;
+
   TIFF *   m_Image;
   bool     m_IsOpen;
   uint32_t m_Width;
@@ -67,8 +78,16 @@ public:
   float    m_YResolution;
   uint16_t m_SampleFormat;
 
+  std::vector<uint64_t> m_SubIFDOffsets;
+  std::vector<tdir_t>   m_ReducedImageDirectories;
+
   bool m_WarningSilence{ false };
   bool m_ErrorSilence{ false };
+
+private:
+  // Read the fields of the current directory.
+  int
+  InitializeDirectory();
 };
 
 } // namespace itk
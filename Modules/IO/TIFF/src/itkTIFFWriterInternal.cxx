@@ -0,0 +1,133 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTIFFWriterInternal.h"
+#include <algorithm>
+#include <cstring>
+
+namespace itk
+{
+
+TIFFWriterInternal::~TIFFWriterInternal() { this->Clean(); }
+
+int
+TIFFWriterInternal::Open(const char * filename, bool bigTIFF)
+{
+  this->Clean();
+  // Adding the "8" option enables the use of big tiff
+  this->m_Image = TIFFOpen(filename, bigTIFF ? "w8" : "w");
+  return this->m_Image != nullptr;
+}
+
+void
+TIFFWriterInternal::Clean()
+{
+  if (this->m_Image)
+  {
+    TIFFClose(this->m_Image);
+  }
+  this->m_Image = nullptr;
+  this->m_Width = 0;
+  this->m_Height = 0;
+  this->m_NextRow = 0;
+  this->m_TileWidth = 0;
+  this->m_TileHeight = 0;
+  this->m_RowSize = 0;
+  this->m_Band.clear();
+  this->m_Band.shrink_to_fit();
+  this->m_Tile.clear();
+  this->m_Tile.shrink_to_fit();
+}
+
+int
+TIFFWriterInternal::StartPage()
+{
+  if (!TIFFGetField(this->m_Image, TIFFTAG_IMAGEWIDTH, &this->m_Width) ||
+      !TIFFGetField(this->m_Image, TIFFTAG_IMAGELENGTH, &this->m_Height))
+  {
+    return 0;
+  }
+  this->m_NextRow = 0;
+  this->m_RowSize = static_cast<size_t>(TIFFScanlineSize64(this->m_Image));
+  this->m_TileWidth = 0;
+  this->m_TileHeight = 0;
+  if (TIFFIsTiled(this->m_Image))
+  {
+    if (!TIFFGetField(this->m_Image, TIFFTAG_TILEWIDTH, &this->m_TileWidth) ||
+        !TIFFGetField(this->m_Image, TIFFTAG_TILELENGTH, &this->m_TileHeight))
+    {
+      return 0;
+    }
+    // The band holds a row of tiles, which is written once it is full.
+    this->m_Band.resize(this->m_RowSize * this->m_TileHeight);
+    this->m_Tile.resize(static_cast<size_t>(TIFFTileSize64(this->m_Image)));
+  }
+  return this->m_RowSize > 0;
+}
+
+int
+TIFFWriterInternal::WriteRows(const void * rows, uint32_t numberOfRows)
+{
+  const auto * row = static_cast<const uint8_t *>(rows);
+  for (uint32_t i = 0; i < numberOfRows; ++i, row += this->m_RowSize)
+  {
+    if (this->m_TileHeight == 0)
+    {
+      if (TIFFWriteScanline(this->m_Image, const_cast<uint8_t *>(row), this->m_NextRow, 0) < 0)
+      {
+        return 0;
+      }
+      ++this->m_NextRow;
+      continue;
+    }
+
+    std::copy_n(row, this->m_RowSize, &this->m_Band[(this->m_NextRow % this->m_TileHeight) * this->m_RowSize]);
+    ++this->m_NextRow;
+    if ((this->m_NextRow % this->m_TileHeight == 0 || this->m_NextRow == this->m_Height) && !this->WriteTileRow())
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+int
+TIFFWriterInternal::WriteTileRow()
+{
+  const uint32_t firstRow = (this->m_NextRow - 1) / this->m_TileHeight * this->m_TileHeight;
+  const uint32_t numberOfRows = this->m_NextRow - firstRow;
+  const size_t   pixelSize = this->m_RowSize / this->m_Width;
+  const size_t   tileRowSize = pixelSize * this->m_TileWidth;
+  for (uint32_t x = 0; x < this->m_Width; x += this->m_TileWidth)
+  {
+    // The part of the tile outside of the image is left zero.
+    const size_t columnsSize = pixelSize * std::min(this->m_TileWidth, this->m_Width - x);
+    std::fill(this->m_Tile.begin(), this->m_Tile.end(), uint8_t{ 0 });
+    for (uint32_t i = 0; i < numberOfRows; ++i)
+    {
+      std::memcpy(&this->m_Tile[i * tileRowSize], &this->m_Band[i * this->m_RowSize + x * pixelSize], columnsSize);
+    }
+    if (TIFFWriteTile(this->m_Image, this->m_Tile.data(), x, firstRow, 0, 0) < 0)
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+} // namespace itk
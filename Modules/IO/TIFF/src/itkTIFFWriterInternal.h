@@ -0,0 +1,72 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTIFFWriterInternal_h
+#define itkTIFFWriterInternal_h
+
+#include "ITKIOTIFFExport.h"
+#include "itkIntTypes.h"
+#include "itk_tiff.h"
+#include <vector>
+
+
+namespace itk
+{
+
+/** Holds the file written by TIFFImageIO between the regions of a streamed
+ * write, and writes the rows of its pages in strips or tiles. */
+class ITKIOTIFF_HIDDEN TIFFWriterInternal
+{
+public:
+  TIFFWriterInternal() = default;
+  ~TIFFWriterInternal();
+
+  int
+  Open(const char * filename, bool bigTIFF);
+
+  void
+  Clean();
+
+  /** Prepare writing the rows of the current directory, in the strips or
+   * tiles set in its fields. */
+  int
+  StartPage();
+
+  /** Write the given number of rows, following those written before. The
+   * rows of a tiled page are buffered until they fill a row of tiles. */
+  int
+  WriteRows(const void * rows, uint32_t numberOfRows);
+
+  TIFF *   m_Image{ nullptr };
+  uint32_t m_Width{ 0 };
+  uint32_t m_Height{ 0 };
+  uint32_t m_NextRow{ 0 };
+
+private:
+  int
+  WriteTileRow();
+
+  uint32_t             m_TileWidth{ 0 };
+  uint32_t             m_TileHeight{ 0 };
+  size_t               m_RowSize{ 0 };
+  std::vector<uint8_t> m_Band{};
+  std::vector<uint8_t> m_Tile{};
+};
+
+} // namespace itk
+
+#endif // itkTIFFWriterInternal_h
@@ -0,0 +1,181 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageSource.h"
+#include "itkTIFFImageIO.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using ImageType = itk::Image<unsigned short, 2>;
+
+unsigned short
+ExpectedValue(const ImageType::IndexType & index)
+{
+  return static_cast<unsigned short>(index[0] + 1000 * index[1]);
+}
+
+// Generates the pixels of the requested region only, so that writers
+// stream it.
+class IndexImageSource : public itk::ImageSource<ImageType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(IndexImageSource);
+
+  using Self = IndexImageSource;
+  using Superclass = itk::ImageSource<ImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(IndexImageSource);
+
+  itkSetMacro(Region, ImageType::RegionType);
+  itkGetConstMacro(NumberOfGeneratedRegions, unsigned int);
+
+protected:
+  IndexImageSource() = default;
+  ~IndexImageSource() override = default;
+
+  void
+  GenerateOutputInformation() override
+  {
+    this->GetOutput()->SetLargestPossibleRegion(m_Region);
+  }
+
+  void
+  GenerateData() override
+  {
+    ImageType * output = this->GetOutput();
+    output->SetBufferedRegion(output->GetRequestedRegion());
+    output->Allocate();
+    for (itk::ImageRegionIteratorWithIndex<ImageType> it(output, output->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+    {
+      it.Set(ExpectedValue(it.GetIndex()));
+    }
+    ++m_NumberOfGeneratedRegions;
+  }
+
+private:
+  ImageType::RegionType m_Region{};
+  unsigned int          m_NumberOfGeneratedRegions{ 0 };
+};
+
+// Write the image in the given number of stream divisions, in tiles of the
+// given size, or in strips when it is zero. Returns the number of regions
+// written.
+unsigned int
+WriteImage(const ImageType::RegionType & largestRegion,
+           const std::string &           fileName,
+           unsigned int                  tileSize,
+           unsigned int                  numberOfStreamDivisions)
+{
+  const auto source = IndexImageSource::New();
+  source->SetRegion(largestRegion);
+  const auto imageIO = itk::TIFFImageIO::New();
+  imageIO->SetTileSize(tileSize);
+  const auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetImageIO(imageIO);
+  writer->SetFileName(fileName);
+  writer->SetInput(source->GetOutput());
+  writer->SetUseCompression(true);
+  writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  writer->Update();
+  return source->GetNumberOfGeneratedRegions();
+}
+
+// Read the given region of the image back, and check that only that region
+// was read, with the expected pixels.
+bool
+ReadRegion(const std::string & fileName, const ImageType::RegionType & regionToRead)
+{
+  const auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetImageIO(itk::TIFFImageIO::New());
+  reader->SetFileName(fileName);
+  reader->GetOutput()->SetRequestedRegion(regionToRead);
+  reader->Update();
+
+  const ImageType * output = reader->GetOutput();
+  if (output->GetBufferedRegion() != regionToRead)
+  {
+    std::cerr << "Test failed for " << fileName << '!' << std::endl;
+    std::cerr << "Expected to read region " << regionToRead << ", but read " << output->GetBufferedRegion()
+              << std::endl;
+    return false;
+  }
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(output, regionToRead); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != ExpectedValue(it.GetIndex()))
+    {
+      std::cerr << "Test failed for " << fileName << '!' << std::endl;
+      std::cerr << "Expected " << ExpectedValue(it.GetIndex()) << " at " << it.GetIndex() << ", but got " << it.Get()
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkTIFFImageIOStreamingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  const auto imageIO = itk::TIFFImageIO::New();
+  ITK_TEST_EXPECT_TRUE(imageIO->CanStreamRead());
+  ITK_TEST_SET_GET_VALUE(0, imageIO->GetTileSize());
+  ITK_TEST_SET_GET_VALUE(0, imageIO->GetResolutionLevel());
+
+  bool success = true;
+
+  // The image is not a whole number of tiles, nor of strips.
+  const ImageType::RegionType largestRegion(ImageType::SizeType{ { 75, 53 } });
+  const ImageType::RegionType regions[] = { ImageType::RegionType({ { 20, 17 } }, { { 40, 20 } }),
+                                            ImageType::RegionType({ { 70, 50 } }, { { 5, 3 } }),
+                                            ImageType::RegionType({ { 0, 31 } }, { { 1, 1 } }),
+                                            largestRegion };
+  for (const unsigned int tileSize : { 0, 16, 32 })
+  {
+    const std::string fileName =
+      outputDirectory + "/itkTIFFImageIOStreamingTest" + std::to_string(tileSize) + ".tif";
+    ITK_TEST_EXPECT_EQUAL(WriteImage(largestRegion, fileName, tileSize, 4), 4);
+
+    imageIO->SetFileName(fileName);
+    ITK_TRY_EXPECT_NO_EXCEPTION(imageIO->ReadImageInformation());
+    ITK_TEST_EXPECT_EQUAL(imageIO->GetNumberOfResolutionLevels(), 1);
+
+    for (const auto & region : regions)
+    {
+      ITK_TRY_EXPECT_NO_EXCEPTION(success &= ReadRegion(fileName, region));
+    }
+  }
+
+  // Tiles must be a multiple of 16 pixels wide.
+  ITK_TRY_EXPECT_EXCEPTION(WriteImage(largestRegion, outputDirectory + "/itkTIFFImageIOStreamingTest.tif", 24, 1));
+
+  std::cout << "Test finished." << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
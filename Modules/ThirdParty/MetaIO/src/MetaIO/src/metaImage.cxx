@@ -1665,8 +1665,10 @@ MetaImage::WriteStream(METAIO_STREAM::ofstream * _stream, bool _writeElements, c
 
   m_WriteStream = _stream;
 
+  // Without the elements, the header keeps the CompressedDataSize set by the
+  // caller, which writes the compressed elements itself.
   unsigned char * compressedElementData = nullptr;
-  if (m_BinaryData && m_CompressedData && m_ElementDataFileName.find('%') == std::string::npos)
+  if (_writeElements && m_BinaryData && m_CompressedData && m_ElementDataFileName.find('%') == std::string::npos)
   // compressed & !slice/file
   {
     int elementSize;
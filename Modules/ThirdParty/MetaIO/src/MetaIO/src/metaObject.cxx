@@ -1085,6 +1085,18 @@ MetaObject::CompressionLevel() const
   return m_CompressionLevel;
 }
 
+void
+MetaObject::CompressedDataSize(std::streamoff _compressedDataSize)
+{
+  m_CompressedDataSize = _compressedDataSize;
+}
+
+std::streamoff
+MetaObject::CompressedDataSize() const
+{
+  return m_CompressedDataSize;
+}
+
 void
 MetaObject::BinaryData(bool _binaryData)
 {
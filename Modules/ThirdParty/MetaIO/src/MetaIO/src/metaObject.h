@@ -378,6 +378,14 @@ public:
   int
   CompressionLevel() const;
 
+  // Size in bytes of the compressed element data, as read from the header.
+  // Set it before writing only the header, to describe element data which
+  // the caller compressed and writes itself.
+  void
+  CompressedDataSize(std::streamoff _compressedDataSize);
+  std::streamoff
+  CompressedDataSize() const;
+
   virtual void
   Clear();
 